@@ -1,5 +1,7 @@
 #include "AudioAnalyzer.h"
 #include "../../Utils/PlatformPaths.h"
+#include "../../Utils/Tracer.h"
+#include <algorithm>
 #include <climits>
 
 AudioAnalyzer::AudioAnalyzer() = default;
@@ -66,6 +68,7 @@ bool AudioAnalyzer::isRMVPEAvailable() const {
 }
 
 void AudioAnalyzer::analyze(Project& project, ProgressCallback onProgress, CompleteCallback onComplete) {
+    TRACE_SCOPE("analyze");
     auto& audioData = project.getAudioData();
     if (audioData.waveform.getNumSamples() == 0)
         return;
@@ -77,8 +80,9 @@ void AudioAnalyzer::analyze(Project& project, ProgressCallback onProgress, Compl
     if (onProgress) onProgress(0.35, "Computing mel spectrogram...");
     MelSpectrogram melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
     audioData.melSpectrogram = melComputer.compute(samples, numSamples);
+    audioData.melSpectrogram.setStorage(melStorage);
 
-    int targetFrames = static_cast<int>(audioData.melSpectrogram.size());
+    int targetFrames = audioData.melSpectrogram.getNumFrames();
 
     if (cancelFlag.load()) return;
 
@@ -150,52 +154,180 @@ void AudioAnalyzer::analyzeAsync(Project& project, ProgressCallback onProgress,
     });
 }
 
+AudioAnalyzer::RangeRequest AudioAnalyzer::prepareRange(const Project& project, int startFrame, int endFrame,
+                                                        const juce::AudioBuffer<float>* sourceAudio) {
+    RangeRequest request;
+    const auto& audioData = project.getAudioData();
+    const auto& audio = sourceAudio != nullptr ? *sourceAudio : audioData.waveform;
+    const int totalFrames = audioData.getNumFrames();
+    const int totalSamples = audio.getNumSamples();
+    if (totalFrames <= 0 || totalSamples == 0)
+        return request;
+
+    startFrame = juce::jlimit(0, totalFrames, startFrame);
+    endFrame = juce::jlimit(startFrame, totalFrames, endFrame);
+
+    // Expand until no note crosses the range boundaries, so whole notes are
+    // replaced and notes outside the range keep their edits
+    bool expanded = true;
+    while (expanded) {
+        expanded = false;
+        for (const auto& note : project.getNotes()) {
+            if (note.getEndFrame() <= startFrame || note.getStartFrame() >= endFrame)
+                continue;
+            if (note.getStartFrame() < startFrame) {
+                startFrame = std::max(0, note.getStartFrame());
+                expanded = true;
+            }
+            if (note.getEndFrame() > endFrame) {
+                endFrame = std::min(totalFrames, note.getEndFrame());
+                expanded = true;
+            }
+        }
+    }
+
+    const int contextFrames = secondsToFrames(RANGE_CONTEXT_SECONDS);
+    request.startFrame = startFrame;
+    request.endFrame = endFrame;
+    request.totalFrames = totalFrames;
+    request.sliceStartFrame = std::max(0, startFrame - contextFrames);
+
+    const int sliceEndFrame = std::min(totalFrames, endFrame + contextFrames);
+    const int sliceStartSample = std::min(request.sliceStartFrame * HOP_SIZE, totalSamples);
+    const int sliceEndSample = std::min(sliceEndFrame * HOP_SIZE, totalSamples);
+    const int sliceSamples = std::max(0, sliceEndSample - sliceStartSample);
+
+    request.slice.setSize(1, sliceSamples);
+    if (sliceSamples > 0)
+        request.slice.copyFrom(0, 0, audio, 0, sliceStartSample, sliceSamples);
+
+    request.state = captureRangeState(project, startFrame, endFrame);
+    return request;
+}
+
+AudioAnalyzer::RangeResult AudioAnalyzer::analyzeRange(const RangeRequest& request, ProgressCallback onProgress) {
+    TRACE_SCOPE("analyze range");
+    RangeResult result;
+    if (request.endFrame <= request.startFrame || request.slice.getNumSamples() == 0)
+        return result;
+
+    cancelFlag = false;
+
+    // Run the regular pipeline on a project that only holds the slice
+    Project sliceProject;
+    auto& sliceData = sliceProject.getAudioData();
+    sliceData.waveform = request.slice;
+    sliceData.sampleRate = SAMPLE_RATE;
+
+    analyze(sliceProject, onProgress);
+    if (cancelFlag.load())
+        return result;
+
+    const int offset = request.startFrame - request.sliceStartFrame;
+    const int numFrames = request.endFrame - request.startFrame;
+    if (offset < 0 || offset + numFrames > sliceData.getNumFrames() ||
+        offset + numFrames > static_cast<int>(sliceData.f0.size()))
+        return result;
+
+    result.startFrame = request.startFrame;
+    result.endFrame = request.endFrame;
+    result.totalFrames = request.totalFrames;
+    result.mel = sliceData.melSpectrogram.getRange(offset, offset + numFrames);
+    result.f0.assign(sliceData.f0.begin() + offset, sliceData.f0.begin() + offset + numFrames);
+    result.voicedMask.assign(sliceData.voicedMask.begin() + offset,
+                             sliceData.voicedMask.begin() + offset + numFrames);
+
+    // Keep notes inside the range, clipped and shifted to project frames
+    for (const auto& note : sliceProject.getNotes()) {
+        int start = std::max(note.getStartFrame(), offset);
+        int end = std::min(note.getEndFrame(), offset + numFrames);
+        if (end - start < 3)
+            continue;
+
+        result.notes.emplace_back(start + request.sliceStartFrame, end + request.sliceStartFrame, note.getMidiNote());
+    }
+
+    result.salience = std::move(sliceData.pitchSalience);
+    result.sliceStartTime = framesToSeconds(request.sliceStartFrame);
+    result.state = request.state;
+    result.valid = true;
+    return result;
+}
+
+bool AudioAnalyzer::applyRange(Project& project, const RangeResult& result,
+                               Project::RangeSnapshot* before, Project::RangeSnapshot* after) {
+    auto& audioData = project.getAudioData();
+    const int totalFrames = audioData.getNumFrames();
+    if (!result.valid || totalFrames != result.totalFrames ||
+        static_cast<int>(audioData.f0.size()) != totalFrames)
+        return false;
+
+    // Edits are not blocked while the range is analysed; anything touching
+    // it since prepareRange (including a note moved across the boundary)
+    // would be replaced, so drop the result instead
+    if (captureRangeState(project, result.startFrame, result.endFrame) != result.state)
+        return false;
+
+    const int start = result.startFrame;
+    const int numFrames = result.endFrame - result.startFrame;
+
+    // Base regeneration reaches an unknown distance past the range, so take
+    // the whole curves now and trim once the rebuilt span is known
+    if (before != nullptr)
+        *before = project.captureRange(result.startFrame, result.endFrame, 0, totalFrames);
+
+    audioData.melSpectrogram.setRange(start, result.mel);
+    audioData.voicedMask.resize(static_cast<size_t>(totalFrames), 0);
+    for (int i = 0; i < numFrames; ++i)
+        audioData.voicedMask[static_cast<size_t>(start + i)] = result.voicedMask[static_cast<size_t>(i)];
+
+    // Replace notes in the range (prepareRange made sure none straddle it,
+    // and the state check above that none moved since)
+    project.replaceNotesInRange(result.startFrame, result.endFrame, result.notes);
+
+    // New base around the replaced notes (delta outside the range is
+    // preserved), then re-derive delta inside the range from the detected pitch
+    const auto rebuilt = PitchCurveProcessor::rebuildBaseFromNotes(project, result.startFrame, result.endFrame);
+    PitchCurveProcessor::updateDeltaFromSource(project, start, start + numFrames, result.f0.data());
+
+    // Keep the stored salience consistent for later voicing re-decodes
+    auto& salience = audioData.pitchSalience;
+    if (!salience.isEmpty() && !result.salience.isEmpty() &&
+        std::abs(salience.getFrameTime() - result.salience.getFrameTime()) < 1e-9) {
+        const double frameTime = salience.getFrameTime();
+        const int dstStart = static_cast<int>(std::ceil(framesToSeconds(result.startFrame) / frameTime));
+        const int dstEnd = static_cast<int>(std::floor(framesToSeconds(result.endFrame) / frameTime));
+        const int srcStart = dstStart - static_cast<int>(std::round(result.sliceStartTime / frameTime));
+        salience.replaceFrames(dstStart, result.salience, srcStart, dstEnd - dstStart);
+    }
+
+    int curveStart = result.startFrame;
+    int curveEnd = result.endFrame;
+    if (rebuilt.second > rebuilt.first) {
+        curveStart = std::min(curveStart, rebuilt.first);
+        curveEnd = std::max(curveEnd, rebuilt.second);
+    }
+    if (before != nullptr)
+        before->trimCurves(curveStart, curveEnd);
+    if (after != nullptr)
+        *after = project.captureRange(result.startFrame, result.endFrame, curveStart, curveEnd);
+
+    project.setF0DirtyRange(result.startFrame, result.endFrame);
+    project.setModified(true);
+    return true;
+}
+
 void AudioAnalyzer::extractF0WithRMVPE(AudioData& audioData, int targetFrames) {
     const float* samples = audioData.waveform.getReadPointer(0);
     int numSamples = audioData.waveform.getNumSamples();
 
     auto* detector = rmvpeDetector ? rmvpeDetector.get() : externalRMVPEDetector;
-    std::vector<float> rmvpeF0 = detector->extractF0(samples, numSamples, SAMPLE_RATE);
-
-    if (!rmvpeF0.empty() && targetFrames > 0) {
-        audioData.f0.resize(targetFrames);
-
-        // Time per frame for each system
-        const double rmvpeFrameTime = 160.0 / 16000.0;    // 0.01 seconds
-        const double vocoderFrameTime = 512.0 / 44100.0;  // ~0.01161 seconds
-
-        for (int i = 0; i < targetFrames; ++i) {
-            double vocoderTime = i * vocoderFrameTime;
-            double rmvpeFramePos = vocoderTime / rmvpeFrameTime;
-            int srcIdx = static_cast<int>(rmvpeFramePos);
-            double frac = rmvpeFramePos - srcIdx;
-
-            if (srcIdx + 1 < static_cast<int>(rmvpeF0.size())) {
-                float f0_a = rmvpeF0[srcIdx];
-                float f0_b = rmvpeF0[srcIdx + 1];
-
-                if (f0_a > 0.0f && f0_b > 0.0f) {
-                    // Log-domain interpolation for musical accuracy
-                    float logF0_a = std::log(f0_a);
-                    float logF0_b = std::log(f0_b);
-                    float logF0_interp = logF0_a * (1.0 - frac) + logF0_b * frac;
-                    audioData.f0[i] = std::exp(logF0_interp);
-                } else if (f0_a > 0.0f) {
-                    audioData.f0[i] = f0_a;
-                } else if (f0_b > 0.0f) {
-                    audioData.f0[i] = f0_b;
-                } else {
-                    audioData.f0[i] = 0.0f;
-                }
-            } else if (srcIdx < static_cast<int>(rmvpeF0.size())) {
-                audioData.f0[i] = rmvpeF0[srcIdx];
-            } else {
-                audioData.f0[i] = rmvpeF0.back() > 0.0f ? rmvpeF0.back() : 0.0f;
-            }
-        }
-    } else {
-        audioData.f0.clear();
-    }
+    std::vector<float> rmvpeF0 = detector->extractF0(samples, numSamples, SAMPLE_RATE,
+                                                     RMVPEPitchDetector::DEFAULT_THRESHOLD,
+                                                     &audioData.pitchSalience);
+
+    // Time per RMVPE frame: 160 / 16000 = 0.01 seconds
+    audioData.f0 = resampleDetectorF0(rmvpeF0, 160.0 / 16000.0, targetFrames);
 
     // Create voiced mask
     audioData.voicedMask.resize(audioData.f0.size());
@@ -209,47 +341,11 @@ void AudioAnalyzer::extractF0WithFCPE(AudioData& audioData, int targetFrames) {
     int numSamples = audioData.waveform.getNumSamples();
 
     auto* detector = fcpeDetector ? fcpeDetector.get() : externalFCPEDetector;
-    std::vector<float> fcpeF0 = detector->extractF0(samples, numSamples, SAMPLE_RATE);
-
-    if (!fcpeF0.empty() && targetFrames > 0) {
-        audioData.f0.resize(targetFrames);
-
-        // Time per frame for each system
-        const double fcpeFrameTime = 160.0 / 16000.0;    // 0.01 seconds
-        const double vocoderFrameTime = 512.0 / 44100.0; // ~0.01161 seconds
-
-        for (int i = 0; i < targetFrames; ++i) {
-            double vocoderTime = i * vocoderFrameTime;
-            double fcpeFramePos = vocoderTime / fcpeFrameTime;
-            int srcIdx = static_cast<int>(fcpeFramePos);
-            double frac = fcpeFramePos - srcIdx;
-
-            if (srcIdx + 1 < static_cast<int>(fcpeF0.size())) {
-                float f0_a = fcpeF0[srcIdx];
-                float f0_b = fcpeF0[srcIdx + 1];
-
-                if (f0_a > 0.0f && f0_b > 0.0f) {
-                    // Log-domain interpolation for musical accuracy
-                    float logF0_a = std::log(f0_a);
-                    float logF0_b = std::log(f0_b);
-                    float logF0_interp = logF0_a * (1.0 - frac) + logF0_b * frac;
-                    audioData.f0[i] = std::exp(logF0_interp);
-                } else if (f0_a > 0.0f) {
-                    audioData.f0[i] = f0_a;
-                } else if (f0_b > 0.0f) {
-                    audioData.f0[i] = f0_b;
-                } else {
-                    audioData.f0[i] = 0.0f;
-                }
-            } else if (srcIdx < static_cast<int>(fcpeF0.size())) {
-                audioData.f0[i] = fcpeF0[srcIdx];
-            } else {
-                audioData.f0[i] = fcpeF0.back() > 0.0f ? fcpeF0.back() : 0.0f;
-            }
-        }
-    } else {
-        audioData.f0.clear();
-    }
+    std::vector<float> fcpeF0 = detector->extractF0(samples, numSamples, SAMPLE_RATE, 0.05f,
+                                                    &audioData.pitchSalience);
+
+    // Time per FCPE frame: 160 / 16000 = 0.01 seconds
+    audioData.f0 = resampleDetectorF0(fcpeF0, 160.0 / 16000.0, targetFrames);
 
     // Create voiced mask
     audioData.voicedMask.resize(audioData.f0.size());
@@ -266,12 +362,149 @@ void AudioAnalyzer::extractF0WithYIN(AudioData& audioData) {
     auto [f0Values, voicedValues] = detector->extractF0(samples, numSamples);
     audioData.f0 = std::move(f0Values);
     audioData.voicedMask = std::move(voicedValues);
+    audioData.pitchSalience.clear();
+}
+
+std::vector<float> AudioAnalyzer::resampleDetectorF0(const std::vector<float>& detectorF0,
+                                                     double detectorFrameTime,
+                                                     int targetFrames) {
+    if (detectorF0.empty() || targetFrames <= 0)
+        return {};
+
+    std::vector<float> f0(static_cast<size_t>(targetFrames));
+    const double vocoderFrameTime = static_cast<double>(HOP_SIZE) / SAMPLE_RATE; // ~0.01161 seconds
+    const int srcSize = static_cast<int>(detectorF0.size());
+
+    for (int i = 0; i < targetFrames; ++i) {
+        double vocoderTime = i * vocoderFrameTime;
+        double srcFramePos = vocoderTime / detectorFrameTime;
+        int srcIdx = static_cast<int>(srcFramePos);
+        double frac = srcFramePos - srcIdx;
+
+        if (srcIdx + 1 < srcSize) {
+            float f0_a = detectorF0[srcIdx];
+            float f0_b = detectorF0[srcIdx + 1];
+
+            if (f0_a > 0.0f && f0_b > 0.0f) {
+                // Log-domain interpolation for musical accuracy
+                float logF0_a = std::log(f0_a);
+                float logF0_b = std::log(f0_b);
+                float logF0_interp = logF0_a * (1.0 - frac) + logF0_b * frac;
+                f0[i] = std::exp(logF0_interp);
+            } else if (f0_a > 0.0f) {
+                f0[i] = f0_a;
+            } else if (f0_b > 0.0f) {
+                f0[i] = f0_b;
+            } else {
+                f0[i] = 0.0f;
+            }
+        } else if (srcIdx < srcSize) {
+            f0[i] = detectorF0[srcIdx];
+        } else {
+            f0[i] = detectorF0.back() > 0.0f ? detectorF0.back() : 0.0f;
+        }
+    }
+
+    return f0;
+}
+
+AudioAnalyzer::F0Baseline AudioAnalyzer::captureF0Baseline(const Project& project) {
+    const auto& audioData = project.getAudioData();
+    F0Baseline baseline;
+    baseline.f0 = audioData.f0;
+    baseline.deltaPitch = audioData.deltaPitch;
+    baseline.voicedMask = audioData.voicedMask;
+    baseline.threshold = audioData.pitchSalience.getThreshold();
+    return baseline;
+}
+
+AudioAnalyzer::RangeState AudioAnalyzer::captureRangeState(const Project& project, int startFrame, int endFrame) {
+    RangeState state;
+    for (const auto* note : project.getNotesInRange(startFrame, endFrame))
+        state.noteVersions.push_back(note->getVersion());
+    std::sort(state.noteVersions.begin(), state.noteVersions.end());
+
+    const auto& audioData = project.getAudioData();
+    auto copyRange = [startFrame, endFrame](const auto& curve, auto& dest) {
+        const int size = static_cast<int>(curve.size());
+        const int first = juce::jlimit(0, size, startFrame);
+        const int last = juce::jlimit(first, size, endFrame);
+        dest.assign(curve.begin() + first, curve.begin() + last);
+    };
+    copyRange(audioData.deltaPitch, state.deltaPitch);
+    copyRange(audioData.voicedMask, state.voicedMask);
+    return state;
+}
+
+std::vector<F0FrameEdit> AudioAnalyzer::redecodeF0(Project& project, const F0Baseline& baseline, float threshold,
+                                                   PitchSalience::Decoder decoder) {
+    auto& audioData = project.getAudioData();
+    auto& salience = audioData.pitchSalience;
+    const int numFrames = static_cast<int>(baseline.f0.size());
+    if (salience.isEmpty() || numFrames == 0 || baseline.deltaPitch.size() != baseline.f0.size() ||
+        audioData.basePitch.size() != baseline.f0.size())
+        return {};
+
+    auto decodeAt = [&](float decodeThreshold, VoicedMask& mask) {
+        auto f0 = resampleDetectorF0(salience.decode(decodeThreshold, decoder), salience.getFrameTime(), numFrames);
+        mask.resize(f0.size());
+        for (size_t i = 0; i < f0.size(); ++i)
+            mask[i] = f0[i] > 0;
+        return f0;
+    };
+
+    // Voicing the detector gave at the gesture's starting threshold; frames
+    // where the baseline mask disagrees with it were set by hand (or by an
+    // earlier edit) and are left alone
+    VoicedMask previousMask;
+    decodeAt(baseline.threshold, previousMask);
+
+    VoicedMask decodedMask;
+    auto decodedF0 = decodeAt(threshold, decodedMask);
+    decodedF0 = F0Smoother::smoothF0(decodedF0, decodedMask);
+    salience.setThreshold(threshold);
+
+    // Start from the baseline, so a frame flipped earlier in the same
+    // gesture and flipped back gets its old values (and edits) again
+    audioData.f0 = baseline.f0;
+    audioData.deltaPitch = baseline.deltaPitch;
+    audioData.voicedMask = baseline.voicedMask;
+    audioData.voicedMask.resize(baseline.f0.size(), 1);
+
+    std::vector<F0FrameEdit> edits;
+    for (int i = 0; i < numFrames; ++i) {
+        const auto frame = static_cast<size_t>(i);
+        const bool wasVoiced = audioData.voicedMask[frame] != 0;
+        const bool voiced = decodedMask[frame] != 0;
+        const bool wasDecodedVoiced = previousMask[frame] != 0;
+        if (voiced == wasDecodedVoiced || wasVoiced != wasDecodedVoiced)
+            continue;
+
+        F0FrameEdit edit;
+        edit.idx = i;
+        edit.oldF0 = edit.newF0 = baseline.f0[frame];
+        edit.oldDelta = edit.newDelta = baseline.deltaPitch[frame];
+        edit.oldVoiced = wasVoiced;
+        edit.newVoiced = voiced;
+
+        if (voiced) {
+            edit.newDelta = freqToMidi(decodedF0[frame]) - audioData.basePitch[frame];
+            edit.newF0 = midiToFreq(audioData.basePitch[frame] + edit.newDelta);
+        }
+
+        audioData.f0[frame] = edit.newF0;
+        audioData.deltaPitch[frame] = edit.newDelta;
+        audioData.voicedMask[frame] = voiced ? 1 : 0;
+        edits.push_back(edit);
+    }
+    return edits;
 }
 
 void AudioAnalyzer::segmentIntoNotes(Project& project) {
     auto& audioData = project.getAudioData();
     auto& notes = project.getNotes();
     notes.clear();
+    project.notesChanged();
 
     if (audioData.f0.empty())
         return;
@@ -325,11 +558,7 @@ void AudioAnalyzer::segmentWithSOME(Project& project) {
                     midi = midiSum / midiCount;
                 }
 
-                Note note(f0Start, f0End, midi);
-                std::vector<float> f0Values(audioData.f0.begin() + f0Start,
-                                            audioData.f0.begin() + f0End);
-                note.setF0Values(std::move(f0Values));
-                notes.push_back(note);
+                notes.emplace_back(f0Start, f0End, midi);
             }
         },
         nullptr
@@ -362,11 +591,7 @@ void AudioAnalyzer::segmentFallback(Project& project) {
             return;
 
         float midi = midiSum / midiCount;
-        Note note(start, end, midi);
-        std::vector<float> f0Values(audioData.f0.begin() + start,
-                                    audioData.f0.begin() + end);
-        note.setF0Values(std::move(f0Values));
-        notes.push_back(note);
+        notes.emplace_back(start, end, midi);
     };
 
     constexpr float pitchSplitThreshold = 0.5f;
@@ -5,6 +5,7 @@
 #include "../../Utils/Constants.h"
 #include "../../Utils/MelSpectrogram.h"
 #include "../../Utils/F0Smoother.h"
+#include "../../Utils/FrameEditRuns.h"
 #include "../../Utils/PitchCurveProcessor.h"
 #include "../PitchDetector.h"
 #include "../FCPEPitchDetector.h"
@@ -28,6 +29,59 @@ public:
     using ProgressCallback = std::function<void(double progress, const juce::String& message)>;
     using CompleteCallback = std::function<void()>;
 
+    /**
+     * What the user can edit inside a re-analysis range: note versions
+     * (unique per edit, see Note::getVersion), delta pitch and voicing.
+     * F0 is left out since it is recomposed from these. Compared before
+     * merging so edits made while the range was analysed are not overwritten.
+     */
+    struct RangeState {
+        std::vector<juce::uint32> noteVersions;  // Sorted
+        std::vector<float> deltaPitch;
+        VoicedMask voicedMask;
+
+        bool operator==(const RangeState& other) const {
+            return noteVersions == other.noteVersions && deltaPitch == other.deltaPitch &&
+                   voicedMask == other.voicedMask;
+        }
+        bool operator!=(const RangeState& other) const { return !(*this == other); }
+    };
+
+    /**
+     * Input for range re-analysis. Built on the message thread by
+     * prepareRange so the background pass only touches its own copy of
+     * the audio slice, never the live Project.
+     */
+    struct RangeRequest {
+        int startFrame = 0;          // First frame to replace
+        int endFrame = 0;            // One past the last frame to replace
+        int sliceStartFrame = 0;     // Project frame at slice sample 0
+        int totalFrames = 0;         // Project frame count when prepared
+        juce::AudioBuffer<float> slice;  // Mono audio covering range + context
+        RangeState state;            // Range contents when prepared
+    };
+
+    /**
+     * Output of range re-analysis, already mapped to project frames.
+     */
+    struct RangeResult {
+        bool valid = false;
+        int startFrame = 0;
+        int endFrame = 0;
+        int totalFrames = 0;
+        MelBuffer mel;                        // [endFrame - startFrame, NUM_MELS]
+        std::vector<float> f0;                // Dense smoothed f0 (Hz)
+        VoicedMask voicedMask;
+        std::vector<Note> notes;              // Project frames, inside the range
+        PitchSalience salience;               // Detector frames from slice start
+        double sliceStartTime = 0.0;          // Seconds at salience frame 0
+        RangeState state;                     // Copied from the request
+    };
+
+    // Context analysed on each side of the range so model edge effects stay
+    // outside the replaced frames
+    static constexpr float RANGE_CONTEXT_SECONDS = 1.0f;
+
     AudioAnalyzer();
     ~AudioAnalyzer();
 
@@ -46,6 +100,10 @@ public:
     void setPitchDetectorType(PitchDetectorType type) { detectorType = type; }
     PitchDetectorType getPitchDetectorType() const { return detectorType; }
 
+    // Storage format for newly computed mel spectrograms
+    void setMelStorage(MelStorage storage) { melStorage = storage; }
+    MelStorage getMelStorage() const { return melStorage; }
+
     // Main analysis function - runs synchronously (call from background thread)
     void analyze(Project& project, ProgressCallback onProgress, CompleteCallback onComplete = nullptr);
 
@@ -55,6 +113,70 @@ public:
     // Note segmentation
     void segmentIntoNotes(Project& project);
 
+    /**
+     * Snap [startFrame, endFrame) outwards so no note straddles its edges,
+     * add context and copy the audio slice. Call on the message thread.
+     * @param sourceAudio Unprocessed input audio; the project waveform holds
+     *                    vocoder output after a render, so it is only used
+     *                    when this is null
+     */
+    static RangeRequest prepareRange(const Project& project, int startFrame, int endFrame,
+                                     const juce::AudioBuffer<float>* sourceAudio = nullptr);
+
+    /**
+     * Run mel, F0 and note segmentation on the request slice only.
+     * Runs synchronously (call from background thread).
+     */
+    RangeResult analyzeRange(const RangeRequest& request, ProgressCallback onProgress = nullptr);
+
+    /**
+     * Merge a range result into the project: mel/F0/uv rows and notes inside
+     * the range are replaced, delta pitch outside the range is kept, and the
+     * range is marked dirty for resynthesis. Call on the message thread.
+     * @param before,after If set, receive the replaced state before and after
+     *                     the merge (for undo)
+     * @return false if the project changed size, or notes or curves in the
+     *         range were edited, since prepareRange
+     */
+    static bool applyRange(Project& project, const RangeResult& result,
+                           Project::RangeSnapshot* before = nullptr,
+                           Project::RangeSnapshot* after = nullptr);
+
+    /**
+     * Convert detector F0 (e.g. 100 fps from RMVPE/FCPE) to the vocoder frame
+     * rate using log-domain interpolation between voiced frames.
+     */
+    static std::vector<float> resampleDetectorF0(const std::vector<float>& detectorF0,
+                                                 double detectorFrameTime,
+                                                 int targetFrames);
+
+    /** Pitch curves as they were when a voicing threshold change started. */
+    struct F0Baseline {
+        std::vector<float> f0;
+        std::vector<float> deltaPitch;
+        VoicedMask voicedMask;
+        float threshold = 0.0f;
+    };
+
+    static F0Baseline captureF0Baseline(const Project& project);
+
+    static RangeState captureRangeState(const Project& project, int startFrame, int endFrame);
+
+    /**
+     * Re-decode the voiced mask from the stored detector salience with a new
+     * threshold/decoder. Only frames whose decoded voicing differs between
+     * baseline.threshold and the new threshold change, and only if their
+     * baseline voicing still matches the old decode: frames that become
+     * voiced take the decoded pitch, frames that become unvoiced keep their
+     * values, and every other frame (including hand-voiced ones) keeps the
+     * baseline curves, so hand-drawn edits survive. Notes are kept.
+     * Cheap enough to run on the message thread while dragging a control.
+     * @return the changed frames relative to baseline (for undo); empty if
+     *         the project has no stored salience or no voicing changed
+     */
+    static std::vector<F0FrameEdit> redecodeF0(Project& project, const F0Baseline& baseline, float threshold,
+                                               PitchSalience::Decoder decoder = PitchSalience::Decoder::LocalArgmax);
+
     // Cancel ongoing analysis
     void cancel() { cancelFlag = true; }
     bool isAnalyzing() const { return isRunning.load(); }
@@ -100,6 +222,7 @@ private:
 
     bool useFCPE = true;
     PitchDetectorType detectorType = PitchDetectorType::RMVPE;
+    MelStorage melStorage = MelStorage::Float32;
     std::atomic<bool> cancelFlag{false};
     std::atomic<bool> isRunning{false};
     std::thread analysisThread;
@@ -0,0 +1,96 @@
+#include "AudioCallbackMonitor.h"
+#include <algorithm>
+
+void AudioCallbackMonitor::prepare(double sampleRate) {
+    deviceSampleRate.store(sampleRate > 0.0 ? sampleRate : 44100.0, std::memory_order_relaxed);
+    reset();
+
+    // The audio thread's first span must not allocate its trace buffer
+    Tracer::reserveRealtimeBuffers(2);
+}
+
+void AudioCallbackMonitor::recordCallback(std::int64_t startMicros, std::int64_t durationMicros, int numSamples) {
+    const double sampleRate = deviceSampleRate.load(std::memory_order_relaxed);
+    if (numSamples <= 0)
+        return;
+
+    const auto deadline = static_cast<std::int64_t>(numSamples * 1.0e6 / sampleRate);
+    const double load = deadline > 0 ? static_cast<double>(durationMicros) / static_cast<double>(deadline) : 0.0;
+
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+    busyMicros.fetch_add(static_cast<std::uint64_t>(std::max<std::int64_t>(0, durationMicros)),
+                         std::memory_order_relaxed);
+    deadlineMicros.fetch_add(static_cast<std::uint64_t>(deadline), std::memory_order_relaxed);
+
+    const int bucket = load > 1.0 ? numBuckets - 1 : std::min(numBuckets - 2, static_cast<int>(load * 10.0));
+    histogram[static_cast<size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+
+    const auto permille = static_cast<std::uint32_t>(std::min(load * 1000.0, 1.0e9));
+    auto previous = maxLoadPermille.load(std::memory_order_relaxed);
+    while (permille > previous &&
+           !maxLoadPermille.compare_exchange_weak(previous, permille, std::memory_order_relaxed)) {
+    }
+
+    Tracer::recordRealtime("audio callback", startMicros, durationMicros);
+
+    if (load > 1.0) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        Tracer::recordInstantRealtime("audio overrun");
+    }
+}
+
+void AudioCallbackMonitor::recordSilenced() {
+    silencedBlocks.fetch_add(1, std::memory_order_relaxed);
+    Tracer::recordInstantRealtime("audio block silenced");
+}
+
+void AudioCallbackMonitor::recordPassthrough() {
+    passthroughBlocks.fetch_add(1, std::memory_order_relaxed);
+    Tracer::recordInstantRealtime("audio passthrough");
+}
+
+AudioCallbackMonitor::Snapshot AudioCallbackMonitor::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.callbacks = callbacks.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    snapshot.silencedBlocks = silencedBlocks.load(std::memory_order_relaxed);
+    snapshot.passthroughBlocks = passthroughBlocks.load(std::memory_order_relaxed);
+
+    const auto deadline = deadlineMicros.load(std::memory_order_relaxed);
+    if (deadline > 0)
+        snapshot.averageLoad = static_cast<double>(busyMicros.load(std::memory_order_relaxed)) / deadline;
+    snapshot.maxLoad = maxLoadPermille.load(std::memory_order_relaxed) / 1000.0;
+
+    for (size_t i = 0; i < histogram.size(); ++i)
+        snapshot.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void AudioCallbackMonitor::reset() {
+    callbacks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    silencedBlocks.store(0, std::memory_order_relaxed);
+    passthroughBlocks.store(0, std::memory_order_relaxed);
+    busyMicros.store(0, std::memory_order_relaxed);
+    deadlineMicros.store(0, std::memory_order_relaxed);
+    maxLoadPermille.store(0, std::memory_order_relaxed);
+    for (auto& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+juce::String AudioCallbackMonitor::formatSnapshot(const Snapshot& snapshot) {
+    juce::String text;
+    text << "audio " << juce::roundToInt(snapshot.averageLoad * 100.0) << "% avg, "
+         << juce::roundToInt(snapshot.maxLoad * 100.0) << "% max, " << (juce::int64) snapshot.overruns
+         << " overruns, " << (juce::int64) snapshot.silencedBlocks << " silenced, "
+         << (juce::int64) snapshot.passthroughBlocks << " passthrough";
+    return text;
+}
+
+juce::String AudioCallbackMonitor::formatHistogram(const Snapshot& snapshot) {
+    juce::String text("load histogram (10% steps):");
+    for (int i = 0; i < numBuckets - 1; ++i)
+        text << " " << (juce::int64) snapshot.histogram[static_cast<size_t>(i)];
+    text << ", over 100%: " << (juce::int64) snapshot.histogram[static_cast<size_t>(numBuckets - 1)];
+    return text;
+}
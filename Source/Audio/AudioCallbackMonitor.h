@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "../Utils/Tracer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Deadline monitor for an audio callback.
+ *
+ * Each callback's CPU time is compared with the time its buffer lasts at the
+ * device rate (the deadline). The monitor keeps a load histogram, the worst
+ * load, the number of overruns (callbacks that took longer than their
+ * buffer) and counters for blocks that were silenced or passed through
+ * unprocessed. Callbacks also go to the trace as spans, with overruns and
+ * fallbacks as instant events.
+ *
+ * All recording is lock-free and allocation-free, so it is safe on the audio
+ * thread; getSnapshot() may be called from any thread.
+ */
+class AudioCallbackMonitor {
+public:
+    static constexpr int numBuckets = 11;  // 10% steps of the deadline, last = over 100%
+
+    struct Snapshot {
+        std::uint64_t callbacks = 0;
+        std::uint64_t overruns = 0;
+        std::uint64_t silencedBlocks = 0;     // Output cleared because data was busy
+        std::uint64_t passthroughBlocks = 0;  // Input copied to output unprocessed
+        double averageLoad = 0.0;             // CPU time / deadline over all callbacks
+        double maxLoad = 0.0;
+        std::array<std::uint64_t, numBuckets> histogram{};
+
+        bool isGlitchFree() const { return overruns == 0 && silencedBlocks == 0; }
+    };
+
+    /** Times the enclosing audio callback. */
+    class ScopedCallback {
+    public:
+        ScopedCallback(AudioCallbackMonitor& owner, int numSamplesInBlock)
+            : monitor(owner), numSamples(numSamplesInBlock), start(Tracer::nowMicros()) {}
+
+        ~ScopedCallback() { monitor.recordCallback(start, Tracer::nowMicros() - start, numSamples); }
+
+    private:
+        AudioCallbackMonitor& monitor;
+        int numSamples;
+        std::int64_t start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    /** Call before processing starts (not on the audio thread). Resets the counters. */
+    void prepare(double sampleRate);
+
+    void recordCallback(std::int64_t startMicros, std::int64_t durationMicros, int numSamples);
+    void recordSilenced();
+    void recordPassthrough();
+
+    Snapshot getSnapshot() const;
+    void reset();
+
+    static juce::String formatSnapshot(const Snapshot& snapshot);
+    static juce::String formatHistogram(const Snapshot& snapshot);
+
+private:
+    std::atomic<double> deviceSampleRate{44100.0};
+
+    std::atomic<std::uint64_t> callbacks{0};
+    std::atomic<std::uint64_t> overruns{0};
+    std::atomic<std::uint64_t> silencedBlocks{0};
+    std::atomic<std::uint64_t> passthroughBlocks{0};
+    std::atomic<std::uint64_t> busyMicros{0};
+    std::atomic<std::uint64_t> deadlineMicros{0};
+    std::atomic<std::uint32_t> maxLoadPermille{0};
+    std::array<std::atomic<std::uint64_t>, numBuckets> histogram{};
+};
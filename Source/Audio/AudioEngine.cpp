@@ -47,6 +47,7 @@ void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
     playbackRatio = static_cast<double>(waveformSampleRate) / sampleRate;
     interpolator.reset();
     fractionalPosition = 0.0;
+    callbackMonitor.prepare(sampleRate);
     
     DBG("AudioEngine::prepareToPlay - Device sample rate: " + juce::String(sampleRate) + 
         " Hz, Waveform sample rate: " + juce::String(waveformSampleRate) + 
@@ -59,6 +60,8 @@ void AudioEngine::releaseResources()
 
 void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    AudioCallbackMonitor::ScopedCallback timing(callbackMonitor, bufferToFill.numSamples);
+
     if (!playing || currentWaveform.getNumSamples() == 0)
     {
         bufferToFill.clearActiveBufferRegion();
@@ -70,6 +73,7 @@ void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferTo
     {
         // Waveform is being updated, output silence to avoid glitches
         bufferToFill.clearActiveBufferRegion();
+        callbackMonitor.recordSilenced();
         return;
     }
 
@@ -2,6 +2,7 @@
 
 #include "../JuceHeader.h"
 #include "../Models/Project.h"
+#include "AudioCallbackMonitor.h"
 #include <functional>
 
 /**
@@ -51,6 +52,9 @@ public:
     // Volume control (dB, -60 to +12)
     void setVolumeDb(float dB);
     float getVolumeDb() const;
+
+    // Callback load and glitch counters
+    const AudioCallbackMonitor& getCallbackMonitor() const { return callbackMonitor; }
     
 private:
     juce::AudioDeviceManager deviceManager;
@@ -80,5 +84,7 @@ private:
     // Volume control (linear gain, lock-free for audio thread)
     std::atomic<float> volumeGain { 1.0f };
 
+    AudioCallbackMonitor callbackMonitor;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
 };
@@ -0,0 +1,359 @@
+#include "BatchProcessor.h"
+#include "../Analysis/AudioAnalyzer.h"
+#include "../IO/AudioFileManager.h"
+#include "../Vocoder.h"
+#include "../../Models/Project.h"
+#include "../../Utils/Constants.h"
+#include "../../Utils/MelSpectrogram.h"
+#include "../../Utils/PitchCurveProcessor.h"
+#include "../../Utils/PlatformPaths.h"
+#include "../../Utils/Tracer.h"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace {
+    double nowMs() {
+        return juce::Time::getMillisecondCounterHiRes();
+    }
+
+    // Measures one pipeline stage into a FileResult
+    class StageTimer {
+    public:
+        StageTimer(BatchProcessor::FileResult& r, const char* stageName)
+            : result(r), name(stageName), start(nowMs()) {}
+
+        ~StageTimer() {
+            result.stages.push_back({name, nowMs() - start});
+        }
+
+    private:
+        BatchProcessor::FileResult& result;
+        juce::String name;
+        double start;
+    };
+} // namespace
+
+/**
+ * One worker thread's models. Loading happens once per worker and the
+ * instance is reused for every file the worker picks up.
+ */
+class BatchProcessor::Worker {
+public:
+    explicit Worker(const Options& opts) : options(opts) {
+        analyzer.initialize();
+        analyzer.setPitchDetectorType(options.detectorType);
+
+        if (options.render) {
+            auto modelPath = PlatformPaths::getModelsDirectory().getChildFile("pc_nsf_hifigan.onnx");
+            if (modelPath.existsAsFile())
+                vocoder.loadModel(modelPath);
+        }
+    }
+
+    FileResult process(const juce::File& input) {
+        FileResult result;
+        result.input = input;
+
+        Project project;
+        if (!load(input, project, result))
+            return result;
+
+        auto& audioData = project.getAudioData();
+
+        {
+            StageTimer timer(result, "analyze");
+            if (input.hasFileExtension("peproj")) {
+                // Notes and curves come from the project; the mel only if
+                // it was not cached in the file
+                if (audioData.melSpectrogram.empty()) {
+                    MelSpectrogram melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+                    audioData.melSpectrogram = melComputer.compute(audioData.waveform.getReadPointer(0),
+                                                                   audioData.waveform.getNumSamples());
+                }
+                PitchCurveProcessor::rebuildBaseFromNotes(project);
+            } else {
+                analyzer.analyze(project, nullptr);
+            }
+        }
+
+        if (audioData.melSpectrogram.empty() || audioData.f0.empty()) {
+            result.error = "analysis produced no frames";
+            return result;
+        }
+
+        {
+            StageTimer timer(result, "edit");
+            applyEdits(project);
+        }
+
+        result.numFrames = audioData.getNumFrames();
+        result.numNotes = static_cast<int>(project.getNotes().size());
+
+        const auto outputDir = options.outputDir == juce::File() ? input.getParentDirectory()
+                                                                 : options.outputDir;
+        const auto stem = input.getFileNameWithoutExtension();
+
+        if (options.saveProject) {
+            StageTimer timer(result, "save_project");
+            auto projectFile = outputDir.getChildFile(stem + "_tuned.peproj");
+            if (!project.saveToFile(projectFile)) {
+                result.error = "failed to write " + projectFile.getFullPathName();
+                return result;
+            }
+        }
+
+        if (options.render) {
+            if (!vocoder.isLoaded()) {
+                result.error = "vocoder model not loaded";
+                return result;
+            }
+
+            std::vector<float> rendered;
+            {
+                StageTimer timer(result, "synthesize");
+                rendered = vocoder.infer(audioData.melSpectrogram, project.getAdjustedF0());
+            }
+
+            if (rendered.empty()) {
+                result.error = "synthesis failed";
+                return result;
+            }
+
+            StageTimer timer(result, "export");
+            juce::AudioBuffer<float> buffer(1, static_cast<int>(rendered.size()));
+            buffer.copyFrom(0, 0, rendered.data(), static_cast<int>(rendered.size()));
+
+            result.output = outputDir.getChildFile(stem + "_tuned.wav");
+            if (!AudioFileManager::writeWavFile(result.output, buffer, vocoder.getSampleRate())) {
+                result.error = "failed to write " + result.output.getFullPathName();
+                return result;
+            }
+        }
+
+        result.success = true;
+        return result;
+    }
+
+private:
+    bool load(const juce::File& input, Project& project, FileResult& result) {
+        StageTimer timer(result, "load");
+        auto& audioData = project.getAudioData();
+
+        juce::File audioFile = input;
+        if (input.hasFileExtension("peproj")) {
+            if (!project.loadFromFile(input)) {
+                result.error = "invalid project file";
+                return false;
+            }
+
+            // A cached mel is all synthesis needs; the cached waveform is
+            // rendered audio, so the mel is never recomputed from it
+            if (!audioData.melSpectrogram.empty())
+                return true;
+            audioFile = project.getFilePath();
+        } else {
+            project.setFilePath(input);
+            project.setName(input.getFileNameWithoutExtension());
+        }
+
+        audioData.waveform = AudioFileManager::readAudioFile(audioFile);
+        audioData.sampleRate = SAMPLE_RATE;
+        if (audioData.waveform.getNumSamples() == 0) {
+            result.error = "cannot read audio " + audioFile.getFullPathName();
+            return false;
+        }
+        return true;
+    }
+
+    void applyEdits(Project& project) {
+        if (options.snapNotes) {
+            for (auto& note : project.getNotes()) {
+                if (note.isRest())
+                    continue;
+                float midi = note.getMidiNote();
+                float target = std::round(midi + note.getPitchOffset());
+                note.setPitchOffset(target - midi);
+            }
+            PitchCurveProcessor::rebuildBaseFromNotes(project);
+        }
+
+        if (options.globalPitchOffset != 0.0f)
+            project.setGlobalPitchOffset(project.getGlobalPitchOffset() + options.globalPitchOffset);
+    }
+
+    const Options& options;
+    AudioAnalyzer analyzer;
+    Vocoder vocoder;
+};
+
+bool BatchProcessor::isBatchCommandLine(const juce::String& commandLine) {
+    auto args = juce::StringArray::fromTokens(commandLine, true);
+    return args.contains("--batch") || args.contains("--headless");
+}
+
+bool BatchProcessor::parseCommandLine(const juce::String& commandLine, Options& options, juce::String& error) {
+    auto args = juce::StringArray::fromTokens(commandLine, true);
+    for (auto& arg : args)
+        arg = arg.unquoted();
+
+    for (int i = 0; i < args.size(); ++i) {
+        const auto& arg = args[i];
+        auto nextValue = [&]() -> juce::String {
+            if (i + 1 >= args.size()) {
+                error = "missing value for " + arg;
+                return {};
+            }
+            return args[++i];
+        };
+
+        if (arg == "--batch" || arg == "--headless") {
+            continue;
+        } else if (arg == "-j" || arg == "--jobs") {
+            options.jobs = nextValue().getIntValue();
+        } else if (arg == "--detector") {
+            auto value = nextValue().toUpperCase();
+            if (value != "RMVPE" && value != "FCPE" && value != "YIN") {
+                error = "unknown detector: " + value;
+                return false;
+            }
+            options.detectorType = stringToPitchDetectorType(value);
+        } else if (arg == "--snap") {
+            options.snapNotes = true;
+        } else if (arg == "--offset") {
+            options.globalPitchOffset = nextValue().getFloatValue();
+        } else if (arg == "--output-dir" || arg == "-o") {
+            options.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+        } else if (arg == "--save-project") {
+            options.saveProject = true;
+        } else if (arg == "--no-render") {
+            options.render = false;
+        } else if (arg == "--timings") {
+            options.timingsFile = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+        } else if (arg == "--trace") {
+            options.traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+        } else if (arg.startsWith("-")) {
+            error = "unknown option: " + arg;
+            return false;
+        } else {
+            auto file = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+            if (!file.existsAsFile()) {
+                error = "input not found: " + file.getFullPathName();
+                return false;
+            }
+            options.inputs.add(file);
+        }
+
+        if (error.isNotEmpty())
+            return false;
+    }
+
+    if (options.inputs.isEmpty()) {
+        error = "no input files";
+        return false;
+    }
+
+    if (options.outputDir != juce::File() && !options.outputDir.isDirectory()) {
+        auto created = options.outputDir.createDirectory();
+        if (created.failed()) {
+            error = created.getErrorMessage();
+            return false;
+        }
+    }
+
+    options.jobs = juce::jlimit(1, 64, options.jobs);
+    return true;
+}
+
+juce::String BatchProcessor::getUsage() {
+    return "Usage: HachiTune --batch [options] <audio or .peproj files...>\n"
+           "  -j, --jobs <n>          Files processed in parallel (default 1)\n"
+           "  --detector <name>       RMVPE, FCPE or YIN (default RMVPE)\n"
+           "  --snap                  Snap notes to the nearest semitone\n"
+           "  --offset <semitones>    Global pitch offset\n"
+           "  -o, --output-dir <dir>  Output directory (default: next to input)\n"
+           "  --save-project          Also write <name>_tuned.peproj\n"
+           "  --no-render             Skip synthesis and WAV export\n"
+           "  --timings <file>        Write the JSON report to a file instead of stdout\n"
+           "  --trace <file>          Write a Chrome trace (chrome://tracing, Perfetto)\n";
+}
+
+BatchProcessor::BatchProcessor(Options opts) : options(std::move(opts)) {}
+
+int BatchProcessor::run() {
+    if (options.traceFile != juce::File())
+        Tracer::setEnabled(true);
+
+    const double wallStart = nowMs();
+    const int numInputs = options.inputs.size();
+    const int numWorkers = std::min(options.jobs, numInputs);
+
+    std::vector<FileResult> results(static_cast<size_t>(numInputs));
+    std::atomic<int> nextIndex{0};
+
+    auto workerLoop = [this, &results, &nextIndex, numInputs]() {
+        Worker worker(options);
+        for (int index = nextIndex++; index < numInputs; index = nextIndex++) {
+            const auto& input = options.inputs.getReference(index);
+            const double start = nowMs();
+            auto result = worker.process(input);
+            result.stages.push_back({"total", nowMs() - start});
+
+            if (!result.success)
+                std::cerr << "[batch] " << input.getFullPathName() << ": " << result.error << std::endl;
+
+            results[static_cast<size_t>(index)] = std::move(result);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(numWorkers));
+    for (int i = 0; i < numWorkers; ++i)
+        threads.emplace_back(workerLoop);
+    for (auto& t : threads)
+        t.join();
+
+    auto report = buildReport(results, nowMs() - wallStart);
+    if (options.timingsFile != juce::File())
+        options.timingsFile.replaceWithText(report);
+    else
+        std::cout << report << std::endl;
+
+    if (options.traceFile != juce::File() &&
+        !Tracer::exportChromeTrace(options.traceFile.getFullPathName().toStdString()))
+        std::cerr << "[batch] could not write trace to " << options.traceFile.getFullPathName() << std::endl;
+
+    for (const auto& r : results)
+        if (!r.success)
+            return 1;
+    return 0;
+}
+
+juce::String BatchProcessor::buildReport(const std::vector<FileResult>& results, double wallMs) const {
+    juce::Array<juce::var> files;
+    for (const auto& r : results) {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("input", r.input.getFullPathName());
+        entry->setProperty("output", r.output.getFullPathName());
+        entry->setProperty("success", r.success);
+        if (r.error.isNotEmpty())
+            entry->setProperty("error", r.error);
+        entry->setProperty("frames", r.numFrames);
+        entry->setProperty("notes", r.numNotes);
+
+        auto* stages = new juce::DynamicObject();
+        for (const auto& stage : r.stages)
+            stages->setProperty(juce::Identifier(stage.name + "_ms"), stage.milliseconds);
+        entry->setProperty("stages", juce::var(stages));
+
+        files.add(juce::var(entry));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("jobs", options.jobs);
+    root->setProperty("detector", juce::String(pitchDetectorTypeToString(options.detectorType)));
+    root->setProperty("wall_ms", wallMs);
+    root->setProperty("files", files);
+    return juce::JSON::toString(juce::var(root));
+}
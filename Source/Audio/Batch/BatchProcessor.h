@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../PitchDetectorType.h"
+#include <vector>
+
+/**
+ * Headless batch pipeline used by the command line (--batch):
+ * load -> analyze -> edit (snap / global offset) -> synthesize -> export.
+ *
+ * Files are processed in parallel by a fixed number of workers. Each worker
+ * owns its own analyzer and vocoder so ONNX sessions are never shared
+ * between threads. Per-stage timings are reported as JSON.
+ */
+class BatchProcessor {
+public:
+    struct Options {
+        juce::Array<juce::File> inputs;      // Audio files or .peproj projects
+        juce::File outputDir;                // Empty = next to each input
+        int jobs = 1;                        // Concurrency limit
+        PitchDetectorType detectorType = PitchDetectorType::RMVPE;
+        bool snapNotes = false;              // Snap notes to the nearest semitone
+        float globalPitchOffset = 0.0f;      // Semitones
+        bool render = true;                  // Synthesize and export WAV
+        bool saveProject = false;            // Also write .peproj
+        juce::File timingsFile;              // Empty = print JSON to stdout
+        juce::File traceFile;                // Chrome trace of the run, empty = none
+    };
+
+    struct StageTiming {
+        juce::String name;
+        double milliseconds = 0.0;
+    };
+
+    struct FileResult {
+        juce::File input;
+        juce::File output;
+        bool success = false;
+        juce::String error;
+        int numFrames = 0;
+        int numNotes = 0;
+        std::vector<StageTiming> stages;
+    };
+
+    /** True if the command line asks for headless batch mode. */
+    static bool isBatchCommandLine(const juce::String& commandLine);
+
+    /**
+     * Parse batch arguments. Returns false and fills error on bad input.
+     */
+    static bool parseCommandLine(const juce::String& commandLine, Options& options, juce::String& error);
+
+    static juce::String getUsage();
+
+    explicit BatchProcessor(Options options);
+
+    /**
+     * Process all inputs (blocks until done) and write the JSON report.
+     * @return process exit code (0 if every file succeeded)
+     */
+    int run();
+
+private:
+    class Worker;
+
+    juce::String buildReport(const std::vector<FileResult>& results, double wallMs) const;
+
+    Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchProcessor)
+};
@@ -1,4 +1,7 @@
 #include "FCPEPitchDetector.h"
+#include "../Utils/AsyncLogger.h"
+#include "../Utils/Resampler.h"
+#include "../Utils/Tracer.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -125,7 +128,7 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
                         melFilterbank[m][k] = data[m * numBins + k];
                     }
                 }
-                DBG("Loaded mel filterbank from file");
+                LOG_AT(Info, Analysis, "Loaded mel filterbank from file");
             }
         }
 
@@ -137,7 +140,7 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
             {
                 centTable.resize(OUT_DIMS);
                 stream.read(centTable.data(), centTable.size() * sizeof(float));
-                DBG("Loaded cent table from file");
+                LOG_AT(Info, Analysis, "Loaded cent table from file");
             }
         }
 
@@ -154,9 +157,9 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
         {
             try {
                 sessionOptions.AppendExecutionProvider("DML");
-                DBG("FCPE: DirectML execution provider added");
+                LOG_AT(Info, Analysis, "FCPE: DirectML execution provider added");
             } catch (const Ort::Exception& e) {
-                DBG("FCPE: Failed to add DirectML provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "FCPE: Failed to add DirectML provider, using CPU: " << e.what());
             }
         }
         else
@@ -168,9 +171,9 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
                 OrtCUDAProviderOptions cudaOptions;
                 cudaOptions.device_id = deviceId;
                 sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
-                DBG("FCPE: CUDA execution provider added, device: " << deviceId);
+                LOG_AT(Info, Analysis, "FCPE: CUDA execution provider added, device: " << deviceId);
             } catch (const Ort::Exception& e) {
-                DBG("FCPE: Failed to add CUDA provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "FCPE: Failed to add CUDA provider, using CPU: " << e.what());
             }
         }
         else
@@ -179,9 +182,9 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
         {
             try {
                 sessionOptions.AppendExecutionProvider("CoreML");
-                DBG("FCPE: CoreML execution provider added");
+                LOG_AT(Info, Analysis, "FCPE: CoreML execution provider added");
             } catch (const Ort::Exception& e) {
-                DBG("FCPE: Failed to add CoreML provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "FCPE: Failed to add CoreML provider, using CPU: " << e.what());
             }
         }
         else
@@ -189,7 +192,7 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
             // CPU fallback - do nothing, CPU is default
             if (provider != GPUProvider::CPU)
             {
-                DBG("FCPE: Using CPU execution provider");
+                LOG_AT(Info, Analysis, "FCPE: Using CPU execution provider");
             }
         }
 
@@ -230,60 +233,27 @@ bool FCPEPitchDetector::loadModel(const juce::File& modelPath,
             outputNames.push_back(name.c_str());
         
         loaded = true;
-        DBG("FCPE model loaded successfully");
+        LOG_AT(Info, Analysis, "FCPE model loaded successfully");
         return true;
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error: " << e.what());
         loaded = false;
         return false;
     }
     catch (const std::exception& e)
     {
-        DBG("Error loading FCPE model: " << e.what());
+        LOG_AT(Error, Analysis, "Error loading FCPE model: " << e.what());
         loaded = false;
         return false;
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return false;
 #endif
 }
 
-std::vector<float> FCPEPitchDetector::resampleTo16k(const float* audio, int numSamples, int srcRate)
-{
-    if (srcRate == FCPE_SAMPLE_RATE)
-    {
-        return std::vector<float>(audio, audio + numSamples);
-    }
-    
-    // Simple linear interpolation resampling
-    // For production, consider using a proper resampler (e.g., libsamplerate)
-    double ratio = static_cast<double>(FCPE_SAMPLE_RATE) / srcRate;
-    int outSamples = static_cast<int>(numSamples * ratio);
-    
-    std::vector<float> resampled(outSamples);
-    
-    for (int i = 0; i < outSamples; ++i)
-    {
-        double srcPos = i / ratio;
-        int srcIdx = static_cast<int>(srcPos);
-        double frac = srcPos - srcIdx;
-        
-        if (srcIdx + 1 < numSamples)
-        {
-            resampled[i] = static_cast<float>(audio[srcIdx] * (1.0 - frac) + audio[srcIdx + 1] * frac);
-        }
-        else if (srcIdx < numSamples)
-        {
-            resampled[i] = audio[srcIdx];
-        }
-    }
-    
-    return resampled;
-}
-
 std::vector<std::vector<float>> FCPEPitchDetector::extractMel(const std::vector<float>& audio)
 {
     const int numBins = N_FFT / 2 + 1;
@@ -433,27 +403,39 @@ std::vector<float> FCPEPitchDetector::decodeF0(const std::vector<std::vector<flo
     return f0;
 }
 
+void FCPEPitchDetector::storeSalience(const float* latent, int numFrames, float threshold,
+                                      PitchSalience& salienceOut) const
+{
+    static_assert(OUT_DIMS == PitchSalience::NUM_BINS, "FCPE latent size must match salience bins");
+
+    salienceOut.reset(static_cast<double>(HOP_SIZE) / FCPE_SAMPLE_RATE, centTable, threshold);
+    salienceOut.appendFrames(latent, numFrames);
+}
+
 std::vector<float> FCPEPitchDetector::extractF0(const float* audio, int numSamples,
-                                                  int sampleRate, float threshold)
+                                                  int sampleRate, float threshold,
+                                                  PitchSalience* salienceOut)
 {
+    TRACE_SCOPE("FCPE");
 #ifdef HAVE_ONNXRUNTIME
     if (!loaded)
     {
-        DBG("FCPE model not loaded");
+        LOG_AT(Warning, Analysis, "FCPE model not loaded");
         return {};
     }
     
     try
     {
         // Step 1: Resample to 16kHz
-        auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
+        auto audio16k = Resampler::resample(audio, numSamples, sampleRate, FCPE_SAMPLE_RATE,
+                                            Resampler::Quality::Fast);
         
         // Step 2: Extract mel spectrogram
         auto mel = extractMel(audio16k);
         
         if (mel.empty())
         {
-            DBG("Empty mel spectrogram");
+            LOG_AT(Warning, Analysis, "Empty mel spectrogram");
             return {};
         }
         
@@ -488,6 +470,9 @@ std::vector<float> FCPEPitchDetector::extractF0(const float* audio, int numSampl
         auto outputShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
         
         int outFrames = static_cast<int>(outputShape[1]);
+
+        if (salienceOut != nullptr)
+            storeSalience(outputData, outFrames, threshold, *salienceOut);
         
         // Convert to 2D vector
         std::vector<std::vector<float>> latent(outFrames);
@@ -505,28 +490,30 @@ std::vector<float> FCPEPitchDetector::extractF0(const float* audio, int numSampl
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error during inference: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error during inference: " << e.what());
         return {};
     }
     catch (const std::exception& e)
     {
-        DBG("Error during F0 extraction: " << e.what());
+        LOG_AT(Error, Analysis, "Error during F0 extraction: " << e.what());
         return {};
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return {};
 #endif
 }
 
 std::vector<float> FCPEPitchDetector::extractF0WithProgress(const float* audio, int numSamples,
                                                             int sampleRate, float threshold,
-                                                            std::function<void(double)> progressCallback)
+                                                            std::function<void(double)> progressCallback,
+                                                            PitchSalience* salienceOut)
 {
+    TRACE_SCOPE("FCPE");
 #ifdef HAVE_ONNXRUNTIME
     if (!loaded)
     {
-        DBG("FCPE model not loaded");
+        LOG_AT(Warning, Analysis, "FCPE model not loaded");
         return {};
     }
 
@@ -535,7 +522,8 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(const float* audio,
         if (progressCallback) progressCallback(0.1);
 
         // Step 1: Resample to 16kHz
-        auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
+        auto audio16k = Resampler::resample(audio, numSamples, sampleRate, FCPE_SAMPLE_RATE,
+                                            Resampler::Quality::Fast);
 
         if (progressCallback) progressCallback(0.3);
 
@@ -544,7 +532,7 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(const float* audio,
 
         if (mel.empty())
         {
-            DBG("Empty mel spectrogram");
+            LOG_AT(Warning, Analysis, "Empty mel spectrogram");
             return {};
         }
 
@@ -586,6 +574,9 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(const float* audio,
 
         int outFrames = static_cast<int>(outputShape[1]);
 
+        if (salienceOut != nullptr)
+            storeSalience(outputData, outFrames, threshold, *salienceOut);
+
         // Convert to 2D vector
         std::vector<std::vector<float>> latent(outFrames);
         for (int t = 0; t < outFrames; ++t)
@@ -608,16 +599,16 @@ std::vector<float> FCPEPitchDetector::extractF0WithProgress(const float* audio,
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error during inference: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error during inference: " << e.what());
         return {};
     }
     catch (const std::exception& e)
     {
-        DBG("Error during F0 extraction: " << e.what());
+        LOG_AT(Error, Analysis, "Error during F0 extraction: " << e.what());
         return {};
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return {};
 #endif
 }
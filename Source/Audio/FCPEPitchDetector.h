@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Utils/PitchSalience.h"
 #include <vector>
 #include <array>
 #include <memory>
@@ -75,17 +76,21 @@ public:
      * @param numSamples Number of samples
      * @param sampleRate Original sample rate
      * @param threshold Confidence threshold (default 0.05)
+     * @param salienceOut If not null, receives the quantized raw latent so the
+     *                    F0 can be re-decoded later without rerunning the model
      * @return F0 values in Hz (0 for unvoiced frames)
      */
     std::vector<float> extractF0(const float* audio, int numSamples,
-                                  int sampleRate, float threshold = 0.05f);
+                                  int sampleRate, float threshold = 0.05f,
+                                  PitchSalience* salienceOut = nullptr);
 
     /**
      * Extract F0 with progress callback.
      */
     std::vector<float> extractF0WithProgress(const float* audio, int numSamples,
                                               int sampleRate, float threshold,
-                                              std::function<void(double)> progressCallback);
+                                              std::function<void(double)> progressCallback,
+                                              PitchSalience* salienceOut = nullptr);
 
     /**
      * Get the number of F0 frames that will be produced for given audio length.
@@ -123,15 +128,16 @@ private:
     // Initialize cent table
     void initCentTable();
     
-    // Resample audio to 16kHz
-    std::vector<float> resampleTo16k(const float* audio, int numSamples, int srcRate);
-    
     // Extract mel spectrogram
     std::vector<std::vector<float>> extractMel(const std::vector<float>& audio);
     
     // Decode latent to F0 (local argmax decoder)
     std::vector<float> decodeF0(const std::vector<std::vector<float>>& latent, 
                                  float threshold);
+
+    // Keep the raw latent [T x OUT_DIMS] in quantized form
+    void storeSalience(const float* latent, int numFrames, float threshold,
+                       PitchSalience& salienceOut) const;
     
     // Convert cent to F0
     static float centToF0(float cent) {
@@ -1,4 +1,6 @@
 #include "AudioFileManager.h"
+#include "../../Utils/Resampler.h"
+#include "../../Utils/Tracer.h"
 
 AudioFileManager::AudioFileManager() = default;
 
@@ -76,45 +78,8 @@ void AudioFileManager::loadAudioFileAsync(const juce::File& file,
         if (onProgress)
             onProgress(0.05, "Loading audio...");
 
-        juce::AudioFormatManager formatManager;
-        formatManager.registerBasicFormats();
-
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
-        if (reader == nullptr || cancelFlag.load()) {
-            isLoadingAudio = false;
-            return;
-        }
-
-        const int numSamples = static_cast<int>(reader->lengthInSamples);
-        const int srcSampleRate = static_cast<int>(reader->sampleRate);
-
-        if (onProgress)
-            onProgress(0.10, "Reading audio...");
-
-        // Read audio data
-        juce::AudioBuffer<float> buffer;
-        if (reader->numChannels == 1) {
-            buffer.setSize(1, numSamples);
-            reader->read(&buffer, 0, numSamples, 0, true, false);
-        } else {
-            juce::AudioBuffer<float> stereoBuffer(2, numSamples);
-            reader->read(&stereoBuffer, 0, numSamples, 0, true, true);
-            buffer = convertToMono(stereoBuffer);
-        }
-
-        if (cancelFlag.load()) {
-            isLoadingAudio = false;
-            return;
-        }
-
-        // Resample if needed
-        if (srcSampleRate != SAMPLE_RATE) {
-            if (onProgress)
-                onProgress(0.18, "Resampling...");
-            buffer = resampleIfNeeded(buffer, srcSampleRate, SAMPLE_RATE);
-        }
-
-        if (cancelFlag.load()) {
+        juce::AudioBuffer<float> buffer = readAudioFile(file);
+        if (buffer.getNumSamples() == 0 || cancelFlag.load()) {
             isLoadingAudio = false;
             return;
         }
@@ -141,6 +106,79 @@ void AudioFileManager::exportAudioFileAsync(const juce::File& file,
         onProgress(0.0, "Exporting...");
 
     // Export synchronously for now (could be made async if needed)
+    bool success = writeWavFile(file, buffer, sampleRate);
+
+    if (onProgress)
+        onProgress(1.0, success ? "Export complete" : "Export failed");
+
+    if (onComplete)
+        onComplete(success);
+}
+
+juce::AudioBuffer<float> AudioFileManager::readAudioFile(const juce::File& file) {
+    TRACE_SCOPE("load audio");
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+        return {};
+
+    const int numSamples = static_cast<int>(reader->lengthInSamples);
+    const int srcSampleRate = static_cast<int>(reader->sampleRate);
+
+    if (srcSampleRate != SAMPLE_RATE && srcSampleRate > 0)
+        return readResampled(*reader, numSamples, srcSampleRate);
+
+    juce::AudioBuffer<float> buffer;
+    if (reader->numChannels == 1) {
+        buffer.setSize(1, numSamples);
+        reader->read(&buffer, 0, numSamples, 0, true, false);
+    } else {
+        juce::AudioBuffer<float> stereoBuffer(2, numSamples);
+        reader->read(&stereoBuffer, 0, numSamples, 0, true, true);
+        buffer = convertToMono(stereoBuffer);
+    }
+
+    return buffer;
+}
+
+juce::AudioBuffer<float> AudioFileManager::readResampled(juce::AudioFormatReader& reader,
+                                                         int numSamples,
+                                                         int srcSampleRate) {
+    TRACE_SCOPE("read and resample");
+    // Read, downmix and resample block by block so the source-rate audio is
+    // never held in memory as a whole
+    constexpr int blockSize = 1 << 16;
+    const bool stereo = reader.numChannels > 1;
+
+    Resampler resampler(srcSampleRate, SAMPLE_RATE);
+    std::vector<float> output;
+    output.reserve(static_cast<size_t>(resampler.getOutputLength(numSamples)));
+
+    juce::AudioBuffer<float> block(stereo ? 2 : 1, blockSize);
+    for (int pos = 0; pos < numSamples; pos += blockSize) {
+        const int count = std::min(blockSize, numSamples - pos);
+        reader.read(&block, 0, count, pos, true, stereo);
+
+        if (stereo) {
+            block.addFrom(0, 0, block, 1, 0, count);
+            block.applyGain(0, 0, count, 0.5f);
+        }
+
+        resampler.processBlock(block.getReadPointer(0), count, output);
+    }
+    resampler.flush(output);
+
+    juce::AudioBuffer<float> buffer(1, static_cast<int>(output.size()));
+    buffer.copyFrom(0, 0, output.data(), buffer.getNumSamples());
+    return buffer;
+}
+
+bool AudioFileManager::writeWavFile(const juce::File& file, const juce::AudioBuffer<float>& buffer, int sampleRate) {
+    if (file.existsAsFile() && !file.deleteFile())
+        return false;
+
     juce::WavAudioFormat wavFormat;
     std::unique_ptr<juce::AudioFormatWriter> writer(
         wavFormat.createWriterFor(new juce::FileOutputStream(file),
@@ -148,16 +186,10 @@ void AudioFileManager::exportAudioFileAsync(const juce::File& file,
                                   static_cast<unsigned int>(buffer.getNumChannels()),
                                   16, {}, 0));
 
-    bool success = false;
-    if (writer) {
-        success = writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
-    }
-
-    if (onProgress)
-        onProgress(1.0, success ? "Export complete" : "Export failed");
+    if (!writer)
+        return false;
 
-    if (onComplete)
-        onComplete(success);
+    return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
 }
 
 bool AudioFileManager::isInterestedInFileDrag(const juce::StringArray& files) {
@@ -180,34 +212,6 @@ juce::File AudioFileManager::getFirstAudioFile(const juce::StringArray& files) {
     return {};
 }
 
-juce::AudioBuffer<float> AudioFileManager::resampleIfNeeded(const juce::AudioBuffer<float>& buffer,
-                                                            int srcSampleRate,
-                                                            int targetSampleRate) {
-    if (srcSampleRate == targetSampleRate)
-        return buffer;
-
-    const double ratio = static_cast<double>(srcSampleRate) / targetSampleRate;
-    const int numSamples = buffer.getNumSamples();
-    const int newNumSamples = static_cast<int>(numSamples / ratio);
-
-    juce::AudioBuffer<float> resampledBuffer(1, newNumSamples);
-    const float* src = buffer.getReadPointer(0);
-    float* dst = resampledBuffer.getWritePointer(0);
-
-    for (int i = 0; i < newNumSamples; ++i) {
-        const double srcPos = i * ratio;
-        const int srcIndex = static_cast<int>(srcPos);
-        const double frac = srcPos - srcIndex;
-
-        if (srcIndex + 1 < numSamples)
-            dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) + src[srcIndex + 1] * frac);
-        else
-            dst[i] = src[srcIndex];
-    }
-
-    return resampledBuffer;
-}
-
 juce::AudioBuffer<float> AudioFileManager::convertToMono(const juce::AudioBuffer<float>& stereoBuffer) {
     const int numSamples = stereoBuffer.getNumSamples();
     juce::AudioBuffer<float> monoBuffer(1, numSamples);
@@ -35,6 +35,17 @@ public:
                              ProgressCallback onProgress,
                              ExportCompleteCallback onComplete);
 
+    /**
+     * Read an audio file synchronously as mono at SAMPLE_RATE.
+     * Returns an empty buffer if the file cannot be read.
+     */
+    static juce::AudioBuffer<float> readAudioFile(const juce::File& file);
+
+    /**
+     * Write a 16-bit WAV file synchronously.
+     */
+    static bool writeWavFile(const juce::File& file, const juce::AudioBuffer<float>& buffer, int sampleRate);
+
     // State
     bool isLoading() const { return isLoadingAudio.load(); }
     void cancelLoading() { cancelFlag = true; }
@@ -44,10 +55,10 @@ public:
     static juce::File getFirstAudioFile(const juce::StringArray& files);
 
 private:
-    // Resample audio to target sample rate
-    static juce::AudioBuffer<float> resampleIfNeeded(const juce::AudioBuffer<float>& buffer,
-                                                     int srcSampleRate,
-                                                     int targetSampleRate);
+    // Streamed mono read + resample to SAMPLE_RATE (used by readAudioFile)
+    static juce::AudioBuffer<float> readResampled(juce::AudioFormatReader& reader,
+                                                  int numSamples,
+                                                  int srcSampleRate);
 
     // Convert stereo to mono
     static juce::AudioBuffer<float> convertToMono(const juce::AudioBuffer<float>& stereoBuffer);
@@ -1,4 +1,5 @@
 #include "PitchDetector.h"
+#include "../Utils/Tracer.h"
 #include <cmath>
 #include <algorithm>
 
@@ -8,9 +9,10 @@ PitchDetector::PitchDetector(int sampleRate, int hopSize)
     windowSize = std::max(2048, static_cast<int>(sampleRate / f0Min) * 2);
 }
 
-std::pair<std::vector<float>, std::vector<bool>> 
+std::pair<std::vector<float>, VoicedMask>
 PitchDetector::extractF0(const float* audio, int numSamples)
 {
+    TRACE_SCOPE("YIN");
     int numFrames = (numSamples - windowSize) / hopSize + 1;
     if (numFrames < 1)
     {
@@ -19,7 +21,7 @@ PitchDetector::extractF0(const float* audio, int numSamples)
     }
     
     std::vector<float> f0Values(numFrames, 0.0f);
-    std::vector<bool> voicedMask(numFrames, false);
+    VoicedMask voicedMask(numFrames, 0);
     
     for (int i = 0; i < numFrames; ++i)
     {
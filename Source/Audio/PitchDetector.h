@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Models/FrameBuffers.h"
 #include <vector>
 
 /**
@@ -19,7 +20,7 @@ public:
      * @param numSamples Number of samples
      * @return Pair of (f0 values, voiced mask)
      */
-    std::pair<std::vector<float>, std::vector<bool>> 
+    std::pair<std::vector<float>, VoicedMask>
     extractF0(const float* audio, int numSamples);
     
     void setSampleRate(int sr) { sampleRate = sr; }
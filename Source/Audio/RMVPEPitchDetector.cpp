@@ -1,4 +1,7 @@
 #include "RMVPEPitchDetector.h"
+#include "../Utils/AsyncLogger.h"
+#include "../Utils/Resampler.h"
+#include "../Utils/Tracer.h"
 #include <cmath>
 #include <algorithm>
 
@@ -26,9 +29,9 @@ bool RMVPEPitchDetector::loadModel(const juce::File& modelPath,
         {
             try {
                 sessionOptions.AppendExecutionProvider("DML");
-                DBG("RMVPE: DirectML execution provider added");
+                LOG_AT(Info, Analysis, "RMVPE: DirectML execution provider added");
             } catch (const Ort::Exception& e) {
-                DBG("RMVPE: Failed to add DirectML provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "RMVPE: Failed to add DirectML provider, using CPU: " << e.what());
             }
         }
         else
@@ -40,9 +43,9 @@ bool RMVPEPitchDetector::loadModel(const juce::File& modelPath,
                 OrtCUDAProviderOptions cudaOptions;
                 cudaOptions.device_id = deviceId;
                 sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
-                DBG("RMVPE: CUDA execution provider added, device: " << deviceId);
+                LOG_AT(Info, Analysis, "RMVPE: CUDA execution provider added, device: " << deviceId);
             } catch (const Ort::Exception& e) {
-                DBG("RMVPE: Failed to add CUDA provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "RMVPE: Failed to add CUDA provider, using CPU: " << e.what());
             }
         }
         else
@@ -51,16 +54,16 @@ bool RMVPEPitchDetector::loadModel(const juce::File& modelPath,
         {
             try {
                 sessionOptions.AppendExecutionProvider("CoreML");
-                DBG("RMVPE: CoreML execution provider added");
+                LOG_AT(Info, Analysis, "RMVPE: CoreML execution provider added");
             } catch (const Ort::Exception& e) {
-                DBG("RMVPE: Failed to add CoreML provider, using CPU: " << e.what());
+                LOG_AT(Warning, Analysis, "RMVPE: Failed to add CoreML provider, using CPU: " << e.what());
             }
         }
         else
         {
             if (provider != GPUProvider::CPU)
             {
-                DBG("RMVPE: Using CPU execution provider");
+                LOG_AT(Info, Analysis, "RMVPE: Using CPU execution provider");
             }
         }
 
@@ -101,59 +104,27 @@ bool RMVPEPitchDetector::loadModel(const juce::File& modelPath,
             outputNames.push_back(name.c_str());
 
         loaded = true;
-        DBG("RMVPE model loaded successfully");
+        LOG_AT(Info, Analysis, "RMVPE model loaded successfully");
         return true;
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error: " << e.what());
         loaded = false;
         return false;
     }
     catch (const std::exception& e)
     {
-        DBG("Error loading RMVPE model: " << e.what());
+        LOG_AT(Error, Analysis, "Error loading RMVPE model: " << e.what());
         loaded = false;
         return false;
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return false;
 #endif
 }
 
-std::vector<float> RMVPEPitchDetector::resampleTo16k(const float* audio, int numSamples, int srcRate)
-{
-    if (srcRate == SAMPLE_RATE)
-    {
-        return std::vector<float>(audio, audio + numSamples);
-    }
-
-    // Linear interpolation resampling
-    double ratio = static_cast<double>(SAMPLE_RATE) / srcRate;
-    int outSamples = static_cast<int>(numSamples * ratio);
-
-    std::vector<float> resampled(outSamples);
-
-    for (int i = 0; i < outSamples; ++i)
-    {
-        double srcPos = i / ratio;
-        int srcIdx = static_cast<int>(srcPos);
-        double frac = srcPos - srcIdx;
-
-        if (srcIdx + 1 < numSamples)
-        {
-            resampled[i] = static_cast<float>(audio[srcIdx] * (1.0 - frac) + audio[srcIdx + 1] * frac);
-        }
-        else if (srcIdx < numSamples)
-        {
-            resampled[i] = audio[srcIdx];
-        }
-    }
-
-    return resampled;
-}
-
 std::vector<float> RMVPEPitchDetector::decodeF0(const float* hidden, int numFrames, float threshold)
 {
     // Decode hidden states to F0 values
@@ -214,19 +185,31 @@ std::vector<float> RMVPEPitchDetector::decodeF0(const float* hidden, int numFram
 }
 
 std::vector<float> RMVPEPitchDetector::extractF0(const float* audio, int numSamples,
-                                                  int sampleRate, float threshold)
+                                                  int sampleRate, float threshold,
+                                                  PitchSalience* salienceOut)
 {
+    TRACE_SCOPE("RMVPE");
 #ifdef HAVE_ONNXRUNTIME
     if (!loaded)
     {
-        DBG("RMVPE model not loaded");
+        LOG_AT(Warning, Analysis, "RMVPE model not loaded");
         return {};
     }
 
     try
     {
         // Step 1: Resample to 16kHz
-        auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
+        auto audio16k = Resampler::resample(audio, numSamples, sampleRate, SAMPLE_RATE,
+                                            Resampler::Quality::Fast);
+
+        if (salienceOut != nullptr)
+        {
+            // idx_cents = idx * 20 + CONST (same mapping as decodeF0)
+            std::vector<float> binCents(N_CLASS);
+            for (int i = 0; i < N_CLASS; ++i)
+                binCents[i] = i * 20.0f + CONST;
+            salienceOut->reset(static_cast<double>(HOP_SIZE) / SAMPLE_RATE, std::move(binCents), threshold);
+        }
 
         // Process in chunks to avoid stack overflow for long audio
         // Max chunk: 30 seconds at 16kHz = 480000 samples
@@ -236,7 +219,11 @@ std::vector<float> RMVPEPitchDetector::extractF0(const float* audio, int numSamp
         if (static_cast<int>(audio16k.size()) <= MAX_CHUNK_SAMPLES)
         {
             // Short audio: process directly
-            return extractF0Chunk(audio16k.data(), static_cast<int>(audio16k.size()), threshold);
+            auto f0 = extractF0Chunk(audio16k.data(), static_cast<int>(audio16k.size()),
+                                     threshold, salienceOut);
+            if (salienceOut != nullptr && salienceOut->getNumFrames() != static_cast<int>(f0.size()))
+                salienceOut->clear();
+            return f0;
         }
 
         // Long audio: process in chunks
@@ -249,7 +236,8 @@ std::vector<float> RMVPEPitchDetector::extractF0(const float* audio, int numSamp
             int chunkEnd = std::min(pos + MAX_CHUNK_SAMPLES, totalSamples);
             int chunkSize = chunkEnd - pos;
 
-            auto chunkF0 = extractF0Chunk(audio16k.data() + pos, chunkSize, threshold);
+            auto chunkF0 = extractF0Chunk(audio16k.data() + pos, chunkSize, threshold,
+                                          salienceOut, pos == 0 ? 0 : OVERLAP_SAMPLES / HOP_SIZE);
 
             if (pos == 0)
             {
@@ -269,25 +257,29 @@ std::vector<float> RMVPEPitchDetector::extractF0(const float* audio, int numSamp
             pos += MAX_CHUNK_SAMPLES - OVERLAP_SAMPLES;
         }
 
+        if (salienceOut != nullptr && salienceOut->getNumFrames() != static_cast<int>(allF0.size()))
+            salienceOut->clear();
+
         return allF0;
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error during RMVPE inference: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error during RMVPE inference: " << e.what());
         return {};
     }
     catch (const std::exception& e)
     {
-        DBG("Error during RMVPE F0 extraction: " << e.what());
+        LOG_AT(Error, Analysis, "Error during RMVPE F0 extraction: " << e.what());
         return {};
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return {};
 #endif
 }
 
-std::vector<float> RMVPEPitchDetector::extractF0Chunk(const float* audio16k, int numSamples, float threshold)
+std::vector<float> RMVPEPitchDetector::extractF0Chunk(const float* audio16k, int numSamples, float threshold,
+                                                       PitchSalience* salienceOut, int salienceSkipFrames)
 {
 #ifdef HAVE_ONNXRUNTIME
     // Prepare input tensor [1, n_samples]
@@ -322,6 +314,20 @@ std::vector<float> RMVPEPitchDetector::extractF0Chunk(const float* audio16k, int
     auto f0Shape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
     int numFrames = static_cast<int>(f0Shape[1]);
 
+    // Optional hidden salience [1, n_frames, N_CLASS] (only in exports that
+    // expose it as a second output)
+    if (salienceOut != nullptr && outputTensors.size() > 1)
+    {
+        auto hiddenShape = outputTensors[1].GetTensorTypeAndShapeInfo().GetShape();
+        if (hiddenShape.size() == 3 && hiddenShape[2] == N_CLASS)
+        {
+            const float* hidden = outputTensors[1].GetTensorData<float>();
+            int hiddenFrames = static_cast<int>(hiddenShape[1]);
+            int skip = std::min(salienceSkipFrames, hiddenFrames);
+            salienceOut->appendFrames(hidden + static_cast<size_t>(skip) * N_CLASS, hiddenFrames - skip);
+        }
+    }
+
     return std::vector<float>(f0Data, f0Data + numFrames);
 #else
     return {};
@@ -332,10 +338,11 @@ std::vector<float> RMVPEPitchDetector::extractF0WithProgress(const float* audio,
                                                               int sampleRate, float threshold,
                                                               std::function<void(double)> progressCallback)
 {
+    TRACE_SCOPE("RMVPE");
 #ifdef HAVE_ONNXRUNTIME
     if (!loaded)
     {
-        DBG("RMVPE model not loaded");
+        LOG_AT(Warning, Analysis, "RMVPE model not loaded");
         return {};
     }
 
@@ -344,7 +351,8 @@ std::vector<float> RMVPEPitchDetector::extractF0WithProgress(const float* audio,
         if (progressCallback) progressCallback(0.1);
 
         // Step 1: Resample to 16kHz
-        auto audio16k = resampleTo16k(audio, numSamples, sampleRate);
+        auto audio16k = Resampler::resample(audio, numSamples, sampleRate, SAMPLE_RATE,
+                                            Resampler::Quality::Fast);
 
         if (progressCallback) progressCallback(0.3);
 
@@ -393,16 +401,16 @@ std::vector<float> RMVPEPitchDetector::extractF0WithProgress(const float* audio,
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error during RMVPE inference: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error during RMVPE inference: " << e.what());
         return {};
     }
     catch (const std::exception& e)
     {
-        DBG("Error during RMVPE F0 extraction: " << e.what());
+        LOG_AT(Error, Analysis, "Error during RMVPE F0 extraction: " << e.what());
         return {};
     }
 #else
-    DBG("ONNX Runtime not available");
+    LOG_AT(Warning, Analysis, "ONNX Runtime not available");
     return {};
 #endif
 }
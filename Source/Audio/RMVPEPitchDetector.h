@@ -2,6 +2,7 @@
 
 #include "../JuceHeader.h"
 #include "FCPEPitchDetector.h"  // For GPUProvider enum
+#include "../Utils/PitchSalience.h"
 #include <vector>
 #include <memory>
 
@@ -58,10 +59,14 @@ public:
      * @param numSamples Number of samples
      * @param sampleRate Original sample rate
      * @param threshold Confidence threshold (default 0.03)
+     * @param salienceOut If not null, receives the quantized hidden salience
+     *                    when the exported model provides it as a second
+     *                    output; left empty otherwise
      * @return F0 values in Hz (0 for unvoiced frames)
      */
     std::vector<float> extractF0(const float* audio, int numSamples,
-                                 int sampleRate, float threshold = DEFAULT_THRESHOLD);
+                                 int sampleRate, float threshold = DEFAULT_THRESHOLD,
+                                 PitchSalience* salienceOut = nullptr);
 
     /**
      * Extract F0 with progress callback.
@@ -88,11 +93,11 @@ public:
 private:
     bool loaded = false;
 
-    // Resample audio to 16kHz
-    std::vector<float> resampleTo16k(const float* audio, int numSamples, int srcRate);
-
-    // Process a single chunk of 16kHz audio
-    std::vector<float> extractF0Chunk(const float* audio16k, int numSamples, float threshold);
+    // Process a single chunk of 16kHz audio. Salience frames before
+    // salienceSkipFrames (chunk overlap) are not stored.
+    std::vector<float> extractF0Chunk(const float* audio16k, int numSamples, float threshold,
+                                      PitchSalience* salienceOut = nullptr,
+                                      int salienceSkipFrames = 0);
 
     // Decode hidden states to F0 (matching Python decode function)
     std::vector<float> decodeF0(const float* hidden, int numFrames, float threshold);
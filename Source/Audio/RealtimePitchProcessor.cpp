@@ -1,4 +1,5 @@
 #include "RealtimePitchProcessor.h"
+#include "../Utils/Resampler.h"
 #include <algorithm>
 #include <cmath>
 
@@ -29,6 +30,7 @@ void RealtimePitchProcessor::setVocoder(Vocoder* voc) {
 void RealtimePitchProcessor::prepareToPlay(double sr, int) {
     sampleRate = sr;
     position.store(0.0);
+    callbackMonitor.prepare(sr);
 }
 
 bool RealtimePitchProcessor::processBlock(juce::AudioBuffer<float>& input,
@@ -47,6 +49,7 @@ bool RealtimePitchProcessor::processBlock(juce::AudioBuffer<float>& input,
     // Passthrough if not ready
     if (!ready.load()) {
         output.makeCopyOf(input);
+        callbackMonitor.recordPassthrough();
         return false;
     }
 
@@ -54,18 +57,21 @@ bool RealtimePitchProcessor::processBlock(juce::AudioBuffer<float>& input,
     const int numChannels = output.getNumChannels();
     auto posSamples = static_cast<juce::int64>(pos * sampleRate);
 
-    // Copy from processed buffer
+    // Copy from processed buffer. Never wait for the background thread
+    // while it swaps the buffer: pass the input through for this block instead.
     {
-        const juce::ScopedLock sl(bufferLock);
+        const juce::ScopedTryLock sl(bufferLock);
 
-        if (processedBuffer.getNumSamples() == 0) {
+        if (!sl.isLocked() || processedBuffer.getNumSamples() == 0) {
             output.makeCopyOf(input);
+            callbackMonitor.recordPassthrough();
             return false;
         }
 
         int available = processedBuffer.getNumSamples() - static_cast<int>(posSamples);
         if (posSamples < 0 || available <= 0) {
             output.makeCopyOf(input);
+            callbackMonitor.recordPassthrough();
             return false;
         }
 
@@ -116,30 +122,16 @@ void RealtimePitchProcessor::invalidate() {
         DBG("  -> Using project waveform directly, samples=" << processedBuffer.getNumSamples());
     } else {
         // Resample to host sample rate
-        const double ratio = static_cast<double>(srcSampleRate) / dstSampleRate;
+        Resampler resampler(srcSampleRate, dstSampleRate);
         const int srcSamples = audioData.waveform.getNumSamples();
-        const int dstSamples = static_cast<int>(srcSamples / ratio);
+        const int dstSamples = resampler.getOutputLength(srcSamples);
         const int numChannels = audioData.waveform.getNumChannels();
 
         juce::AudioBuffer<float> resampled(numChannels, dstSamples);
 
-        for (int ch = 0; ch < numChannels; ++ch) {
-            const float* src = audioData.waveform.getReadPointer(ch);
-            float* dst = resampled.getWritePointer(ch);
-
-            for (int i = 0; i < dstSamples; ++i) {
-                const double srcPos = i * ratio;
-                const int srcIndex = static_cast<int>(srcPos);
-                const double frac = srcPos - srcIndex;
-
-                if (srcIndex + 1 < srcSamples)
-                    dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) + src[srcIndex + 1] * frac);
-                else if (srcIndex < srcSamples)
-                    dst[i] = src[srcIndex];
-                else
-                    dst[i] = 0.0f;
-            }
-        }
+        for (int ch = 0; ch < numChannels; ++ch)
+            resampler.process(audioData.waveform.getReadPointer(ch), srcSamples,
+                              resampled.getWritePointer(ch), dstSamples);
 
         const juce::ScopedLock sl(bufferLock);
         processedBuffer = std::move(resampled);
@@ -187,9 +179,9 @@ void RealtimePitchProcessor::computeInBackground() {
     }
 
     auto adjustedF0 = project->getAdjustedF0();
-    DBG("  -> adjustedF0 size=" << adjustedF0.size() << ", melSpec size=" << audioData.melSpectrogram.size());
+    DBG("  -> adjustedF0 size=" << adjustedF0.size() << ", melSpec size=" << audioData.melSpectrogram.getNumFrames());
 
-    if (adjustedF0.empty() || adjustedF0.size() != audioData.melSpectrogram.size()) {
+    if (adjustedF0.empty() || adjustedF0.size() != static_cast<size_t>(audioData.melSpectrogram.getNumFrames())) {
         DBG("  -> Aborted: F0 size mismatch");
         computing = false;
         return;
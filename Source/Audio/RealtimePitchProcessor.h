@@ -2,6 +2,7 @@
 
 #include "../JuceHeader.h"
 #include "../Models/Project.h"
+#include "AudioCallbackMonitor.h"
 #include "Vocoder.h"
 #include <atomic>
 #include <memory>
@@ -37,6 +38,9 @@ public:
     double getPosition() const { return position.load(); }
     void setPosition(double positionSeconds) { position.store(positionSeconds); }
 
+    // Host callback timing; processBlock() records its passthroughs here
+    AudioCallbackMonitor& getCallbackMonitor() { return callbackMonitor; }
+
 private:
     void startComputation();
     void computeInBackground();
@@ -53,4 +57,6 @@ private:
 
     juce::CriticalSection bufferLock;
     std::unique_ptr<std::thread> computeThread;
+
+    AudioCallbackMonitor callbackMonitor;
 };
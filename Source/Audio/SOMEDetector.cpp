@@ -1,4 +1,7 @@
 #include "SOMEDetector.h"
+#include "../Utils/AsyncLogger.h"
+#include "../Utils/Resampler.h"
+#include "../Utils/Tracer.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -23,25 +26,25 @@ bool SOMEDetector::loadModel(const juce::File& modelPath)
 #ifdef USE_DIRECTML
         try {
             sessionOptions.AppendExecutionProvider("DML");
-            DBG("SOME: DirectML execution provider added");
+            LOG_AT(Info, Analysis, "SOME: DirectML execution provider added");
         } catch (const Ort::Exception& e) {
-            DBG("SOME: Failed to add DirectML provider, using CPU");
+            LOG_AT(Warning, Analysis, "SOME: Failed to add DirectML provider, using CPU");
         }
 #elif defined(USE_CUDA)
         try {
             OrtCUDAProviderOptions cudaOptions{};
             cudaOptions.device_id = 0;
             sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
-            DBG("SOME: CUDA execution provider added");
+            LOG_AT(Info, Analysis, "SOME: CUDA execution provider added");
         } catch (const Ort::Exception& e) {
-            DBG("SOME: Failed to add CUDA provider, using CPU");
+            LOG_AT(Warning, Analysis, "SOME: Failed to add CUDA provider, using CPU");
         }
 #elif defined(__APPLE__)
         try {
             sessionOptions.AppendExecutionProvider("CoreML");
-            DBG("SOME: CoreML execution provider added");
+            LOG_AT(Info, Analysis, "SOME: CoreML execution provider added");
         } catch (const Ort::Exception& e) {
-            DBG("SOME: Failed to add CoreML provider, using CPU");
+            LOG_AT(Warning, Analysis, "SOME: Failed to add CoreML provider, using CPU");
         }
 #endif
 
@@ -81,12 +84,12 @@ bool SOMEDetector::loadModel(const juce::File& modelPath)
             outputNames.push_back(name.c_str());
 
         loaded = true;
-        DBG("SOME model loaded: " << inputNameStrings.size() << " inputs, " << outputNameStrings.size() << " outputs");
+        LOG_AT(Info, Analysis, "SOME model loaded: " << inputNameStrings.size() << " inputs, " << outputNameStrings.size() << " outputs");
         return true;
     }
     catch (const Ort::Exception& e)
     {
-        DBG("ONNX Runtime error: " << e.what());
+        LOG_AT(Error, Analysis, "ONNX Runtime error: " << e.what());
         loaded = false;
         return false;
     }
@@ -95,29 +98,6 @@ bool SOMEDetector::loadModel(const juce::File& modelPath)
 #endif
 }
 
-std::vector<float> SOMEDetector::resampleTo44k(const float* audio, int numSamples, int srcRate)
-{
-    if (srcRate == SAMPLE_RATE)
-        return std::vector<float>(audio, audio + numSamples);
-
-    double ratio = static_cast<double>(SAMPLE_RATE) / srcRate;
-    int outSamples = static_cast<int>(numSamples * ratio);
-    std::vector<float> resampled(outSamples);
-
-    for (int i = 0; i < outSamples; ++i)
-    {
-        double srcPos = i / ratio;
-        int srcIdx = static_cast<int>(srcPos);
-        double frac = srcPos - srcIdx;
-
-        if (srcIdx + 1 < numSamples)
-            resampled[i] = static_cast<float>(audio[srcIdx] * (1.0 - frac) + audio[srcIdx + 1] * frac);
-        else if (srcIdx < numSamples)
-            resampled[i] = audio[srcIdx];
-    }
-    return resampled;
-}
-
 // RMS calculation for slicer
 std::vector<double> SOMEDetector::getRms(const std::vector<float>& samples, int frameLength, int hopLength)
 {
@@ -262,7 +242,7 @@ bool SOMEDetector::inferChunk(const std::vector<float>& chunk, std::vector<float
     }
     catch (const Ort::Exception& e)
     {
-        DBG("SOME chunk inference error: " << e.what());
+        LOG_AT(Error, Analysis, "SOME chunk inference error: " << e.what());
         return false;
     }
 #else
@@ -280,22 +260,24 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
     const float* audio, int numSamples, int sampleRate,
     std::function<void(double)> progressCallback)
 {
+    TRACE_SCOPE("SOME");
 #ifdef HAVE_ONNXRUNTIME
     if (!loaded || !onnxSession)
     {
-        DBG("SOME model not loaded");
+        LOG_AT(Warning, Analysis, "SOME model not loaded");
         return {};
     }
 
     if (progressCallback) progressCallback(0.05);
 
-    std::vector<float> waveform = resampleTo44k(audio, numSamples, sampleRate);
+    std::vector<float> waveform = Resampler::resample(audio, numSamples, sampleRate, SAMPLE_RATE,
+                                                       Resampler::Quality::Fast);
     int64_t totalSize = static_cast<int64_t>(waveform.size());
 
     if (progressCallback) progressCallback(0.1);
 
     MarkerList chunks = sliceAudio(waveform);
-    DBG("SOME: sliced into " << chunks.size() << " chunks");
+    LOG_AT(Debug, Analysis, "SOME: sliced into " << chunks.size() << " chunks");
 
     if (chunks.empty())
         return {};
@@ -333,7 +315,7 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
         
         // Debug: log SOME output for diagnosis
         int restCount = static_cast<int>(std::count(noteRest.begin(), noteRest.end(), true));
-        DBG("SOME chunk: " << noteMidi.size() << " notes, rest count: " << restCount);
+        LOG_AT(Debug, Analysis, "SOME chunk: " << noteMidi.size() << " notes, rest count: " << restCount);
         std::cout << "[SOME] Chunk: " << noteMidi.size() << " notes, " << restCount << " rest notes" << std::endl;
 
         // Calculate start frame for this chunk
@@ -383,7 +365,7 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
             // CRITICAL: Check bounds for note_frames array
             if (i >= note_frames.size())
             {
-                DBG("SOME: note_frames index " << i << " out of bounds (size=" << note_frames.size() << ")");
+                LOG_AT(Warning, Analysis, "SOME: note_frames index " << i << " out of bounds (size=" << note_frames.size() << ")");
                 std::cout << "[SOME] ERROR: note_frames index " << i << " out of bounds" << std::endl;
                 break;
             }
@@ -409,13 +391,13 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
             notesCreated++;
 
             // Log SOME output for debugging
-            DBG("SOME note: midi=" << noteMidi[i] << " (raw float from model)");
+            LOG_AT(Debug, Analysis, "SOME note: midi=" << noteMidi[i] << " (raw float from model)");
             
             // Advance position for next note (or rest)
             start_frame_temp += noteDurationFrames;
         }
         
-        DBG("SOME chunk built: " << notesCreated << " notes created, " << restSkipped << " rest skipped");
+        LOG_AT(Debug, Analysis, "SOME chunk built: " << notesCreated << " notes created, " << restSkipped << " rest skipped");
         std::cout << "[SOME] Chunk built: " << notesCreated << " notes, " << restSkipped << " rest, start=" 
                   << chunkStartFrame << ", end=" << start_frame_temp << std::endl;
 
@@ -426,7 +408,7 @@ std::vector<SOMEDetector::NoteEvent> SOMEDetector::detectNotesWithProgress(
 
     if (progressCallback) progressCallback(1.0);
 
-    DBG("SOME: detected " << allNotes.size() << " notes total");
+    LOG_AT(Info, Analysis, "SOME: detected " << allNotes.size() << " notes total");
     return allNotes;
 
 #else
@@ -439,24 +421,26 @@ void SOMEDetector::detectNotesStreaming(
     std::function<void(const std::vector<NoteEvent>&)> noteCallback,
     std::function<void(double)> progressCallback)
 {
+    TRACE_SCOPE("SOME streaming");
 #ifdef HAVE_ONNXRUNTIME
-    DBG("=== detectNotesStreaming CALLED: " << numSamples << " samples ===");
+    LOG_AT(Debug, Analysis, "=== detectNotesStreaming CALLED: " << numSamples << " samples ===");
 
     if (!loaded || !onnxSession)
     {
-        DBG("SOME model not loaded");
+        LOG_AT(Warning, Analysis, "SOME model not loaded");
         return;
     }
 
     if (progressCallback) progressCallback(0.05);
 
-    std::vector<float> waveform = resampleTo44k(audio, numSamples, sampleRate);
+    std::vector<float> waveform = Resampler::resample(audio, numSamples, sampleRate, SAMPLE_RATE,
+                                                       Resampler::Quality::Fast);
     int64_t totalSize = static_cast<int64_t>(waveform.size());
 
     if (progressCallback) progressCallback(0.1);
 
     MarkerList chunks = sliceAudio(waveform);
-    DBG("SOME streaming: sliced into " << chunks.size() << " chunks");
+    LOG_AT(Debug, Analysis, "SOME streaming: sliced into " << chunks.size() << " chunks");
 
     if (chunks.empty())
         return;
@@ -482,7 +466,7 @@ void SOMEDetector::detectNotesStreaming(
 
         if (!inferChunk(chunkData, noteMidi, noteRest, noteDur))
         {
-            DBG("SOME chunk inference failed");
+            LOG_AT(Warning, Analysis, "SOME chunk inference failed");
             std::cout << "[SOME] Chunk inference failed" << std::endl;
             continue;
         }
@@ -492,7 +476,7 @@ void SOMEDetector::detectNotesStreaming(
         
         // Debug: log SOME output for diagnosis
         int restCount = static_cast<int>(std::count(noteRest.begin(), noteRest.end(), true));
-        DBG("SOME streaming chunk: " << noteMidi.size() << " notes, rest count: " << restCount);
+        LOG_AT(Debug, Analysis, "SOME streaming chunk: " << noteMidi.size() << " notes, rest count: " << restCount);
 
         int chunkStartFrame = static_cast<int>(beginFrame / HOP_SIZE);
         chunkStartFrame = std::max(chunkStartFrame, lastEndFrame);
@@ -538,7 +522,7 @@ void SOMEDetector::detectNotesStreaming(
             // CRITICAL: Check bounds for note_frames array
             if (i >= note_frames.size())
             {
-                DBG("SOME streaming: note_frames index " << i << " out of bounds (size=" << note_frames.size() << ")");
+                LOG_AT(Warning, Analysis, "SOME streaming: note_frames index " << i << " out of bounds (size=" << note_frames.size() << ")");
                 std::cout << "[SOME] ERROR: note_frames index " << i << " out of bounds" << std::endl;
                 break;
             }
@@ -564,13 +548,13 @@ void SOMEDetector::detectNotesStreaming(
             notesCreated++;
 
             // Log SOME output for debugging
-            DBG("SOME streaming note: midi=" << noteMidi[i] << " (raw float from model)");
+            LOG_AT(Debug, Analysis, "SOME streaming note: midi=" << noteMidi[i] << " (raw float from model)");
             
             // Advance position for next note (or rest)
             start_frame_temp += noteDurationFrames;
         }
         
-        DBG("SOME streaming chunk built: " << notesCreated << " notes created, " << restSkipped << " rest skipped");
+        LOG_AT(Debug, Analysis, "SOME streaming chunk built: " << notesCreated << " notes created, " << restSkipped << " rest skipped");
 
         lastEndFrame = start_frame_temp;
 
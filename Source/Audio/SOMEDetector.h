@@ -44,8 +44,6 @@ public:
 private:
     bool loaded = false;
 
-    std::vector<float> resampleTo44k(const float* audio, int numSamples, int srcRate);
-
     // Slicer
     using MarkerList = std::vector<std::pair<int64_t, int64_t>>;
     MarkerList sliceAudio(const std::vector<float>& samples) const;
@@ -111,17 +111,16 @@ void IncrementalSynthesizer::synthesizeRegion(ProgressCallback onProgress,
 
     // Clamp to valid range
     startFrame = std::max(0, startFrame);
-    endFrame = std::min(static_cast<int>(audioData.melSpectrogram.size()), endFrame);
+    endFrame = std::min(audioData.melSpectrogram.getNumFrames(), endFrame);
 
     if (startFrame >= endFrame) {
         if (onComplete) onComplete(false);
         return;
     }
 
-    // Extract mel spectrogram range
-    std::vector<std::vector<float>> melRange(
-        audioData.melSpectrogram.begin() + startFrame,
-        audioData.melSpectrogram.begin() + endFrame);
+    // Extract mel spectrogram range (kept in the project's storage format;
+    // the vocoder decodes half-precision rows as it reads them)
+    MelBuffer melRange = audioData.melSpectrogram.getRange(startFrame, endFrame);
 
     // Get adjusted F0 for range
     std::vector<float> adjustedF0Range = project->getAdjustedF0ForRange(startFrame, endFrame);
@@ -183,6 +182,9 @@ void IncrementalSynthesizer::synthesizeRegion(ProgressCallback onProgress,
                 return;
             }
 
+            if (onRegionAboutToBeReplaced)
+                onRegionAboutToBeReplaced(startSample, samplesToReplace);
+
             // Direct replacement - no crossfade
             for (int i = 0; i < samplesToReplace; ++i) {
                 int dstIdx = startSample + i;
@@ -193,8 +195,13 @@ void IncrementalSynthesizer::synthesizeRegion(ProgressCallback onProgress,
                 }
             }
 
+            audioData.updateWaveformPeaks(startSample, samplesToReplace);
+
             DBG("synthesizeRegion: replaced " << samplesToReplace << " samples at " << startSample);
 
+            if (onRegionReplaced)
+                onRegionReplaced(startSample, samplesToReplace);
+
             // Clear dirty flags
             capturedProject->clearAllDirty();
 
@@ -39,6 +39,11 @@ public:
     // Check if synthesis is in progress
     bool isSynthesizing() const { return isBusy.load(); }
 
+    // Called on the message thread just before and after rendered samples
+    // are written into the waveform (e.g. to keep them for undo)
+    std::function<void(int startSample, int numSamples)> onRegionAboutToBeReplaced;
+    std::function<void(int startSample, int numSamples)> onRegionReplaced;
+
 private:
     /**
      * Expand dirty range to nearest silence boundaries.
@@ -0,0 +1,109 @@
+#include "RenderSnapshotStore.h"
+
+namespace {
+    constexpr int BITS_PER_SAMPLE = 24;
+}
+
+RenderSnapshotStore::RenderSnapshotStore(size_t budgetBytes)
+    : budget(budgetBytes) {
+}
+
+int RenderSnapshotStore::add(const juce::AudioBuffer<float>& source, int startSample, int numSamples,
+                             int sampleRate) {
+    startSample = std::max(0, startSample);
+    numSamples = std::min(numSamples, source.getNumSamples() - startSample);
+    const int numChannels = source.getNumChannels();
+    if (numSamples <= 0 || numChannels <= 0)
+        return 0;
+
+    // FLAC takes integer samples; keep peaks above full scale from clipping
+    juce::AudioBuffer<float> span(numChannels, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+        span.copyFrom(ch, 0, source, ch, startSample, numSamples);
+
+    const float peak = span.getMagnitude(0, numSamples);
+    const float gain = peak > 1.0f ? peak : 1.0f;
+    if (gain > 1.0f)
+        span.applyGain(1.0f / gain);
+
+    Entry entry;
+    entry.startSample = startSample;
+    entry.numSamples = numSamples;
+    entry.numChannels = numChannels;
+    entry.gain = gain;
+
+    {
+        juce::FlacAudioFormat flac;
+        auto stream = std::make_unique<juce::MemoryOutputStream>(entry.data, false);
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            flac.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                 BITS_PER_SAMPLE, {}, 0));
+        if (writer == nullptr)
+            return 0;
+        stream.release();  // Owned by the writer now
+
+        if (!writer->writeFromAudioSampleBuffer(span, 0, numSamples))
+            return 0;
+    }
+
+    const int id = nextId++;
+    totalBytes += entry.data.getSize();
+    lru.push_back(id);
+    entry.lruPosition = std::prev(lru.end());
+    entries.emplace(id, std::move(entry));
+
+    evictToBudget();
+    return contains(id) ? id : 0;
+}
+
+bool RenderSnapshotStore::restore(int id, juce::AudioBuffer<float>& dest) {
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return false;
+
+    auto& entry = it->second;
+    if (entry.numChannels != dest.getNumChannels() || entry.startSample + entry.numSamples > dest.getNumSamples())
+        return false;
+
+    juce::FlacAudioFormat flac;
+    std::unique_ptr<juce::AudioFormatReader> reader(
+        flac.createReaderFor(new juce::MemoryInputStream(entry.data, false), true));
+    if (reader == nullptr)
+        return false;
+
+    juce::AudioBuffer<float> span(entry.numChannels, entry.numSamples);
+    if (!reader->read(&span, 0, entry.numSamples, 0, true, true))
+        return false;
+
+    for (int ch = 0; ch < entry.numChannels; ++ch)
+        dest.copyFrom(ch, entry.startSample, span.getReadPointer(ch), entry.numSamples, entry.gain);
+
+    lru.splice(lru.end(), lru, entry.lruPosition);
+    return true;
+}
+
+void RenderSnapshotStore::remove(int id) {
+    auto it = entries.find(id);
+    if (it == entries.end())
+        return;
+
+    totalBytes -= it->second.data.getSize();
+    lru.erase(it->second.lruPosition);
+    entries.erase(it);
+}
+
+void RenderSnapshotStore::clear() {
+    entries.clear();
+    lru.clear();
+    totalBytes = 0;
+}
+
+void RenderSnapshotStore::setBudget(size_t bytes) {
+    budget = bytes;
+    evictToBudget();
+}
+
+void RenderSnapshotStore::evictToBudget() {
+    while (totalBytes > budget && !lru.empty())
+        remove(lru.front());
+}
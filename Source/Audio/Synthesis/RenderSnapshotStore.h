@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include <list>
+#include <map>
+
+/**
+ * Bounded store of rendered audio spans, kept FLAC-compressed in memory.
+ *
+ * Undo and redo use it to put back the samples an edit's render replaced
+ * (or produced) instead of running the vocoder again. Entries are evicted
+ * least recently used first once the budget is exceeded; restoring an
+ * evicted id fails and the caller falls back to synthesis.
+ *
+ * Spans are stored at 24 bits (scaled down first if they exceed full
+ * scale), which is far below anything audible.
+ */
+class RenderSnapshotStore {
+public:
+    static constexpr size_t defaultBudgetBytes = 96 * 1024 * 1024;
+
+    explicit RenderSnapshotStore(size_t budgetBytes = defaultBudgetBytes);
+
+    /**
+     * Compress samples [startSample, startSample + numSamples) of source.
+     * Returns an id (> 0), or 0 if the span could not be stored.
+     */
+    int add(const juce::AudioBuffer<float>& source, int startSample, int numSamples, int sampleRate);
+
+    bool contains(int id) const { return entries.count(id) > 0; }
+
+    /** Decode a span back into dest at the position it was taken from. */
+    bool restore(int id, juce::AudioBuffer<float>& dest);
+
+    void remove(int id);
+    void clear();
+
+    void setBudget(size_t bytes);
+    size_t getMemoryBytes() const { return totalBytes; }
+
+private:
+    struct Entry {
+        int startSample = 0;
+        int numSamples = 0;
+        int numChannels = 0;
+        float gain = 1.0f;  // Samples were divided by this before encoding
+        juce::MemoryBlock data;
+        std::list<int>::iterator lruPosition;
+    };
+
+    void evictToBudget();
+
+    std::map<int, Entry> entries;
+    std::list<int> lru;  // Front = least recently used
+    size_t budget;
+    size_t totalBytes = 0;
+    int nextId = 1;
+};
@@ -1,26 +1,14 @@
 #include "Vocoder.h"
 #include "../Utils/Constants.h"
-#include "../Utils/PlatformPaths.h"
+#include "../Utils/Tracer.h"
 #include <cmath>
 #include <thread>
 #include <algorithm>
 #include <chrono>
-#include <sstream>
-#include <iomanip>
 
 Vocoder::Vocoder()
 {
-    // Open log file in platform-appropriate logs directory
-    auto logPath = PlatformPaths::getLogFile("vocoder_log.txt");
-    logFile = std::make_unique<std::ofstream>(logPath.getFullPathName().toStdString(), std::ios::app);
-    
-    if (logFile && logFile->is_open())
-    {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        *logFile << "\n========== Vocoder Session Started at " << std::ctime(&time) << " ==========\n";
-        logFile->flush();
-    }
+    log("========== Vocoder session started ==========");
     
 #ifdef HAVE_ONNXRUNTIME
     // Initialize ONNX Runtime environment
@@ -29,7 +17,7 @@ Vocoder::Vocoder()
         allocator = std::make_unique<Ort::AllocatorWithDefaultOptions>();
         log("ONNX Runtime initialized successfully");
     } catch (const Ort::Exception& e) {
-        log("Failed to initialize ONNX Runtime: " + std::string(e.what()));
+        log("Failed to initialize ONNX Runtime: " + std::string(e.what()), AsyncLogger::Level::Error);
     }
 #endif
 }
@@ -40,34 +28,12 @@ Vocoder::~Vocoder()
     onnxSession.reset();
     onnxEnv.reset();
 #endif
-    if (logFile && logFile->is_open())
-    {
-        log("Vocoder session ended");
-        logFile->close();
-    }
+    log("Vocoder session ended");
 }
 
-void Vocoder::log(const std::string& message)
+void Vocoder::log(const std::string& message, AsyncLogger::Level level)
 {
-    DBG(message);
-    if (logFile && logFile->is_open())
-    {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-        
-        std::tm tm_buf;
-#ifdef _WIN32
-        localtime_s(&tm_buf, &time);
-#else
-        localtime_r(&time, &tm_buf);
-#endif
-        
-        *logFile << std::put_time(&tm_buf, "%H:%M:%S") << "." 
-                 << std::setfill('0') << std::setw(3) << ms.count() 
-                 << " | " << message << "\n";
-        logFile->flush();
-    }
+    AsyncLogger::getInstance().write(AsyncLogger::Channel::Vocoder, level, message);
 }
 
 bool Vocoder::isOnnxRuntimeAvailable()
@@ -187,7 +153,7 @@ bool Vocoder::loadModel(const juce::File& modelPath)
         return true;
         
     } catch (const Ort::Exception& e) {
-        log("Failed to load ONNX model: " + std::string(e.what()));
+        log("Failed to load ONNX model: " + std::string(e.what()), AsyncLogger::Level::Error);
         loaded = false;
         return false;
     }
@@ -218,38 +184,44 @@ bool Vocoder::loadModel(const juce::File& modelPath)
 #endif
 }
 
-std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
+std::vector<float> Vocoder::infer(const MelBuffer& mel,
                                    const std::vector<float>& f0)
 {
     if (!loaded || mel.empty() || f0.empty())
         return {};
     
-    size_t numFrames = std::min(mel.size(), f0.size());
+    TRACE_SCOPE("vocoder");
+    size_t numFrames = std::min(static_cast<size_t>(mel.getNumFrames()), f0.size());
     
-    log("Starting inference with " + std::to_string(numFrames) + " frames");
+    LOG_AT(Debug, Vocoder, "Starting inference with " << (int) numFrames << " frames");
     
     auto startTotal = std::chrono::high_resolution_clock::now();
     
 #ifdef HAVE_ONNXRUNTIME
     if (!onnxSession)
     {
-        log("ONNX session not available, using fallback");
+        log("ONNX session not available, using fallback", AsyncLogger::Level::Warning);
         return generateSineFallback(f0);
     }
     
     try {
         auto startPrep = std::chrono::high_resolution_clock::now();
+        Tracer::Span prepSpan("vocoder prep");
         
         // Prepare mel input: [batch=1, num_mels, frames]
         std::vector<int64_t> melShape = {1, static_cast<int64_t>(numMels), static_cast<int64_t>(numFrames)};
         std::vector<float> melData(numMels * numFrames);
         
-        // Transpose mel from [T, num_mels] to [num_mels, T]
+        // Transpose mel from [T, num_mels] to [num_mels, T]. Half-precision
+        // mels are decoded one row at a time into a reused scratch row.
+        const int melsAvailable = std::min(numMels, mel.getNumMels());
+        std::vector<float> melRow(static_cast<size_t>(mel.getNumMels()));
         for (size_t frame = 0; frame < numFrames; ++frame)
         {
-            for (int m = 0; m < numMels && m < static_cast<int>(mel[frame].size()); ++m)
+            const float* melFrame = mel.readFrame(static_cast<int>(frame), melRow.data());
+            for (int m = 0; m < melsAvailable; ++m)
             {
-                melData[m * numFrames + frame] = mel[frame][m];
+                melData[m * numFrames + frame] = melFrame[m];
             }
         }
         
@@ -262,7 +234,7 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
             melMin = std::min(melMin, v);
             melMax = std::max(melMax, v);
         }
-        log("Mel stats: min=" + std::to_string(melMin) + " max=" + std::to_string(melMax));
+        LOG_AT(Debug, Vocoder, "Mel stats: min=" << melMin << " max=" << melMax);
         
         // Clamp mel values to reasonable range to avoid extreme values
         // This prevents potential numerical issues in the model
@@ -297,14 +269,13 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
                 voicedCount++;
             }
         }
-        log("F0 stats: min=" + std::to_string(f0Min) + 
-            " max=" + std::to_string(f0Max) + 
-            " mean=" + std::to_string(voicedCount > 0 ? f0Sum / voicedCount : 0.0f) +
-            " voiced=" + std::to_string(voicedCount) + "/" + std::to_string(numFrames));
+        LOG_AT(Debug, Vocoder, "F0 stats: min=" << f0Min << " max=" << f0Max
+                                   << " mean=" << (voicedCount > 0 ? f0Sum / voicedCount : 0.0f)
+                                   << " voiced=" << voicedCount << "/" << (int) numFrames);
         
         auto endPrep = std::chrono::high_resolution_clock::now();
         auto prepMs = std::chrono::duration_cast<std::chrono::milliseconds>(endPrep - startPrep).count();
-        log("Data preparation took " + std::to_string(prepMs) + " ms");
+        LOG_AT(Debug, Vocoder, "Data preparation took " << (juce::int64) prepMs << " ms");
         
         // Create memory info
         auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
@@ -318,23 +289,27 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
             memoryInfo, f0Data.data(), f0Data.size(),
             f0Shape.data(), f0Shape.size()));
         
+        prepSpan.end();
+        
         // Run inference
         auto startInfer = std::chrono::high_resolution_clock::now();
+        Tracer::Span runSpan("vocoder run");
         
         auto outputTensors = onnxSession->Run(
             Ort::RunOptions{nullptr},
             inputNames.data(), inputTensors.data(), inputTensors.size(),
             outputNames.data(), outputNames.size());
         
+        runSpan.end();
         auto endInfer = std::chrono::high_resolution_clock::now();
         auto inferMs = std::chrono::duration_cast<std::chrono::milliseconds>(endInfer - startInfer).count();
-        log("ONNX inference took " + std::to_string(inferMs) + " ms for " + 
-            std::to_string(numFrames) + " frames");
+        LOG_AT(Info, Vocoder, "ONNX inference took " << (juce::int64) inferMs << " ms for " << (int) numFrames
+                                                      << " frames");
         
         // Get output
         if (outputTensors.empty())
         {
-            log("ONNX inference returned no output");
+            log("ONNX inference returned no output", AsyncLogger::Level::Error);
             return generateSineFallback(f0);
         }
         
@@ -344,22 +319,23 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
         auto outputShape = typeInfo.GetShape();
         size_t outputSize = typeInfo.GetElementCount();
         
-        log("ONNX output shape: [" +
-            std::to_string(outputShape.size() > 0 ? outputShape[0] : 0) + ", " +
-            std::to_string(outputShape.size() > 1 ? outputShape[1] : 0) + ", " +
-            std::to_string(outputShape.size() > 2 ? outputShape[2] : 0) + "]");
-        log("Output samples: " + std::to_string(outputSize));
+        LOG_AT(Debug, Vocoder, "ONNX output shape: [" << (juce::int64) (outputShape.size() > 0 ? outputShape[0] : 0)
+                                   << ", " << (juce::int64) (outputShape.size() > 1 ? outputShape[1] : 0)
+                                   << ", " << (juce::int64) (outputShape.size() > 2 ? outputShape[2] : 0) << "]");
+        LOG_AT(Debug, Vocoder, "Output samples: " << (juce::int64) outputSize);
 
         // DIAGNOSTIC: Check if output length matches expected length
         size_t expectedSamples = numFrames * hopSize;
         if (outputSize != expectedSamples) {
-            log("WARNING: Output length mismatch! Expected " + std::to_string(expectedSamples) +
-                " samples (" + std::to_string(numFrames) + " frames * " + std::to_string(hopSize) +
-                " hop), but got " + std::to_string(outputSize) + " samples. Difference: " +
-                std::to_string(static_cast<int>(outputSize) - static_cast<int>(expectedSamples)) + " samples");
+            LOG_AT(Warning, Vocoder, "Output length mismatch! Expected " << (juce::int64) expectedSamples
+                                         << " samples (" << (int) numFrames << " frames * " << hopSize
+                                         << " hop), but got " << (juce::int64) outputSize << " samples. Difference: "
+                                         << static_cast<int>(outputSize) - static_cast<int>(expectedSamples)
+                                         << " samples");
         }
         
         // Copy output to vector
+        Tracer::Span postprocessSpan("vocoder postprocess");
         float* outputData = outputTensor.GetTensorMutableData<float>();
         std::vector<float> waveform(outputData, outputData + outputSize);
         
@@ -374,10 +350,8 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
         float maxAbs = std::max(std::abs(minVal), std::abs(maxVal));
         float avgAbs = sumAbs / waveform.size();
         
-        log("Pre-normalization stats: min=" + std::to_string(minVal) + 
-            " max=" + std::to_string(maxVal) +
-            " maxAbs=" + std::to_string(maxAbs) +
-            " avgAbs=" + std::to_string(avgAbs));
+        LOG_AT(Debug, Vocoder, "Pre-normalization stats: min=" << minVal << " max=" << maxVal
+                                   << " maxAbs=" << maxAbs << " avgAbs=" << avgAbs);
         
         // No normalization - output vocoder result as-is
         // Only apply safety clamp to prevent clipping
@@ -388,12 +362,12 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
         
         auto endTotal = std::chrono::high_resolution_clock::now();
         auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(endTotal - startTotal).count();
-        log("Total vocoder inference took " + std::to_string(totalMs) + " ms");
+        LOG_AT(Info, Vocoder, "Total vocoder inference took " << (juce::int64) totalMs << " ms");
         
         return waveform;
         
     } catch (const Ort::Exception& e) {
-        log("ONNX inference failed: " + std::string(e.what()));
+        log("ONNX inference failed: " + std::string(e.what()), AsyncLogger::Level::Error);
         return generateSineFallback(f0);
     }
 #else
@@ -401,7 +375,7 @@ std::vector<float> Vocoder::infer(const std::vector<std::vector<float>>& mel,
 #endif
 }
 
-std::vector<float> Vocoder::inferWithPitchShift(const std::vector<std::vector<float>>& mel,
+std::vector<float> Vocoder::inferWithPitchShift(const MelBuffer& mel,
                                                  const std::vector<float>& f0,
                                                  float pitchShiftSemitones)
 {
@@ -421,7 +395,7 @@ std::vector<float> Vocoder::inferWithPitchShift(const std::vector<std::vector<fl
     return infer(mel, shiftedF0);
 }
 
-void Vocoder::inferAsync(const std::vector<std::vector<float>>& mel,
+void Vocoder::inferAsync(const MelBuffer& mel,
                          const std::vector<float>& f0,
                          std::function<void(std::vector<float>)> callback,
                          std::shared_ptr<std::atomic<bool>> cancelFlag)
@@ -535,7 +509,7 @@ Ort::SessionOptions Vocoder::createSessionOptions()
             sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
             log("CUDA execution provider added");
         } catch (const Ort::Exception& e) {
-            log("Failed to add CUDA provider: " + std::string(e.what()));
+            log("Failed to add CUDA provider: " + std::string(e.what()), AsyncLogger::Level::Warning);
             log("Falling back to CPU");
         }
     }
@@ -548,7 +522,7 @@ Ort::SessionOptions Vocoder::createSessionOptions()
             sessionOptions.AppendExecutionProvider("DML");
             log("DirectML execution provider added");
         } catch (const Ort::Exception& e) {
-            log("Failed to add DirectML provider: " + std::string(e.what()));
+            log("Failed to add DirectML provider: " + std::string(e.what()), AsyncLogger::Level::Warning);
             log("Falling back to CPU");
         }
     }
@@ -560,7 +534,7 @@ Ort::SessionOptions Vocoder::createSessionOptions()
             sessionOptions.AppendExecutionProvider("CoreML");
             log("CoreML execution provider added");
         } catch (const Ort::Exception& e) {
-            log("Failed to add CoreML provider: " + std::string(e.what()));
+            log("Failed to add CoreML provider: " + std::string(e.what()), AsyncLogger::Level::Warning);
             log("Falling back to CPU");
         }
     }
@@ -572,7 +546,7 @@ Ort::SessionOptions Vocoder::createSessionOptions()
             sessionOptions.AppendExecutionProvider_TensorRT(trtOptions);
             log("TensorRT execution provider added");
         } catch (const Ort::Exception& e) {
-            log("Failed to add TensorRT provider: " + std::string(e.what()));
+            log("Failed to add TensorRT provider: " + std::string(e.what()), AsyncLogger::Level::Warning);
             log("Falling back to CPU");
         }
     }
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Models/FrameBuffers.h"
+#include "../Utils/AsyncLogger.h"
 #include <vector>
 #include <functional>
 #include <memory>
-#include <fstream>
 
 #ifdef HAVE_ONNXRUNTIME
 #include <onnxruntime_cxx_api.h>
@@ -39,11 +40,12 @@ public:
     
     /**
      * Synthesize waveform from mel spectrogram and F0.
-     * @param mel Mel spectrogram [T, NUM_MELS] (T frames, each with NUM_MELS values)
+     * @param mel Mel spectrogram [T, NUM_MELS] (T frames, each with NUM_MELS values),
+     *            float32 or float16 storage
      * @param f0 F0 values [T] (fundamental frequency per frame)
      * @return Synthesized waveform, or empty vector on failure
      */
-    std::vector<float> infer(const std::vector<std::vector<float>>& mel,
+    std::vector<float> infer(const MelBuffer& mel,
                               const std::vector<float>& f0);
     
     /**
@@ -53,7 +55,7 @@ public:
      * @param pitchShiftSemitones Pitch shift in semitones (+12 = one octave up)
      * @return Synthesized waveform
      */
-    std::vector<float> inferWithPitchShift(const std::vector<std::vector<float>>& mel,
+    std::vector<float> inferWithPitchShift(const MelBuffer& mel,
                                             const std::vector<float>& f0,
                                             float pitchShiftSemitones);
     
@@ -63,7 +65,7 @@ public:
      * @param f0 F0 values
      * @param callback Called with result on completion
      */
-    void inferAsync(const std::vector<std::vector<float>>& mel,
+    void inferAsync(const MelBuffer& mel,
                     const std::vector<float>& f0,
                     std::function<void(std::vector<float>)> callback,
                     std::shared_ptr<std::atomic<bool>> cancelFlag = nullptr);
@@ -81,6 +83,9 @@ public:
     // Reload model with new settings (call after changing device)
     bool reloadModel();
     
+    // Lets the benchmark suite reach internal DSP helpers
+    friend struct BenchmarkAccess;
+
 private:
     bool loaded = false;
     int sampleRate = 44100;
@@ -97,9 +102,8 @@ private:
 #endif
 
     juce::File modelFile;
-    std::unique_ptr<std::ofstream> logFile;
     
-    void log(const std::string& message);
+    void log(const std::string& message, AsyncLogger::Level level = AsyncLogger::Level::Info);
     
 #ifdef HAVE_ONNXRUNTIME
     std::unique_ptr<Ort::Env> onnxEnv;
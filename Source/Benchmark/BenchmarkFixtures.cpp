@@ -0,0 +1,142 @@
+#include "BenchmarkFixtures.h"
+#include "../Utils/Constants.h"
+#include "../Utils/MelSpectrogram.h"
+#include "../Utils/PitchCurveProcessor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Repeating melody (MIDI); every fourth note ends with an unvoiced gap
+    constexpr float MELODY[] = {60.0f, 62.0f, 64.0f, 65.0f, 67.0f, 65.0f, 64.0f, 62.0f};
+    constexpr int MELODY_LENGTH = static_cast<int>(sizeof(MELODY) / sizeof(MELODY[0]));
+    constexpr double GAP_SECONDS = 0.05;
+    constexpr int NUM_HARMONICS = 8;
+    constexpr double VIBRATO_RATE_HZ = 5.5;
+    constexpr double VIBRATO_DEPTH_SEMITONES = 0.3;
+
+    // Pitch (MIDI) at a time, or a negative value inside an unvoiced gap
+    double midiAtTime(double t)
+    {
+        const int noteIndex = static_cast<int>(t / BenchmarkFixtures::NOTE_SECONDS);
+        const double posInNote = t - noteIndex * BenchmarkFixtures::NOTE_SECONDS;
+
+        if (noteIndex % 4 == 3 && posInNote > BenchmarkFixtures::NOTE_SECONDS - GAP_SECONDS)
+            return -1.0;
+
+        const double vibrato = VIBRATO_DEPTH_SEMITONES
+                             * std::sin(2.0 * juce::MathConstants<double>::pi * VIBRATO_RATE_HZ * t);
+        return MELODY[noteIndex % MELODY_LENGTH] + vibrato;
+    }
+}
+
+namespace BenchmarkFixtures
+{
+    juce::AudioBuffer<float> makeSignal(double seconds, int sampleRate)
+    {
+        const int numSamples = static_cast<int>(seconds * sampleRate);
+        juce::AudioBuffer<float> buffer(1, numSamples);
+        auto* out = buffer.getWritePointer(0);
+
+        juce::Random random(RANDOM_SEED);
+        double phase = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double t = static_cast<double>(i) / sampleRate;
+            const double midi = midiAtTime(t);
+            const float noise = (random.nextFloat() * 2.0f - 1.0f) * 0.01f;
+
+            if (midi < 0.0)
+            {
+                out[i] = noise;
+                continue;
+            }
+
+            const double freq = 440.0 * std::pow(2.0, (midi - 69.0) / 12.0);
+            phase += 2.0 * juce::MathConstants<double>::pi * freq / sampleRate;
+            if (phase > 2.0 * juce::MathConstants<double>::pi)
+                phase -= 2.0 * juce::MathConstants<double>::pi;
+
+            double sample = 0.0;
+            for (int h = 1; h <= NUM_HARMONICS; ++h)
+                sample += std::sin(phase * h) / h;
+
+            out[i] = static_cast<float>(0.25 * sample) + noise;
+        }
+
+        return buffer;
+    }
+
+    std::vector<float> makeReferenceF0(int numFrames)
+    {
+        std::vector<float> f0(static_cast<size_t>(numFrames), 0.0f);
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const double midi = midiAtTime(framesToSeconds(i));
+            if (midi >= 0.0)
+                f0[static_cast<size_t>(i)] = midiToFreq(static_cast<float>(midi));
+        }
+        return f0;
+    }
+
+    void buildProject(Project& project, double seconds)
+    {
+        auto& audioData = project.getAudioData();
+        audioData.waveform = makeSignal(seconds, SAMPLE_RATE);
+        audioData.sampleRate = SAMPLE_RATE;
+
+        MelSpectrogram melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+        audioData.melSpectrogram = melComputer.compute(audioData.waveform.getReadPointer(0),
+                                                       audioData.waveform.getNumSamples());
+
+        const int numFrames = audioData.getNumFrames();
+        audioData.f0 = makeReferenceF0(numFrames);
+        audioData.voicedMask.resize(static_cast<size_t>(numFrames));
+        for (int i = 0; i < numFrames; ++i)
+            audioData.voicedMask[static_cast<size_t>(i)] = audioData.f0[static_cast<size_t>(i)] > 0.0f;
+
+        project.clearNotes();
+        const int numNotes = static_cast<int>(seconds / NOTE_SECONDS);
+        for (int n = 0; n < numNotes; ++n)
+        {
+            const int start = secondsToFrames(static_cast<float>(n * NOTE_SECONDS));
+            const int end = std::min(numFrames, secondsToFrames(static_cast<float>((n + 1) * NOTE_SECONDS)));
+            if (end > start)
+                project.addNote(Note(start, end, MELODY[n % MELODY_LENGTH]));
+        }
+
+        audioData.f0 = PitchCurveProcessor::interpolateWithUvMask(audioData.f0, audioData.voicedMask);
+        PitchCurveProcessor::rebuildCurvesFromSource(project, audioData.f0);
+        project.setName("benchmark");
+    }
+
+    juce::var describe(const Project& project, double seconds)
+    {
+        // Bytes per component, so layout changes show up next to the timings
+        auto* memory = new juce::DynamicObject();
+        const auto report = project.getMemoryReport();
+        for (const auto& entry : report.entries)
+            memory->setProperty(juce::Identifier(entry.component), static_cast<juce::int64>(entry.bytes));
+        memory->setProperty("total", static_cast<juce::int64>(report.getTotalBytes()));
+
+        // Mel footprint per storage format
+        auto* melStorage = new juce::DynamicObject();
+        MelBuffer mel(project.getAudioData().melSpectrogram);
+        for (auto storage : {MelStorage::Float32, MelStorage::Float16})
+        {
+            mel.setStorage(storage);
+            melStorage->setProperty(melStorageToString(storage), static_cast<juce::int64>(mel.getMemoryBytes()));
+        }
+
+        auto* fixture = new juce::DynamicObject();
+        fixture->setProperty("seconds", seconds);
+        fixture->setProperty("sample_rate", SAMPLE_RATE);
+        fixture->setProperty("frames", secondsToFrames(static_cast<float>(seconds)));
+        fixture->setProperty("note_seconds", NOTE_SECONDS);
+        fixture->setProperty("seed", RANDOM_SEED);
+        fixture->setProperty("memory_bytes", juce::var(memory));
+        fixture->setProperty("mel_storage_bytes", juce::var(melStorage));
+        return juce::var(fixture);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "../Models/Project.h"
+#include <vector>
+
+/**
+ * Deterministic inputs for the benchmark suite.
+ *
+ * The signal is a synthetic "sung" melody: harmonic tones with vibrato,
+ * short unvoiced gaps and low-level seeded noise, so every run (and every
+ * build) processes exactly the same samples. The project fixture derives
+ * mel, uv, notes and base/delta curves from that signal the same way the
+ * analyzer does, using the known melody as the source pitch.
+ */
+namespace BenchmarkFixtures
+{
+    constexpr juce::int64 RANDOM_SEED = 0x48414348;  // "HACH"
+    constexpr double NOTE_SECONDS = 0.3;
+
+    /** Mono vocal-like signal at the given rate. */
+    juce::AudioBuffer<float> makeSignal(double seconds, int sampleRate);
+
+    /** Ground-truth pitch (Hz, 0 = unvoiced) per vocoder frame for makeSignal. */
+    std::vector<float> makeReferenceF0(int numFrames);
+
+    /**
+     * Fill a project with waveform, mel, f0, uv mask, notes and base/delta
+     * curves for a signal of the given length.
+     */
+    void buildProject(Project& project, double seconds);
+
+    /** Description of the fixture (including its memory report) for the JSON report. */
+    juce::var describe(const Project& project, double seconds);
+}
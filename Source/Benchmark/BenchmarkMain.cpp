@@ -0,0 +1,379 @@
+/*
+    PitchEditorBenchmark - microbenchmarks for the analysis, curve and
+    synthesis hot paths. Prints a JSON report (see BenchmarkRunner).
+
+    Usage: PitchEditorBenchmark [--seconds 30] [--iterations 10] [--warmup 2]
+                                [--filter <text>] [--models <dir>]
+                                [--baseline <report.json>] [--output <file>]
+*/
+
+#include "BenchmarkFixtures.h"
+#include "BenchmarkRunner.h"
+#include "../Audio/FCPEPitchDetector.h"
+#include "../Audio/PitchDetector.h"
+#include "../Audio/RMVPEPitchDetector.h"
+#include "../Audio/SOMEDetector.h"
+#include "../Audio/Vocoder.h"
+#include "../Models/Project.h"
+#include "../Utils/BasePitchCurve.h"
+#include "../Utils/Constants.h"
+#include "../Utils/F0Smoother.h"
+#include "../Utils/MelSpectrogram.h"
+#include "../Utils/PitchCurveProcessor.h"
+#include "../Utils/PitchSalience.h"
+#include "../Utils/Resampler.h"
+#include <iostream>
+
+/**
+ * Access to private helpers that have no public entry point but are hot
+ * paths worth tracking on their own (declared friend in those classes).
+ */
+struct BenchmarkAccess
+{
+    static std::vector<float> sineFallback(Vocoder& vocoder, const std::vector<float>& f0)
+    {
+        return vocoder.generateSineFallback(f0);
+    }
+};
+
+namespace
+{
+    struct Settings
+    {
+        BenchmarkRunner::Options runner;
+        double seconds = 30.0;
+        juce::File modelsDir;
+        juce::File outputFile;
+    };
+
+    bool parseArguments(const juce::StringArray& args, Settings& settings, juce::String& error)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            auto nextValue = [&]() -> juce::String {
+                if (i + 1 >= args.size())
+                {
+                    error = "missing value for " + arg;
+                    return {};
+                }
+                return args[++i];
+            };
+
+            if (arg == "--seconds")
+                settings.seconds = juce::jlimit(1.0, 600.0, nextValue().getDoubleValue());
+            else if (arg == "--iterations")
+                settings.runner.iterations = nextValue().getIntValue();
+            else if (arg == "--warmup")
+                settings.runner.warmupIterations = nextValue().getIntValue();
+            else if (arg == "--filter")
+                settings.runner.filter = nextValue();
+            else if (arg == "--models")
+                settings.modelsDir = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+            else if (arg == "--baseline")
+                settings.runner.baselineFile = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+            else if (arg == "--output")
+                settings.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(nextValue());
+            else
+                error = "unknown option: " + arg;
+
+            if (error.isNotEmpty())
+                return false;
+        }
+
+        // The benchmark is a plain executable (no bundle), so models are
+        // copied next to it on every platform
+        if (settings.modelsDir == juce::File())
+            settings.modelsDir = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                                     .getParentDirectory()
+                                     .getChildFile("models");
+        return true;
+    }
+
+    void addCoreBenchmarks(BenchmarkRunner& runner, const Settings& settings, const Project& fixture)
+    {
+        const double seconds = settings.seconds;
+        const auto& audioData = fixture.getAudioData();
+        const float* audio = audioData.waveform.getReadPointer(0);
+        const int numSamples = audioData.waveform.getNumSamples();
+        const int numFrames = audioData.getNumFrames();
+
+        // Shared sink so results are observable and cannot be optimized away
+        auto sink = std::make_shared<std::vector<float>>();
+
+        runner.add("dsp", "mel_spectrogram", seconds, [=]() {
+            MelSpectrogram mel(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN, FMAX);
+            auto result = mel.compute(audio, numSamples);
+            sink->assign(1, static_cast<float>(result.getNumFrames()));
+        });
+
+        runner.add("dsp", "yin_extract_f0", seconds, [=]() {
+            PitchDetector detector(SAMPLE_RATE, HOP_SIZE);
+            *sink = detector.extractF0(audio, numSamples).first;
+        });
+
+        runner.add("dsp", "f0_smooth", seconds, [=, &audioData]() {
+            *sink = F0Smoother::smoothF0(audioData.f0, audioData.voicedMask);
+            *sink = PitchCurveProcessor::interpolateWithUvMask(*sink, audioData.voicedMask);
+        });
+
+        // Resampler at the ratios used by file import (48k -> 44.1k), the
+        // detectors (44.1k -> 16k) and host playback (44.1k -> 48k)
+        auto input48k = std::make_shared<juce::AudioBuffer<float>>(BenchmarkFixtures::makeSignal(seconds, 48000));
+        runner.add("resample", "file_48k_to_44k", seconds, [=]() {
+            *sink = Resampler::resample(input48k->getReadPointer(0), input48k->getNumSamples(), 48000, SAMPLE_RATE);
+        });
+
+        runner.add("resample", "detector_44k_to_16k", seconds, [=]() {
+            *sink = Resampler::resample(audio, numSamples, SAMPLE_RATE, 16000, Resampler::Quality::Fast);
+        });
+
+        runner.add("resample", "playback_44k_to_48k", seconds, [=]() {
+            *sink = Resampler::resample(audio, numSamples, SAMPLE_RATE, 48000);
+        });
+
+        runner.add("resample", "high_quality_44k_to_16k", seconds, [=]() {
+            *sink = Resampler::resample(audio, numSamples, SAMPLE_RATE, 16000);
+        });
+
+        runner.add("resample", "stream_48k_to_44k", seconds, [=]() {
+            Resampler resampler(48000, SAMPLE_RATE);
+            sink->clear();
+            const float* in = input48k->getReadPointer(0);
+            const int total = input48k->getNumSamples();
+            for (int pos = 0; pos < total; pos += 4096)
+                resampler.processBlock(in + pos, std::min(4096, total - pos), *sink);
+            resampler.flush(*sink);
+        });
+
+        // Pitch curves
+        auto segments = std::make_shared<std::vector<BasePitchCurve::NoteSegment>>();
+        for (const auto& note : fixture.getNotes())
+            segments->push_back({note.getStartFrame(), note.getEndFrame(), note.getAdjustedMidiNote()});
+
+        // Mel storage: half-precision encode, range decode into a reused
+        // scratch buffer (incremental synthesis) and the full row walk the
+        // vocoder does while transposing its input
+        auto melHalf = std::make_shared<MelBuffer>(audioData.melSpectrogram);
+        melHalf->setStorage(MelStorage::Float16);
+
+        runner.add("mel", "encode_fp16", seconds, [=, &audioData]() {
+            MelBuffer encoded(audioData.melSpectrogram);
+            encoded.setStorage(MelStorage::Float16);
+            sink->assign(1, static_cast<float>(encoded.getMemoryBytes()));
+        });
+
+        for (const auto* mel : {&audioData.melSpectrogram, melHalf.get()})
+        {
+            const juce::String suffix = melStorageToString(mel->getStorage());
+            const int melFrames = mel->getNumFrames();
+            const int decodeStart = std::max(0, melFrames / 2 - secondsToFrames(0.5f));
+            const int decodeEnd = std::min(melFrames, decodeStart + secondsToFrames(1.0f));
+            auto scratch = std::make_shared<MelBuffer>();
+
+            runner.add("mel", "decode_range_" + suffix, 1.0, [=]() {
+                mel->decodeRange(decodeStart, decodeEnd, *scratch);
+            });
+
+            runner.add("mel", "read_rows_" + suffix, seconds, [=]() {
+                std::vector<float> row(static_cast<size_t>(mel->getNumMels()));
+                float sum = 0.0f;
+                for (int frame = 0; frame < melFrames; ++frame)
+                    sum += mel->readFrame(frame, row.data())[0];
+                sink->assign(1, sum);
+            });
+        }
+
+        runner.add("curves", "base_pitch_generate", seconds, [=]() {
+            *sink = BasePitchCurve::generateForNotes(*segments, numFrames);
+        });
+
+        // Re-pitch one note in the middle of the song (should not scale with length)
+        if (!segments->empty())
+        {
+            auto editedBase = std::make_shared<std::vector<float>>(BasePitchCurve::generateForNotes(*segments, numFrames));
+            const auto& edited = (*segments)[segments->size() / 2];
+            runner.add("curves", "base_pitch_note_edit", seconds, [=]() {
+                BasePitchCurve::regenerateRange(*segments, edited.startFrame, edited.endFrame, *editedBase);
+            });
+        }
+
+        runner.add("curves", "compose_f0", seconds, [=, &fixture]() {
+            *sink = PitchCurveProcessor::composeF0(fixture, true, 0.5f);
+        });
+
+        runner.add("curves", "adjusted_f0", seconds, [=, &fixture]() {
+            *sink = fixture.getAdjustedF0();
+        });
+
+        // One second around the middle, as the incremental synthesizer asks for
+        const int rangeStart = std::max(0, numFrames / 2 - secondsToFrames(0.5f));
+        const int rangeEnd = std::min(numFrames, rangeStart + secondsToFrames(1.0f));
+        runner.add("curves", "adjusted_f0_range", 1.0, [=, &fixture]() {
+            *sink = fixture.getAdjustedF0ForRange(rangeStart, rangeEnd);
+        });
+
+        // Salience re-decode (random salience with the RMVPE bin layout)
+        auto salience = std::make_shared<PitchSalience>();
+        {
+            const int salienceFrames = static_cast<int>(seconds * 100.0);
+            std::vector<float> cents(PitchSalience::NUM_BINS);
+            for (int i = 0; i < PitchSalience::NUM_BINS; ++i)
+                cents[static_cast<size_t>(i)] = i * 20.0f + RMVPEPitchDetector::CONST;
+
+            std::vector<float> raw(static_cast<size_t>(salienceFrames) * PitchSalience::NUM_BINS);
+            juce::Random random(BenchmarkFixtures::RANDOM_SEED);
+            for (auto& v : raw)
+                v = random.nextFloat();
+
+            salience->reset(0.01, std::move(cents), RMVPEPitchDetector::DEFAULT_THRESHOLD);
+            salience->appendFrames(raw.data(), salienceFrames);
+        }
+        runner.add("curves", "salience_decode", seconds, [=]() {
+            *sink = salience->decode(0.5f);
+        });
+
+        // Project persistence
+        runner.add("project", "to_xml", seconds, [=, &fixture]() {
+            auto xml = fixture.toXml();
+            sink->assign(1, static_cast<float>(xml->getNumChildElements()));
+        });
+
+        auto serialized = std::make_shared<juce::String>(fixture.toXml()->toString());
+        runner.add("project", "from_xml", seconds, [=]() {
+            Project project;
+            auto xml = juce::XmlDocument::parse(*serialized);
+            if (xml != nullptr)
+                project.fromXml(*xml);
+            sink->assign(1, static_cast<float>(project.getNotes().size()));
+        });
+
+        // Binary format with the cached mel and waveform
+        auto binaryFile = std::make_shared<juce::TemporaryFile>(".peproj");
+        fixture.saveToFile(binaryFile->getFile());
+
+        runner.add("project", "save_binary", seconds, [=, &fixture]() {
+            const bool ok = fixture.saveToFile(binaryFile->getFile());
+            sink->assign(1, ok ? 1.0f : 0.0f);
+        });
+
+        runner.add("project", "load_binary", seconds, [=]() {
+            Project project;
+            project.loadFromFile(binaryFile->getFile());
+            sink->assign(1, static_cast<float>(project.getAudioData().getNumFrames()));
+        });
+
+        // Synthesis fallback path (no model required)
+        auto vocoder = std::make_shared<Vocoder>();
+        runner.add("synthesis", "sine_fallback", seconds, [=, &audioData]() {
+            *sink = BenchmarkAccess::sineFallback(*vocoder, audioData.f0);
+        });
+    }
+
+    void addOnnxBenchmarks(BenchmarkRunner& runner, const Settings& settings, const Project& fixture)
+    {
+        const auto modelsDir = settings.modelsDir;
+        const char* group = "onnx";
+
+#ifdef HAVE_ONNXRUNTIME
+        const double seconds = settings.seconds;
+        const auto& audioData = fixture.getAudioData();
+        const float* audio = audioData.waveform.getReadPointer(0);
+        const int numSamples = audioData.waveform.getNumSamples();
+        auto sink = std::make_shared<std::vector<float>>();
+
+        auto rmvpe = std::make_shared<RMVPEPitchDetector>();
+        if (rmvpe->loadModel(modelsDir.getChildFile("rmvpe.onnx")))
+            runner.add(group, "rmvpe_extract_f0", seconds, [=]() {
+                *sink = rmvpe->extractF0(audio, numSamples, SAMPLE_RATE);
+            });
+        else
+            runner.skip(group, "rmvpe_extract_f0", "rmvpe.onnx not loaded");
+
+        auto fcpe = std::make_shared<FCPEPitchDetector>();
+        if (fcpe->loadModel(modelsDir.getChildFile("fcpe.onnx"),
+                            modelsDir.getChildFile("mel_filterbank.bin"),
+                            modelsDir.getChildFile("cent_table.bin")))
+            runner.add(group, "fcpe_extract_f0", seconds, [=]() {
+                *sink = fcpe->extractF0(audio, numSamples, SAMPLE_RATE);
+            });
+        else
+            runner.skip(group, "fcpe_extract_f0", "fcpe.onnx not loaded");
+
+        auto some = std::make_shared<SOMEDetector>();
+        if (some->loadModel(modelsDir.getChildFile("some.onnx")))
+            runner.add(group, "some_detect_notes", seconds, [=]() {
+                auto notes = some->detectNotes(audio, numSamples, SAMPLE_RATE);
+                sink->assign(1, static_cast<float>(notes.size()));
+            });
+        else
+            runner.skip(group, "some_detect_notes", "some.onnx not loaded");
+
+        auto vocoder = std::make_shared<Vocoder>();
+        if (vocoder->loadModel(modelsDir.getChildFile("pc_nsf_hifigan.onnx")))
+            runner.add(group, "vocoder_infer", seconds, [=, &fixture]() {
+                *sink = vocoder->infer(fixture.getAudioData().melSpectrogram, fixture.getAdjustedF0());
+            });
+        else
+            runner.skip(group, "vocoder_infer", "pc_nsf_hifigan.onnx not loaded");
+
+        // Same synthesis from a half-precision mel (decode overhead)
+        auto melHalf = std::make_shared<MelBuffer>(audioData.melSpectrogram);
+        melHalf->setStorage(MelStorage::Float16);
+        if (vocoder->isLoaded())
+            runner.add(group, "vocoder_infer_fp16", seconds, [=, &fixture]() {
+                *sink = vocoder->infer(*melHalf, fixture.getAdjustedF0());
+            });
+        else
+            runner.skip(group, "vocoder_infer_fp16", "pc_nsf_hifigan.onnx not loaded");
+#else
+        juce::ignoreUnused(fixture);
+        for (auto* name : {"rmvpe_extract_f0", "fcpe_extract_f0", "some_detect_notes", "vocoder_infer",
+                           "vocoder_infer_fp16"})
+            runner.skip(group, name, "built without ONNX Runtime (" + modelsDir.getFullPathName() + ")");
+#endif
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::String::fromUTF8(argv[i]));
+
+    Settings settings;
+    juce::String error;
+    if (!parseArguments(args, settings, error))
+    {
+        std::cerr << error << "\n"
+                  << "Usage: PitchEditorBenchmark [--seconds s] [--iterations n] [--warmup n]\n"
+                  << "       [--filter text] [--models dir] [--baseline report.json] [--output file]\n";
+        return 2;
+    }
+
+    Project fixture;
+    BenchmarkFixtures::buildProject(fixture, settings.seconds);
+
+    BenchmarkRunner runner(settings.runner);
+    addCoreBenchmarks(runner, settings, fixture);
+    addOnnxBenchmarks(runner, settings, fixture);
+
+    auto report = runner.toJson(runner.runAll(), BenchmarkFixtures::describe(fixture, settings.seconds));
+
+    if (settings.outputFile != juce::File())
+    {
+        if (!settings.outputFile.replaceWithText(report))
+        {
+            std::cerr << "cannot write " << settings.outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << report << std::endl;
+    }
+
+    return 0;
+}
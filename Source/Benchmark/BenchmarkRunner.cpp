@@ -0,0 +1,173 @@
+#include "BenchmarkRunner.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <numeric>
+
+namespace
+{
+    double ticksToMs(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    }
+
+    juce::String getCompilerString()
+    {
+    #if defined(__clang__)
+        return "clang " __clang_version__;
+    #elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+    #elif defined(_MSC_VER)
+        return "msvc " + juce::String(_MSC_VER);
+    #else
+        return "unknown";
+    #endif
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner(Options opts) : options(std::move(opts))
+{
+    options.warmupIterations = std::max(0, options.warmupIterations);
+    options.iterations = std::max(1, options.iterations);
+}
+
+void BenchmarkRunner::add(const juce::String& group, const juce::String& name, double workSeconds,
+                          std::function<void()> run)
+{
+    if (options.filter.isNotEmpty() && !(group + "." + name).containsIgnoreCase(options.filter))
+        return;
+
+    cases.push_back({name, group, workSeconds, std::move(run)});
+}
+
+void BenchmarkRunner::skip(const juce::String& group, const juce::String& name, const juce::String& reason)
+{
+    if (options.filter.isNotEmpty() && !(group + "." + name).containsIgnoreCase(options.filter))
+        return;
+
+    skipped.set(group + "." + name, reason);
+}
+
+std::vector<BenchmarkRunner::Result> BenchmarkRunner::runAll()
+{
+    std::vector<Result> results;
+    results.reserve(cases.size());
+
+    for (const auto& benchCase : cases)
+    {
+        std::cerr << "[bench] " << benchCase.group << "." << benchCase.name << std::flush;
+
+        for (int i = 0; i < options.warmupIterations; ++i)
+            benchCase.run();
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<size_t>(options.iterations));
+        for (int i = 0; i < options.iterations; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            benchCase.run();
+            samples.push_back(ticksToMs(juce::Time::getHighResolutionTicks() - start));
+        }
+
+        results.push_back(summarize(benchCase, std::move(samples)));
+        std::cerr << "  median " << results.back().medianMs << " ms" << std::endl;
+    }
+
+    return results;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::summarize(const Case& benchCase, std::vector<double> samplesMs)
+{
+    Result r;
+    r.name = benchCase.name;
+    r.group = benchCase.group;
+    r.iterations = static_cast<int>(samplesMs.size());
+
+    std::sort(samplesMs.begin(), samplesMs.end());
+    const size_t n = samplesMs.size();
+
+    r.minMs = samplesMs.front();
+    r.medianMs = (n % 2 == 1) ? samplesMs[n / 2] : 0.5 * (samplesMs[n / 2 - 1] + samplesMs[n / 2]);
+    r.meanMs = std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0) / static_cast<double>(n);
+    r.p95Ms = samplesMs[std::min(n - 1, static_cast<size_t>(std::ceil(0.95 * static_cast<double>(n))) - 1)];
+
+    double variance = 0.0;
+    for (double s : samplesMs)
+        variance += (s - r.meanMs) * (s - r.meanMs);
+    r.stddevMs = std::sqrt(variance / static_cast<double>(n));
+
+    if (benchCase.workSeconds > 0.0 && r.medianMs > 0.0)
+        r.realtimeFactor = benchCase.workSeconds / (r.medianMs / 1000.0);
+
+    return r;
+}
+
+juce::String BenchmarkRunner::toJson(const std::vector<Result>& results, const juce::var& fixture) const
+{
+    // Median of each case in the baseline report, keyed by "group.name"
+    std::map<juce::String, double> baseline;
+    if (options.baselineFile.existsAsFile())
+    {
+        auto parsed = juce::JSON::parse(options.baselineFile);
+        if (auto* entries = parsed["results"].getArray())
+            for (const auto& entry : *entries)
+                baseline[entry["group"].toString() + "." + entry["name"].toString()]
+                    = static_cast<double>(entry["median_ms"]);
+    }
+
+    juce::Array<juce::var> entries;
+    for (const auto& r : results)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("group", r.group);
+        entry->setProperty("name", r.name);
+        entry->setProperty("iterations", r.iterations);
+        entry->setProperty("min_ms", r.minMs);
+        entry->setProperty("median_ms", r.medianMs);
+        entry->setProperty("mean_ms", r.meanMs);
+        entry->setProperty("p95_ms", r.p95Ms);
+        entry->setProperty("stddev_ms", r.stddevMs);
+        if (r.realtimeFactor > 0.0)
+            entry->setProperty("realtime_factor", r.realtimeFactor);
+
+        auto it = baseline.find(r.group + "." + r.name);
+        if (it != baseline.end() && it->second > 0.0)
+        {
+            entry->setProperty("baseline_median_ms", it->second);
+            entry->setProperty("speedup", it->second / r.medianMs);
+        }
+
+        entries.add(juce::var(entry));
+    }
+
+    auto* skippedObj = new juce::DynamicObject();
+    for (const auto& key : skipped.getAllKeys())
+        skippedObj->setProperty(key, skipped[key]);
+
+    auto* build = new juce::DynamicObject();
+    build->setProperty("version", juce::String(JUCE_APPLICATION_VERSION_STRING));
+    build->setProperty("compiler", getCompilerString());
+    build->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    build->setProperty("cpu", juce::SystemStats::getCpuModel());
+    build->setProperty("cores", juce::SystemStats::getNumCpus());
+#if JUCE_DEBUG
+    build->setProperty("config", "Debug");
+#else
+    build->setProperty("config", "Release");
+#endif
+#ifdef HAVE_ONNXRUNTIME
+    build->setProperty("onnxruntime", true);
+#else
+    build->setProperty("onnxruntime", false);
+#endif
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("build", juce::var(build));
+    root->setProperty("fixture", fixture);
+    root->setProperty("warmup_iterations", options.warmupIterations);
+    root->setProperty("results", entries);
+    root->setProperty("skipped", juce::var(skippedObj));
+    return juce::JSON::toString(juce::var(root));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <functional>
+#include <vector>
+
+/**
+ * Minimal microbenchmark harness for the PitchEditorBenchmark target.
+ *
+ * Each case runs a number of warmup iterations followed by measured
+ * iterations; per-iteration wall times are reduced to min / median / mean /
+ * p95 / stddev. Results are written as JSON so two builds can be compared
+ * (optionally against a previous report passed as the baseline).
+ */
+class BenchmarkRunner
+{
+public:
+    struct Options
+    {
+        int warmupIterations = 2;
+        int iterations = 10;
+        juce::String filter;        // Only run cases whose name contains this
+        juce::File baselineFile;    // Previous JSON report to compare against
+    };
+
+    struct Case
+    {
+        juce::String name;
+        juce::String group;
+        double workSeconds = 0.0;   // Audio duration processed per iteration (0 = n/a)
+        std::function<void()> run;
+    };
+
+    struct Result
+    {
+        juce::String name;
+        juce::String group;
+        int iterations = 0;
+        double minMs = 0.0;
+        double medianMs = 0.0;
+        double meanMs = 0.0;
+        double p95Ms = 0.0;
+        double stddevMs = 0.0;
+        double realtimeFactor = 0.0;  // workSeconds / median, 0 if not applicable
+    };
+
+    explicit BenchmarkRunner(Options options);
+
+    void add(const juce::String& group, const juce::String& name, double workSeconds,
+             std::function<void()> run);
+
+    /** Record a case that could not run (e.g. model not present). */
+    void skip(const juce::String& group, const juce::String& name, const juce::String& reason);
+
+    /** Run every registered case in registration order. */
+    std::vector<Result> runAll();
+
+    /** Build the JSON report; fixture describes the inputs used. */
+    juce::String toJson(const std::vector<Result>& results, const juce::var& fixture) const;
+
+private:
+    static Result summarize(const Case& benchCase, std::vector<double> samplesMs);
+
+    Options options;
+    std::vector<Case> cases;
+    juce::StringPairArray skipped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkRunner)
+};
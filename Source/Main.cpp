@@ -2,11 +2,14 @@
 // MainComponent)
 
 #include "JuceHeader.h"
+#include "Audio/Batch/BatchProcessor.h"
 #include "UI/MainComponent.h"
 #include "Utils/AppLogger.h"
 #include "Utils/Constants.h"
 #include "Utils/Localization.h"
 #include "Utils/PlatformUtils.h"
+#include "Utils/Tracer.h"
+#include <iostream>
 
 #if JUCE_WINDOWS
 #include <dwmapi.h>
@@ -24,8 +27,15 @@ public:
   bool moreThanOneInstanceAllowed() override { return true; }
 
   void initialise(const juce::String &commandLine) override {
-    juce::ignoreUnused(commandLine);
+    if (BatchProcessor::isBatchCommandLine(commandLine)) {
+      runBatch(commandLine);
+      return;
+    }
+
     LOG("========== APP STARTING ==========");
+    traceFile = getTraceFile(commandLine);
+    if (traceFile != juce::File())
+      Tracer::setEnabled(true);
     LOG("Loading localization...");
     Localization::loadFromSettings();
     LOG("Localization loaded, creating MainWindow...");
@@ -33,7 +43,16 @@ public:
     LOG("MainWindow created and visible");
   }
 
-  void shutdown() override { mainWindow = nullptr; }
+  void shutdown() override {
+    mainWindow = nullptr;
+
+    if (traceFile != juce::File()) {
+      if (Tracer::exportChromeTrace(traceFile.getFullPathName().toStdString()))
+        LOG("Trace written to " + traceFile.getFullPathName());
+      else
+        LOG("Could not write trace to " + traceFile.getFullPathName());
+    }
+  }
 
   void systemRequestedQuit() override { quit(); }
 
@@ -110,7 +129,37 @@ public:
   };
 
 private:
+  // --trace <file>: write a Chrome trace of the session on quit
+  static juce::File getTraceFile(const juce::String &commandLine) {
+    auto args = juce::StringArray::fromTokens(commandLine, true);
+    const int index = args.indexOf("--trace");
+    if (index < 0 || index + 1 >= args.size())
+      return {};
+    return juce::File::getCurrentWorkingDirectory().getChildFile(
+        args[index + 1].unquoted());
+  }
+
+  // Headless mode: no windows are created, the process exits when done
+  void runBatch(const juce::String &commandLine) {
+    BatchProcessor::Options options;
+    juce::String error;
+    if (!BatchProcessor::parseCommandLine(commandLine, options, error)) {
+      std::cerr << "Error: " << error << "\n\n"
+                << BatchProcessor::getUsage() << std::endl;
+      setApplicationReturnValue(2);
+      quit();
+      return;
+    }
+
+    LOG("Batch mode: " + juce::String(options.inputs.size()) + " file(s), " +
+        juce::String(options.jobs) + " job(s)");
+    BatchProcessor processor(std::move(options));
+    setApplicationReturnValue(processor.run());
+    quit();
+  }
+
   std::unique_ptr<MainWindow> mainWindow;
+  juce::File traceFile;
 };
 
 START_JUCE_APPLICATION(PitchEditorApplication)
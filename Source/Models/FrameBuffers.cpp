@@ -0,0 +1,273 @@
+#include "FrameBuffers.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__F16C__) || defined(__AVX2__)
+#include <immintrin.h>
+#define FRAME_BUFFERS_USE_F16C 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FRAME_BUFFERS_USE_NEON 1
+#endif
+
+namespace
+{
+    // IEEE binary16 conversion, round to nearest even. Matches the hardware
+    // instructions used below, so results do not depend on block alignment.
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        const uint32_t absBits = bits & 0x7fffffffu;
+
+        if (absBits >= 0x7f800000u)                       // Inf / NaN
+            return static_cast<uint16_t>(sign | (absBits > 0x7f800000u ? 0x7e00u : 0x7c00u));
+        if (absBits >= 0x477ff000u)                       // Rounds past 65504
+            return static_cast<uint16_t>(sign | 0x7c00u);
+
+        if (absBits < 0x38800000u)                        // Half subnormal or zero
+        {
+            if (absBits < 0x33000000u)
+                return static_cast<uint16_t>(sign);
+
+            const uint32_t mantissa = (absBits & 0x7fffffu) | 0x800000u;
+            const uint32_t shift = 126u - (absBits >> 23);
+            const uint32_t rest = mantissa & ((1u << shift) - 1u);
+            const uint32_t halfway = 1u << (shift - 1u);
+            uint32_t result = mantissa >> shift;
+            if (rest > halfway || (rest == halfway && (result & 1u)))
+                ++result;
+            return static_cast<uint16_t>(sign | result);
+        }
+
+        // Rebias the exponent (127 -> 15); a mantissa carry rolls into it correctly
+        uint32_t result = (absBits - 0x38000000u) >> 13;
+        const uint32_t rest = absBits & 0x1fffu;
+        if (rest > 0x1000u || (rest == 0x1000u && (result & 1u)))
+            ++result;
+        return static_cast<uint16_t>(sign | result);
+    }
+
+    float halfToFloat(uint16_t half)
+    {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1fu;
+        const uint32_t mantissa = half & 0x3ffu;
+
+        uint32_t bits;
+        if (exponent == 0)
+        {
+            // Zero or subnormal: mantissa * 2^-24
+            const float magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+            std::memcpy(&bits, &magnitude, sizeof(bits));
+            bits |= sign;
+        }
+        else if (exponent == 31)
+        {
+            bits = sign | 0x7f800000u | (mantissa << 13);
+        }
+        else
+        {
+            bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void encodeHalves(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if FRAME_BUFFERS_USE_F16C
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+#elif FRAME_BUFFERS_USE_NEON
+        for (; i + 4 <= count; i += 4)
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+#endif
+        for (; i < count; ++i)
+            dst[i] = floatToHalf(src[i]);
+    }
+
+    void decodeHalves(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#if FRAME_BUFFERS_USE_F16C
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(packed));
+        }
+#elif FRAME_BUFFERS_USE_NEON
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+#endif
+        for (; i < count; ++i)
+            dst[i] = halfToFloat(src[i]);
+    }
+}
+
+MelBuffer::MelBuffer(int frames, int mels, MelStorage initialStorage)
+    : storage(initialStorage)
+{
+    resize(frames, mels);
+}
+
+void MelBuffer::resize(int frames, int mels)
+{
+    frames = std::max(0, frames);
+    mels = std::max(0, mels);
+    const size_t count = static_cast<size_t>(frames) * static_cast<size_t>(mels);
+
+    // A changed row length would misalign existing rows, so start over
+    if (storage == MelStorage::Float16)
+    {
+        if (mels != numMels)
+            halves.assign(count, 0);
+        else
+            halves.resize(count, 0);
+    }
+    else
+    {
+        if (mels != numMels)
+            values.assign(count, 0.0f);
+        else
+            values.resize(count, 0.0f);
+    }
+
+    numFrames = frames;
+    numMels = mels;
+}
+
+void MelBuffer::clear()
+{
+    values.clear();
+    values.shrink_to_fit();
+    halves.clear();
+    halves.shrink_to_fit();
+    numFrames = 0;
+    numMels = 0;
+}
+
+void MelBuffer::setStorage(MelStorage newStorage)
+{
+    if (newStorage == storage)
+        return;
+
+    const size_t count = offsetOf(numFrames);
+    if (newStorage == MelStorage::Float16)
+    {
+        halves.resize(count);
+        encodeHalves(values.data(), halves.data(), count);
+        values.clear();
+        values.shrink_to_fit();
+    }
+    else
+    {
+        values.resize(count);
+        decodeHalves(halves.data(), values.data(), count);
+        halves.clear();
+        halves.shrink_to_fit();
+    }
+
+    storage = newStorage;
+}
+
+void* MelBuffer::getStorageData()
+{
+    return storage == MelStorage::Float32 ? static_cast<void*>(values.data()) : static_cast<void*>(halves.data());
+}
+
+const void* MelBuffer::getStorageData() const
+{
+    return storage == MelStorage::Float32 ? static_cast<const void*>(values.data())
+                                          : static_cast<const void*>(halves.data());
+}
+
+size_t MelBuffer::getStorageBytes() const
+{
+    return offsetOf(numFrames) * (storage == MelStorage::Float32 ? sizeof(float) : sizeof(uint16_t));
+}
+
+const float* MelBuffer::readFrame(int frame, float* scratch) const
+{
+    if (storage == MelStorage::Float32)
+        return values.data() + offsetOf(frame);
+
+    decodeHalves(halves.data() + offsetOf(frame), scratch, static_cast<size_t>(numMels));
+    return scratch;
+}
+
+void MelBuffer::decodeRange(int startFrame, int endFrame, MelBuffer& dest) const
+{
+    startFrame = std::max(0, startFrame);
+    endFrame = std::min(numFrames, endFrame);
+    const int count = std::max(0, endFrame - startFrame);
+
+    dest.setStorage(MelStorage::Float32);
+    dest.resize(count, numMels);
+    if (count == 0)
+        return;
+
+    const size_t valueCount = offsetOf(count);
+    if (storage == MelStorage::Float32)
+        std::copy_n(values.data() + offsetOf(startFrame), valueCount, dest.values.data());
+    else
+        decodeHalves(halves.data() + offsetOf(startFrame), dest.values.data(), valueCount);
+}
+
+MelBuffer MelBuffer::getRange(int startFrame, int endFrame) const
+{
+    startFrame = std::max(0, startFrame);
+    endFrame = std::min(numFrames, endFrame);
+
+    MelBuffer range;
+    range.storage = storage;
+    if (endFrame <= startFrame)
+        return range;
+
+    range.resize(endFrame - startFrame, numMels);
+    if (storage == MelStorage::Float32)
+        std::copy(values.data() + offsetOf(startFrame), values.data() + offsetOf(endFrame), range.values.data());
+    else
+        std::copy(halves.data() + offsetOf(startFrame), halves.data() + offsetOf(endFrame), range.halves.data());
+    return range;
+}
+
+bool MelBuffer::setRange(int startFrame, const MelBuffer& source)
+{
+    if (source.empty())
+        return true;
+    if (source.numMels != numMels || startFrame < 0)
+        return false;
+
+    const int count = std::min(source.numFrames, numFrames - startFrame);
+    if (count <= 0)
+        return true;
+
+    const size_t valueCount = offsetOf(count);
+    const size_t offset = offsetOf(startFrame);
+
+    if (storage == source.storage)
+    {
+        if (storage == MelStorage::Float32)
+            std::copy_n(source.values.data(), valueCount, values.data() + offset);
+        else
+            std::copy_n(source.halves.data(), valueCount, halves.data() + offset);
+    }
+    else if (storage == MelStorage::Float16)
+    {
+        encodeHalves(source.values.data(), halves.data() + offset, valueCount);
+    }
+    else
+    {
+        decodeHalves(source.halves.data(), values.data() + offset, valueCount);
+    }
+    return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../Utils/AlignedAllocator.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Per-frame feature storage used by AudioData.
+ */
+
+/**
+ * Voiced/unvoiced flag per frame (1 = voiced). One byte per frame rather
+ * than std::vector<bool>, so mask loops read plain memory and vectorize.
+ */
+using VoicedMask = std::vector<uint8_t>;
+
+/**
+ * How MelBuffer holds its values.
+ *
+ * Float16 halves the footprint (about 80 MB instead of 160 MB per hour of
+ * audio). Log-mel values stay within a few units of zero, where half
+ * precision keeps roughly three significant digits - well below what the
+ * vocoder can resolve.
+ */
+enum class MelStorage
+{
+    Float32,
+    Float16
+};
+
+/** Convert MelStorage to string for settings storage. */
+inline const char* melStorageToString(MelStorage storage)
+{
+    return storage == MelStorage::Float16 ? "float16" : "float32";
+}
+
+/** Convert string to MelStorage (unknown values mean Float32). */
+inline MelStorage stringToMelStorage(std::string_view str)
+{
+    return str == "float16" ? MelStorage::Float16 : MelStorage::Float32;
+}
+
+/**
+ * Log-mel spectrogram [T, numMels] in one contiguous, 64-byte aligned
+ * row-major block. Replaces std::vector<std::vector<float>>, which paid a
+ * separate heap block (plus its header) per frame and scattered rows
+ * across the heap.
+ *
+ * Rows are stored as float32 or, for long sessions, as float16
+ * (setStorage). Direct row access (getFrame, data) needs Float32 storage;
+ * readers that accept either go through readFrame/decodeRange, which
+ * convert into a caller-owned scratch buffer only when needed.
+ */
+class MelBuffer
+{
+public:
+    MelBuffer() = default;
+    MelBuffer(int frames, int mels, MelStorage initialStorage = MelStorage::Float32);
+
+    /** Resize to frames x mels; new values are zero. */
+    void resize(int frames, int mels);
+    void clear();
+
+    bool empty() const { return numFrames == 0; }
+    int getNumFrames() const { return numFrames; }
+    int getNumMels() const { return numMels; }
+
+    MelStorage getStorage() const { return storage; }
+
+    /** Convert the held values to the given storage (no-op if unchanged). */
+    void setStorage(MelStorage newStorage);
+
+    // Float32 storage only
+    float* getFrame(int frame) { return values.data() + static_cast<size_t>(frame) * static_cast<size_t>(numMels); }
+    const float* getFrame(int frame) const { return values.data() + static_cast<size_t>(frame) * static_cast<size_t>(numMels); }
+
+    float* data() { return values.data(); }
+    const float* data() const { return values.data(); }
+
+    /**
+     * Row of the given frame as float32. Points into the buffer for Float32
+     * storage, otherwise decodes into scratch (numMels floats) and returns it.
+     */
+    const float* readFrame(int frame, float* scratch) const;
+
+    /**
+     * Decode frames [startFrame, endFrame) (clamped) into dest as Float32.
+     * dest keeps its allocation between calls, so a long-lived scratch
+     * buffer decodes repeated ranges without touching the heap.
+     */
+    void decodeRange(int startFrame, int endFrame, MelBuffer& dest) const;
+
+    /** Copy of frames [startFrame, endFrame), clamped, in this buffer's storage. */
+    MelBuffer getRange(int startFrame, int endFrame) const;
+
+    /**
+     * Overwrite frames starting at startFrame with source's rows (clamped
+     * to this buffer), converting to this buffer's storage. Returns false
+     * if the mel sizes differ.
+     */
+    bool setRange(int startFrame, const MelBuffer& source);
+
+    /**
+     * Raw stored values (float32 or IEEE binary16 per getStorage), for
+     * persistence. getStorageBytes() covers numFrames x numMels values.
+     */
+    void* getStorageData();
+    const void* getStorageData() const;
+    size_t getStorageBytes() const;
+
+    /** Heap bytes held (capacity, not size). */
+    size_t getMemoryBytes() const
+    {
+        return values.capacity() * sizeof(float) + halves.capacity() * sizeof(uint16_t);
+    }
+
+private:
+    size_t offsetOf(int frame) const { return static_cast<size_t>(frame) * static_cast<size_t>(numMels); }
+
+    int numFrames = 0;
+    int numMels = 0;
+    MelStorage storage = MelStorage::Float32;
+    std::vector<float, AlignedAllocator<float>> values;        // Float32 storage
+    std::vector<uint16_t, AlignedAllocator<uint16_t>> halves;  // Float16 storage (IEEE binary16)
+};
@@ -1,54 +1,93 @@
 #include "Note.h"
-#include "../Utils/Constants.h"
+#include <atomic>
 
-Note::Note(int startFrame, int endFrame, float midiNote)
-    : startFrame(startFrame), endFrame(endFrame), midiNote(midiNote)
+namespace
 {
+    std::atomic<juce::uint32> flagRevision{0};
+    std::atomic<juce::uint32> frameRevision{0};
+    std::atomic<juce::uint32> lastVersion{0};
+
+    // Versions are unique across notes, so two notes never share one by accident
+    juce::uint32 nextVersion()
+    {
+        return lastVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
 }
 
-std::vector<float> Note::getAdjustedF0() const
+Note::Note(int startFrame, int endFrame, float midiNote)
+    : startFrame(startFrame), endFrame(endFrame), midiNote(midiNote), version(nextVersion())
 {
-    if (f0Values.empty() || pitchOffset == 0.0f)
-        return f0Values;
+}
 
-    // Convert semitone offset to frequency ratio
-    float ratio = std::pow(2.0f, pitchOffset / 12.0f);
+void Note::setStartFrame(int frame)
+{
+    if (startFrame == frame)
+        return;
+    startFrame = frame;
+    version = nextVersion();
+    frameRevision.fetch_add(1, std::memory_order_relaxed);
+}
 
-    std::vector<float> adjusted;
-    adjusted.reserve(f0Values.size());
+void Note::setEndFrame(int frame)
+{
+    if (endFrame == frame)
+        return;
+    endFrame = frame;
+    version = nextVersion();
+    frameRevision.fetch_add(1, std::memory_order_relaxed);
+}
 
-    for (float f0 : f0Values)
-    {
-        if (f0 > 0.0f)
-            adjusted.push_back(f0 * ratio);
-        else
-            adjusted.push_back(0.0f);
-    }
+void Note::setMidiNote(float note)
+{
+    if (midiNote == note)
+        return;
+    midiNote = note;
+    version = nextVersion();
+}
 
-    return adjusted;
+void Note::setPitchOffset(float offset)
+{
+    if (pitchOffset == offset)
+        return;
+    pitchOffset = offset;
+    version = nextVersion();
 }
 
-std::vector<float> Note::computeF0FromDelta() const
+void Note::setRest(bool r)
 {
-    int numFrames = endFrame - startFrame;
-    std::vector<float> result(numFrames, 0.0f);
+    if (rest == r)
+        return;
+    rest = r;
+    version = nextVersion();
+}
 
-    for (int i = 0; i < numFrames; ++i)
-    {
-        // Get delta pitch for this frame (or 0 if not available)
-        float delta = (i < static_cast<int>(deltaPitch.size())) ? deltaPitch[i] : 0.0f;
+bool Note::containsFrame(int frame) const
+{
+    return frame >= startFrame && frame < endFrame;
+}
 
-        // Actual MIDI = base + offset + delta
-        float actualMidi = midiNote + pitchOffset + delta;
+void Note::setSelected(bool sel)
+{
+    if (selected == sel)
+        return;
+    selected = sel;
+    flagRevision.fetch_add(1, std::memory_order_relaxed);
+}
 
-        // Convert to Hz
-        result[i] = midiToFreq(actualMidi);
-    }
+void Note::setDirty(bool d)
+{
+    if (dirty == d)
+        return;
+    dirty = d;
+    flagRevision.fetch_add(1, std::memory_order_relaxed);
+}
 
-    return result;
+juce::uint32 Note::getFlagRevision()
+{
+    return flagRevision.load(std::memory_order_relaxed);
 }
 
-bool Note::containsFrame(int frame) const
+juce::uint32 Note::getFrameRevision()
 {
-    return frame >= startFrame && frame < endFrame;
+    return frameRevision.load(std::memory_order_relaxed);
 }
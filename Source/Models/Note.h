@@ -3,18 +3,36 @@
 #include "../JuceHeader.h"
 #include <vector>
 
+/**
+ * Stable reference to a note owned by a Project.
+ *
+ * Unlike a Note*, a handle stays valid when the note vector grows, shrinks
+ * or is reordered; resolve it with Project::getNote() at the point of use.
+ * A handle to a removed note resolves to nullptr rather than to whichever
+ * note now occupies its old position.
+ */
+struct NoteHandle
+{
+    juce::uint32 slot = 0;
+    juce::uint32 generation = 0;  // 0 = invalid
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const NoteHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const NoteHandle& other) const { return !(*this == other); }
+};
+
 /**
  * Represents a single note/pitch segment.
  *
  * Pitch model:
  * - midiNote: The base pitch of the note (can be changed by dragging)
- * - deltaPitch: Per-frame deviation from base pitch (preserved during drag)
- * - f0Values: Original F0 values from detection (for reference)
+ * - Per-frame deviation from the base pitch lives in the project's dense
+ *   AudioData::deltaPitch, not in the note, and is preserved during drag
  *
  * When dragging a note up/down:
  * - midiNote changes
  * - deltaPitch stays the same
- * - Actual pitch = midiNote + deltaPitch[frame]
+ * - Actual pitch = base pitch (from midiNote) + deltaPitch[frame]
  */
 class Note
 {
@@ -25,22 +43,17 @@ public:
     // Frame range
     int getStartFrame() const { return startFrame; }
     int getEndFrame() const { return endFrame; }
-    void setStartFrame(int frame) { startFrame = frame; }
-    void setEndFrame(int frame) { endFrame = frame; }
+    void setStartFrame(int frame);
+    void setEndFrame(int frame);
     int getDurationFrames() const { return endFrame - startFrame; }
 
     // Pitch
     float getMidiNote() const { return midiNote; }
-    void setMidiNote(float note) { midiNote = note; }
+    void setMidiNote(float note);
     float getPitchOffset() const { return pitchOffset; }
-    void setPitchOffset(float offset) { pitchOffset = offset; }
+    void setPitchOffset(float offset);
     float getAdjustedMidiNote() const { return midiNote + pitchOffset; }
 
-    // Delta pitch (per-frame deviation from base pitch in semitones)
-    const std::vector<float>& getDeltaPitch() const { return deltaPitch; }
-    void setDeltaPitch(std::vector<float> delta) { deltaPitch = std::move(delta); }
-    bool hasDeltaPitch() const { return !deltaPitch.empty(); }
-
     // Vibrato
     bool isVibratoEnabled() const { return vibratoEnabled; }
     void setVibratoEnabled(bool enabled) { vibratoEnabled = enabled; }
@@ -51,27 +64,30 @@ public:
     float getVibratoPhaseRadians() const { return vibratoPhaseRadians; }
     void setVibratoPhaseRadians(float radians) { vibratoPhaseRadians = radians; }
 
-    // F0 values (original detected values)
-    const std::vector<float>& getF0Values() const { return f0Values; }
-    void setF0Values(std::vector<float> values) { f0Values = std::move(values); }
-    std::vector<float> getAdjustedF0() const;
-
-    // Get F0 values based on current midiNote + deltaPitch
-    std::vector<float> computeF0FromDelta() const;
-
     // Selection
     bool isSelected() const { return selected; }
-    void setSelected(bool sel) { selected = sel; }
+    void setSelected(bool sel);
 
     // Dirty flag (for incremental synthesis)
     bool isDirty() const { return dirty; }
-    void setDirty(bool d) { dirty = d; }
-    void markDirty() { dirty = true; }
-    void clearDirty() { dirty = false; }
+    void setDirty(bool d);
+    void markDirty() { setDirty(true); }
+    void clearDirty() { setDirty(false); }
+
+    // Incremented whenever any note's selected or dirty flag changes, so
+    // Project can keep its selected/dirty lists without rescanning per query
+    static juce::uint32 getFlagRevision();
+
+    // Changes whenever the note's frames, pitch or rest flag change (copies
+    // share it), so views can cache what they derive from the note
+    juce::uint32 getVersion() const { return version; }
+
+    // Incremented whenever any note's start or end frame changes
+    static juce::uint32 getFrameRevision();
 
     // Rest note (no pitch, just a placeholder for silence)
     bool isRest() const { return rest; }
-    void setRest(bool r) { rest = r; }
+    void setRest(bool r);
 
     // Lyric (character/syllable for this note)
     juce::String getLyric() const { return lyric; }
@@ -86,24 +102,30 @@ public:
     // Check if frame is within note
     bool containsFrame(int frame) const;
 
+    // Handle assigned by the owning Project (invalid until the note is in one)
+    NoteHandle getHandle() const { return handle; }
+
 private:
+    friend class Project;
+
     int startFrame = 0;
     int endFrame = 0;
     float midiNote = 60.0f;
     float pitchOffset = 0.0f;
 
-    std::vector<float> deltaPitch;  // Per-frame deviation from midiNote in semitones
-
     bool vibratoEnabled = false;
     float vibratoRateHz = 5.0f;
     float vibratoDepthSemitones = 0.0f;
     float vibratoPhaseRadians = 0.0f;
 
-    std::vector<float> f0Values;
     bool selected = false;
     bool dirty = false;  // For incremental synthesis
     bool rest = false;   // Rest note (silence placeholder)
+    juce::uint32 version = 0;
 
     juce::String lyric;   // Lyric text (e.g., "a", "SP" for silence)
     juce::String phoneme; // Phoneme (e.g., "a", "sp", for pronunciation)
+
+    // Assigned lazily by Project (which may only have const access at the time)
+    mutable NoteHandle handle;
 };
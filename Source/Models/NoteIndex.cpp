@@ -0,0 +1,93 @@
+#include "NoteIndex.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+void NoteIndex::rebuild(const std::vector<Note>& notes)
+{
+    const int count = static_cast<int>(notes.size());
+
+    order.resize(static_cast<size_t>(count));
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return notes[static_cast<size_t>(a)].getStartFrame() < notes[static_cast<size_t>(b)].getStartFrame();
+    });
+
+    starts.resize(order.size());
+    ends.resize(order.size());
+    maxEnds.resize(order.size());
+
+    int maxEnd = std::numeric_limits<int>::min();
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const auto& note = notes[static_cast<size_t>(order[i])];
+        starts[i] = note.getStartFrame();
+        ends[i] = note.getEndFrame();
+        maxEnd = std::max(maxEnd, ends[i]);
+        maxEnds[i] = maxEnd;
+    }
+
+    refreshFlags(notes);
+}
+
+void NoteIndex::refreshFlags(const std::vector<Note>& notes)
+{
+    selected.clear();
+    dirty.clear();
+
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        if (notes[i].isSelected())
+            selected.push_back(static_cast<int>(i));
+        if (notes[i].isDirty())
+            dirty.push_back(static_cast<int>(i));
+    }
+}
+
+std::pair<size_t, size_t> NoteIndex::candidates(int startFrame, int endFrame) const
+{
+    // Notes starting at or after endFrame cannot overlap; among the rest,
+    // everything before the first running max end past startFrame ends too early
+    const auto last = std::lower_bound(starts.begin(), starts.end(), endFrame);
+    const auto first = std::upper_bound(maxEnds.begin(), maxEnds.begin() + (last - starts.begin()), startFrame);
+    return {static_cast<size_t>(first - maxEnds.begin()), static_cast<size_t>(last - starts.begin())};
+}
+
+int NoteIndex::findAt(int frame) const
+{
+    const auto [first, last] = candidates(frame, frame + 1);
+
+    int best = -1;
+    for (size_t i = first; i < last; ++i)
+    {
+        if (ends[i] > frame && starts[i] <= frame && (best < 0 || order[i] < best))
+            best = order[i];
+    }
+    return best;
+}
+
+void NoteIndex::findInRange(int startFrame, int endFrame, std::vector<int>& positions) const
+{
+    if (endFrame <= startFrame)
+        return;
+
+    const auto [first, last] = candidates(startFrame, endFrame);
+    for (size_t i = first; i < last; ++i)
+    {
+        if (ends[i] > startFrame)
+            positions.push_back(order[i]);
+    }
+}
+
+void NoteIndex::findStartingAt(int frame, std::vector<int>& positions) const
+{
+    const auto range = std::equal_range(starts.begin(), starts.end(), frame);
+    for (auto it = range.first; it != range.second; ++it)
+        positions.push_back(order[static_cast<size_t>(it - starts.begin())]);
+}
+
+size_t NoteIndex::getMemoryBytes() const
+{
+    return (order.capacity() + starts.capacity() + ends.capacity() + maxEnds.capacity() +
+            selected.capacity() + dirty.capacity()) * sizeof(int);
+}
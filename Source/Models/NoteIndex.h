@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Note.h"
+#include <utility>
+#include <vector>
+
+/**
+ * Time-sorted lookup structure over a project's notes.
+ *
+ * The notes themselves stay unordered in Project's dense vector (see
+ * Project::addNote/removeNote). The index stores their positions ordered
+ * by start frame together with a running maximum of end frames, so point
+ * and range queries are a binary search plus a walk over the hits:
+ * O(log n + k) for the usual non-overlapping layout.
+ *
+ * Selected and dirty notes are kept as separate position lists so those
+ * queries cost O(k).
+ */
+class NoteIndex
+{
+public:
+    /** Re-index every note (call after notes were added, removed or moved). */
+    void rebuild(const std::vector<Note>& notes);
+
+    /** Re-collect the selected and dirty lists only. */
+    void refreshFlags(const std::vector<Note>& notes);
+
+    /** Position of the first note (in vector order) containing frame, or -1. */
+    int findAt(int frame) const;
+
+    /**
+     * Positions of notes overlapping [startFrame, endFrame), ordered by
+     * start frame. Appends to positions.
+     */
+    void findInRange(int startFrame, int endFrame, std::vector<int>& positions) const;
+
+    /** Positions of notes whose start frame equals frame, ordered by start. */
+    void findStartingAt(int frame, std::vector<int>& positions) const;
+
+    const std::vector<int>& getSelected() const { return selected; }
+    const std::vector<int>& getDirty() const { return dirty; }
+
+    void clearSelected() { selected.clear(); }
+    void clearDirty() { dirty.clear(); }
+
+    /** Heap bytes held by the index arrays. */
+    size_t getMemoryBytes() const;
+
+private:
+    // Index range [first, last) into 'order' of notes that may overlap [startFrame, endFrame)
+    std::pair<size_t, size_t> candidates(int startFrame, int endFrame) const;
+
+    std::vector<int> order;     // Note positions sorted by start frame
+    std::vector<int> starts;    // Start frame per sorted entry
+    std::vector<int> ends;      // End frame per sorted entry
+    std::vector<int> maxEnds;   // Running max of ends (non-decreasing)
+
+    std::vector<int> selected;  // Positions, ascending
+    std::vector<int> dirty;     // Positions, ascending
+};
@@ -1,12 +1,26 @@
 #include "Project.h"
+#include "ProjectFile.h"
 #include "../Utils/Constants.h"
 #include "../Utils/PitchCurveProcessor.h"
+#include "../Utils/Tracer.h"
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <cmath>
 
 namespace
 {
-    constexpr float twoPi = 6.2831853071795864769f;
+    // Process-wide, so a handle minted in a project copy (background
+    // analysis) never aliases one of the original when notes are copied back
+    std::atomic<juce::uint32> nextNoteGeneration{1};
+
+    juce::uint32 newNoteGeneration()
+    {
+        juce::uint32 generation = nextNoteGeneration.fetch_add(1);
+        if (generation == 0)
+            generation = nextNoteGeneration.fetch_add(1);
+        return generation;
+    }
 }
 
 Project::Project()
@@ -15,10 +29,35 @@ Project::Project()
 
 bool Project::saveToFile(const juce::File& file) const
 {
-    auto xml = toXml();
-    if (!xml)
-        return false;
-    return xml->writeTo(file);
+    return ProjectFile::save(*this, file);
+}
+
+bool Project::loadFromFile(const juce::File& file)
+{
+    if (ProjectFile::isBinaryProject(file))
+    {
+        ProjectFile::Reader reader(file);
+        if (!reader.readProject(*this))
+            return false;
+        restoreDenseCurves();
+
+        if (!reader.readMel(audioData.melSpectrogram))
+            audioData.melSpectrogram.clear();
+        if (!reader.readWaveform(audioData.waveform))
+            audioData.waveform.setSize(0, 0);
+    }
+    else
+    {
+        auto xml = juce::XmlDocument::parse(file);
+        if (!xml || !fromXml(*xml))
+            return false;
+
+        audioData.melSpectrogram.clear();
+        audioData.waveform.setSize(0, 0);
+    }
+
+    projectFilePath = file;
+    return true;
 }
 
 std::unique_ptr<juce::XmlElement> Project::toXml() const
@@ -94,6 +133,26 @@ std::unique_ptr<juce::XmlElement> Project::toXml() const
         voicedElem->addTextElement(mask);
     }
 
+    // PitchSalience (optional, quantized detector output stored as base64)
+    const auto& salience = audioData.pitchSalience;
+    if (!salience.isEmpty())
+    {
+        auto* salienceElem = root->createNewChildElement("PitchSalience");
+        salienceElem->setAttribute("frameTime", salience.getFrameTime());
+        salienceElem->setAttribute("threshold", salience.getThreshold());
+        salienceElem->setAttribute("numFrames", salience.getNumFrames());
+
+        const auto& cents = salience.getBinCents();
+        const auto& peaks = salience.getPeaks();
+        const auto& bins = salience.getQuantizedBins();
+        salienceElem->createNewChildElement("BinCents")->addTextElement(
+            juce::MemoryBlock(cents.data(), cents.size() * sizeof(float)).toBase64Encoding());
+        salienceElem->createNewChildElement("Peaks")->addTextElement(
+            juce::MemoryBlock(peaks.data(), peaks.size() * sizeof(float)).toBase64Encoding());
+        salienceElem->createNewChildElement("Bins")->addTextElement(
+            juce::MemoryBlock(bins.data(), bins.size()).toBase64Encoding());
+    }
+
     return root;
 }
 
@@ -131,6 +190,7 @@ bool Project::fromXml(const juce::XmlElement& xml)
             }
         }
     }
+    notesChanged();
 
     // F0
     audioData.f0.clear();
@@ -145,8 +205,6 @@ bool Project::fromXml(const juce::XmlElement& xml)
             if (p.isNotEmpty())
                 audioData.f0.push_back(p.getFloatValue());
         }
-        // Initialize baseF0 from loaded f0
-        audioData.baseF0 = audioData.f0;
     }
 
     // BasePitch (MIDI)
@@ -189,7 +247,42 @@ bool Project::fromXml(const juce::XmlElement& xml)
             audioData.voicedMask.push_back(mask[i] == '1');
     }
 
-    // Build dense curves if missing or misaligned
+    // PitchSalience
+    audioData.pitchSalience.clear();
+    if (auto* salienceElem = xml.getChildByName("PitchSalience"))
+    {
+        auto readBlock = [salienceElem](const char* tag) {
+            juce::MemoryBlock block;
+            if (auto* e = salienceElem->getChildByName(tag))
+                block.fromBase64Encoding(e->getAllSubText());
+            return block;
+        };
+
+        auto centsBlock = readBlock("BinCents");
+        auto peaksBlock = readBlock("Peaks");
+        auto binsBlock = readBlock("Bins");
+
+        const auto* centsData = static_cast<const float*>(centsBlock.getData());
+        const auto* peaksData = static_cast<const float*>(peaksBlock.getData());
+        const auto* binsData = static_cast<const uint8_t*>(binsBlock.getData());
+
+        std::vector<float> cents(centsData, centsData + centsBlock.getSize() / sizeof(float));
+        std::vector<float> peaks(peaksData, peaksData + peaksBlock.getSize() / sizeof(float));
+        std::vector<uint8_t> bins(binsData, binsData + binsBlock.getSize());
+
+        audioData.pitchSalience.restore(salienceElem->getDoubleAttribute("frameTime", 0.01),
+                                        static_cast<float>(salienceElem->getDoubleAttribute("threshold", 0.0)),
+                                        std::move(cents), std::move(peaks), std::move(bins));
+    }
+
+    restoreDenseCurves();
+
+    modified = false;
+    return true;
+}
+
+void Project::restoreDenseCurves()
+{
     const bool needsCurveRebuild = audioData.basePitch.empty() ||
                                    audioData.deltaPitch.empty() ||
                                    audioData.basePitch.size() != audioData.f0.size() ||
@@ -206,77 +299,413 @@ bool Project::fromXml(const juce::XmlElement& xml)
         // Compose f0 if only curves were stored
         PitchCurveProcessor::composeF0InPlace(*this, /*applyUvMask=*/false);
     }
+}
 
-    modified = false;
+const NoteIndex& Project::getNoteIndex() const
+{
+    // The index works on positions; handles are only re-matched on a
+    // failed lookup (see findNotePosition)
+    if (!noteIndexValid || indexedData != notes.data() || indexedCount != notes.size() ||
+        indexedFrameRevision != Note::getFrameRevision())
+    {
+        noteIndex.rebuild(notes);
+        noteIndexValid = true;
+        indexedData = notes.data();
+        indexedCount = notes.size();
+        indexedFlagRevision = Note::getFlagRevision();
+        indexedFrameRevision = Note::getFrameRevision();
+    }
+    else if (indexedFlagRevision != Note::getFlagRevision())
+    {
+        noteIndex.refreshFlags(notes);
+        indexedFlagRevision = Note::getFlagRevision();
+    }
+    return noteIndex;
+}
+
+void Project::reconcileHandles() const
+{
+    std::vector<bool> claimed(noteSlots.size(), false);
+    std::vector<int> unassigned;
+
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        const auto handle = notes[i].handle;
+        if (handle.isValid() && handle.slot < noteSlots.size() && !claimed[handle.slot] &&
+            noteSlots[handle.slot].generation == handle.generation)
+        {
+            claimed[handle.slot] = true;
+            noteSlots[handle.slot].position = static_cast<int>(i);
+        }
+        else
+        {
+            // New note, or a copy of one that already holds the handle
+            unassigned.push_back(static_cast<int>(i));
+        }
+    }
+
+    // Slots whose note is gone become free; lowest slots are reused first
+    freeNoteSlots.clear();
+    for (size_t slot = noteSlots.size(); slot-- > 0;)
+    {
+        if (!claimed[slot])
+        {
+            noteSlots[slot] = NoteSlot{};
+            freeNoteSlots.push_back(static_cast<juce::uint32>(slot));
+        }
+    }
+
+    for (int position : unassigned)
+        notes[static_cast<size_t>(position)].handle = allocateHandle(position);
+}
+
+NoteHandle Project::allocateHandle(int position) const
+{
+    juce::uint32 slot;
+    if (!freeNoteSlots.empty())
+    {
+        slot = freeNoteSlots.back();
+        freeNoteSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<juce::uint32>(noteSlots.size());
+        noteSlots.emplace_back();
+    }
+
+    auto& entry = noteSlots[slot];
+    entry.generation = newNoteGeneration();
+    entry.position = position;
+    return {slot, entry.generation};
+}
+
+int Project::findNotePosition(NoteHandle handle) const
+{
+    if (!handle.isValid())
+        return -1;
+
+    // -1: removed (or never issued), -2: slot and vector disagree
+    auto lookup = [this, handle]() {
+        if (handle.slot >= noteSlots.size() || noteSlots[handle.slot].generation != handle.generation)
+            return -1;
+        const int position = noteSlots[handle.slot].position;
+        if (position < 0 || position >= static_cast<int>(notes.size()) ||
+            notes[static_cast<size_t>(position)].handle != handle)
+            return -2;
+        return position;
+    };
+
+    int position = lookup();
+    if (position == -2)
+    {
+        // The vector was edited directly since positions were recorded
+        reconcileHandles();
+        position = lookup();
+    }
+    return std::max(-1, position);
+}
+
+void Project::eraseNoteAt(int position)
+{
+    // Free the note's slot if it holds one
+    const auto removed = notes[static_cast<size_t>(position)].handle;
+    if (removed.isValid() && removed.slot < noteSlots.size() &&
+        noteSlots[removed.slot].generation == removed.generation &&
+        noteSlots[removed.slot].position == position)
+    {
+        noteSlots[removed.slot] = NoteSlot{};
+        freeNoteSlots.push_back(removed.slot);
+    }
+
+    const auto last = notes.size() - 1;
+    if (static_cast<size_t>(position) != last)
+    {
+        notes[static_cast<size_t>(position)] = std::move(notes[last]);
+
+        const auto moved = notes[static_cast<size_t>(position)].handle;
+        if (moved.isValid() && moved.slot < noteSlots.size() &&
+            noteSlots[moved.slot].generation == moved.generation &&
+            noteSlots[moved.slot].position == static_cast<int>(last))
+            noteSlots[moved.slot].position = position;
+    }
+    notes.pop_back();
+    noteIndexValid = false;
+}
+
+NoteHandle Project::addNote(Note note)
+{
+    note.handle = allocateHandle(static_cast<int>(notes.size()));
+    notes.push_back(std::move(note));
+    noteIndexValid = false;
+    return notes.back().handle;
+}
+
+NoteHandle Project::restoreNote(Note note, NoteHandle handle)
+{
+    if (!handle.isValid())
+        return addNote(std::move(note));
+
+    auto slotIsFree = [this, handle]() {
+        return handle.slot >= noteSlots.size() || noteSlots[handle.slot].generation == 0;
+    };
+
+    if (!slotIsFree())
+    {
+        // The slot may only look taken because its note was removed through
+        // getNotes(); re-match once before giving up on the old handle
+        const auto& entry = noteSlots[handle.slot];
+        const bool occupied = entry.position >= 0 && entry.position < static_cast<int>(notes.size()) &&
+                              notes[static_cast<size_t>(entry.position)].handle ==
+                                  NoteHandle{handle.slot, entry.generation};
+        if (occupied)
+            return addNote(std::move(note));
+        reconcileHandles();
+        if (!slotIsFree())
+            return addNote(std::move(note));
+    }
+
+    if (handle.slot >= noteSlots.size())
+    {
+        // Slots skipped over on the way become free
+        for (auto slot = static_cast<juce::uint32>(noteSlots.size()); slot < handle.slot; ++slot)
+            freeNoteSlots.insert(freeNoteSlots.begin(), slot);
+        noteSlots.resize(static_cast<size_t>(handle.slot) + 1);
+    }
+    else
+    {
+        freeNoteSlots.erase(std::remove(freeNoteSlots.begin(), freeNoteSlots.end(), handle.slot),
+                            freeNoteSlots.end());
+    }
+
+    // Generations are never reissued, so the old one is still unique
+    auto& entry = noteSlots[handle.slot];
+    entry.generation = handle.generation;
+    entry.position = static_cast<int>(notes.size());
+
+    note.handle = handle;
+    notes.push_back(std::move(note));
+    noteIndexValid = false;
+    return handle;
+}
+
+bool Project::removeNote(NoteHandle handle)
+{
+    const int position = findNotePosition(handle);
+    if (position < 0)
+        return false;
+
+    eraseNoteAt(position);
     return true;
 }
 
-Note* Project::getNoteAtFrame(int frame)
+Note* Project::getNote(NoteHandle handle)
+{
+    const int position = findNotePosition(handle);
+    return position >= 0 ? &notes[static_cast<size_t>(position)] : nullptr;
+}
+
+const Note* Project::getNote(NoteHandle handle) const
+{
+    const int position = findNotePosition(handle);
+    return position >= 0 ? &notes[static_cast<size_t>(position)] : nullptr;
+}
+
+NoteHandle Project::getHandle(const Note& note) const
 {
-    for (auto& note : notes)
+    const auto handle = note.handle;
+    if (handle.isValid() && handle.slot < noteSlots.size() &&
+        noteSlots[handle.slot].generation == handle.generation)
     {
-        if (note.containsFrame(frame))
-            return &note;
+        const int position = noteSlots[handle.slot].position;
+        if (position >= 0 && position < static_cast<int>(notes.size()) &&
+            &notes[static_cast<size_t>(position)] == &note)
+            return handle;
     }
-    return nullptr;
+
+    // A note pushed through getNotes(), or a copy of one that holds the handle
+    reconcileHandles();
+    return note.handle;
+}
+
+Note* Project::getNoteAtFrame(int frame)
+{
+    const int position = getNoteIndex().findAt(frame);
+    return position >= 0 ? &notes[static_cast<size_t>(position)] : nullptr;
 }
 
 std::vector<Note*> Project::getNotesInRange(int startFrame, int endFrame)
 {
+    std::vector<int> positions;
+    getNoteIndex().findInRange(startFrame, endFrame, positions);
+
     std::vector<Note*> result;
-    for (auto& note : notes)
-    {
-        if (note.getStartFrame() < endFrame && note.getEndFrame() > startFrame)
-            result.push_back(&note);
-    }
+    result.reserve(positions.size());
+    for (int position : positions)
+        result.push_back(&notes[static_cast<size_t>(position)]);
+    return result;
+}
+
+std::vector<const Note*> Project::getNotesInRange(int startFrame, int endFrame) const
+{
+    std::vector<int> positions;
+    getNoteIndex().findInRange(startFrame, endFrame, positions);
+
+    std::vector<const Note*> result;
+    result.reserve(positions.size());
+    for (int position : positions)
+        result.push_back(&notes[static_cast<size_t>(position)]);
     return result;
 }
 
 std::vector<Note*> Project::getSelectedNotes()
 {
     std::vector<Note*> result;
-    for (auto& note : notes)
-    {
-        if (note.isSelected())
-            result.push_back(&note);
-    }
+    for (int position : getNoteIndex().getSelected())
+        result.push_back(&notes[static_cast<size_t>(position)]);
     return result;
 }
 
 bool Project::removeNoteByStartFrame(int startFrame)
 {
-    for (auto it = notes.begin(); it != notes.end(); ++it)
+    std::vector<int> positions;
+    getNoteIndex().findStartingAt(startFrame, positions);
+    if (positions.empty())
+        return false;
+
+    // Same note the linear scan found: the first one in vector order
+    eraseNoteAt(*std::min_element(positions.begin(), positions.end()));
+    return true;
+}
+
+void Project::replaceNotesInRange(int startFrame, int endFrame, const std::vector<Note>& newNotes)
+{
+    std::vector<int> positions;
+    getNoteIndex().findInRange(startFrame, endFrame, positions);
+
+    // Highest position first: each removal only moves a note from the end
+    std::sort(positions.begin(), positions.end(), std::greater<int>());
+    for (int position : positions)
+        eraseNoteAt(position);
+
+    // Notes from a snapshot get their old handles back; fresh ones get new
+    for (const auto& note : newNotes)
+        restoreNote(note, note.getHandle());
+}
+
+namespace
+{
+    template <typename Values>
+    void copyCurve(const Values& source, int start, int end, Values& dest)
     {
-        if (it->getStartFrame() == startFrame)
+        const auto first = static_cast<size_t>(std::clamp(start, 0, static_cast<int>(source.size())));
+        const auto last = static_cast<size_t>(std::clamp(end, static_cast<int>(first), static_cast<int>(source.size())));
+        dest.assign(source.begin() + static_cast<std::ptrdiff_t>(first), source.begin() + static_cast<std::ptrdiff_t>(last));
+    }
+
+    template <typename Values>
+    void writeCurve(const Values& source, int start, Values& dest)
+    {
+        for (size_t i = 0; i < source.size(); ++i)
         {
-            notes.erase(it);
-            return true;
+            const auto frame = static_cast<size_t>(start) + i;
+            if (frame < dest.size())
+                dest[frame] = source[i];
         }
     }
-    return false;
+}
+
+void Project::RangeSnapshot::trimCurves(int start, int end)
+{
+    const int offset = start - curveStart;
+    const int count = end - start;
+    for (auto* curve : {&f0, &basePitch, &deltaPitch})
+    {
+        std::vector<float> trimmed;
+        copyCurve(*curve, offset, offset + count, trimmed);
+        *curve = std::move(trimmed);
+    }
+    VoicedMask trimmedMask;
+    copyCurve(voicedMask, offset, offset + count, trimmedMask);
+    voicedMask = std::move(trimmedMask);
+    curveStart = std::max(curveStart, start);
+}
+
+size_t Project::RangeSnapshot::getMemoryBytes() const
+{
+    return sizeof(*this) + mel.getMemoryBytes() + notes.capacity() * sizeof(Note) +
+           (f0.capacity() + basePitch.capacity() + deltaPitch.capacity()) * sizeof(float) +
+           voicedMask.capacity() + salience.getMemoryUsage();
+}
+
+Project::RangeSnapshot Project::captureRange(int startFrame, int endFrame, int curveStart, int curveEnd) const
+{
+    RangeSnapshot snapshot;
+    snapshot.startFrame = startFrame;
+    snapshot.endFrame = endFrame;
+    snapshot.mel = audioData.melSpectrogram.getRange(startFrame, endFrame);
+
+    for (const auto* note : getNotesInRange(startFrame, endFrame))
+        snapshot.notes.push_back(*note);
+
+    snapshot.curveStart = std::max(0, curveStart);
+    copyCurve(audioData.f0, curveStart, curveEnd, snapshot.f0);
+    copyCurve(audioData.basePitch, curveStart, curveEnd, snapshot.basePitch);
+    copyCurve(audioData.deltaPitch, curveStart, curveEnd, snapshot.deltaPitch);
+    copyCurve(audioData.voicedMask, curveStart, curveEnd, snapshot.voicedMask);
+
+    const auto& salience = audioData.pitchSalience;
+    if (!salience.isEmpty())
+    {
+        const double frameTime = salience.getFrameTime();
+        snapshot.salienceStart = static_cast<int>(std::floor(framesToSeconds(startFrame) / frameTime));
+        const int salienceEnd = static_cast<int>(std::ceil(framesToSeconds(endFrame) / frameTime));
+        snapshot.salience = salience.extractFrames(snapshot.salienceStart, salienceEnd - snapshot.salienceStart);
+    }
+    return snapshot;
+}
+
+void Project::restoreRange(const RangeSnapshot& snapshot)
+{
+    audioData.melSpectrogram.setRange(snapshot.startFrame, snapshot.mel);
+    replaceNotesInRange(snapshot.startFrame, snapshot.endFrame, snapshot.notes);
+
+    writeCurve(snapshot.f0, snapshot.curveStart, audioData.f0);
+    writeCurve(snapshot.basePitch, snapshot.curveStart, audioData.basePitch);
+    writeCurve(snapshot.deltaPitch, snapshot.curveStart, audioData.deltaPitch);
+    writeCurve(snapshot.voicedMask, snapshot.curveStart, audioData.voicedMask);
+
+    if (!snapshot.salience.isEmpty())
+        audioData.pitchSalience.replaceFrames(snapshot.salienceStart, snapshot.salience, 0,
+                                              snapshot.salience.getNumFrames());
 }
 
 void Project::deselectAllNotes()
 {
-    for (auto& note : notes)
-        note.setSelected(false);
+    const auto& index = getNoteIndex();
+    for (int position : index.getSelected())
+        notes[static_cast<size_t>(position)].setSelected(false);
+
+    noteIndex.clearSelected();
+    indexedFlagRevision = Note::getFlagRevision();
 }
 
 std::vector<Note*> Project::getDirtyNotes()
 {
     std::vector<Note*> result;
-    for (auto& note : notes)
-    {
-        if (note.isDirty())
-            result.push_back(&note);
-    }
+    for (int position : getNoteIndex().getDirty())
+        result.push_back(&notes[static_cast<size_t>(position)]);
     return result;
 }
 
 void Project::clearAllDirty()
 {
-    for (auto& note : notes)
-        note.clearDirty();
+    const auto& index = getNoteIndex();
+    for (int position : index.getDirty())
+        notes[static_cast<size_t>(position)].clearDirty();
+
+    noteIndex.clearDirty();
+    indexedFlagRevision = Note::getFlagRevision();
+
     // Also clear F0 dirty range
     f0DirtyStart = -1;
     f0DirtyEnd = -1;
@@ -284,12 +713,7 @@ void Project::clearAllDirty()
 
 bool Project::hasDirtyNotes() const
 {
-    for (const auto& note : notes)
-    {
-        if (note.isDirty())
-            return true;
-    }
-    return false;
+    return !getNoteIndex().getDirty().empty();
 }
 
 void Project::setF0DirtyRange(int startFrame, int endFrame)
@@ -322,15 +746,13 @@ std::pair<int, int> Project::getDirtyFrameRange() const
     int maxEnd = -1;
     
     // Check dirty notes
-    for (const auto& note : notes)
+    for (int position : getNoteIndex().getDirty())
     {
-        if (note.isDirty())
-        {
-            if (minStart < 0 || note.getStartFrame() < minStart)
-                minStart = note.getStartFrame();
-            if (maxEnd < 0 || note.getEndFrame() > maxEnd)
-                maxEnd = note.getEndFrame();
-        }
+        const auto& note = notes[static_cast<size_t>(position)];
+        if (minStart < 0 || note.getStartFrame() < minStart)
+            minStart = note.getStartFrame();
+        if (maxEnd < 0 || note.getEndFrame() > maxEnd)
+            maxEnd = note.getEndFrame();
     }
     
     // Also include F0 dirty range from Draw mode edits
@@ -353,35 +775,10 @@ std::vector<float> Project::getAdjustedF0() const
     if (audioData.basePitch.empty() || audioData.deltaPitch.empty())
         return {};
 
-    // Compose base + delta with UV applied and global offset
-    std::vector<float> adjustedF0 = PitchCurveProcessor::composeF0(*this,
-                                                                   /*applyUvMask=*/true,
-                                                                   globalPitchOffset);
-
-    // Apply vibrato per note on top of composed curve
-    for (const auto& note : notes)
-    {
-        const bool hasVibrato = note.isVibratoEnabled() &&
-                                note.getVibratoDepthSemitones() > 0.0001f &&
-                                note.getVibratoRateHz() > 0.0001f;
-        if (!hasVibrato)
-            continue;
-
-        const int start = std::max(0, note.getStartFrame());
-        const int end = std::min(note.getEndFrame(), static_cast<int>(adjustedF0.size()));
-
-        for (int i = start; i < end; ++i)
-        {
-            if (i < static_cast<int>(audioData.voicedMask.size()) && !audioData.voicedMask[i])
-                continue;
-
-            float vib = note.getVibratoDepthSemitones() *
-                        std::sin(twoPi * note.getVibratoRateHz() * framesToSeconds(i - start) +
-                                 note.getVibratoPhaseRadians());
-            adjustedF0[static_cast<size_t>(i)] *= std::pow(2.0f, vib / 12.0f);
-        }
-    }
-
+    // Compose base + delta with UV applied, global offset and per-note vibrato
+    const int totalFrames = static_cast<int>(audioData.basePitch.size());
+    std::vector<float> adjustedF0(static_cast<size_t>(totalFrames));
+    PitchCurveProcessor::composeAdjustedF0(*this, 0, totalFrames, adjustedF0.data());
     return adjustedF0;
 }
 
@@ -397,46 +794,80 @@ std::vector<float> Project::getAdjustedF0ForRange(int startFrame, int endFrame)
     if (startFrame >= endFrame)
         return {};
 
-    const int rangeSize = endFrame - startFrame;
-    std::vector<float> adjustedF0(static_cast<size_t>(rangeSize), 0.0f);
+    std::vector<float> adjustedF0(static_cast<size_t>(endFrame - startFrame));
+    PitchCurveProcessor::composeAdjustedF0(*this, startFrame, endFrame, adjustedF0.data());
+    return adjustedF0;
+}
 
-    for (int i = 0; i < rangeSize; ++i)
-    {
-        const int globalIdx = startFrame + i;
-        const float base = audioData.basePitch[static_cast<size_t>(globalIdx)];
-        const float delta = (globalIdx < static_cast<int>(audioData.deltaPitch.size()))
-                                ? audioData.deltaPitch[static_cast<size_t>(globalIdx)]
-                                : 0.0f;
-        float midi = base + delta + globalPitchOffset;
-        float freq = midiToFreq(midi);
-        if (globalIdx < static_cast<int>(audioData.voicedMask.size()) && !audioData.voicedMask[globalIdx])
-            freq = 0.0f;
-        adjustedF0[static_cast<size_t>(i)] = freq;
-    }
+size_t MemoryReport::getTotalBytes() const
+{
+    size_t total = 0;
+    for (const auto& entry : entries)
+        total += entry.bytes;
+    return total;
+}
 
-    // Apply vibrato for overlapping notes
-    for (const auto& note : notes)
-    {
-        const bool hasVibrato = note.isVibratoEnabled() &&
-                                note.getVibratoDepthSemitones() > 0.0001f &&
-                                note.getVibratoRateHz() > 0.0001f;
-        if (!hasVibrato)
-            continue;
+juce::String MemoryReport::toString() const
+{
+    juce::String text;
+    for (const auto& entry : entries)
+        text << entry.component << ": " << juce::File::descriptionOfSizeInBytes(static_cast<juce::int64>(entry.bytes)) << "\n";
+    text << "total: " << juce::File::descriptionOfSizeInBytes(static_cast<juce::int64>(getTotalBytes()));
+    return text;
+}
 
-        const int overlapStart = std::max(note.getStartFrame(), startFrame);
-        const int overlapEnd = std::min(note.getEndFrame(), endFrame);
-        for (int frame = overlapStart; frame < overlapEnd; ++frame)
-        {
-            const int localIdx = frame - startFrame;
-            if (frame < static_cast<int>(audioData.voicedMask.size()) && !audioData.voicedMask[frame])
-                continue;
-
-            float vib = note.getVibratoDepthSemitones() *
-                        std::sin(twoPi * note.getVibratoRateHz() * framesToSeconds(frame - note.getStartFrame()) +
-                                 note.getVibratoPhaseRadians());
-            adjustedF0[static_cast<size_t>(localIdx)] *= std::pow(2.0f, vib / 12.0f);
-        }
-    }
+WaveformPeaks::Peak AudioData::getWaveformPeak(int startSample, int endSample) const
+{
+    if (waveform.getNumSamples() == 0)
+        return {};
+    if (waveformPeaks.getNumSamples() != waveform.getNumSamples())
+        waveformPeaks.build(waveform.getReadPointer(0), waveform.getNumSamples());
+    return waveformPeaks.getPeak(waveform.getReadPointer(0), startSample, endSample);
+}
 
-    return adjustedF0;
+void AudioData::rebuildWaveformPeaks()
+{
+    TRACE_SCOPE("build waveform peaks");
+    if (waveform.getNumSamples() > 0)
+        waveformPeaks.build(waveform.getReadPointer(0), waveform.getNumSamples());
+    else
+        waveformPeaks.clear();
+}
+
+void AudioData::updateWaveformPeaks(int startSample, int numSamples)
+{
+    TRACE_SCOPE("update waveform peaks");
+    if (waveformPeaks.getNumSamples() != waveform.getNumSamples())
+        rebuildWaveformPeaks();
+    else
+        waveformPeaks.update(waveform.getReadPointer(0), startSample, numSamples);
+}
+
+void AudioData::addMemoryUsage(MemoryReport& report) const
+{
+    report.add("waveform", static_cast<size_t>(waveform.getNumChannels()) *
+                               static_cast<size_t>(waveform.getNumSamples()) * sizeof(float));
+    report.add("waveformPeaks", waveformPeaks.getMemoryBytes());
+    report.add("mel", melSpectrogram.getMemoryBytes());
+    report.add("f0", f0.capacity() * sizeof(float));
+    report.add("basePitch", basePitch.capacity() * sizeof(float));
+    report.add("deltaPitch", deltaPitch.capacity() * sizeof(float));
+    report.add("voicedMask", voicedMask.capacity() * sizeof(uint8_t));
+    report.add("pitchSalience", (pitchSalience.getBinCents().capacity() + pitchSalience.getPeaks().capacity()) * sizeof(float) +
+                                    pitchSalience.getQuantizedBins().capacity());
+}
+
+MemoryReport Project::getMemoryReport() const
+{
+    MemoryReport report;
+    audioData.addMemoryUsage(report);
+
+    size_t noteBytes = notes.capacity() * sizeof(Note);
+    for (const auto& note : notes)
+        noteBytes += note.getLyric().getNumBytesAsUTF8() + note.getPhoneme().getNumBytesAsUTF8();
+    report.add("notes", noteBytes);
+
+    report.add("noteIndex", noteIndex.getMemoryBytes() + noteSlots.capacity() * sizeof(NoteSlot) +
+                                freeNoteSlots.capacity() * sizeof(juce::uint32));
+    return report;
 }
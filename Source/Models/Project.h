@@ -1,12 +1,42 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "FrameBuffers.h"
 #include "Note.h"
+#include "NoteIndex.h"
+#include "WaveformPeaks.h"
+#include "../Utils/PitchSalience.h"
 #include <vector>
 #include <memory>
 
+/**
+ * Heap bytes held by each part of a project (see Project::getMemoryReport).
+ */
+struct MemoryReport
+{
+    struct Entry
+    {
+        juce::String component;
+        size_t bytes = 0;
+    };
+
+    std::vector<Entry> entries;
+
+    void add(const juce::String& component, size_t bytes) { entries.push_back({component, bytes}); }
+    size_t getTotalBytes() const;
+
+    // One "component: size" line per entry followed by the total
+    juce::String toString() const;
+};
+
 /**
  * Container for audio data and extracted features.
+ *
+ * Per-frame features are stored once each, structure-of-arrays: the mel is
+ * one contiguous aligned block, the curves are flat float arrays and the
+ * uv mask is a byte per frame. Anything derivable (base pitch in Hz, a
+ * note's slice of f0 or delta) is computed from these when needed rather
+ * than kept as another copy.
  */
 struct AudioData
 {
@@ -14,12 +44,14 @@ struct AudioData
     int sampleRate = 44100;
     
     // Extracted features
-    std::vector<std::vector<float>> melSpectrogram;  // [T, NUM_MELS]
+    MelBuffer melSpectrogram;                         // [T, NUM_MELS], float32 or float16
     std::vector<float> f0;                            // [T] (composed: base + delta, dense)
-    std::vector<float> baseF0;                        // [T] (cached base pitch in Hz)
     std::vector<float> basePitch;                     // [T] base pitch in MIDI (dense)
     std::vector<float> deltaPitch;                    // [T] delta pitch in MIDI (dense)
-    std::vector<bool> voicedMask;                     // [T] uv mask (true = voiced)
+    VoicedMask voicedMask;                            // [T] uv mask (1 = voiced)
+
+    // Raw detector salience at the detector frame rate (optional, empty for YIN)
+    PitchSalience pitchSalience;
     
     float getDuration() const
     {
@@ -29,8 +61,23 @@ struct AudioData
     
     int getNumFrames() const
     {
-        return static_cast<int>(melSpectrogram.size());
+        return melSpectrogram.getNumFrames();
     }
+
+    // Min/max/RMS of waveform channel 0 over [startSample, endSample), read
+    // from the peak pyramid (built on first use if the sample count changed)
+    WaveformPeaks::Peak getWaveformPeak(int startSample, int endSample) const;
+
+    // Call after replacing the waveform wholesale
+    void rebuildWaveformPeaks();
+
+    // Call after rewriting samples [startSample, startSample + numSamples) in place
+    void updateWaveformPeaks(int startSample, int numSamples);
+
+    void addMemoryUsage(MemoryReport& report) const;
+
+private:
+    mutable WaveformPeaks waveformPeaks;
 };
 
 /**
@@ -55,18 +102,77 @@ public:
     const AudioData& getAudioData() const { return audioData; }
     
     // Notes
+    // Notes live unordered in a dense vector addressed through a slot map:
+    // addNote() appends, removeNote() moves the last note into the gap, and
+    // both only touch the affected slots, so add, split and delete are O(1).
+    // Time lookups go through a sorted index (see NoteIndex), rebuilt lazily
+    // in O(n log n) on the first query after notes were added, removed or
+    // moved in time.
+    //
+    // Adding or removing notes through getNotes() is picked up automatically
+    // when the count changes; call notesChanged() after otherwise
+    // rearranging the vector in place. Handles are re-matched to positions
+    // (O(n)) only when a lookup finds the vector was edited that way.
+    //
+    // Note* stays valid only until the vector changes. Anything that outlives
+    // the current call (drag state, undo actions, panels) should keep a
+    // NoteHandle and resolve it with getNote() when needed.
     std::vector<Note>& getNotes() { return notes; }
     const std::vector<Note>& getNotes() const { return notes; }
-    void addNote(Note note) { notes.push_back(std::move(note)); }
-    void clearNotes() { notes.clear(); }
+    NoteHandle addNote(Note note);
+    // Re-inserts a removed note under its old handle so handles kept by
+    // undo actions stay valid; issues a new one if that slot is taken
+    NoteHandle restoreNote(Note note, NoteHandle handle);
+    bool removeNote(NoteHandle handle);
+    void clearNotes() { notes.clear(); notesChanged(); }
+    void notesChanged() { noteIndexValid = false; }
+
+    // Returns nullptr if the note has been removed
+    Note* getNote(NoteHandle handle);
+    const Note* getNote(NoteHandle handle) const;
+    NoteHandle getHandle(const Note& note) const;
 
     Note* getNoteAtFrame(int frame);
     std::vector<Note*> getNotesInRange(int startFrame, int endFrame);
+    std::vector<const Note*> getNotesInRange(int startFrame, int endFrame) const;
     std::vector<Note*> getSelectedNotes();
     bool removeNoteByStartFrame(int startFrame);
     std::vector<Note*> getDirtyNotes();
     void deselectAllNotes();
     void clearAllDirty();
+
+    // Replace the notes overlapping [startFrame, endFrame) with newNotes;
+    // notes copied out of this project keep their handles (see restoreNote)
+    void replaceNotesInRange(int startFrame, int endFrame, const std::vector<Note>& newNotes);
+
+    /**
+     * What range re-analysis replaces: mel rows, notes and salience frames
+     * over [startFrame, endFrame), and the pitch curves from curveStart
+     * (base pitch regeneration can reach past the range). Captured before
+     * and after a replacement, it makes the replacement undoable.
+     */
+    struct RangeSnapshot
+    {
+        int startFrame = 0;
+        int endFrame = 0;
+        MelBuffer mel;
+        std::vector<Note> notes;
+        int curveStart = 0;
+        std::vector<float> f0;
+        std::vector<float> basePitch;
+        std::vector<float> deltaPitch;
+        VoicedMask voicedMask;
+        int salienceStart = 0;
+        PitchSalience salience;
+
+        int getCurveEnd() const { return curveStart + static_cast<int>(f0.size()); }
+        // Drop curve values outside [start, end)
+        void trimCurves(int start, int end);
+        size_t getMemoryBytes() const;
+    };
+
+    RangeSnapshot captureRange(int startFrame, int endFrame, int curveStart, int curveEnd) const;
+    void restoreRange(const RangeSnapshot& snapshot);
     
     // Global settings
     float getGlobalPitchOffset() const { return globalPitchOffset; }
@@ -97,22 +203,62 @@ public:
     bool hasF0DirtyRange() const;
     std::pair<int, int> getF0DirtyRange() const;
     
+    // Heap usage per component (audio, features, notes, indices)
+    MemoryReport getMemoryReport() const;
+
     // Modified state
     bool isModified() const { return modified; }
     void setModified(bool mod) { modified = mod; }
 
     // Persistence
+    // Files are written in the binary format (see ProjectFile), including
+    // the cached mel and waveform. loadFromFile reads binary projects and
+    // imports XML ones; an XML project has no cached mel or waveform.
     bool saveToFile(const juce::File& file) const;
+    bool loadFromFile(const juce::File& file);
     std::unique_ptr<juce::XmlElement> toXml() const;
     bool fromXml(const juce::XmlElement& xml);
     
 private:
+    // Re-derive base/delta curves when missing or misaligned with f0 (or
+    // compose f0 when only the curves were stored)
+    void restoreDenseCurves();
+
     juce::String name = "Untitled";
     juce::File filePath;
     juce::File projectFilePath;
     
     AudioData audioData;
     std::vector<Note> notes;
+
+    // Rebuilds or refreshes the note index if notes or flags changed
+    const NoteIndex& getNoteIndex() const;
+
+    // Handle bookkeeping: keeps every live handle pointing at its note's
+    // current position and gives unassigned or duplicated notes new handles
+    void reconcileHandles() const;
+    int findNotePosition(NoteHandle handle) const;
+    NoteHandle allocateHandle(int position) const;
+    // Remove notes[position] by moving the last note into its place
+    void eraseNoteAt(int position);
+
+    struct NoteSlot
+    {
+        juce::uint32 generation = 0;  // 0 = free
+        int position = -1;            // Index into notes
+    };
+
+    // Lazily maintained; keyed on the vector's storage so copies and
+    // reallocations are detected without an explicit notesChanged()
+    mutable NoteIndex noteIndex;
+    mutable bool noteIndexValid = false;
+    mutable const Note* indexedData = nullptr;
+    mutable size_t indexedCount = 0;
+    mutable juce::uint32 indexedFlagRevision = 0;
+    mutable juce::uint32 indexedFrameRevision = 0;
+
+    mutable std::vector<NoteSlot> noteSlots;
+    mutable std::vector<juce::uint32> freeNoteSlots;
     
     float globalPitchOffset = 0.0f;
     float formantShift = 0.0f;
@@ -0,0 +1,513 @@
+#include "ProjectAutosave.h"
+#include "Project.h"
+#include "ProjectFile.h"
+#include "../Utils/AppLogger.h"
+#include "../Utils/PlatformPaths.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr juce::uint32 JOURNAL_MAGIC = 0x4c4a5448;  // "HTJL"
+    constexpr juce::uint32 JOURNAL_VERSION = 1;
+    constexpr juce::uint32 RECORD_MAGIC = 0x43455248;   // "HREC"
+
+    // Compact once the journal holds this much since the last snapshot
+    constexpr size_t COMPACT_BYTES = 4 * 1024 * 1024;
+    constexpr int COMPACT_RECORDS = 500;
+
+    // Changed frames closer than this are written as one span
+    constexpr size_t SPAN_GAP = 16;
+
+    enum Tag : juce::uint8
+    {
+        TAG_END = 0,
+        TAG_GLOBALS = 1,  // pitch offset, formant shift, volume, name, project file path
+        TAG_NOTES = 2,    // Full note table
+        TAG_RESIZE = 3,   // curve, new length (new frames are zero)
+        TAG_SPAN = 4      // curve, start, count, raw values
+    };
+
+    enum Curve : juce::uint8
+    {
+        CURVE_F0 = 0,
+        CURVE_BASE = 1,
+        CURVE_DELTA = 2,
+        CURVE_MASK = 3
+    };
+
+    juce::uint32 checksum(const void* data, size_t size)
+    {
+        // FNV-1a; only has to catch torn or garbled records
+        const auto* bytes = static_cast<const juce::uint8*>(data);
+        juce::uint32 hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    bool writeCurveChanges(juce::OutputStream& out, Curve curve, const std::vector<T>& current, std::vector<T>& previous)
+    {
+        bool changed = false;
+        if (current.size() != previous.size())
+        {
+            out.writeByte(static_cast<char>(TAG_RESIZE));
+            out.writeByte(static_cast<char>(curve));
+            out.writeInt(static_cast<int>(current.size()));
+            previous.resize(current.size(), T{});
+            changed = true;
+        }
+
+        // Bitwise compare so NaN frames do not count as changed every time
+        auto same = [&](size_t i) { return std::memcmp(&current[i], &previous[i], sizeof(T)) == 0; };
+
+        const size_t count = current.size();
+        size_t i = 0;
+        while (i < count)
+        {
+            if (same(i))
+            {
+                ++i;
+                continue;
+            }
+
+            size_t lastChanged = i;
+            for (size_t j = i + 1; j < count && j - lastChanged <= SPAN_GAP; ++j)
+            {
+                if (!same(j))
+                    lastChanged = j;
+            }
+
+            const size_t spanCount = lastChanged + 1 - i;
+            out.writeByte(static_cast<char>(TAG_SPAN));
+            out.writeByte(static_cast<char>(curve));
+            out.writeInt(static_cast<int>(i));
+            out.writeInt(static_cast<int>(spanCount));
+            out.write(current.data() + i, spanCount * sizeof(T));
+            std::copy_n(current.data() + i, spanCount, previous.data() + i);
+
+            i = lastChanged + 1;
+            changed = true;
+        }
+        return changed;
+    }
+
+    template <typename T>
+    bool readSpan(juce::InputStream& in, std::vector<T>& values)
+    {
+        const int start = in.readInt();
+        const int count = in.readInt();
+        if (start < 0 || count < 0 || static_cast<size_t>(start) + static_cast<size_t>(count) > values.size())
+            return false;
+
+        const int bytes = count * static_cast<int>(sizeof(T));
+        return in.read(values.data() + start, bytes) == bytes;
+    }
+
+    bool applyRecord(juce::InputStream& in, Project& project)
+    {
+        auto& audioData = project.getAudioData();
+
+        for (;;)
+        {
+            if (in.isExhausted())
+                return false;
+
+            const auto tag = static_cast<juce::uint8>(in.readByte());
+            switch (tag)
+            {
+                case TAG_END:
+                    return true;
+
+                case TAG_GLOBALS:
+                {
+                    project.setGlobalPitchOffset(in.readFloat());
+                    project.setFormantShift(in.readFloat());
+                    project.setVolume(in.readFloat());
+                    project.setName(in.readString());
+                    const auto path = in.readString();
+                    project.setProjectFilePath(path.isEmpty() ? juce::File() : juce::File(path));
+                    break;
+                }
+
+                case TAG_NOTES:
+                    if (!ProjectFile::readNotes(in, project.getNotes()))
+                        return false;
+                    project.notesChanged();
+                    break;
+
+                case TAG_RESIZE:
+                {
+                    const auto curve = static_cast<juce::uint8>(in.readByte());
+                    const int size = in.readInt();
+                    if (size < 0)
+                        return false;
+
+                    const auto frames = static_cast<size_t>(size);
+                    if (curve == CURVE_F0)
+                        audioData.f0.resize(frames, 0.0f);
+                    else if (curve == CURVE_BASE)
+                        audioData.basePitch.resize(frames, 0.0f);
+                    else if (curve == CURVE_DELTA)
+                        audioData.deltaPitch.resize(frames, 0.0f);
+                    else if (curve == CURVE_MASK)
+                        audioData.voicedMask.resize(frames, 0);
+                    else
+                        return false;
+                    break;
+                }
+
+                case TAG_SPAN:
+                {
+                    const auto curve = static_cast<juce::uint8>(in.readByte());
+                    bool ok = false;
+                    if (curve == CURVE_F0)
+                        ok = readSpan(in, audioData.f0);
+                    else if (curve == CURVE_BASE)
+                        ok = readSpan(in, audioData.basePitch);
+                    else if (curve == CURVE_DELTA)
+                        ok = readSpan(in, audioData.deltaPitch);
+                    else if (curve == CURVE_MASK)
+                        ok = readSpan(in, audioData.voicedMask);
+                    if (!ok)
+                        return false;
+                    break;
+                }
+
+                default:
+                    return false;
+            }
+        }
+    }
+}
+
+ProjectAutosave::ProjectAutosave(const juce::File& dir)
+    : directory(dir),
+      snapshotFile(dir.getChildFile("autosave.peproj")),
+      journalFile(dir.getChildFile("autosave.journal"))
+{
+}
+
+ProjectAutosave::~ProjectAutosave()
+{
+    stopWriter();
+}
+
+juce::File ProjectAutosave::getDefaultDirectory()
+{
+    return PlatformPaths::getConfigDirectory().getChildFile("Autosave");
+}
+
+void ProjectAutosave::start(const Project& project)
+{
+    // Raw spans are written in host order, as in ProjectFile
+    if (juce::ByteOrder::isBigEndian())
+        return;
+
+    updateShadow(project);
+    active = true;
+
+    if (!writer.joinable())
+    {
+        stopRequested = false;
+        writer = std::thread([this]() { writerLoop(); });
+    }
+
+    // The previous session's journal does not belong to the new snapshot
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.clear();
+    }
+    Job job;
+    job.snapshot = makeSnapshot(project);
+    job.newSession = true;
+    enqueue(std::move(job));
+
+    journalBytes = 0;
+    journalRecords = 0;
+}
+
+void ProjectAutosave::captureChanges(const Project& project)
+{
+    if (!active)
+        return;
+
+    const auto& audioData = project.getAudioData();
+    juce::MemoryOutputStream out;
+    bool changed = false;
+
+    const auto projectPath = project.getProjectFilePath().getFullPathName();
+    if (project.getGlobalPitchOffset() != shadow.globalPitchOffset || project.getFormantShift() != shadow.formantShift ||
+        project.getVolume() != shadow.volume || project.getName() != shadow.name || projectPath != shadow.projectFilePath)
+    {
+        shadow.globalPitchOffset = project.getGlobalPitchOffset();
+        shadow.formantShift = project.getFormantShift();
+        shadow.volume = project.getVolume();
+        shadow.name = project.getName();
+        shadow.projectFilePath = projectPath;
+
+        out.writeByte(static_cast<char>(TAG_GLOBALS));
+        out.writeFloat(shadow.globalPitchOffset);
+        out.writeFloat(shadow.formantShift);
+        out.writeFloat(shadow.volume);
+        out.writeString(shadow.name);
+        out.writeString(shadow.projectFilePath);
+        changed = true;
+    }
+
+    juce::MemoryOutputStream notes;
+    ProjectFile::writeNotes(notes, project.getNotes());
+    if (notes.getDataSize() != shadow.notes.getSize() ||
+        std::memcmp(notes.getData(), shadow.notes.getData(), notes.getDataSize()) != 0)
+    {
+        out.writeByte(static_cast<char>(TAG_NOTES));
+        out.write(notes.getData(), notes.getDataSize());
+        shadow.notes = notes.getMemoryBlock();
+        changed = true;
+    }
+
+    changed |= writeCurveChanges(out, CURVE_F0, audioData.f0, shadow.f0);
+    changed |= writeCurveChanges(out, CURVE_BASE, audioData.basePitch, shadow.basePitch);
+    changed |= writeCurveChanges(out, CURVE_DELTA, audioData.deltaPitch, shadow.deltaPitch);
+    changed |= writeCurveChanges(out, CURVE_MASK, audioData.voicedMask, shadow.voicedMask);
+
+    if (!changed)
+        return;
+
+    out.writeByte(static_cast<char>(TAG_END));
+    journalBytes += out.getDataSize();
+    ++journalRecords;
+
+    Job job;
+    job.record = out.getMemoryBlock();
+    enqueue(std::move(job));
+
+    // Compact only after the record is queued: until the journal is
+    // truncated, the old journal must hold every change the new snapshot has
+    if (journalBytes > COMPACT_BYTES || journalRecords > COMPACT_RECORDS)
+        compact(project);
+}
+
+void ProjectAutosave::discard()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.clear();
+    }
+    stopWriter();
+    active = false;
+
+    journalFile.deleteFile();
+    snapshotFile.deleteFile();
+}
+
+bool ProjectAutosave::hasRecoverableSession(const juce::File& dir)
+{
+    return ProjectFile::isBinaryProject(dir.getChildFile("autosave.peproj"));
+}
+
+bool ProjectAutosave::restore(const juce::File& dir, Project& project)
+{
+    if (!project.loadFromFile(dir.getChildFile("autosave.peproj")))
+    {
+        LOG("ProjectAutosave: cannot read the session snapshot");
+        return false;
+    }
+    project.setProjectFilePath(juce::File());
+
+    juce::FileInputStream in(dir.getChildFile("autosave.journal"));
+    if (in.openedOk() && static_cast<juce::uint32>(in.readInt()) == JOURNAL_MAGIC &&
+        static_cast<juce::uint32>(in.readInt()) <= JOURNAL_VERSION)
+    {
+        const auto path = in.readString();
+        if (path.isNotEmpty())
+            project.setProjectFilePath(juce::File(path));
+
+        int replayed = 0;
+        while (in.getNumBytesRemaining() >= 12)
+        {
+            if (static_cast<juce::uint32>(in.readInt()) != RECORD_MAGIC)
+                break;
+
+            const auto size = static_cast<juce::uint32>(in.readInt());
+            in.readInt();  // Sequence number
+            if (static_cast<juce::int64>(size) + 4 > in.getNumBytesRemaining())
+                break;
+
+            juce::MemoryBlock payload;
+            if (in.readIntoMemoryBlock(payload, static_cast<ssize_t>(size)) != size)
+                break;
+            if (static_cast<juce::uint32>(in.readInt()) != checksum(payload.getData(), payload.getSize()))
+                break;
+
+            juce::MemoryInputStream record(payload, false);
+            if (!applyRecord(record, project))
+                break;
+            ++replayed;
+        }
+
+        LOG("ProjectAutosave: restored snapshot + " + juce::String(replayed) + " journal records");
+    }
+
+    project.notesChanged();
+    project.setModified(true);
+    return true;
+}
+
+void ProjectAutosave::updateShadow(const Project& project)
+{
+    const auto& audioData = project.getAudioData();
+    shadow.f0 = audioData.f0;
+    shadow.basePitch = audioData.basePitch;
+    shadow.deltaPitch = audioData.deltaPitch;
+    shadow.voicedMask = audioData.voicedMask;
+    shadow.globalPitchOffset = project.getGlobalPitchOffset();
+    shadow.formantShift = project.getFormantShift();
+    shadow.volume = project.getVolume();
+    shadow.name = project.getName();
+    shadow.projectFilePath = project.getProjectFilePath().getFullPathName();
+
+    juce::MemoryOutputStream notes;
+    ProjectFile::writeNotes(notes, project.getNotes());
+    shadow.notes = notes.getMemoryBlock();
+}
+
+std::shared_ptr<Project> ProjectAutosave::makeSnapshot(const Project& project)
+{
+    auto snapshot = std::make_shared<Project>();
+    snapshot->setName(project.getName());
+    snapshot->setFilePath(project.getFilePath());
+    snapshot->setProjectFilePath(project.getProjectFilePath());
+    snapshot->setGlobalPitchOffset(project.getGlobalPitchOffset());
+    snapshot->setFormantShift(project.getFormantShift());
+    snapshot->setVolume(project.getVolume());
+    snapshot->getNotes() = project.getNotes();
+    snapshot->notesChanged();
+
+    const auto& source = project.getAudioData();
+    auto& audioData = snapshot->getAudioData();
+    audioData.sampleRate = source.sampleRate;
+    audioData.f0 = source.f0;
+    audioData.basePitch = source.basePitch;
+    audioData.deltaPitch = source.deltaPitch;
+    audioData.voicedMask = source.voicedMask;
+    return snapshot;
+}
+
+void ProjectAutosave::compact(const Project& project)
+{
+    Job job;
+    job.snapshot = makeSnapshot(project);
+    enqueue(std::move(job));
+
+    journalBytes = 0;
+    journalRecords = 0;
+}
+
+void ProjectAutosave::enqueue(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(job));
+    }
+    queueCondition.notify_one();
+}
+
+void ProjectAutosave::stopWriter()
+{
+    if (!writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+    queueCondition.notify_one();
+    writer.join();
+    journal.reset();
+}
+
+void ProjectAutosave::writerLoop()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopRequested || !queue.empty(); });
+            if (queue.empty())
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        if (job.snapshot)
+        {
+            if (job.newSession)
+            {
+                // An old journal must never be replayed over the new snapshot
+                journal.reset();
+                journalFile.deleteFile();
+            }
+            writeSnapshot(*job.snapshot);
+        }
+        else
+        {
+            appendRecord(job.record);
+        }
+    }
+}
+
+bool ProjectAutosave::writeSnapshot(const Project& snapshot)
+{
+    if (!directory.createDirectory())
+    {
+        LOG("ProjectAutosave: cannot create " + directory.getFullPathName());
+        return false;
+    }
+
+    ProjectFile::SaveOptions options;
+    options.includeMel = false;
+    options.includeWaveform = false;
+    if (!ProjectFile::save(snapshot, snapshotFile, options))
+    {
+        // The old snapshot and journal stay consistent (the journal already
+        // holds the change that triggered this compaction), so keep appending
+        LOG("ProjectAutosave: snapshot failed");
+        return false;
+    }
+
+    // Records so far are covered by the snapshot; start the journal over
+    journal = std::make_unique<juce::FileOutputStream>(journalFile);
+    if (!journal->openedOk() || !journal->setPosition(0) || journal->truncate().failed())
+    {
+        LOG("ProjectAutosave: cannot open " + journalFile.getFullPathName());
+        journal.reset();
+        return false;
+    }
+
+    journal->writeInt(static_cast<int>(JOURNAL_MAGIC));
+    journal->writeInt(static_cast<int>(JOURNAL_VERSION));
+    journal->writeString(snapshot.getProjectFilePath().getFullPathName());
+    journal->flush();
+    nextSequence = 0;
+    return true;
+}
+
+void ProjectAutosave::appendRecord(const juce::MemoryBlock& payload)
+{
+    // Without a journal (no session snapshot yet) changes wait for the next compaction
+    if (journal == nullptr)
+        return;
+
+    journal->writeInt(static_cast<int>(RECORD_MAGIC));
+    journal->writeInt(static_cast<int>(payload.getSize()));
+    journal->writeInt(static_cast<int>(nextSequence++));
+    journal->write(payload.getData(), payload.getSize());
+    journal->writeInt(static_cast<int>(checksum(payload.getData(), payload.getSize())));
+    journal->flush();
+}
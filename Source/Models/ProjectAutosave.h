@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "FrameBuffers.h"
+#include "Note.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Project;
+
+/**
+ * Crash-recovery autosave.
+ *
+ * A session keeps two files in its directory:
+ *   autosave.peproj   snapshot (binary project without the mel and waveform)
+ *   autosave.journal  records appended since the snapshot
+ *
+ * captureChanges() runs on the message thread after each edit. It diffs the
+ * project against a shadow copy of the last captured state and queues only
+ * what changed: frame spans of the curves, the note table if any note
+ * changed, and the global settings. A writer thread appends the record to the
+ * journal, so a safety save costs about the size of the edit. Once the
+ * journal grows past a limit it is compacted: the record that crossed the
+ * limit is appended, then a fresh snapshot replaces the old one and the
+ * journal starts over.
+ *
+ * Records hold absolute values and the journal holds every change up to
+ * the new snapshot, so replaying it over that snapshot (a crash between the
+ * two steps of a compaction) gives the snapshot's state again. Recovery
+ * loads the snapshot and replays records up to the first torn or corrupt
+ * one.
+ */
+class ProjectAutosave
+{
+public:
+    explicit ProjectAutosave(const juce::File& directory);
+    ~ProjectAutosave();
+
+    /** Default location: <config directory>/Autosave. */
+    static juce::File getDefaultDirectory();
+
+    /** Start a new session for project (writes a snapshot and an empty journal). */
+    void start(const Project& project);
+
+    /** Queue a journal record if the project changed since the last capture. */
+    void captureChanges(const Project& project);
+
+    /** End the session and delete its files (clean exit or project closed). */
+    void discard();
+
+    bool isActive() const { return active; }
+
+    /** True if a previous session left a snapshot behind (it did not exit cleanly). */
+    static bool hasRecoverableSession(const juce::File& directory);
+
+    /**
+     * Load the snapshot and replay the journal into project. The mel and
+     * waveform are not part of the session and have to be rebuilt from the
+     * source audio.
+     */
+    static bool restore(const juce::File& directory, Project& project);
+
+private:
+    struct Job
+    {
+        juce::MemoryBlock record;          // Journal payload to append
+        std::shared_ptr<Project> snapshot; // Compaction: snapshot to write instead
+        bool newSession = false;           // Drop the old journal before the snapshot
+    };
+
+    void enqueue(Job job);
+    void writerLoop();
+    bool writeSnapshot(const Project& snapshot);
+    void appendRecord(const juce::MemoryBlock& payload);
+    void stopWriter();
+
+    // Copy of what the session stores (no mel, waveform or salience)
+    static std::shared_ptr<Project> makeSnapshot(const Project& project);
+    void updateShadow(const Project& project);
+    void compact(const Project& project);
+
+    juce::File directory;
+    juce::File snapshotFile;
+    juce::File journalFile;
+
+    // Message thread state: last captured values and journal size since the snapshot
+    struct Shadow
+    {
+        std::vector<float> f0;
+        std::vector<float> basePitch;
+        std::vector<float> deltaPitch;
+        VoicedMask voicedMask;
+        juce::MemoryBlock notes;  // Note table as written by ProjectFile::writeNotes
+        float globalPitchOffset = 0.0f;
+        float formantShift = 0.0f;
+        float volume = 0.0f;
+        juce::String name;
+        juce::String projectFilePath;
+    };
+
+    Shadow shadow;
+    size_t journalBytes = 0;
+    int journalRecords = 0;
+    bool active = false;
+
+    // Writer thread
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<Job> queue;
+    bool stopRequested = false;
+    std::unique_ptr<juce::FileOutputStream> journal;
+    juce::uint32 nextSequence = 0;
+};
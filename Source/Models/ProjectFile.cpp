@@ -0,0 +1,529 @@
+#include "ProjectFile.h"
+#include "Project.h"
+#include "../Utils/AppLogger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr juce::uint32 makeId(char a, char b, char c, char d)
+    {
+        return static_cast<juce::uint32>(static_cast<unsigned char>(a)) |
+               (static_cast<juce::uint32>(static_cast<unsigned char>(b)) << 8) |
+               (static_cast<juce::uint32>(static_cast<unsigned char>(c)) << 16) |
+               (static_cast<juce::uint32>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    constexpr juce::uint32 MAGIC = makeId('H', 'T', 'P', 'J');
+    constexpr juce::uint32 VERSION = 1;
+    constexpr juce::uint32 META_ID = makeId('M', 'E', 'T', 'A');
+    constexpr juce::uint32 NOTE_ID = makeId('N', 'O', 'T', 'E');
+    constexpr juce::uint32 F0_ID = makeId('F', '0', ' ', ' ');
+    constexpr juce::uint32 BASE_ID = makeId('B', 'A', 'S', 'E');
+    constexpr juce::uint32 DELTA_ID = makeId('D', 'L', 'T', 'A');
+    constexpr juce::uint32 MASK_ID = makeId('V', 'M', 'S', 'K');
+    constexpr juce::uint32 SALIENCE_ID = makeId('S', 'A', 'L', 'I');
+    constexpr juce::uint32 MEL_ID = makeId('M', 'E', 'L', ' ');
+    constexpr juce::uint32 WAVE_ID = makeId('W', 'A', 'V', 'E');
+
+    enum Encoding : juce::uint32
+    {
+        RAW = 0,
+        XOR_DELTA_DEFLATE = 1  // 32-bit words XORed with their predecessor, byte planes, zlib
+    };
+
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr size_t CHUNK_ENTRY_SIZE = 32;
+    constexpr size_t DATA_ALIGNMENT = 64;
+
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    struct PendingChunk
+    {
+        juce::uint32 id = 0;
+        juce::uint32 encoding = 0;
+        juce::uint32 param0 = 0;
+        juce::uint32 param1 = 0;
+        juce::MemoryBlock ownedData;
+        const void* data = nullptr;  // Points into ownedData or into the project
+        size_t size = 0;
+    };
+
+    PendingChunk makeChunk(juce::uint32 id, juce::uint32 encoding, juce::MemoryBlock block,
+                           juce::uint32 param0 = 0, juce::uint32 param1 = 0)
+    {
+        PendingChunk chunk;
+        chunk.id = id;
+        chunk.encoding = encoding;
+        chunk.param0 = param0;
+        chunk.param1 = param1;
+        chunk.ownedData = std::move(block);
+        chunk.data = chunk.ownedData.getData();
+        chunk.size = chunk.ownedData.getSize();
+        return chunk;
+    }
+
+    PendingChunk makeViewChunk(juce::uint32 id, const void* data, size_t size,
+                               juce::uint32 param0 = 0, juce::uint32 param1 = 0)
+    {
+        PendingChunk chunk;
+        chunk.id = id;
+        chunk.param0 = param0;
+        chunk.param1 = param1;
+        chunk.data = data;
+        chunk.size = size;
+        return chunk;
+    }
+
+    void writeFloatArray(juce::OutputStream& out, const std::vector<float>& values)
+    {
+        out.writeInt(static_cast<int>(values.size()));
+        out.write(values.data(), values.size() * sizeof(float));
+    }
+
+    bool readFloatArray(juce::InputStream& in, std::vector<float>& values)
+    {
+        const int count = in.readInt();
+        if (count < 0 || static_cast<juce::int64>(count) * 4 > in.getNumBytesRemaining())
+            return false;
+        values.resize(static_cast<size_t>(count));
+        return in.read(values.data(), count * static_cast<int>(sizeof(float))) == count * static_cast<int>(sizeof(float));
+    }
+
+    juce::MemoryBlock encodeCurve(const std::vector<float>& values)
+    {
+        // Neighbouring frames share sign, exponent and high mantissa bits, so
+        // the XOR is mostly zero bytes; grouping byte planes lines those up
+        const size_t count = values.size();
+        std::vector<uint8_t> planes(count * 4);
+        juce::uint32 previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            const juce::uint32 delta = bits ^ previous;
+            previous = bits;
+
+            for (size_t b = 0; b < 4; ++b)
+                planes[b * count + i] = static_cast<uint8_t>(delta >> (8 * b));
+        }
+
+        juce::MemoryOutputStream out;
+        {
+            juce::GZIPCompressorOutputStream zip(out, 6);
+            zip.write(planes.data(), planes.size());
+            zip.flush();
+        }
+        return out.getMemoryBlock();
+    }
+
+    bool decodeCurve(const char* data, size_t size, size_t count, std::vector<float>& values)
+    {
+        std::vector<uint8_t> planes(count * 4);
+        juce::MemoryInputStream source(data, size, false);
+        juce::GZIPDecompressorInputStream zip(source);
+        if (zip.read(planes.data(), static_cast<int>(planes.size())) != static_cast<int>(planes.size()))
+            return false;
+
+        values.resize(count);
+        juce::uint32 previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            juce::uint32 delta = 0;
+            for (size_t b = 0; b < 4; ++b)
+                delta |= static_cast<juce::uint32>(planes[b * count + i]) << (8 * b);
+
+            previous ^= delta;
+            std::memcpy(&values[i], &previous, sizeof(previous));
+        }
+        return true;
+    }
+}
+
+bool ProjectFile::isBinaryProject(const juce::File& file)
+{
+    juce::FileInputStream in(file);
+    return in.openedOk() && static_cast<juce::uint32>(in.readInt()) == MAGIC;
+}
+
+bool ProjectFile::save(const Project& project, const juce::File& file, const SaveOptions& options)
+{
+    // Raw chunks are written in host order
+    if (juce::ByteOrder::isBigEndian())
+        return false;
+
+    const auto& audioData = project.getAudioData();
+    std::vector<PendingChunk> pending;
+
+    {
+        juce::MemoryOutputStream meta;
+        meta.writeString(project.getName());
+        meta.writeString(project.getFilePath().getFullPathName());
+        meta.writeInt(audioData.sampleRate);
+        meta.writeFloat(project.getGlobalPitchOffset());
+        meta.writeFloat(project.getFormantShift());
+        meta.writeFloat(project.getVolume());
+        pending.push_back(makeChunk(META_ID, RAW, meta.getMemoryBlock()));
+    }
+
+    {
+        juce::MemoryOutputStream table;
+        writeNotes(table, project.getNotes());
+        pending.push_back(makeChunk(NOTE_ID, RAW, table.getMemoryBlock(),
+                                    static_cast<juce::uint32>(project.getNotes().size())));
+    }
+
+    pending.push_back(makeChunk(F0_ID, XOR_DELTA_DEFLATE, encodeCurve(audioData.f0),
+                                static_cast<juce::uint32>(audioData.f0.size())));
+    pending.push_back(makeChunk(BASE_ID, XOR_DELTA_DEFLATE, encodeCurve(audioData.basePitch),
+                                static_cast<juce::uint32>(audioData.basePitch.size())));
+    pending.push_back(makeChunk(DELTA_ID, XOR_DELTA_DEFLATE, encodeCurve(audioData.deltaPitch),
+                                static_cast<juce::uint32>(audioData.deltaPitch.size())));
+    pending.push_back(makeViewChunk(MASK_ID, audioData.voicedMask.data(), audioData.voicedMask.size()));
+
+    const auto& salience = audioData.pitchSalience;
+    if (!salience.isEmpty())
+    {
+        juce::MemoryOutputStream out;
+        out.writeDouble(salience.getFrameTime());
+        out.writeFloat(salience.getThreshold());
+        writeFloatArray(out, salience.getBinCents());
+        writeFloatArray(out, salience.getPeaks());
+        const auto& bins = salience.getQuantizedBins();
+        out.writeInt64(static_cast<juce::int64>(bins.size()));
+        out.write(bins.data(), bins.size());
+        pending.push_back(makeChunk(SALIENCE_ID, RAW, out.getMemoryBlock()));
+    }
+
+    const auto& mel = audioData.melSpectrogram;
+    if (options.includeMel && !mel.empty())
+        pending.push_back(makeViewChunk(MEL_ID, mel.getStorageData(), mel.getStorageBytes(),
+                                        static_cast<juce::uint32>(mel.getNumMels()),
+                                        static_cast<juce::uint32>(mel.getStorage())));
+
+    const auto& waveform = audioData.waveform;
+    const size_t channelBytes = static_cast<size_t>(waveform.getNumSamples()) * sizeof(float);
+    const bool writeWaveform = options.includeWaveform && waveform.getNumSamples() > 0;
+
+    // Chunk offsets: table right after the header, data blocks aligned
+    const size_t numChunks = pending.size() + (writeWaveform ? 1 : 0);
+    std::vector<juce::uint64> offsets;
+    size_t position = HEADER_SIZE + numChunks * CHUNK_ENTRY_SIZE;
+    for (const auto& chunk : pending)
+    {
+        position = alignUp(position, DATA_ALIGNMENT);
+        offsets.push_back(position);
+        position += chunk.size;
+    }
+    const size_t waveOffset = alignUp(position, DATA_ALIGNMENT);
+
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk())
+        {
+            LOG("ProjectFile: cannot write " + temp.getFile().getFullPathName());
+            return false;
+        }
+
+        out.writeInt(static_cast<int>(MAGIC));
+        out.writeInt(static_cast<int>(VERSION));
+        out.writeInt(static_cast<int>(numChunks));
+        out.writeInt(0);
+
+        auto writeEntry = [&out](juce::uint32 id, juce::uint32 encoding, juce::uint64 offset, juce::uint64 size,
+                                 juce::uint32 param0, juce::uint32 param1) {
+            out.writeInt(static_cast<int>(id));
+            out.writeInt(static_cast<int>(encoding));
+            out.writeInt64(static_cast<juce::int64>(offset));
+            out.writeInt64(static_cast<juce::int64>(size));
+            out.writeInt(static_cast<int>(param0));
+            out.writeInt(static_cast<int>(param1));
+        };
+
+        for (size_t i = 0; i < pending.size(); ++i)
+            writeEntry(pending[i].id, pending[i].encoding, offsets[i], pending[i].size,
+                       pending[i].param0, pending[i].param1);
+        if (writeWaveform)
+            writeEntry(WAVE_ID, RAW, waveOffset, channelBytes * static_cast<size_t>(waveform.getNumChannels()),
+                       static_cast<juce::uint32>(waveform.getNumChannels()),
+                       static_cast<juce::uint32>(audioData.sampleRate));
+
+        auto padTo = [&out](size_t target) {
+            const auto current = static_cast<size_t>(out.getPosition());
+            if (target > current)
+                out.writeRepeatedByte(0, target - current);
+        };
+
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            padTo(static_cast<size_t>(offsets[i]));
+            out.write(pending[i].data, pending[i].size);
+        }
+
+        if (writeWaveform)
+        {
+            padTo(waveOffset);
+            for (int ch = 0; ch < waveform.getNumChannels(); ++ch)
+                out.write(waveform.getReadPointer(ch), channelBytes);
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            LOG("ProjectFile: write failed: " + out.getStatus().getErrorMessage());
+            return false;
+        }
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+void ProjectFile::writeNotes(juce::OutputStream& out, const std::vector<Note>& notes)
+{
+    out.writeInt(static_cast<int>(notes.size()));
+    for (const auto& note : notes)
+    {
+        out.writeInt(note.getStartFrame());
+        out.writeInt(note.getEndFrame());
+        out.writeFloat(note.getMidiNote());
+        out.writeFloat(note.getPitchOffset());
+        out.writeBool(note.isVibratoEnabled());
+        out.writeFloat(note.getVibratoRateHz());
+        out.writeFloat(note.getVibratoDepthSemitones());
+        out.writeFloat(note.getVibratoPhaseRadians());
+        out.writeBool(note.isRest());
+        out.writeString(note.getLyric());
+        out.writeString(note.getPhoneme());
+    }
+}
+
+bool ProjectFile::readNotes(juce::InputStream& in, std::vector<Note>& notes)
+{
+    notes.clear();
+    const int count = in.readInt();
+    if (count < 0)
+        return false;
+
+    notes.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i)
+    {
+        if (in.isExhausted())
+            return false;
+
+        Note note;
+        note.setStartFrame(in.readInt());
+        note.setEndFrame(in.readInt());
+        note.setMidiNote(in.readFloat());
+        note.setPitchOffset(in.readFloat());
+        note.setVibratoEnabled(in.readBool());
+        note.setVibratoRateHz(in.readFloat());
+        note.setVibratoDepthSemitones(in.readFloat());
+        note.setVibratoPhaseRadians(in.readFloat());
+        note.setRest(in.readBool());
+        note.setLyric(in.readString());
+        note.setPhoneme(in.readString());
+        notes.push_back(std::move(note));
+    }
+    return true;
+}
+
+ProjectFile::Reader::Reader(const juce::File& file)
+{
+    mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapping->getData() != nullptr)
+    {
+        base = static_cast<const char*>(mapping->getData());
+        fileSize = mapping->getSize();
+    }
+    else
+    {
+        mapping.reset();
+        if (!file.loadFileAsData(fallbackData))
+            return;
+        base = static_cast<const char*>(fallbackData.getData());
+        fileSize = fallbackData.getSize();
+    }
+
+    if (juce::ByteOrder::isBigEndian() || fileSize < HEADER_SIZE)
+        return;
+
+    juce::MemoryInputStream in(base, fileSize, false);
+    if (static_cast<juce::uint32>(in.readInt()) != MAGIC)
+        return;
+
+    const auto version = static_cast<juce::uint32>(in.readInt());
+    const auto numChunks = static_cast<juce::uint32>(in.readInt());
+    in.readInt();  // Reserved
+
+    if (version > VERSION)
+    {
+        LOG("ProjectFile: unsupported version " + juce::String(version));
+        return;
+    }
+    if (HEADER_SIZE + static_cast<juce::uint64>(numChunks) * CHUNK_ENTRY_SIZE > fileSize)
+        return;
+
+    chunks.reserve(numChunks);
+    for (juce::uint32 i = 0; i < numChunks; ++i)
+    {
+        Chunk chunk;
+        chunk.id = static_cast<juce::uint32>(in.readInt());
+        chunk.encoding = static_cast<juce::uint32>(in.readInt());
+        chunk.offset = static_cast<juce::uint64>(in.readInt64());
+        chunk.size = static_cast<juce::uint64>(in.readInt64());
+        chunk.param0 = static_cast<juce::uint32>(in.readInt());
+        chunk.param1 = static_cast<juce::uint32>(in.readInt());
+
+        if (chunk.offset > fileSize || chunk.size > fileSize - chunk.offset)
+        {
+            LOG("ProjectFile: chunk " + juce::String(i) + " lies outside the file");
+            return;
+        }
+        chunks.push_back(chunk);
+    }
+
+    valid = findChunk(META_ID) != nullptr;
+}
+
+bool ProjectFile::Reader::hasMel() const
+{
+    return findChunk(MEL_ID) != nullptr;
+}
+
+bool ProjectFile::Reader::hasWaveform() const
+{
+    return findChunk(WAVE_ID) != nullptr;
+}
+
+const ProjectFile::Reader::Chunk* ProjectFile::Reader::findChunk(juce::uint32 id) const
+{
+    for (const auto& chunk : chunks)
+    {
+        if (chunk.id == id)
+            return &chunk;
+    }
+    return nullptr;
+}
+
+bool ProjectFile::Reader::readCurve(juce::uint32 id, std::vector<float>& values) const
+{
+    values.clear();
+    const auto* chunk = findChunk(id);
+    if (chunk == nullptr)
+        return true;
+
+    if (chunk->encoding == XOR_DELTA_DEFLATE)
+        return decodeCurve(getChunkData(*chunk), static_cast<size_t>(chunk->size), chunk->param0, values);
+
+    if (chunk->encoding != RAW)
+        return false;
+
+    const auto* data = reinterpret_cast<const float*>(getChunkData(*chunk));
+    values.assign(data, data + chunk->size / sizeof(float));
+    return true;
+}
+
+bool ProjectFile::Reader::readProject(Project& project) const
+{
+    if (!valid)
+        return false;
+
+    auto& audioData = project.getAudioData();
+
+    {
+        const auto* chunk = findChunk(META_ID);
+        juce::MemoryInputStream in(getChunkData(*chunk), static_cast<size_t>(chunk->size), false);
+        project.setName(in.readString());
+        project.setFilePath(juce::File(in.readString()));
+        audioData.sampleRate = in.readInt();
+        project.setGlobalPitchOffset(in.readFloat());
+        project.setFormantShift(in.readFloat());
+        project.setVolume(in.readFloat());
+    }
+
+    project.getNotes().clear();
+    if (const auto* chunk = findChunk(NOTE_ID))
+    {
+        juce::MemoryInputStream in(getChunkData(*chunk), static_cast<size_t>(chunk->size), false);
+        readNotes(in, project.getNotes());
+    }
+    project.notesChanged();
+
+    if (!readCurve(F0_ID, audioData.f0) || !readCurve(BASE_ID, audioData.basePitch) ||
+        !readCurve(DELTA_ID, audioData.deltaPitch))
+    {
+        LOG("ProjectFile: corrupt pitch curve");
+        return false;
+    }
+
+    audioData.voicedMask.clear();
+    if (const auto* chunk = findChunk(MASK_ID))
+    {
+        const auto* data = reinterpret_cast<const uint8_t*>(getChunkData(*chunk));
+        audioData.voicedMask.assign(data, data + chunk->size);
+    }
+
+    audioData.pitchSalience.clear();
+    if (const auto* chunk = findChunk(SALIENCE_ID))
+    {
+        juce::MemoryInputStream in(getChunkData(*chunk), static_cast<size_t>(chunk->size), false);
+        const double frameTime = in.readDouble();
+        const float threshold = in.readFloat();
+
+        std::vector<float> cents, peaks;
+        std::vector<uint8_t> bins;
+        bool ok = readFloatArray(in, cents) && readFloatArray(in, peaks);
+        const auto binCount = in.readInt64();
+        if (ok && binCount >= 0 && binCount <= in.getNumBytesRemaining())
+        {
+            bins.resize(static_cast<size_t>(binCount));
+            ok = in.read(bins.data(), static_cast<int>(binCount)) == static_cast<int>(binCount);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (ok)
+            audioData.pitchSalience.restore(frameTime, threshold, std::move(cents), std::move(peaks), std::move(bins));
+    }
+
+    project.setModified(false);
+    return true;
+}
+
+bool ProjectFile::Reader::readMel(MelBuffer& mel) const
+{
+    const auto* chunk = findChunk(MEL_ID);
+    if (chunk == nullptr || chunk->param0 == 0)
+        return false;
+
+    const auto storage = chunk->param1 == static_cast<juce::uint32>(MelStorage::Float16) ? MelStorage::Float16
+                                                                                         : MelStorage::Float32;
+    const size_t rowBytes = chunk->param0 * (storage == MelStorage::Float16 ? sizeof(uint16_t) : sizeof(float));
+    const auto numFrames = static_cast<int>(chunk->size / rowBytes);
+
+    mel = MelBuffer(numFrames, static_cast<int>(chunk->param0), storage);
+    std::memcpy(mel.getStorageData(), getChunkData(*chunk), mel.getStorageBytes());
+    return true;
+}
+
+bool ProjectFile::Reader::readWaveform(juce::AudioBuffer<float>& waveform) const
+{
+    const auto* chunk = findChunk(WAVE_ID);
+    if (chunk == nullptr || chunk->param0 == 0)
+        return false;
+
+    const int numChannels = static_cast<int>(chunk->param0);
+    const auto numSamples = static_cast<int>(chunk->size / (sizeof(float) * chunk->param0));
+    const auto* data = reinterpret_cast<const float*>(getChunkData(*chunk));
+
+    waveform.setSize(numChannels, numSamples, false, false, false);
+    for (int ch = 0; ch < numChannels; ++ch)
+        waveform.copyFrom(ch, 0, data + static_cast<size_t>(ch) * static_cast<size_t>(numSamples), numSamples);
+    return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "FrameBuffers.h"
+#include <memory>
+#include <vector>
+
+class Note;
+class Project;
+
+/**
+ * Binary chunked project file (.peproj).
+ *
+ * Layout (little-endian):
+ *   header      magic "HTPJ", version, chunk count, reserved     16 bytes
+ *   chunk table one ChunkEntry per chunk                         32 bytes each
+ *   chunk data  each chunk starts on a 64-byte boundary
+ *
+ * Chunks:
+ *   META  name, audio path, sample rate, global settings
+ *   NOTE  note table
+ *   F0 / BASE / DLTA  f0, base and delta pitch curves
+ *   VMSK  uv mask, one byte per frame
+ *   SALI  detector salience (optional)
+ *   MEL   cached mel spectrogram, raw rows in its storage format (optional)
+ *   WAVE  cached synthesized waveform, planar float32 (optional)
+ *
+ * Curves are stored XOR-delta encoded and deflated (lossless, and smooth or
+ * flat stretches shrink to almost nothing); the mel and waveform are raw so
+ * reading them is a copy out of the memory-mapped file. Unknown chunks are
+ * skipped, so later versions can add chunks without breaking older readers.
+ *
+ * The XML format (Project::toXml / fromXml) stays readable for import and
+ * is still used for plugin state.
+ */
+class ProjectFile
+{
+public:
+    struct SaveOptions
+    {
+        bool includeMel = true;       // Opening skips mel analysis
+        bool includeWaveform = true;  // Opening skips decoding the audio file
+    };
+
+    /** True if the file starts with the binary project magic. */
+    static bool isBinaryProject(const juce::File& file);
+
+    /**
+     * Write the project to a temporary file next to the target and move it
+     * into place, so a failed save never leaves a truncated project.
+     */
+    static bool save(const Project& project, const juce::File& file, const SaveOptions& options = {});
+
+    /** Note table layout (NOTE chunk), shared with the autosave journal. */
+    static void writeNotes(juce::OutputStream& out, const std::vector<Note>& notes);
+    static bool readNotes(juce::InputStream& in, std::vector<Note>& notes);
+
+    /**
+     * Read-only view of a binary project file. The file is memory-mapped
+     * and each chunk is only touched when it is read, so skipped chunks
+     * (e.g. the waveform when rendering) cost nothing.
+     */
+    class Reader
+    {
+    public:
+        explicit Reader(const juce::File& file);
+
+        bool isValid() const { return valid; }
+
+        /** Metadata, notes, curves, uv mask and salience. */
+        bool readProject(Project& project) const;
+
+        bool hasMel() const;
+        bool readMel(MelBuffer& mel) const;
+
+        bool hasWaveform() const;
+        bool readWaveform(juce::AudioBuffer<float>& waveform) const;
+
+    private:
+        struct Chunk
+        {
+            juce::uint32 id = 0;
+            juce::uint32 encoding = 0;
+            juce::uint64 offset = 0;
+            juce::uint64 size = 0;
+            juce::uint32 param0 = 0;
+            juce::uint32 param1 = 0;
+        };
+
+        const Chunk* findChunk(juce::uint32 id) const;
+        const char* getChunkData(const Chunk& chunk) const { return base + chunk.offset; }
+        bool readCurve(juce::uint32 id, std::vector<float>& values) const;
+
+        std::unique_ptr<juce::MemoryMappedFile> mapping;
+        juce::MemoryBlock fallbackData;  // When the file cannot be mapped
+        const char* base = nullptr;
+        size_t fileSize = 0;
+        std::vector<Chunk> chunks;
+        bool valid = false;
+    };
+};
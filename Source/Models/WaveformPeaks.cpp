@@ -0,0 +1,172 @@
+#include "WaveformPeaks.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    struct Accumulator
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        double sumSquares = 0.0;
+
+        void addSamples(const float* samples, int start, int end)
+        {
+            for (int i = start; i < end; ++i)
+            {
+                const float s = samples[i];
+                min = std::min(min, s);
+                max = std::max(max, s);
+                sumSquares += static_cast<double>(s) * s;
+            }
+        }
+    };
+}
+
+WaveformPeaks::Block WaveformPeaks::scanBlock(const float* samples, int start, int end)
+{
+    Block block;
+    block.min = samples[start];
+    block.max = samples[start];
+    double sumSquares = 0.0;
+    for (int i = start; i < end; ++i)
+    {
+        const float s = samples[i];
+        block.min = std::min(block.min, s);
+        block.max = std::max(block.max, s);
+        sumSquares += static_cast<double>(s) * s;
+    }
+    block.sumSquares = static_cast<float>(sumSquares);
+    return block;
+}
+
+void WaveformPeaks::build(const float* samples, int count)
+{
+    clear();
+    if (samples == nullptr || count <= 0)
+        return;
+
+    numSamples = count;
+    const int numBlocks = (count + samplesPerBlock - 1) / samplesPerBlock;
+
+    // Size every level up front, then fill them bottom-up
+    levels.emplace_back(static_cast<size_t>(numBlocks));
+    while (levels.back().size() > 1)
+        levels.emplace_back((levels.back().size() + 1) / 2);
+
+    for (int b = 0; b < numBlocks; ++b)
+        levels[0][static_cast<size_t>(b)] =
+            scanBlock(samples, b * samplesPerBlock, std::min(count, (b + 1) * samplesPerBlock));
+
+    updateParents(0, numBlocks - 1);
+}
+
+void WaveformPeaks::update(const float* samples, int startSample, int count)
+{
+    if (samples == nullptr || levels.empty())
+        return;
+
+    const int start = std::max(0, startSample);
+    const int end = std::min(numSamples, startSample + count);
+    if (start >= end)
+        return;
+
+    const int firstBlock = start / samplesPerBlock;
+    const int lastBlock = (end - 1) / samplesPerBlock;
+    for (int b = firstBlock; b <= lastBlock; ++b)
+        levels[0][static_cast<size_t>(b)] =
+            scanBlock(samples, b * samplesPerBlock, std::min(numSamples, (b + 1) * samplesPerBlock));
+
+    updateParents(firstBlock, lastBlock);
+}
+
+void WaveformPeaks::updateParents(int firstBlock, int lastBlock)
+{
+    for (size_t level = 1; level < levels.size(); ++level)
+    {
+        const auto& children = levels[level - 1];
+        auto& parents = levels[level];
+        firstBlock /= 2;
+        lastBlock /= 2;
+
+        for (int p = firstBlock; p <= lastBlock; ++p)
+        {
+            const auto left = static_cast<size_t>(2 * p);
+            Block block = children[left];
+            if (left + 1 < children.size())
+            {
+                const auto& right = children[left + 1];
+                block.min = std::min(block.min, right.min);
+                block.max = std::max(block.max, right.max);
+                block.sumSquares += right.sumSquares;
+            }
+            parents[static_cast<size_t>(p)] = block;
+        }
+    }
+}
+
+void WaveformPeaks::clear()
+{
+    levels.clear();
+    numSamples = 0;
+}
+
+WaveformPeaks::Peak WaveformPeaks::getPeak(const float* samples, int startSample, int endSample) const
+{
+    const int start = std::max(0, startSample);
+    const int end = std::min(numSamples, endSample);
+    if (samples == nullptr || start >= end)
+        return {};
+
+    Accumulator acc;
+
+    // Whole blocks inside the range come from the pyramid, the ragged ends from the samples
+    const int firstBlock = (start + samplesPerBlock - 1) / samplesPerBlock;
+    const int endBlock = end / samplesPerBlock;
+    if (firstBlock >= endBlock)
+    {
+        acc.addSamples(samples, start, end);
+    }
+    else
+    {
+        acc.addSamples(samples, start, firstBlock * samplesPerBlock);
+        acc.addSamples(samples, endBlock * samplesPerBlock, end);
+
+        // Climb while the range is aligned, taking unpaired entries at either end
+        int lo = firstBlock;
+        int hi = endBlock;
+        for (size_t level = 0; lo < hi; ++level)
+        {
+            const auto& blocks = levels[level];
+            auto take = [&](int index)
+            {
+                const auto& block = blocks[static_cast<size_t>(index)];
+                acc.min = std::min(acc.min, block.min);
+                acc.max = std::max(acc.max, block.max);
+                acc.sumSquares += block.sumSquares;
+            };
+
+            if (lo & 1)
+                take(lo++);
+            if (hi & 1)
+                take(--hi);
+            lo /= 2;
+            hi /= 2;
+        }
+    }
+
+    Peak peak;
+    peak.min = acc.min;
+    peak.max = acc.max;
+    peak.rms = static_cast<float>(std::sqrt(acc.sumSquares / static_cast<double>(end - start)));
+    return peak;
+}
+
+size_t WaveformPeaks::getMemoryBytes() const
+{
+    size_t bytes = levels.capacity() * sizeof(std::vector<Block>);
+    for (const auto& level : levels)
+        bytes += level.capacity() * sizeof(Block);
+    return bytes;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Min/max/RMS peak pyramid over one waveform channel, for drawing.
+ *
+ * Level 0 summarises blocks of samplesPerBlock samples; each level above
+ * halves the resolution until a single block covers the whole signal. A
+ * query combines O(log n) pyramid entries plus at most two partial blocks of
+ * raw samples at its ends, so drawing a pixel column costs the same at any
+ * zoom level and file length.
+ *
+ * The pyramid does not own the samples: build() and update() read them, and
+ * getPeak() needs the same data for the partial blocks. When samples are
+ * rewritten in place, update() recomputes only the blocks they touch and
+ * their parents.
+ */
+class WaveformPeaks
+{
+public:
+    static constexpr int samplesPerBlock = 64;
+
+    struct Peak
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+
+        float getMagnitude() const { return max > -min ? max : -min; }
+    };
+
+    void build(const float* samples, int numSamples);
+
+    /** Samples [startSample, startSample + count) changed in place. */
+    void update(const float* samples, int startSample, int count);
+
+    void clear();
+
+    /** Number of samples the pyramid was built for (0 if not built). */
+    int getNumSamples() const { return numSamples; }
+
+    /** Min, max and RMS of samples [startSample, endSample), clamped to the signal. */
+    Peak getPeak(const float* samples, int startSample, int endSample) const;
+
+    size_t getMemoryBytes() const;
+
+private:
+    struct Block
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float sumSquares = 0.0f;
+    };
+
+    static Block scanBlock(const float* samples, int start, int end);
+    void updateParents(int firstBlock, int lastBlock);
+
+    std::vector<std::vector<Block>> levels;
+    int numSamples = 0;
+};
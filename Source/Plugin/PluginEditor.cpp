@@ -14,6 +14,7 @@ PitchEditorAudioProcessorEditor::PitchEditorAudioProcessorEditor(PitchEditorAudi
 {
     addAndMakeVisible(mainComponent);
     audioProcessor.setMainComponent(&mainComponent);
+    mainComponent.setCallbackMonitor(&audioProcessor.getRealtimeProcessor().getCallbackMonitor());
 
 #if JucePlugin_Enable_ARA
     setupARAMode();
@@ -108,6 +108,8 @@ void PitchEditorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages) {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    // Times both the ARA renderer and the non-ARA path
+    AudioCallbackMonitor::ScopedCallback timing(realtimeProcessor.getCallbackMonitor(), buffer.getNumSamples());
 
 #if JucePlugin_Enable_ARA
     // ARA mode: let ARA renderer handle audio
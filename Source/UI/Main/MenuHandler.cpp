@@ -18,10 +18,19 @@ juce::PopupMenu MenuHandler::getMenuForIndex(int menuIndex, const juce::String&
             bool canRedo = undoManager && undoManager->canRedo();
             menu.addItem(MenuUndo, TRANS("Undo"), canUndo);
             menu.addItem(MenuRedo, TRANS("Redo"), canRedo);
+            menu.addSeparator();
+            menu.addItem(MenuReanalyzeSelection, TRANS("Re-analyze Selection"),
+                         canReanalyzeSelection && canReanalyzeSelection());
         } else if (menuIndex == 1) {
             // View menu
             menu.addItem(MenuShowDeltaPitch, TRANS("Show Delta Pitch"), true, showDeltaPitch);
             menu.addItem(MenuShowBasePitch, TRANS("Show Base Pitch"), true, showBasePitch);
+            menu.addItem(MenuShowSpectrogram, TRANS("Show Spectrogram"), true, showSpectrogram);
+            menu.addSeparator();
+            menu.addItem(MenuShowPerformanceOverlay, TRANS("Show Performance Overlay"), true,
+                         showPerformanceOverlay);
+            menu.addItem(MenuRecordTrace, TRANS("Record Performance Trace"), true, Tracer::isEnabled());
+            menu.addItem(MenuExportTrace, TRANS("Export Performance Trace..."));
         } else if (menuIndex == 2) {
             // Settings menu
             menu.addItem(MenuSettings, TRANS("Settings..."));
@@ -42,10 +51,19 @@ juce::PopupMenu MenuHandler::getMenuForIndex(int menuIndex, const juce::String&
             bool canRedo = undoManager && undoManager->canRedo();
             menu.addItem(MenuUndo, TRANS("Undo"), canUndo);
             menu.addItem(MenuRedo, TRANS("Redo"), canRedo);
+            menu.addSeparator();
+            menu.addItem(MenuReanalyzeSelection, TRANS("Re-analyze Selection"),
+                         canReanalyzeSelection && canReanalyzeSelection());
         } else if (menuIndex == 2) {
             // View menu
             menu.addItem(MenuShowDeltaPitch, TRANS("Show Delta Pitch"), true, showDeltaPitch);
             menu.addItem(MenuShowBasePitch, TRANS("Show Base Pitch"), true, showBasePitch);
+            menu.addItem(MenuShowSpectrogram, TRANS("Show Spectrogram"), true, showSpectrogram);
+            menu.addSeparator();
+            menu.addItem(MenuShowPerformanceOverlay, TRANS("Show Performance Overlay"), true,
+                         showPerformanceOverlay);
+            menu.addItem(MenuRecordTrace, TRANS("Record Performance Trace"), true, Tracer::isEnabled());
+            menu.addItem(MenuExportTrace, TRANS("Export Performance Trace..."));
         } else if (menuIndex == 3) {
             // Settings menu
             menu.addItem(MenuSettings, TRANS("Settings..."));
@@ -78,9 +96,18 @@ void MenuHandler::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/) {
         case MenuSettings:
             if (onShowSettings) onShowSettings();
             break;
+        case MenuReanalyzeSelection:
+            if (onReanalyzeSelection) onReanalyzeSelection();
+            break;
         case MenuExportSOMEDebug:
             if (onExportSOMEDebug) onExportSOMEDebug();
             break;
+        case MenuExportTrace:
+            if (onExportTrace) onExportTrace();
+            break;
+        case MenuRecordTrace:
+            Tracer::setEnabled(!Tracer::isEnabled());
+            break;
         case MenuShowDeltaPitch:
             showDeltaPitch = !showDeltaPitch;
             if (onShowDeltaPitchChanged) onShowDeltaPitchChanged(showDeltaPitch);
@@ -91,6 +118,16 @@ void MenuHandler::menuItemSelected(int menuItemID, int /*topLevelMenuIndex*/) {
             if (onShowBasePitchChanged) onShowBasePitchChanged(showBasePitch);
             menuItemsChanged();
             break;
+        case MenuShowSpectrogram:
+            showSpectrogram = !showSpectrogram;
+            if (onShowSpectrogramChanged) onShowSpectrogramChanged(showSpectrogram);
+            menuItemsChanged();
+            break;
+        case MenuShowPerformanceOverlay:
+            showPerformanceOverlay = !showPerformanceOverlay;
+            if (onShowPerformanceOverlayChanged) onShowPerformanceOverlayChanged(showPerformanceOverlay);
+            menuItemsChanged();
+            break;
         default:
             break;
     }
@@ -3,6 +3,7 @@
 #include "../../JuceHeader.h"
 #include "../../Utils/UndoManager.h"
 #include "../../Utils/Localization.h"
+#include "../../Utils/Tracer.h"
 #include <functional>
 
 /**
@@ -27,17 +28,26 @@ public:
     std::function<void()> onExportFile;
     std::function<void()> onUndo;
     std::function<void()> onRedo;
+    std::function<void()> onReanalyzeSelection;
+    std::function<bool()> canReanalyzeSelection;
     std::function<void()> onShowSettings;
     std::function<void()> onQuit;
     std::function<void()> onExportSOMEDebug;
+    std::function<void()> onExportTrace;
     std::function<void(bool)> onShowDeltaPitchChanged;
     std::function<void(bool)> onShowBasePitchChanged;
+    std::function<void(bool)> onShowSpectrogramChanged;
+    std::function<void(bool)> onShowPerformanceOverlayChanged;
 
     // View settings
     void setShowDeltaPitch(bool show) { showDeltaPitch = show; }
     void setShowBasePitch(bool show) { showBasePitch = show; }
+    void setShowSpectrogram(bool show) { showSpectrogram = show; }
+    void setShowPerformanceOverlay(bool show) { showPerformanceOverlay = show; }
     bool getShowDeltaPitch() const { return showDeltaPitch; }
     bool getShowBasePitch() const { return showBasePitch; }
+    bool getShowSpectrogram() const { return showSpectrogram; }
+    bool getShowPerformanceOverlay() const { return showPerformanceOverlay; }
 
 private:
     enum MenuIDs {
@@ -50,12 +60,19 @@ private:
         MenuSettings,
         MenuExportSOMEDebug,
         MenuShowDeltaPitch,
-        MenuShowBasePitch
+        MenuShowBasePitch,
+        MenuReanalyzeSelection,
+        MenuShowSpectrogram,
+        MenuShowPerformanceOverlay,
+        MenuExportTrace,
+        MenuRecordTrace
     };
 
     bool pluginMode = false;
     bool showDeltaPitch = true;
     bool showBasePitch = false;
+    bool showSpectrogram = false;
+    bool showPerformanceOverlay = false;
     PitchUndoManager* undoManager = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MenuHandler)
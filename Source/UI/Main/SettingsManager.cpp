@@ -29,6 +29,8 @@ void SettingsManager::loadSettings() {
             juce::String pitchDetectorStr = xml->getStringAttribute("pitchDetector", "RMVPE");
             pitchDetectorType = stringToPitchDetectorType(pitchDetectorStr);
             LOG("SettingsManager: Loaded pitchDetector = " + pitchDetectorStr);
+
+            melStorage = stringToMelStorage(xml->getStringAttribute("melStorage", "float32").toStdString());
         }
     } else {
         LOG("SettingsManager: Settings file not found, using defaults (RMVPE)");
@@ -70,6 +72,10 @@ void SettingsManager::loadConfig() {
                     showDeltaPitch = static_cast<bool>(configObj->getProperty("showDeltaPitch"));
                 if (configObj->hasProperty("showBasePitch"))
                     showBasePitch = static_cast<bool>(configObj->getProperty("showBasePitch"));
+                if (configObj->hasProperty("showSpectrogram"))
+                    showSpectrogram = static_cast<bool>(configObj->getProperty("showSpectrogram"));
+                if (configObj->hasProperty("showPerformanceOverlay"))
+                    showPerformanceOverlay = static_cast<bool>(configObj->getProperty("showPerformanceOverlay"));
             }
         }
     }
@@ -87,6 +93,8 @@ void SettingsManager::saveConfig() {
     config->setProperty("windowHeight", windowHeight);
     config->setProperty("showDeltaPitch", showDeltaPitch);
     config->setProperty("showBasePitch", showBasePitch);
+    config->setProperty("showSpectrogram", showSpectrogram);
+    config->setProperty("showPerformanceOverlay", showPerformanceOverlay);
 
     juce::String jsonText = juce::JSON::toString(juce::var(config.get()));
     configFile.replaceWithText(jsonText);
@@ -3,6 +3,7 @@
 #include "../../JuceHeader.h"
 #include "../../Audio/Vocoder.h"
 #include "../../Audio/PitchDetectorType.h"
+#include "../../Models/FrameBuffers.h"
 #include "../../Utils/PlatformPaths.h"
 #include <functional>
 
@@ -22,6 +23,7 @@ public:
     juce::String getDevice() const { return device; }
     int getThreads() const { return threads; }
     PitchDetectorType getPitchDetectorType() const { return pitchDetectorType; }
+    MelStorage getMelStorage() const { return melStorage; }
 
     // Config (config.json - window state, last file)
     void loadConfig();
@@ -35,8 +37,12 @@ public:
     // View settings
     void setShowDeltaPitch(bool show) { showDeltaPitch = show; }
     void setShowBasePitch(bool show) { showBasePitch = show; }
+    void setShowSpectrogram(bool show) { showSpectrogram = show; }
+    void setShowPerformanceOverlay(bool show) { showPerformanceOverlay = show; }
     bool getShowDeltaPitch() const { return showDeltaPitch; }
     bool getShowBasePitch() const { return showBasePitch; }
+    bool getShowSpectrogram() const { return showSpectrogram; }
+    bool getShowPerformanceOverlay() const { return showPerformanceOverlay; }
 
     // Callbacks
     std::function<void()> onSettingsChanged;
@@ -51,6 +57,7 @@ private:
     juce::String device = "CPU";
     int threads = 0;
     PitchDetectorType pitchDetectorType = PitchDetectorType::RMVPE;
+    MelStorage melStorage = MelStorage::Float32;
 
     // Config
     juce::File lastFilePath;
@@ -58,6 +65,8 @@ private:
     int windowHeight = 800;
     bool showDeltaPitch = true;
     bool showBasePitch = false;
+    bool showSpectrogram = false;
+    bool showPerformanceOverlay = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsManager)
 };
@@ -6,9 +6,14 @@
 #include "../Utils/MelSpectrogram.h"
 #include "../Utils/PitchCurveProcessor.h"
 #include "../Utils/PlatformPaths.h"
+#include "../Utils/Resampler.h"
+#include "../Utils/Tracer.h"
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 #include <climits>
+#include <limits>
+#include <utility>
 
 MainComponent::MainComponent(bool enableAudioDevice)
     : enableAudioDeviceFlag(enableAudioDevice) {
@@ -25,12 +30,26 @@ MainComponent::MainComponent(bool enableAudioDevice)
   fcpePitchDetector = std::make_unique<FCPEPitchDetector>();
   rmvpePitchDetector = std::make_unique<RMVPEPitchDetector>();
   vocoder = std::make_unique<Vocoder>();
-  undoManager = std::make_unique<PitchUndoManager>(100);
+  undoManager = std::make_unique<PitchUndoManager>(
+      500, PitchUndoManager::defaultMemoryBudget);
 
   // Initialize new modular components
   fileManager = std::make_unique<AudioFileManager>();
   audioAnalyzer = std::make_unique<AudioAnalyzer>();
   incrementalSynth = std::make_unique<IncrementalSynthesizer>();
+  renderSnapshots = std::make_unique<RenderSnapshotStore>();
+  undoManager->onActionDropped = [this](UndoableAction &action) {
+    for (const auto &snapshot : action.getRenderSnapshots()) {
+      renderSnapshots->remove(snapshot.beforeId);
+      renderSnapshots->remove(snapshot.afterId);
+    }
+  };
+  incrementalSynth->onRegionAboutToBeReplaced = [this](int start, int count) {
+    onRenderAboutToReplace(start, count);
+  };
+  incrementalSynth->onRegionReplaced = [this](int start, int count) {
+    onRenderReplaced(start, count);
+  };
   playbackController = std::make_unique<PlaybackController>();
   menuHandler = std::make_unique<MenuHandler>();
   settingsManager = std::make_unique<SettingsManager>();
@@ -110,8 +129,9 @@ MainComponent::MainComponent(bool enableAudioDevice)
   audioAnalyzer->setYINDetector(pitchDetector.get());
   audioAnalyzer->setSOMEDetector(someDetector.get());
 
-  // Apply pitch detector type from settings
+  // Apply pitch detector type and mel storage from settings
   audioAnalyzer->setPitchDetectorType(settingsManager->getPitchDetectorType());
+  audioAnalyzer->setMelStorage(settingsManager->getMelStorage());
 
   incrementalSynth->setVocoder(vocoder.get());
   playbackController->setAudioEngine(audioEngine.get());
@@ -136,8 +156,14 @@ MainComponent::MainComponent(bool enableAudioDevice)
   menuHandler->onExportFile = [this]() { exportFile(); };
   menuHandler->onUndo = [this]() { undo(); };
   menuHandler->onRedo = [this]() { redo(); };
+  menuHandler->onReanalyzeSelection = [this]() { reanalyzeSelection(); };
+  menuHandler->canReanalyzeSelection = [this]() {
+    return project && !isLoadingAudio && !isReanalyzing &&
+           !project->getSelectedNotes().empty();
+  };
   menuHandler->onShowSettings = [this]() { showSettings(); };
   menuHandler->onQuit = [this]() { juce::JUCEApplication::getInstance()->systemRequestedQuit(); };
+  menuHandler->onExportTrace = [this]() { exportTrace(); };
   menuHandler->onExportSOMEDebug = [this]() {
     if (!project) return;
 
@@ -189,8 +215,14 @@ MainComponent::MainComponent(bool enableAudioDevice)
   // View menu callbacks
   menuHandler->setShowDeltaPitch(settingsManager->getShowDeltaPitch());
   menuHandler->setShowBasePitch(settingsManager->getShowBasePitch());
+  menuHandler->setShowSpectrogram(settingsManager->getShowSpectrogram());
+  menuHandler->setShowPerformanceOverlay(
+      settingsManager->getShowPerformanceOverlay());
   pianoRoll.setShowDeltaPitch(settingsManager->getShowDeltaPitch());
   pianoRoll.setShowBasePitch(settingsManager->getShowBasePitch());
+  pianoRoll.setShowSpectrogram(settingsManager->getShowSpectrogram());
+  pianoRoll.setShowPerformanceOverlay(
+      settingsManager->getShowPerformanceOverlay());
 
   menuHandler->onShowDeltaPitchChanged = [this](bool show) {
     pianoRoll.setShowDeltaPitch(show);
@@ -202,6 +234,16 @@ MainComponent::MainComponent(bool enableAudioDevice)
     settingsManager->setShowBasePitch(show);
     settingsManager->saveConfig();
   };
+  menuHandler->onShowSpectrogramChanged = [this](bool show) {
+    pianoRoll.setShowSpectrogram(show);
+    settingsManager->setShowSpectrogram(show);
+    settingsManager->saveConfig();
+  };
+  menuHandler->onShowPerformanceOverlayChanged = [this](bool show) {
+    pianoRoll.setShowPerformanceOverlay(show);
+    settingsManager->setShowPerformanceOverlay(show);
+    settingsManager->saveConfig();
+  };
 
   // Add child components - macOS uses native menu, others use in-app menu bar
 #if JUCE_MAC
@@ -253,9 +295,13 @@ MainComponent::MainComponent(bool enableAudioDevice)
   // Setup piano roll callbacks
   pianoRoll.onSeek = [this](double time) { seek(time); };
   pianoRoll.onNoteSelected = [this](Note *note) { onNoteSelected(note); };
-  pianoRoll.onPitchEdited = [this]() { onPitchEdited(); };
+  // The piano roll repaints what an edit changed itself; a full repaint here
+  // would undo its dirty regions on every drawing move
+  pianoRoll.onPitchEdited = [this]() { parameterPanel.updateFromNote(); };
   pianoRoll.onPitchEditFinished = [this]() {
-    resynthesizeIncremental();
+    // Undo/redo restore or resynthesize themselves
+    if (!applyingHistory)
+      resynthesizeIncremental();
     // Melodyne-style: trigger real-time processor update in plugin mode
     if (isPluginMode() && onPitchEditFinished)
       onPitchEditFinished();
@@ -277,6 +323,22 @@ MainComponent::MainComponent(bool enableAudioDevice)
     if (audioEngine)
       audioEngine->setVolumeDb(dB);
   };
+  parameterPanel.onVoicingThresholdChanged = [this](float threshold) {
+    // Cheap re-decode from the stored salience; synthesis runs on drag end.
+    // Each step compares against the curves from the start of the gesture.
+    if (!project || project->getAudioData().pitchSalience.isEmpty())
+      return;
+    if (!voicingBaseline)
+      voicingBaseline = std::make_unique<AudioAnalyzer::F0Baseline>(
+          AudioAnalyzer::captureF0Baseline(*project));
+    voicingEdits =
+        AudioAnalyzer::redecodeF0(*project, *voicingBaseline, threshold);
+    project->setModified(true);
+    pianoRoll.repaint();
+  };
+  parameterPanel.onVoicingThresholdEditFinished = [this]() {
+    commitVoicingThreshold();
+  };
   parameterPanel.setProject(project.get());
 
   // Setup audio engine callbacks
@@ -293,6 +355,8 @@ MainComponent::MainComponent(bool enableAudioDevice)
         toolbar.setPlaying(false);
       });
     });
+
+    pianoRoll.setAudioCallbackMonitor(&audioEngine->getCallbackMonitor());
   }
 
   // Set initial project
@@ -306,9 +370,28 @@ MainComponent::MainComponent(bool enableAudioDevice)
   if (enableAudioDeviceFlag)
     settingsManager->loadConfig();
 
+  // Journal edits for crash recovery (the host saves plugin state)
+  if (enableAudioDeviceFlag) {
+    autosave =
+        std::make_unique<ProjectAutosave>(ProjectAutosave::getDefaultDirectory());
+    undoManager->onHistoryChanged = [this]() {
+      if (autosave && project && !isLoadingAudio.load())
+        autosave->captureChanges(*project);
+    };
+
+    if (ProjectAutosave::hasRecoverableSession(
+            ProjectAutosave::getDefaultDirectory())) {
+      juce::Component::SafePointer<MainComponent> safeThis(this);
+      juce::MessageManager::callAsync([safeThis]() {
+        if (safeThis != nullptr)
+          safeThis->offerSessionRecovery();
+      });
+    }
+  }
+
   LOG("MainComponent: starting timer...");
   // Start timer for UI updates
-  startTimerHz(30);
+  startTimerHz(timerHz);
   LOG("MainComponent: constructor complete");
 }
 
@@ -325,6 +408,12 @@ MainComponent::~MainComponent() {
   cancelLoading = true;
   if (loaderThread.joinable())
     loaderThread.join();
+  if (saveThread.joinable())
+    saveThread.join();
+
+  // Clean exit: nothing to recover
+  if (autosave)
+    autosave->discard();
 
   if (audioEngine) {
     audioEngine->clearCallbacks();
@@ -367,6 +456,8 @@ void MainComponent::mouseDoubleClick(const juce::MouseEvent &e) {
 }
 
 void MainComponent::timerCallback() {
+  pianoRoll.recordTimerTick(1000.0 / timerHz);
+
   // Handle throttled cursor updates (30Hz max)
   if (hasPendingCursorUpdate.load()) {
     double position = pendingCursorTime.load();
@@ -392,6 +483,12 @@ void MainComponent::timerCallback() {
     }
   }
 
+  // Safety net for edits that bypass the undo history (every 2 s)
+  if (autosave && project && !isLoadingAudio.load() && ++autosaveTicks >= 60) {
+    autosaveTicks = 0;
+    autosave->captureChanges(*project);
+  }
+
   if (isLoadingAudio.load()) {
     const auto progress = static_cast<float>(loadingProgress.load());
     toolbar.setProgress(progress);
@@ -519,31 +616,54 @@ void MainComponent::saveProject() {
       if (file.getFileExtension().isEmpty())
         file = file.withFileExtension("peproj");
 
-      toolbar.showProgress("Saving...");
-      toolbar.setProgress(-1.0f);
-
-      const bool ok = project->saveToFile(file);
-      if (ok)
-        project->setProjectFilePath(file);
-
-      toolbar.hideProgress();
+      writeProject(file);
     });
 
     return;
   }
 
+  writeProject(target);
+}
+
+void MainComponent::writeProject(const juce::File &file) {
+  if (!project || isSaving.load())
+    return;
+
   toolbar.showProgress("Saving...");
   toolbar.setProgress(-1.0f);
 
-  const bool ok = project->saveToFile(target);
-  juce::ignoreUnused(ok);
+  // Write a snapshot on a background thread so large projects (mel and
+  // waveform included) do not stall the UI; edits made meanwhile go into
+  // the next save
+  auto snapshot = std::make_shared<Project>(*project);
+  isSaving = true;
+
+  if (saveThread.joinable())
+    saveThread.join();
+
+  juce::Component::SafePointer<MainComponent> safeThis(this);
+  saveThread = std::thread([safeThis, snapshot, file]() {
+    const bool ok = snapshot->saveToFile(file);
+    if (!ok)
+      LOG("Failed to save project: " + file.getFullPathName());
 
-  toolbar.hideProgress();
+    juce::MessageManager::callAsync([safeThis, file, ok]() {
+      if (safeThis == nullptr)
+        return;
+
+      if (ok && safeThis->project)
+        safeThis->project->setProjectFilePath(file);
+
+      safeThis->isSaving = false;
+      safeThis->toolbar.hideProgress();
+    });
+  });
 }
 
 void MainComponent::openFile() {
   fileChooser = std::make_unique<juce::FileChooser>(
-      "Select an audio file...", juce::File{}, "*.wav;*.mp3;*.flac;*.aiff");
+      "Select an audio file or project...", juce::File{},
+      "*.wav;*.mp3;*.flac;*.aiff;*.peproj");
 
   auto chooserFlags = juce::FileBrowserComponent::openMode |
                       juce::FileBrowserComponent::canSelectFiles;
@@ -551,13 +671,16 @@ void MainComponent::openFile() {
   fileChooser->launchAsync(chooserFlags, [this](const juce::FileChooser &fc) {
     auto file = fc.getResult();
     if (file.existsAsFile()) {
-      loadAudioFile(file);
+      if (file.hasFileExtension("peproj"))
+        loadProjectFile(file);
+      else
+        loadAudioFile(file);
     }
   });
 }
 
 void MainComponent::loadAudioFile(const juce::File &file) {
-  if (isLoadingAudio.load())
+  if (isLoadingAudio.load() || isReanalyzing)
     return;
 
   cancelLoading = false;
@@ -629,24 +752,12 @@ void MainComponent::loadAudioFile(const juce::File &file) {
     // Resample if needed
     if (srcSampleRate != SAMPLE_RATE) {
       updateProgress(0.18, "Resampling...");
-      const double ratio = static_cast<double>(srcSampleRate) / SAMPLE_RATE;
-      const int newNumSamples = static_cast<int>(numSamples / ratio);
-
-      juce::AudioBuffer<float> resampledBuffer(1, newNumSamples);
-      const float *src = buffer.getReadPointer(0);
-      float *dst = resampledBuffer.getWritePointer(0);
-
-      for (int i = 0; i < newNumSamples; ++i) {
-        const double srcPos = i * ratio;
-        const int srcIndex = static_cast<int>(srcPos);
-        const double frac = srcPos - srcIndex;
-
-        if (srcIndex + 1 < numSamples)
-          dst[i] = static_cast<float>(src[srcIndex] * (1.0 - frac) +
-                                      src[srcIndex + 1] * frac);
-        else
-          dst[i] = src[srcIndex];
-      }
+      Resampler resampler(srcSampleRate, SAMPLE_RATE);
+      juce::AudioBuffer<float> resampledBuffer(
+          1, resampler.getOutputLength(numSamples));
+      resampler.process(buffer.getReadPointer(0), numSamples,
+                        resampledBuffer.getWritePointer(0),
+                        resampledBuffer.getNumSamples());
 
       buffer = std::move(resampledBuffer);
     }
@@ -678,104 +789,263 @@ void MainComponent::loadAudioFile(const juce::File &file) {
     }
 
     updateProgress(0.95, "Finalizing...");
+    newProject->getAudioData().rebuildWaveformPeaks();
 
     juce::MessageManager::callAsync([safeThis, newProject]() mutable {
-      if (safeThis == nullptr)
+      if (safeThis != nullptr)
+        safeThis->finishLoading(std::move(newProject));
+    });
+  });
+}
+
+void MainComponent::loadProjectFile(const juce::File &file) {
+  loadProjectAsync(
+      "Loading project...",
+      [file](Project &target) {
+        if (target.loadFromFile(file))
+          return true;
+        LOG("Failed to load project: " + file.getFullPathName());
+        return false;
+      },
+      false);
+}
+
+void MainComponent::offerSessionRecovery() {
+  juce::AlertWindow::showOkCancelBox(
+      juce::MessageBoxIconType::QuestionIcon, "Recover Session",
+      "HachiTune did not exit cleanly last time. Restore the unsaved "
+      "session?",
+      "Restore", "Discard", this,
+      juce::ModalCallbackFunction::create([this](int result) {
+        const auto dir = ProjectAutosave::getDefaultDirectory();
+        if (result == 0) {
+          if (autosave)
+            autosave->discard();
+          return;
+        }
+
+        // The session has no rendered audio, so render the edits once the
+        // source audio is loaded
+        loadProjectAsync(
+            "Restoring session...",
+            [dir](Project &target) {
+              return ProjectAutosave::restore(dir, target);
+            },
+            true);
+      }));
+}
+
+void MainComponent::loadProjectAsync(
+    const juce::String &message, std::function<bool(Project &)> readProject,
+    bool renderEdits) {
+  if (isLoadingAudio.load() || isReanalyzing)
+    return;
+
+  cancelLoading = false;
+  isLoadingAudio = true;
+  loadingProgress = 0.0;
+  {
+    const juce::ScopedLock sl(loadingMessageLock);
+    loadingMessage = message;
+  }
+  toolbar.showProgress(message);
+  toolbar.setProgress(0.0f);
+
+  if (loaderThread.joinable())
+    loaderThread.join();
+
+  loaderThread = std::thread([this, message, readProject, renderEdits]() {
+    juce::Component::SafePointer<MainComponent> safeThis(this);
+
+    auto updateProgress = [this](double p, const juce::String &msg) {
+      loadingProgress = juce::jlimit(0.0, 1.0, p);
+      const juce::ScopedLock sl(loadingMessageLock);
+      loadingMessage = msg;
+    };
+
+    auto abortLoading = [safeThis]() {
+      juce::MessageManager::callAsync([safeThis]() {
+        if (safeThis != nullptr)
+          safeThis->isLoadingAudio = false;
+      });
+    };
+
+    updateProgress(0.05, message);
+
+    auto newProject = std::make_shared<Project>();
+    if (!readProject(*newProject)) {
+      abortLoading();
+      return;
+    }
+
+    // Binary projects carry the mel and rendered audio; XML imports (or
+    // projects saved without them) fall back to the source audio
+    auto &audioData = newProject->getAudioData();
+    const bool needsMel = audioData.melSpectrogram.empty();
+    const bool hasCachedWaveform = audioData.waveform.getNumSamples() > 0;
+
+    // A cached waveform is a vocoder render, so the source is read either
+    // way: range re-analysis on the render would detect the edited pitch
+    updateProgress(0.2, "Reading audio...");
+    auto source = AudioFileManager::readAudioFile(newProject->getFilePath());
+    if (cancelLoading.load()) {
+      abortLoading();
+      return;
+    }
+    if (source.getNumSamples() == 0) {
+      LOG("Project audio not found: " +
+          newProject->getFilePath().getFullPathName());
+      if (needsMel || !hasCachedWaveform) {
+        abortLoading();
         return;
+      }
+      // Still usable; re-analysis falls back to the rendered audio
+    }
 
-      safeThis->project = std::make_unique<Project>(std::move(*newProject));
+    if (needsMel) {
+      updateProgress(0.5, "Computing mel spectrogram...");
+      MelSpectrogram melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN,
+                                 FMAX);
+      audioData.melSpectrogram =
+          melComputer.compute(source.getReadPointer(0), source.getNumSamples());
+      audioData.melSpectrogram.setStorage(settingsManager->getMelStorage());
+    }
 
-      // Update UI
-      safeThis->pianoRoll.setProject(safeThis->project.get());
-      safeThis->parameterPanel.setProject(safeThis->project.get());
-      safeThis->toolbar.setTotalTime(
-          safeThis->project->getAudioData().getDuration());
+    if (needsMel || !hasCachedWaveform)
+      audioData.sampleRate = SAMPLE_RATE;
 
-      // Get audio data reference (used in multiple places below)
-      auto &audioData = safeThis->project->getAudioData();
-
-      // Set audio to engine (standalone mode only)
-      // CRITICAL: In plugin mode, audioEngine is nullptr and should NEVER be
-      // accessed
-      if (safeThis) {
-        // CRITICAL FIRST CHECK: Never call loadWaveform in plugin mode
-        if (safeThis->isPluginMode()) {
-          // This is expected in plugin mode - audioEngine doesn't exist
-          // No need to log or call loadWaveform
-        } else if (safeThis->audioEngine) {
-          // Double-check audioEngine is still valid before calling
-          AudioEngine *engine = safeThis->audioEngine.get();
-          if (engine) {
-            DBG("MainComponent::loadAudioFile - calling loadWaveform, "
-                "engine="
-                << juce::String::toHexString(
-                       reinterpret_cast<uintptr_t>(engine)));
-            try {
-              engine->loadWaveform(audioData.waveform, audioData.sampleRate);
-            } catch (...) {
-              DBG("MainComponent::loadAudioFile - EXCEPTION in loadWaveform!");
-            }
-          } else {
-            DBG("MainComponent::loadAudioFile - engine pointer is null!");
-          }
-        } else {
-          DBG("MainComponent::loadAudioFile - audioEngine is null in "
-              "standalone mode!");
-        }
+    std::shared_ptr<juce::AudioBuffer<float>> sourceAudio;
+    if (!hasCachedWaveform)
+      audioData.waveform = std::move(source);
+    else if (source.getNumSamples() > 0)
+      sourceAudio =
+          std::make_shared<juce::AudioBuffer<float>>(std::move(source));
+
+    if (cancelLoading.load()) {
+      abortLoading();
+      return;
+    }
+
+    updateProgress(0.95, "Finalizing...");
+    newProject->getAudioData().rebuildWaveformPeaks();
+
+    juce::MessageManager::callAsync(
+        [safeThis, newProject, renderEdits, sourceAudio]() mutable {
+          if (safeThis != nullptr)
+            safeThis->finishLoading(std::move(newProject), renderEdits,
+                                    std::move(sourceAudio));
+        });
+  });
+}
+
+void MainComponent::finishLoading(
+    std::shared_ptr<Project> newProject, bool renderEdits,
+    std::shared_ptr<juce::AudioBuffer<float>> sourceAudio) {
+  project = std::make_unique<Project>(std::move(*newProject));
+  renderSnapshots->clear();
+  voicingBaseline.reset();
+  voicingEdits.clear();
+
+  // Update UI
+  pianoRoll.setProject(project.get());
+  parameterPanel.setProject(project.get());
+  toolbar.setTotalTime(project->getAudioData().getDuration());
+
+  // Get audio data reference (used in multiple places below)
+  auto &audioData = project->getAudioData();
+
+  // Set audio to engine (standalone mode only)
+  // CRITICAL: In plugin mode, audioEngine is nullptr and should NEVER be
+  // accessed
+  if (isPluginMode()) {
+    // This is expected in plugin mode - audioEngine doesn't exist
+    // No need to log or call loadWaveform
+  } else if (audioEngine) {
+    // Double-check audioEngine is still valid before calling
+    AudioEngine *engine = audioEngine.get();
+    if (engine) {
+      DBG("MainComponent::finishLoading - calling loadWaveform, "
+          "engine="
+          << juce::String::toHexString(
+                 reinterpret_cast<uintptr_t>(engine)));
+      try {
+        engine->loadWaveform(audioData.waveform, audioData.sampleRate);
+      } catch (...) {
+        DBG("MainComponent::finishLoading - EXCEPTION in loadWaveform!");
       }
+    } else {
+      DBG("MainComponent::finishLoading - engine pointer is null!");
+    }
+  } else {
+    DBG("MainComponent::finishLoading - audioEngine is null in "
+        "standalone mode!");
+  }
 
-      // Save original waveform for incremental synthesis
-      safeThis->originalWaveform.makeCopyOf(audioData.waveform);
-      safeThis->hasOriginalWaveform = true;
+  // Save original waveform for incremental synthesis and re-analysis (the
+  // project waveform is a render when it came from the project cache)
+  if (sourceAudio != nullptr && sourceAudio->getNumSamples() > 0)
+    originalWaveform = std::move(*sourceAudio);
+  else
+    originalWaveform.makeCopyOf(audioData.waveform);
+  hasOriginalWaveform = true;
 
-      // Center view on detected pitch range
-      const auto &f0 = audioData.f0;
-      if (!f0.empty()) {
-        float minF0 = 10000.0f, maxF0 = 0.0f;
-        for (float freq : f0) {
-          if (freq > 50.0f) // Valid pitch
-          {
-            minF0 = std::min(minF0, freq);
-            maxF0 = std::max(maxF0, freq);
-          }
-        }
-        if (maxF0 > minF0) {
-          float minMidi = freqToMidi(minF0) - 2.0f; // Add margin
-          float maxMidi = freqToMidi(maxF0) + 2.0f;
-          safeThis->pianoRoll.centerOnPitchRange(minMidi, maxMidi);
-        }
+  // Center view on detected pitch range
+  const auto &f0 = audioData.f0;
+  if (!f0.empty()) {
+    float minF0 = 10000.0f, maxF0 = 0.0f;
+    for (float freq : f0) {
+      if (freq > 50.0f) // Valid pitch
+      {
+        minF0 = std::min(minF0, freq);
+        maxF0 = std::max(maxF0, freq);
       }
+    }
+    if (maxF0 > minF0) {
+      float minMidi = freqToMidi(minF0) - 2.0f; // Add margin
+      float maxMidi = freqToMidi(maxF0) + 2.0f;
+      pianoRoll.centerOnPitchRange(minMidi, maxMidi);
+    }
+  }
 
-      // Ensure vocoder is loaded (shared logic - analyzeAudio should have
-      // loaded it, but double-check)
-      if (!safeThis->vocoder->isLoaded()) {
-        DBG("MainComponent::loadAudioFile - vocoder not loaded, loading now");
-        auto modelPath = PlatformPaths::getModelsDirectory().getChildFile(
-            "pc_nsf_hifigan.onnx");
-        if (modelPath.existsAsFile()) {
-          if (safeThis->vocoder->loadModel(modelPath)) {
-            DBG("MainComponent::loadAudioFile - vocoder model loaded "
-                "successfully");
-          } else {
-            DBG("MainComponent::loadAudioFile - failed to load vocoder model");
-          }
-        } else {
-          DBG("MainComponent::loadAudioFile - vocoder model not found");
-        }
+  // Ensure vocoder is loaded (shared logic - analyzeAudio should have
+  // loaded it, but double-check)
+  if (!vocoder->isLoaded()) {
+    DBG("MainComponent::finishLoading - vocoder not loaded, loading now");
+    auto modelPath = PlatformPaths::getModelsDirectory().getChildFile(
+        "pc_nsf_hifigan.onnx");
+    if (modelPath.existsAsFile()) {
+      if (vocoder->loadModel(modelPath)) {
+        DBG("MainComponent::finishLoading - vocoder model loaded "
+            "successfully");
+      } else {
+        DBG("MainComponent::finishLoading - failed to load vocoder model");
       }
+    } else {
+      DBG("MainComponent::finishLoading - vocoder model not found");
+    }
+  }
 
-      safeThis->repaint();
-      safeThis->isLoadingAudio = false;
+  LOG("Project memory after load:\n" +
+      project->getMemoryReport().toString());
 
-      // Notify plugin mode that project data is ready
-      if (safeThis->isPluginMode() && safeThis->onProjectDataChanged)
-        safeThis->onProjectDataChanged();
-    });
-  });
+  repaint();
+  isLoadingAudio = false;
+
+  if (autosave)
+    autosave->start(*project);
+
+  if (renderEdits) {
+    project->setF0DirtyRange(0, audioData.getNumFrames());
+    resynthesizeIncremental();
+  }
+
+  // Notify plugin mode that project data is ready
+  if (isPluginMode() && onProjectDataChanged)
+    onProjectDataChanged();
 }
 
 void MainComponent::analyzeAudio() {
-  if (!project)
+  if (!project || isReanalyzing)
     return;
 
   // Run analysis in background thread to avoid blocking UI
@@ -845,8 +1115,9 @@ void MainComponent::analyzeAudio(
   MelSpectrogram melComputer(SAMPLE_RATE, N_FFT, HOP_SIZE, NUM_MELS, FMIN,
                              FMAX);
   audioData.melSpectrogram = melComputer.compute(samples, numSamples);
+  audioData.melSpectrogram.setStorage(settingsManager->getMelStorage());
 
-  int targetFrames = static_cast<int>(audioData.melSpectrogram.size());
+  int targetFrames = audioData.melSpectrogram.getNumFrames();
 
   onProgress(0.55, "Extracting pitch (F0)...");
 
@@ -865,11 +1136,14 @@ void MainComponent::analyzeAudio(
   // Try selected detector first
   if (detectorType == PitchDetectorType::RMVPE && rmvpePitchDetector && rmvpePitchDetector->isLoaded()) {
     LOG(">>> USING RMVPE (selected)");
-    extractedF0 = rmvpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE);
+    extractedF0 = rmvpePitchDetector->extractF0(
+        samples, numSamples, SAMPLE_RATE, RMVPEPitchDetector::DEFAULT_THRESHOLD,
+        &audioData.pitchSalience);
     useNeuralDetector = true;
   } else if (detectorType == PitchDetectorType::FCPE && fcpePitchDetector && fcpePitchDetector->isLoaded()) {
     LOG(">>> USING FCPE (selected)");
-    extractedF0 = fcpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE);
+    extractedF0 = fcpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE,
+                                               0.05f, &audioData.pitchSalience);
     useNeuralDetector = true;
   } else {
     LOG("WARNING: Selected detector not available!");
@@ -884,11 +1158,14 @@ void MainComponent::analyzeAudio(
     isFallback = true;
     if (rmvpePitchDetector && rmvpePitchDetector->isLoaded()) {
       LOG(">>> FALLBACK: Using RMVPE");
-      extractedF0 = rmvpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE);
+      extractedF0 = rmvpePitchDetector->extractF0(
+          samples, numSamples, SAMPLE_RATE,
+          RMVPEPitchDetector::DEFAULT_THRESHOLD, &audioData.pitchSalience);
       useNeuralDetector = true;
     } else if (fcpePitchDetector && fcpePitchDetector->isLoaded()) {
       LOG(">>> FALLBACK: Using FCPE");
-      extractedF0 = fcpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE);
+      extractedF0 = fcpePitchDetector->extractF0(samples, numSamples, SAMPLE_RATE,
+                                               0.05f, &audioData.pitchSalience);
       useNeuralDetector = true;
     }
   }
@@ -899,41 +1176,8 @@ void MainComponent::analyzeAudio(
 
   if (useNeuralDetector && !extractedF0.empty() && targetFrames > 0) {
     // Resample neural F0 (100 fps @ 16kHz) to vocoder frame rate (86.1 fps @ 44.1kHz)
-    audioData.f0.resize(targetFrames);
-
-    // Time per frame for each system
-    const double neuralFrameTime = 160.0 / 16000.0;    // 0.01 seconds
-    const double vocoderFrameTime = 512.0 / 44100.0;   // ~0.01161 seconds
-
-    for (int i = 0; i < targetFrames; ++i) {
-      double vocoderTime = i * vocoderFrameTime;
-      double neuralFramePos = vocoderTime / neuralFrameTime;
-      int srcIdx = static_cast<int>(neuralFramePos);
-      double frac = neuralFramePos - srcIdx;
-
-      if (srcIdx + 1 < static_cast<int>(extractedF0.size())) {
-        float f0_a = extractedF0[srcIdx];
-        float f0_b = extractedF0[srcIdx + 1];
-
-        if (f0_a > 0.0f && f0_b > 0.0f) {
-          // Log-domain interpolation for musical accuracy
-          float logF0_a = std::log(f0_a);
-          float logF0_b = std::log(f0_b);
-          float logF0_interp = logF0_a * (1.0 - frac) + logF0_b * frac;
-          audioData.f0[i] = std::exp(logF0_interp);
-        } else if (f0_a > 0.0f) {
-          audioData.f0[i] = f0_a;
-        } else if (f0_b > 0.0f) {
-          audioData.f0[i] = f0_b;
-        } else {
-          audioData.f0[i] = 0.0f;
-        }
-      } else if (srcIdx < static_cast<int>(extractedF0.size())) {
-        audioData.f0[i] = extractedF0[srcIdx];
-      } else {
-        audioData.f0[i] = extractedF0.back() > 0.0f ? extractedF0.back() : 0.0f;
-      }
-    }
+    audioData.f0 = AudioAnalyzer::resampleDetectorF0(extractedF0, 160.0 / 16000.0,
+                                                     targetFrames);
 
     // Create voiced mask
     audioData.voicedMask.resize(audioData.f0.size());
@@ -953,6 +1197,7 @@ void MainComponent::analyzeAudio(
         pitchDetector->extractF0(samples, numSamples);
     audioData.f0 = std::move(f0Values);
     audioData.voicedMask = std::move(voicedValues);
+    audioData.pitchSalience.clear();
 
     // Apply F0 smoothing
     onProgress(0.65, "Smoothing pitch curve...");
@@ -1085,6 +1330,36 @@ void MainComponent::exportFile() {
   });
 }
 
+void MainComponent::exportTrace() {
+  auto defaultFile =
+      juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+          .getChildFile("hachitune_trace.json");
+  fileChooser = std::make_unique<juce::FileChooser>("Export performance trace...",
+                                                    defaultFile, "*.json");
+
+  auto chooserFlags = juce::FileBrowserComponent::saveMode |
+                      juce::FileBrowserComponent::canSelectFiles |
+                      juce::FileBrowserComponent::warnAboutOverwriting;
+
+  fileChooser->launchAsync(chooserFlags, [this](const juce::FileChooser &fc) {
+    auto file = fc.getResult();
+    if (file == juce::File{})
+      return;
+
+    // Load in chrome://tracing or ui.perfetto.dev
+    if (Tracer::exportChromeTrace(file.getFullPathName().toStdString()))
+      StyledMessageBox::show(this, "Export Complete",
+                             "Performance trace saved to:\n" +
+                                 file.getFullPathName(),
+                             StyledMessageBox::InfoIcon);
+    else
+      StyledMessageBox::show(this, "Export Failed",
+                             "Could not write trace to:\n" +
+                                 file.getFullPathName(),
+                             StyledMessageBox::WarningIcon);
+  });
+}
+
 void MainComponent::play() {
   if (!project)
     return;
@@ -1200,6 +1475,19 @@ void MainComponent::resynthesizeIncremental() {
   DBG("  Proceeding with synthesis: dirty frames " + juce::String(dirtyStart) +
       " to " + juce::String(dirtyEnd));
 
+  // Attribute the render to the edit that caused it, so undo/redo can
+  // restore its audio. Renders with no new edit behind them, or that
+  // supersede one still in flight (and so cover several edits), are not.
+  renderTargetSerial = 0;
+  if (undoManager) {
+    auto *lastAction = undoManager->getLastAction();
+    if (!applyingHistory && lastAction &&
+        undoManager->getEditCount() != renderedEditCount &&
+        !incrementalSynth->isSynthesizing())
+      renderTargetSerial = lastAction->getSerial();
+    renderedEditCount = undoManager->getEditCount();
+  }
+
   // Setup incrementalSynth
   incrementalSynth->setProject(project.get());
   incrementalSynth->setVocoder(vocoder.get());
@@ -1264,6 +1552,48 @@ void MainComponent::onNoteSelected(Note *note) {
   parameterPanel.setSelectedNote(note);
 }
 
+void MainComponent::commitVoicingThreshold() {
+  if (!project || !voicingBaseline)
+    return;
+
+  const auto baseline = std::move(voicingBaseline);
+  auto edits = std::move(voicingEdits);
+  voicingEdits.clear();
+
+  const float newThreshold =
+      project->getAudioData().pitchSalience.getThreshold();
+  if (edits.empty() && newThreshold == baseline->threshold)
+    return;
+
+  int minFrame = std::numeric_limits<int>::max();
+  int maxFrame = std::numeric_limits<int>::min();
+  for (const auto &e : edits) {
+    minFrame = std::min(minFrame, e.idx);
+    maxFrame = std::max(maxFrame, e.idx);
+  }
+
+  if (undoManager) {
+    undoManager->addAction(std::make_unique<VoicingThresholdAction>(
+        project.get(), std::move(edits), baseline->threshold, newThreshold,
+        [this](int firstFrame, int lastFrame) {
+          // Undo/redo: the slider follows, undo() resynthesizes
+          parameterPanel.updateGlobalSliders();
+          if (project && firstFrame <= lastFrame) {
+            project->setF0DirtyRange(firstFrame, lastFrame);
+            if (isPluginMode() && onPitchEditFinished)
+              onPitchEditFinished();
+          }
+        }));
+  }
+
+  if (minFrame <= maxFrame) {
+    project->setF0DirtyRange(minFrame, maxFrame);
+    resynthesizeIncremental();
+    if (isPluginMode() && onPitchEditFinished)
+      onPitchEditFinished();
+  }
+}
+
 void MainComponent::onPitchEdited() {
   pianoRoll.repaint();
   parameterPanel.updateFromNote();
@@ -1284,30 +1614,140 @@ void MainComponent::onZoomChanged(float pixelsPerSecond) {
 
 void MainComponent::undo() {
   if (undoManager && undoManager->canUndo()) {
+    auto *action = undoManager->getLastAction();
+    const bool renderPending =
+        project && (project->hasF0DirtyRange() || project->hasDirtyNotes());
+
+    applyingHistory = true;
     undoManager->undo();
     pianoRoll.repaint();
 
-    if (project) {
+    if (project && (renderPending || !restoreRenderedAudio(*action, false))) {
       // Don't mark all notes as dirty - let undo action callbacks handle
       // the specific dirty range. This avoids synthesizing the entire project.
       // The undo action's callback will set the correct F0 dirty range.
       resynthesizeIncremental();
     }
+    applyingHistory = false;
   }
 }
 
 void MainComponent::redo() {
   if (undoManager && undoManager->canRedo()) {
+    auto *action = undoManager->getNextRedoAction();
+    const bool renderPending =
+        project && (project->hasF0DirtyRange() || project->hasDirtyNotes());
+
+    applyingHistory = true;
     undoManager->redo();
     pianoRoll.repaint();
 
-    if (project) {
+    if (project && (renderPending || !restoreRenderedAudio(*action, true))) {
       // Don't mark all notes as dirty - let redo action callbacks handle
       // the specific dirty range. This avoids synthesizing the entire project.
       // The redo action's callback will set the correct F0 dirty range.
       resynthesizeIncremental();
     }
+    applyingHistory = false;
+  }
+}
+
+bool MainComponent::restoreRenderedAudio(const UndoableAction &action,
+                                         bool forward) {
+  // A render in flight would land on top of the restored samples
+  const auto &snapshots = action.getRenderSnapshots();
+  if (snapshots.empty() || incrementalSynth->isSynthesizing())
+    return false;
+
+  for (const auto &snapshot : snapshots) {
+    if (!renderSnapshots->contains(forward ? snapshot.afterId
+                                           : snapshot.beforeId))
+      return false;
+  }
+
+  // Undo puts back what each render replaced, newest first; redo replays
+  // the rendered spans in order
+  auto &audioData = project->getAudioData();
+  bool restored = true;
+  if (forward) {
+    for (const auto &snapshot : snapshots)
+      restored = restored &&
+                 renderSnapshots->restore(snapshot.afterId, audioData.waveform);
+  } else {
+    for (auto it = snapshots.rbegin(); it != snapshots.rend(); ++it)
+      restored = restored &&
+                 renderSnapshots->restore(it->beforeId, audioData.waveform);
+  }
+  for (const auto &snapshot : snapshots) {
+    audioData.updateWaveformPeaks(snapshot.startSample, snapshot.numSamples);
+    pianoRoll.invalidateWaveformRange(snapshot.startSample,
+                                      snapshot.numSamples);
+  }
+  if (!restored)
+    return false;
+
+  // The action's callbacks marked its range for resynthesis; the audio
+  // already matches
+  project->clearAllDirty();
+
+  if (audioEngine && !isPluginMode())
+    audioEngine->loadWaveform(audioData.waveform, audioData.sampleRate, true);
+  pianoRoll.repaint();
+
+  if (isPluginMode() && onProjectDataChanged)
+    onProjectDataChanged();
+  return true;
+}
+
+void MainComponent::onRenderAboutToReplace(int startSample, int numSamples) {
+  renderBeforeId = 0;
+  if (renderTargetSerial != 0 && project) {
+    const auto &audioData = project->getAudioData();
+    renderBeforeId = renderSnapshots->add(audioData.waveform, startSample,
+                                          numSamples, audioData.sampleRate);
+  }
+}
+
+void MainComponent::onRenderReplaced(int startSample, int numSamples) {
+  pianoRoll.invalidateWaveformRange(startSample, numSamples);
+
+  const auto serial = std::exchange(renderTargetSerial, juce::uint64{0});
+  const int beforeId = std::exchange(renderBeforeId, 0);
+  if (!undoManager || !project)
+    return;
+
+  auto *action = serial != 0 ? undoManager->findAction(serial) : nullptr;
+  if (action && beforeId != 0) {
+    const auto &audioData = project->getAudioData();
+    const int afterId = renderSnapshots->add(audioData.waveform, startSample,
+                                             numSamples, audioData.sampleRate);
+    if (afterId != 0) {
+      action->addRenderSnapshot({startSample, numSamples, beforeId, afterId});
+      return;
+    }
   }
+  if (beforeId != 0)
+    renderSnapshots->remove(beforeId);
+
+  // Audio changed outside any one undo step: stored spans overlapping it
+  // no longer fit the audio around them
+  const int endSample = startSample + numSamples;
+  undoManager->forEachAction([&](UndoableAction &other) {
+    const auto &snapshots = other.getRenderSnapshots();
+    const bool overlaps = std::any_of(
+        snapshots.begin(), snapshots.end(), [&](const auto &snapshot) {
+          return snapshot.startSample < endSample &&
+                 startSample < snapshot.startSample + snapshot.numSamples;
+        });
+    if (!overlaps)
+      return;
+
+    for (const auto &snapshot : snapshots) {
+      renderSnapshots->remove(snapshot.beforeId);
+      renderSnapshots->remove(snapshot.afterId);
+    }
+    other.clearRenderSnapshots();
+  });
 }
 
 void MainComponent::setEditMode(EditMode mode) {
@@ -1316,7 +1756,7 @@ void MainComponent::setEditMode(EditMode mode) {
 }
 
 void MainComponent::segmentIntoNotes() {
-  if (!project)
+  if (!project || isReanalyzing)
     return;
 
   // Run segmentation in background thread to avoid blocking UI
@@ -1343,6 +1783,7 @@ void MainComponent::segmentIntoNotes() {
 
       // Copy notes back
       safeThis->project->getNotes() = projectCopy->getNotes();
+      safeThis->project->notesChanged();
 
       // Update UI
       safeThis->pianoRoll.invalidateBasePitchCache();
@@ -1351,6 +1792,103 @@ void MainComponent::segmentIntoNotes() {
   });
 }
 
+void MainComponent::reanalyzeSelection() {
+  if (!project)
+    return;
+
+  auto selected = project->getSelectedNotes();
+  if (selected.empty())
+    return;
+
+  int startFrame = INT_MAX;
+  int endFrame = 0;
+  for (auto *note : selected) {
+    startFrame = std::min(startFrame, note->getStartFrame());
+    endFrame = std::max(endFrame, note->getEndFrame());
+  }
+
+  reanalyzeRange(startFrame, endFrame);
+}
+
+void MainComponent::reanalyzeRange(int startFrame, int endFrame) {
+  // One background pass at a time; starting another would join the running
+  // one on the message thread
+  if (!project || isLoadingAudio || isReanalyzing)
+    return;
+
+  // Only the range (plus context) is copied; the live project stays on the
+  // message thread. The project waveform holds vocoder output after a
+  // render, so slice the input audio.
+  auto request = std::make_shared<AudioAnalyzer::RangeRequest>(
+      AudioAnalyzer::prepareRange(*project, startFrame, endFrame,
+                                  hasOriginalWaveform ? &originalWaveform
+                                                      : nullptr));
+  if (request->endFrame <= request->startFrame)
+    return;
+
+  toolbar.showProgress(TR("progress.analyzing"));
+  toolbar.setProgress(-1.0f);
+
+  juce::Component::SafePointer<MainComponent> safeThis(this);
+
+  if (loaderThread.joinable())
+    loaderThread.join();
+
+  // Edits stay enabled meanwhile; applyRange drops the result if they
+  // touched the range
+  isReanalyzing = true;
+  loaderThread = std::thread([safeThis, request]() {
+    if (safeThis == nullptr)
+      return;
+
+    auto result = std::make_shared<AudioAnalyzer::RangeResult>(
+        safeThis->audioAnalyzer->analyzeRange(*request));
+
+    juce::MessageManager::callAsync([safeThis, result]() {
+      if (safeThis == nullptr)
+        return;
+
+      safeThis->isReanalyzing = false;
+      safeThis->toolbar.hideProgress();
+      if (!safeThis->project)
+        return;
+
+      Project::RangeSnapshot before, after;
+      if (!AudioAnalyzer::applyRange(*safeThis->project, *result, &before,
+                                     &after)) {
+        DBG("MainComponent::reanalyzeRange - result discarded (range edited "
+            "or project changed during analysis)");
+        return;
+      }
+
+      if (safeThis->undoManager) {
+        auto *self = safeThis.getComponent();
+        safeThis->undoManager->addAction(std::make_unique<ReanalyzeRangeAction>(
+            self->project.get(), std::move(before), std::move(after),
+            [self](int firstFrame, int endFrame) {
+              // Undo/redo: selected notes may have been swapped out
+              self->onNoteSelected(nullptr);
+              self->project->setF0DirtyRange(firstFrame, endFrame);
+              self->pianoRoll.invalidateBasePitchCache();
+              self->pianoRoll.invalidateSpectrogramRange(firstFrame, endFrame);
+              if (self->isPluginMode() && self->onPitchEditFinished)
+                self->onPitchEditFinished();
+            }));
+      }
+      safeThis->onNoteSelected(nullptr);
+
+      safeThis->pianoRoll.invalidateBasePitchCache();
+      safeThis->pianoRoll.invalidateSpectrogramRange(result->startFrame,
+                                                     result->endFrame);
+      safeThis->pianoRoll.repaint();
+      safeThis->resynthesizeIncremental();
+
+      if (safeThis->onProjectDataChanged)
+        safeThis->onProjectDataChanged();
+    });
+  });
+}
+
 void MainComponent::segmentIntoNotes(Project &targetProject) {
   // NOTE: This function performs SOME model inference.
   // It should ONLY be called from background threads to avoid blocking UI.
@@ -1358,6 +1896,7 @@ void MainComponent::segmentIntoNotes(Project &targetProject) {
   auto &audioData = targetProject.getAudioData();
   auto &notes = targetProject.getNotes();
   notes.clear();
+  targetProject.notesChanged();
 
   if (audioData.f0.empty())
     return;
@@ -1396,11 +1935,7 @@ void MainComponent::segmentIntoNotes(Project &targetProject) {
 
             // Use SOME's predicted MIDI value directly for note position
             // Delta pitch (from RMVPE/FCPE F0) will capture the pitch curve details
-            Note note(f0Start, f0End, someNote.midiNote);
-            std::vector<float> f0Values(audioData.f0.begin() + f0Start,
-                                        audioData.f0.begin() + f0End);
-            note.setF0Values(std::move(f0Values));
-            notes.push_back(note);
+            notes.emplace_back(f0Start, f0End, someNote.midiNote);
           }
 
           // Update UI on main thread
@@ -1447,11 +1982,7 @@ void MainComponent::segmentIntoNotes(Project &targetProject) {
 
     float midi = midiSum / midiCount;
 
-    Note note(start, end, midi);
-    std::vector<float> f0Values(audioData.f0.begin() + start,
-                                audioData.f0.begin() + end);
-    note.setF0Values(std::move(f0Values));
-    notes.push_back(note);
+    notes.emplace_back(start, end, midi);
   };
 
   // Segment F0 into notes, splitting on pitch changes > 0.5 semitones
@@ -1538,6 +2069,9 @@ void MainComponent::showSettings() {
     settingsDialog = std::make_unique<SettingsDialog>(deviceMgr);
     settingsDialog->getSettingsComponent()->onSettingsChanged = [this]() {
       settingsManager->applySettings();
+      // Takes effect on the next analysis; background synthesis may be
+      // reading the current project's mel
+      audioAnalyzer->setMelStorage(settingsManager->getMelStorage());
     };
     settingsDialog->getSettingsComponent()->onPitchDetectorChanged = [this](PitchDetectorType type) {
       audioAnalyzer->setPitchDetectorType(type);
@@ -1552,7 +2086,8 @@ bool MainComponent::isInterestedInFileDrag(const juce::StringArray &files) {
   for (const auto &file : files) {
     if (file.endsWithIgnoreCase(".wav") || file.endsWithIgnoreCase(".mp3") ||
         file.endsWithIgnoreCase(".flac") || file.endsWithIgnoreCase(".aiff") ||
-        file.endsWithIgnoreCase(".ogg") || file.endsWithIgnoreCase(".m4a"))
+        file.endsWithIgnoreCase(".ogg") || file.endsWithIgnoreCase(".m4a") ||
+        file.endsWithIgnoreCase(".peproj"))
       return true;
   }
   return false;
@@ -1563,9 +2098,14 @@ void MainComponent::filesDropped(const juce::StringArray &files, int /*x*/,
   if (files.isEmpty())
     return;
 
-  juce::File audioFile(files[0]);
-  if (audioFile.existsAsFile())
-    loadAudioFile(audioFile);
+  juce::File droppedFile(files[0]);
+  if (!droppedFile.existsAsFile())
+    return;
+
+  if (droppedFile.hasFileExtension("peproj"))
+    loadProjectFile(droppedFile);
+  else
+    loadAudioFile(droppedFile);
 }
 
 void MainComponent::setHostAudio(const juce::AudioBuffer<float> &buffer,
@@ -1573,6 +2113,12 @@ void MainComponent::setHostAudio(const juce::AudioBuffer<float> &buffer,
   if (!isPluginMode())
     return;
 
+  // Joining the loader thread would block until the range pass finishes
+  if (isReanalyzing) {
+    DBG("MainComponent::setHostAudio - skipped, re-analysis in progress");
+    return;
+  }
+
   DBG("MainComponent::setHostAudio called - starting async analysis");
 
   // Use SafePointer to prevent accessing destroyed component
@@ -1585,6 +2131,7 @@ void MainComponent::setHostAudio(const juce::AudioBuffer<float> &buffer,
   // Store sample rate and waveform (on message thread)
   project->getAudioData().sampleRate = static_cast<int>(sampleRate);
   project->getAudioData().waveform = buffer;
+  project->getAudioData().rebuildWaveformPeaks();
 
   // Store original waveform for synthesis
   originalWaveform = buffer;
@@ -9,9 +9,11 @@
 #include "../Audio/IO/AudioFileManager.h"
 #include "../Audio/Analysis/AudioAnalyzer.h"
 #include "../Audio/Synthesis/IncrementalSynthesizer.h"
+#include "../Audio/Synthesis/RenderSnapshotStore.h"
 #include "../Audio/Engine/PlaybackController.h"
 #include "../JuceHeader.h"
 #include "../Models/Project.h"
+#include "../Models/ProjectAutosave.h"
 #include "../Utils/UndoManager.h"
 #include "CustomMenuBarLookAndFeel.h"
 #include "CustomTitleBar.h"
@@ -38,6 +40,7 @@ public:
   void resized() override;
 
   void timerCallback() override;
+  static constexpr int timerHz = 30;  // Cursor updates, progress, autosave
 
   // KeyListener
   bool keyPressed(const juce::KeyPress &key,
@@ -76,23 +79,47 @@ public:
   // Plugin mode - update playback position from host
   void updatePlaybackPosition(double timeSeconds);
 
+  // Plugin mode - host callback timing for the performance overlay
+  void setCallbackMonitor(const AudioCallbackMonitor *monitor) {
+    pianoRoll.setAudioCallbackMonitor(monitor);
+  }
+
 private:
   void openFile();
   void exportFile();
+  void exportTrace();
   void play();
   void pause();
   void stop();
   void seek(double time);
   void resynthesizeIncremental(); // Incremental synthesis on edit
+  // Undo/redo: put back the audio rendered around action instead of
+  // resynthesizing; false if any span is no longer stored
+  bool restoreRenderedAudio(const UndoableAction &action, bool forward);
+  void onRenderAboutToReplace(int startSample, int numSamples);
+  void onRenderReplaced(int startSample, int numSamples);
   void showSettings();
 
   void onNoteSelected(Note *note);
   void onPitchEdited();
+  // Push the finished voicing threshold gesture as one undo step and render it
+  void commitVoicingThreshold();
   void onZoomChanged(float pixelsPerSecond);
   void reinterpolateUV(int startFrame,
                        int endFrame); // Re-infer UV regions using FCPE
 
   void loadAudioFile(const juce::File &file);
+  void loadProjectFile(const juce::File &file);
+  // Runs readProject on the loader thread, then fills in the mel and
+  // waveform from the source audio if the project did not carry them
+  void loadProjectAsync(const juce::String &message,
+                        std::function<bool(Project &)> readProject,
+                        bool renderEdits);
+  // sourceAudio: input audio when the project waveform is a cached render
+  void finishLoading(
+      std::shared_ptr<Project> newProject, bool renderEdits = false,
+      std::shared_ptr<juce::AudioBuffer<float>> sourceAudio = nullptr);
+  void offerSessionRecovery();
   void analyzeAudio();
   void analyzeAudio(
       Project &targetProject,
@@ -100,8 +127,11 @@ private:
       std::function<void()> onComplete = nullptr);
   void segmentIntoNotes();
   void segmentIntoNotes(Project &targetProject);
+  void reanalyzeSelection();
+  void reanalyzeRange(int startFrame, int endFrame);
 
   void saveProject();
+  void writeProject(const juce::File &file);
 
   void undo();
   void redo();
@@ -117,12 +147,17 @@ private:
   std::unique_ptr<SOMEDetector>
       someDetector; // SOME note segmentation detector (legacy)
   std::unique_ptr<Vocoder> vocoder;
+
+  // Curves at the start of the current voicing threshold gesture
+  std::unique_ptr<AudioAnalyzer::F0Baseline> voicingBaseline;
+  std::vector<F0FrameEdit> voicingEdits;
   std::unique_ptr<PitchUndoManager> undoManager;
 
   // New modular components
   std::unique_ptr<AudioFileManager> fileManager;
   std::unique_ptr<AudioAnalyzer> audioAnalyzer;
   std::unique_ptr<IncrementalSynthesizer> incrementalSynth;
+  std::unique_ptr<RenderSnapshotStore> renderSnapshots;
   std::unique_ptr<PlaybackController> playbackController;
   std::unique_ptr<MenuHandler> menuHandler;
   std::unique_ptr<SettingsManager> settingsManager;
@@ -152,12 +187,28 @@ private:
   // Async load state
   std::thread loaderThread;
   std::atomic<bool> isLoadingAudio{false};
+  // Range re-analysis in flight on loaderThread (message thread only)
+  bool isReanalyzing = false;
   std::atomic<bool> cancelLoading{false};
   std::atomic<double> loadingProgress{0.0};
   juce::CriticalSection loadingMessageLock;
   juce::String loadingMessage;
   juce::String lastLoadingMessage;
 
+  // Background project save (writes a snapshot of the project)
+  std::thread saveThread;
+  std::atomic<bool> isSaving{false};
+
+  // Render attribution for undo/redo audio restore
+  bool applyingHistory = false;         // Inside undo()/redo()
+  juce::uint64 renderedEditCount = 0;   // Undo edit count at the last render
+  juce::uint64 renderTargetSerial = 0;  // Action the in-flight render belongs to
+  int renderBeforeId = 0;               // Samples the in-flight render replaced
+
+  // Crash-recovery journal (standalone only)
+  std::unique_ptr<ProjectAutosave> autosave;
+  int autosaveTicks = 0;
+
   // Cursor update throttling
   std::atomic<double> pendingCursorTime{0.0};
   std::atomic<bool> hasPendingCursorUpdate{false};
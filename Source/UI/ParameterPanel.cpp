@@ -29,6 +29,8 @@ ParameterPanel::ParameterPanel()
 
     setupSlider(formantShiftSlider, formantShiftLabel, TR("param.formant_shift"), -12.0, 12.0, 0.0);
     setupSlider(globalPitchSlider, globalPitchLabel, TR("param.global_pitch"), -24.0, 24.0, 0.0);
+    setupSlider(voicingThresholdSlider, voicingThresholdLabel, TR("param.voicing_threshold"), 0.0, 0.5, 0.05);
+    voicingThresholdSlider.setRange(0.0, 0.5, 0.005);
 
     // Section labels
     pitchSectionLabel.setText(TR("param.pitch"), juce::dontSendNotification);
@@ -125,16 +127,20 @@ void ParameterPanel::resized()
     bounds.removeFromTop(5);
     globalPitchLabel.setBounds(bounds.removeFromTop(20));
     globalPitchSlider.setBounds(bounds.removeFromTop(24));
+    bounds.removeFromTop(5);
+    voicingThresholdLabel.setBounds(bounds.removeFromTop(20));
+    voicingThresholdSlider.setBounds(bounds.removeFromTop(24));
 }
 
 void ParameterPanel::sliderValueChanged(juce::Slider* slider)
 {
     if (isUpdating) return;
 
-    if (slider == &pitchOffsetSlider && selectedNote)
+    if (slider == &pitchOffsetSlider && getSelectedNote())
     {
-        selectedNote->setPitchOffset(static_cast<float>(slider->getValue()));
-        selectedNote->markDirty();  // Mark as dirty for incremental synthesis
+        auto* note = getSelectedNote();
+        note->setPitchOffset(static_cast<float>(slider->getValue()));
+        note->markDirty();  // Mark as dirty for incremental synthesis
 
         if (onParameterChanged)
             onParameterChanged();
@@ -150,6 +156,15 @@ void ParameterPanel::sliderValueChanged(juce::Slider* slider)
         if (onGlobalPitchChanged)
             onGlobalPitchChanged();
     }
+    else if (slider == &voicingThresholdSlider && project)
+    {
+        if (onVoicingThresholdChanged)
+            onVoicingThresholdChanged(static_cast<float>(slider->getValue()));
+
+        // Keyboard and wheel steps have no drag around them
+        if (!voicingDragActive && onVoicingThresholdEditFinished)
+            onVoicingThresholdEditFinished();
+    }
     else if (slider == &volumeKnob)
     {
         // Update display
@@ -162,9 +177,15 @@ void ParameterPanel::sliderValueChanged(juce::Slider* slider)
     }
 }
 
+void ParameterPanel::sliderDragStarted(juce::Slider* slider)
+{
+    if (slider == &voicingThresholdSlider)
+        voicingDragActive = true;
+}
+
 void ParameterPanel::sliderDragEnded(juce::Slider* slider)
 {
-    if (slider == &pitchOffsetSlider && selectedNote)
+    if (slider == &pitchOffsetSlider && getSelectedNote())
     {
         // Trigger incremental synthesis when slider drag ends
         if (onParameterEditFinished)
@@ -176,6 +197,12 @@ void ParameterPanel::sliderDragEnded(juce::Slider* slider)
         if (onParameterEditFinished)
             onParameterEditFinished();
     }
+    else if (slider == &voicingThresholdSlider)
+    {
+        voicingDragActive = false;
+        if (project && onVoicingThresholdEditFinished)
+            onVoicingThresholdEditFinished();
+    }
 }
 
 void ParameterPanel::buttonClicked(juce::Button* button)
@@ -191,17 +218,22 @@ void ParameterPanel::setProject(Project* proj)
 
 void ParameterPanel::setSelectedNote(Note* note)
 {
-    selectedNote = note;
+    selectedNote = (note && project) ? project->getHandle(*note) : NoteHandle{};
     updateFromNote();
 }
 
+Note* ParameterPanel::getSelectedNote() const
+{
+    return project ? project->getNote(selectedNote) : nullptr;
+}
+
 void ParameterPanel::updateFromNote()
 {
     isUpdating = true;
 
-    if (selectedNote)
+    if (auto* note = getSelectedNote())
     {
-        float midi = selectedNote->getAdjustedMidiNote();
+        float midi = note->getAdjustedMidiNote();
         int octave = static_cast<int>(midi / 12) - 1;
         int noteIndex = static_cast<int>(midi) % 12;
         static const char* noteNames[] = { "C", "C#", "D", "D#", "E", "F",
@@ -212,7 +244,7 @@ void ParameterPanel::updateFromNote()
                                 " (" + juce::String(midi, 1) + ")";
         noteInfoLabel.setText(noteInfo, juce::dontSendNotification);
 
-        pitchOffsetSlider.setValue(selectedNote->getPitchOffset());
+        pitchOffsetSlider.setValue(note->getPitchOffset());
         pitchOffsetSlider.setEnabled(true);
     }
     else
@@ -233,11 +265,17 @@ void ParameterPanel::updateGlobalSliders()
     {
         globalPitchSlider.setValue(project->getGlobalPitchOffset());
         globalPitchSlider.setEnabled(true);
+
+        // Only adjustable when the detector salience was kept
+        const auto& salience = project->getAudioData().pitchSalience;
+        voicingThresholdSlider.setValue(salience.getThreshold());
+        voicingThresholdSlider.setEnabled(!salience.isEmpty());
     }
     else
     {
         globalPitchSlider.setValue(0.0);
         globalPitchSlider.setEnabled(false);
+        voicingThresholdSlider.setEnabled(false);
     }
 
     isUpdating = false;
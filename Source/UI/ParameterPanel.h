@@ -19,6 +19,7 @@ public:
     void resized() override;
 
     void sliderValueChanged(juce::Slider* slider) override;
+    void sliderDragStarted(juce::Slider* slider) override;
     void sliderDragEnded(juce::Slider* slider) override;
     void buttonClicked(juce::Button* button) override;
 
@@ -33,14 +34,20 @@ public:
     std::function<void()> onParameterEditFinished;  // Called when slider drag ends
     std::function<void()> onGlobalPitchChanged;
     std::function<void(float)> onVolumeChanged;  // Called with volume in dB
+    std::function<void(float)> onVoicingThresholdChanged;  // Re-decode from stored salience
+    std::function<void()> onVoicingThresholdEditFinished;  // End of a drag, or a single step
     
 private:
     void setupSlider(juce::Slider& slider, juce::Label& label,
                     const juce::String& name, double min, double max, double def);
 
+    // Resolves selectedNote; nullptr once the note has been removed
+    Note* getSelectedNote() const;
+
     Project* project = nullptr;
-    Note* selectedNote = nullptr;
+    NoteHandle selectedNote;
     bool isUpdating = false;  // Prevent feedback loops
+    bool voicingDragActive = false;
 
     // Note info
     juce::Label noteInfoLabel;
@@ -63,6 +70,8 @@ private:
     juce::Label globalSectionLabel { {}, "Global Settings" };
     juce::Slider globalPitchSlider;
     juce::Label globalPitchLabel { {}, "Global Pitch:" };
+    juce::Slider voicingThresholdSlider;
+    juce::Label voicingThresholdLabel { {}, "Voicing Threshold:" };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterPanel)
 };
@@ -31,7 +31,13 @@ std::vector<Note*> BoxSelector::getNotesInRect(Project* project, CoordinateMappe
 
     auto rect = getSelectionRect();
 
-    for (auto& note : project->getNotes()) {
+    // Narrow to notes overlapping the rectangle's time span first
+    const float pixelsPerSecond = mapper->getPixelsPerSecond();
+    const int startFrame = secondsToFrames(rect.getX() / pixelsPerSecond) - 1;
+    const int endFrame = secondsToFrames(rect.getRight() / pixelsPerSecond) + 2;
+
+    for (auto* candidate : project->getNotesInRange(startFrame, endFrame)) {
+        auto& note = *candidate;
         if (note.isRest())
             continue;
 
@@ -0,0 +1,238 @@
+#include "NotePathCache.h"
+#include "PitchPathBuilder.h"
+#include "../../Utils/Constants.h"
+#include <cstring>
+
+namespace {
+    constexpr juce::uint64 FNV_OFFSET = 1469598103934665603ull;
+    constexpr juce::uint64 FNV_PRIME = 1099511628211ull;
+
+    void hashFloats(juce::uint64& hash, const std::vector<float>& values, int startFrame, int endFrame) {
+        endFrame = std::min(endFrame, static_cast<int>(values.size()));
+        for (int i = std::max(0, startFrame); i < endFrame; ++i) {
+            juce::uint32 bits;
+            std::memcpy(&bits, &values[static_cast<size_t>(i)], sizeof(bits));
+            hash = (hash ^ bits) * FNV_PRIME;
+        }
+    }
+
+    float catmullRom(float t, float p0, float p1, float p2, float p3) {
+        float t2 = t * t;
+        float t3 = t2 * t;
+        return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
+                       (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                       (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+    }
+}
+
+const juce::Path& NotePathCache::getPitchCurve(const Project& project, const Note& note, float globalPitchOffset,
+                                               float pixelsPerSecond, float pixelsPerSemitone) {
+    const auto& audioData = project.getAudioData();
+    const auto checksum = checksumCurves(audioData, note.getStartFrame(), note.getEndFrame());
+
+    auto& entry = curves[makeKey(project.getHandle(note))];
+    entry.lastUsed = paintCounter;
+    if (entry.version != note.getVersion() || entry.pixelsPerSecond != pixelsPerSecond ||
+        entry.pixelsPerSemitone != pixelsPerSemitone || entry.globalPitchOffset != globalPitchOffset ||
+        entry.curveChecksum != checksum) {
+        entry.version = note.getVersion();
+        entry.pixelsPerSecond = pixelsPerSecond;
+        entry.pixelsPerSemitone = pixelsPerSemitone;
+        entry.globalPitchOffset = globalPitchOffset;
+        entry.curveChecksum = checksum;
+        buildPitchCurve(audioData, note, globalPitchOffset, pixelsPerSecond, pixelsPerSemitone, entry.stroke);
+    }
+    return entry.stroke;
+}
+
+const NotePathCache::NoteWaveform& NotePathCache::getNoteWaveform(const Project& project, const Note& note,
+                                                                  float pixelsPerSecond, float pixelsPerSemitone) {
+    const auto& audioData = project.getAudioData();
+    const auto key = makeKey(project.getHandle(note));
+
+    auto it = waveforms.find(key);
+    if (it == waveforms.end() || it->second.version != note.getVersion() ||
+        it->second.pixelsPerSecond != pixelsPerSecond || it->second.pixelsPerSemitone != pixelsPerSemitone) {
+        auto& entry = waveforms[key];
+        entry.version = note.getVersion();
+        entry.pixelsPerSecond = pixelsPerSecond;
+        entry.pixelsPerSemitone = pixelsPerSemitone;
+        entry.startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) * audioData.sampleRate);
+        entry.endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) * audioData.sampleRate);
+        buildNoteWaveform(audioData, note, pixelsPerSecond, pixelsPerSemitone, entry.shape);
+        it = waveforms.find(key);
+    }
+
+    it->second.lastUsed = paintCounter;
+    return it->second.shape;
+}
+
+void NotePathCache::invalidateSamples(int startSample, int numSamples) {
+    const int endSample = startSample + numSamples;
+    for (auto it = waveforms.begin(); it != waveforms.end();) {
+        if (it->second.startSample < endSample && it->second.endSample > startSample)
+            it = waveforms.erase(it);
+        else
+            ++it;
+    }
+}
+
+void NotePathCache::clear() {
+    curves.clear();
+    waveforms.clear();
+}
+
+void NotePathCache::trim() {
+    auto dropUnused = [this](auto& entries) {
+        if (entries.size() <= maxUnusedEntries)
+            return;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.lastUsed != paintCounter)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    };
+    dropUnused(curves);
+    dropUnused(waveforms);
+    ++paintCounter;
+}
+
+juce::uint64 NotePathCache::checksumCurves(const AudioData& audioData, int startFrame, int endFrame) {
+    juce::uint64 hash = FNV_OFFSET;
+    hashFloats(hash, audioData.f0, startFrame, endFrame);
+    hashFloats(hash, audioData.basePitch, startFrame, endFrame);
+    hashFloats(hash, audioData.deltaPitch, startFrame, endFrame);
+    return hash;
+}
+
+void NotePathCache::buildPitchCurve(const AudioData& audioData, const Note& note, float globalPitchOffset,
+                                    float pixelsPerSecond, float pixelsPerSemitone, juce::Path& stroke) {
+    stroke.clear();
+
+    // Vertex count bounded by the columns the note spans, not its frames
+    juce::Path path;
+    PitchPathBuilder builder(path, pixelsPerSecond, pixelsPerSemitone);
+
+    int startFrame = note.getStartFrame();
+    int endFrame = std::min(note.getEndFrame(), static_cast<int>(audioData.f0.size()));
+
+    for (int i = startFrame; i < endFrame; ++i) {
+        // Base pitch: during drag, add pitchOffset to simulate the new base pitch
+        float baseMidi = (i < static_cast<int>(audioData.basePitch.size()))
+            ? audioData.basePitch[static_cast<size_t>(i)] + note.getPitchOffset()
+            : (audioData.f0[static_cast<size_t>(i)] > 0.0f
+                ? freqToMidi(audioData.f0[static_cast<size_t>(i)]) + note.getPitchOffset()
+                : 0.0f);
+
+        float deltaMidi = (i < static_cast<int>(audioData.deltaPitch.size()))
+            ? audioData.deltaPitch[static_cast<size_t>(i)]
+            : 0.0f;
+
+        float finalMidi = baseMidi + deltaMidi + globalPitchOffset;
+
+        // Unvoiced frames are skipped; the line joins across them
+        if (finalMidi > 0.0f)
+            builder.add(i, finalMidi);
+    }
+    builder.finish();
+
+    if (!path.isEmpty())
+        juce::PathStrokeType(2.0f).createStrokedPath(stroke, path);
+}
+
+void NotePathCache::buildNoteWaveform(const AudioData& audioData, const Note& note, float pixelsPerSecond,
+                                      float pixelsPerSemitone, NoteWaveform& shape) {
+    shape.fill.clear();
+    shape.outline.clear();
+
+    const int totalSamples = audioData.waveform.getNumSamples();
+    float w = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
+    if (totalSamples == 0 || w <= 2.0f)
+        return;
+
+    float x = framesToSeconds(note.getStartFrame()) * pixelsPerSecond;
+    float h = pixelsPerSemitone;
+    float y = (MAX_MIDI_NOTE - note.getMidiNote()) * pixelsPerSemitone - note.getPitchOffset() * pixelsPerSemitone;
+
+    int startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) * audioData.sampleRate);
+    int endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) * audioData.sampleRate);
+    startSample = std::max(0, std::min(startSample, totalSamples - 1));
+    endSample = std::max(startSample + 1, std::min(endSample, totalSamples));
+
+    int numNoteSamples = endSample - startSample;
+    int samplesPerPixel = std::max(1, static_cast<int>(numNoteSamples / w));
+
+    float centerY = y + h * 0.5f;
+    float waveHeight = h * 3.0f;
+
+    std::vector<float> waveValues;
+    float step = std::max(0.5f, w / 1024.0f);
+
+    for (float px = 0; px <= w; px += step) {
+        int sampleIdx = startSample + static_cast<int>((px / w) * numNoteSamples);
+        int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
+        waveValues.push_back(audioData.getWaveformPeak(sampleIdx, sampleEnd).getMagnitude());
+    }
+
+    // Smooth waveform
+    if (waveValues.size() > 2) {
+        std::vector<float> smoothed(waveValues.size());
+        smoothed[0] = waveValues[0];
+        for (size_t i = 1; i + 1 < waveValues.size(); ++i) {
+            smoothed[i] = (waveValues[i - 1] * 0.25f + waveValues[i] * 0.5f + waveValues[i + 1] * 0.25f);
+        }
+        smoothed[waveValues.size() - 1] = waveValues[waveValues.size() - 1];
+        waveValues = std::move(smoothed);
+    }
+
+    size_t numPoints = waveValues.size();
+    if (numPoints < 2)
+        return;
+
+    auto& path = shape.fill;
+    path.startNewSubPath(x, centerY - waveValues[0] * waveHeight * 0.5f);
+
+    const int curveSegments = 4;
+    for (size_t i = 0; i + 1 < numPoints; ++i) {
+        float px1 = (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+        float px2 = (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) * w;
+
+        size_t idx0 = (i > 0) ? i - 1 : i;
+        size_t idx1 = i;
+        size_t idx2 = i + 1;
+        size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
+
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+            float t = static_cast<float>(seg) / static_cast<float>(curveSegments);
+            float px = px1 + (px2 - px1) * t;
+            float val = catmullRom(t, waveValues[idx0], waveValues[idx1], waveValues[idx2], waveValues[idx3]);
+            path.lineTo(x + px, centerY - val * waveHeight * 0.5f);
+        }
+    }
+
+    // Bottom curve
+    path.lineTo(x + w, centerY + waveValues[numPoints - 1] * waveHeight * 0.5f);
+
+    for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
+        float px1 = (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) * w;
+        float px2 = (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
+
+        size_t idx0 = (static_cast<size_t>(i) + 2 < numPoints) ? static_cast<size_t>(i) + 2 : static_cast<size_t>(i) + 1;
+        size_t idx1 = static_cast<size_t>(i) + 1;
+        size_t idx2 = static_cast<size_t>(i);
+        size_t idx3 = (i > 0) ? static_cast<size_t>(i) - 1 : static_cast<size_t>(i);
+
+        for (int seg = 1; seg <= curveSegments; ++seg) {
+            float t = static_cast<float>(seg) / static_cast<float>(curveSegments);
+            float px = px1 + (px2 - px1) * t;
+            float val = catmullRom(t, waveValues[idx0], waveValues[idx1], waveValues[idx2], waveValues[idx3]);
+            path.lineTo(x + px, centerY + val * waveHeight * 0.5f);
+        }
+    }
+
+    path.closeSubPath();
+
+    juce::PathStrokeType(1.2f, juce::PathStrokeType::curved, juce::PathStrokeType::rounded)
+        .createStrokedPath(shape.outline, path);
+}
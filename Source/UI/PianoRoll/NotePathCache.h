@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../../Models/Project.h"
+#include <unordered_map>
+
+/**
+ * Cached per-note geometry for the piano roll: the stroked pitch curve and
+ * the waveform shape drawn inside each note, in world coordinates.
+ *
+ * Entries are keyed by note handle and rebuilt when the note's version or
+ * the zoom changes. Pitch curves also keep a checksum of the note's slice of
+ * the curves (edited in place by many tools) and waveform shapes are dropped
+ * by invalidateSamples() when resynthesis rewrites their audio. A repaint
+ * then only builds paths for notes that actually changed.
+ */
+class NotePathCache {
+public:
+    struct NoteWaveform {
+        juce::Path fill;
+        juce::Path outline;  // Stroked edge of fill
+    };
+
+    /** Stroked pitch curve of note (empty if no frame is voiced). */
+    const juce::Path& getPitchCurve(const Project& project, const Note& note, float globalPitchOffset,
+                                    float pixelsPerSecond, float pixelsPerSemitone);
+
+    /** Waveform shape inside note (empty if the note is too short to show one). */
+    const NoteWaveform& getNoteWaveform(const Project& project, const Note& note, float pixelsPerSecond,
+                                        float pixelsPerSemitone);
+
+    /** Samples [startSample, startSample + numSamples) changed. */
+    void invalidateSamples(int startSample, int numSamples);
+
+    void clear();
+
+    /** Call once per paint: drops entries left unused once the cache outgrows a screenful. */
+    void trim();
+
+private:
+    struct CurveEntry {
+        juce::uint32 version = 0;
+        float pixelsPerSecond = 0.0f;
+        float pixelsPerSemitone = 0.0f;
+        float globalPitchOffset = 0.0f;
+        juce::uint64 curveChecksum = 0;
+        juce::uint32 lastUsed = 0;
+        juce::Path stroke;
+    };
+
+    struct WaveformEntry {
+        juce::uint32 version = 0;
+        float pixelsPerSecond = 0.0f;
+        float pixelsPerSemitone = 0.0f;
+        int startSample = 0;
+        int endSample = 0;
+        juce::uint32 lastUsed = 0;
+        NoteWaveform shape;
+    };
+
+    static juce::uint64 makeKey(NoteHandle handle) {
+        return (static_cast<juce::uint64>(handle.slot) << 32) | handle.generation;
+    }
+
+    static juce::uint64 checksumCurves(const AudioData& audioData, int startFrame, int endFrame);
+    static void buildPitchCurve(const AudioData& audioData, const Note& note, float globalPitchOffset,
+                                float pixelsPerSecond, float pixelsPerSemitone, juce::Path& stroke);
+    static void buildNoteWaveform(const AudioData& audioData, const Note& note, float pixelsPerSecond,
+                                  float pixelsPerSemitone, NoteWaveform& shape);
+
+    static constexpr size_t maxUnusedEntries = 1024;
+
+    std::unordered_map<juce::uint64, CurveEntry> curves;
+    std::unordered_map<juce::uint64, WaveformEntry> waveforms;
+    juce::uint32 paintCounter = 1;
+};
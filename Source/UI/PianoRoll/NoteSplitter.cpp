@@ -8,7 +8,10 @@ Note* NoteSplitter::findNoteAt(float x, float y) {
     float pixelsPerSecond = coordMapper->getPixelsPerSecond();
     float pixelsPerSemitone = coordMapper->getPixelsPerSemitone();
 
-    for (auto& note : project->getNotes()) {
+    // Only notes around the frame under the cursor can contain it
+    const int frame = secondsToFrames(x / pixelsPerSecond);
+    for (auto* candidate : project->getNotesInRange(frame - 1, frame + 2)) {
+        auto& note = *candidate;
         if (note.isRest())
             continue;
 
@@ -36,7 +39,9 @@ bool NoteSplitter::splitNoteAtFrame(Note* note, int splitFrame) {
     if (splitFrame <= startFrame + 5 || splitFrame >= endFrame - 5)
         return false;
 
-    // Store original note data for undo
+    // Store original note data for undo. addNote() may reallocate the note
+    // vector, so the first note is re-resolved through its handle afterwards.
+    const NoteHandle firstHandle = project->getHandle(*note);
     Note originalNote = *note;
 
     // Create the second note (right part)
@@ -49,14 +54,15 @@ bool NoteSplitter::splitNoteAtFrame(Note* note, int splitFrame) {
 
     // Modify the first note (left part)
     note->setEndFrame(splitFrame);
+    Note firstNote = *note;
 
     // Add the second note to project
-    project->addNote(secondNote);
+    const NoteHandle secondHandle = project->addNote(secondNote);
 
     // Create undo action
     if (undoManager) {
         auto action = std::make_unique<NoteSplitAction>(
-            project, originalNote, *note, secondNote,
+            project, firstHandle, secondHandle, originalNote, firstNote, secondNote,
             [this]() {
                 if (onNoteSplit)
                     onNoteSplit();
@@ -0,0 +1,191 @@
+#include "PaintProfiler.h"
+#include "../../Utils/AppLogger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    juce::String formatRate(float rate) {
+        return rate < 0.0f ? juce::String("-") : juce::String(juce::roundToInt(rate * 100.0f)) + "%";
+    }
+}
+
+double PaintProfiler::ticksToMs(juce::int64 ticks) {
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+const char* PaintProfiler::getLayerName(Layer layer) {
+    switch (layer) {
+        case Layer::Spectrogram: return "spectrogram";
+        case Layer::Waveform:    return "waveform";
+        case Layer::Grid:        return "grid";
+        case Layer::Notes:       return "notes";
+        case Layer::Curves:      return "curves";
+        case Layer::Timeline:    return "timeline";
+        case Layer::Keys:        return "keys";
+        default:                 return "";
+    }
+}
+
+void PaintProfiler::setEnabled(bool shouldBeEnabled) {
+    if (enabled == shouldBeEnabled)
+        return;
+
+    enabled = shouldBeEnabled;
+    summary = {};
+    lastTimerTick = 0;
+    resetWindow(juce::Time::getHighResolutionTicks());
+}
+
+void PaintProfiler::beginPaint() {
+    if (enabled)
+        paintStart = juce::Time::getHighResolutionTicks();
+}
+
+void PaintProfiler::endPaint() {
+    if (!enabled)
+        return;
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    const auto ticks = now - paintStart;
+    ++paints;
+    paintTicks += ticks;
+    maxPaintTicks = std::max(maxPaintTicks, ticks);
+    advanceWindow(now);
+}
+
+void PaintProfiler::addLayerTime(Layer layer, juce::int64 ticks) {
+    layerTicks[static_cast<size_t>(layer)] += ticks;
+}
+
+void PaintProfiler::recordCacheLookups(Cache cache, int hits, int misses) {
+    if (!enabled)
+        return;
+
+    cacheHits[static_cast<size_t>(cache)] += hits;
+    cacheMisses[static_cast<size_t>(cache)] += misses;
+}
+
+bool PaintProfiler::recordTimerTick(double expectedIntervalMs) {
+    if (!enabled)
+        return false;
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    if (lastTimerTick != 0) {
+        const double interval = ticksToMs(now - lastTimerTick);
+        const double jitter = std::abs(interval - expectedIntervalMs);
+        ++timerTicks;
+        timerIntervalMs += interval;
+        jitterMs += jitter;
+        maxJitterMs = std::max(maxJitterMs, jitter);
+    }
+    lastTimerTick = now;
+
+    return advanceWindow(now);
+}
+
+bool PaintProfiler::advanceWindow(juce::int64 now) {
+    if (juce::Time::highResolutionTicksToSeconds(now - windowStart) < 1.0)
+        return false;
+
+    summary = {};
+    summary.paints = paints;
+    if (paints > 0) {
+        summary.averagePaintMs = ticksToMs(paintTicks) / paints;
+        summary.maxPaintMs = ticksToMs(maxPaintTicks);
+        for (size_t i = 0; i < layerTicks.size(); ++i)
+            summary.averageLayerMs[i] = ticksToMs(layerTicks[i]) / paints;
+    }
+
+    for (size_t i = 0; i < cacheHits.size(); ++i) {
+        const int lookups = cacheHits[i] + cacheMisses[i];
+        summary.hitRate[i] = lookups > 0 ? static_cast<float>(cacheHits[i]) / lookups : -1.0f;
+    }
+
+    summary.timerTicks = timerTicks;
+    if (timerTicks > 0) {
+        summary.averageTimerIntervalMs = timerIntervalMs / timerTicks;
+        summary.averageJitterMs = jitterMs / timerTicks;
+        summary.maxJitterMs = maxJitterMs;
+    }
+
+    LOG("Paint profile: " + formatSummary());
+
+    resetWindow(now);
+    return true;
+}
+
+void PaintProfiler::resetWindow(juce::int64 now) {
+    windowStart = now;
+    paints = 0;
+    paintTicks = 0;
+    maxPaintTicks = 0;
+    layerTicks.fill(0);
+    cacheHits.fill(0);
+    cacheMisses.fill(0);
+    timerTicks = 0;
+    timerIntervalMs = 0.0;
+    jitterMs = 0.0;
+    maxJitterMs = 0.0;
+}
+
+juce::String PaintProfiler::formatSummary() const {
+    juce::String text;
+    text << summary.paints << " paints/s, avg " << juce::String(summary.averagePaintMs, 2) << " ms, max "
+         << juce::String(summary.maxPaintMs, 2) << " ms;";
+    for (int i = 0; i < numLayers; ++i)
+        text << " " << getLayerName(static_cast<Layer>(i)) << " "
+             << juce::String(summary.averageLayerMs[static_cast<size_t>(i)], 2);
+    text << "; cache hits: waveform "
+         << formatRate(summary.hitRate[static_cast<size_t>(Cache::WaveformTiles)]) << ", base pitch "
+         << formatRate(summary.hitRate[static_cast<size_t>(Cache::BasePitch)]) << "; timer "
+         << juce::String(summary.averageTimerIntervalMs, 1) << " ms, jitter avg "
+         << juce::String(summary.averageJitterMs, 1) << " max " << juce::String(summary.maxJitterMs, 1) << " ms";
+    return text;
+}
+
+juce::Rectangle<int> PaintProfiler::getOverlayBounds(const juce::Rectangle<int>& area) {
+    constexpr int width = 300;
+    constexpr int height = 5 * 16 + 8;
+    return {area.getRight() - width - 8, area.getY() + 8, width, height};
+}
+
+void PaintProfiler::drawOverlay(juce::Graphics& g, const juce::Rectangle<int>& area) const {
+    if (!enabled)
+        return;
+
+    auto bounds = getOverlayBounds(area);
+    g.setColour(juce::Colours::black.withAlpha(0.7f));
+    g.fillRoundedRectangle(bounds.toFloat(), 4.0f);
+
+    // Layers sorted by cost, so the one to look at comes first
+    std::array<int, numLayers> order{};
+    for (int i = 0; i < numLayers; ++i)
+        order[static_cast<size_t>(i)] = i;
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return summary.averageLayerMs[static_cast<size_t>(a)] > summary.averageLayerMs[static_cast<size_t>(b)];
+    });
+
+    juce::String layers;
+    for (int i = 0; i < 3; ++i) {
+        const auto layer = static_cast<size_t>(order[static_cast<size_t>(i)]);
+        layers << getLayerName(static_cast<Layer>(layer)) << " " << juce::String(summary.averageLayerMs[layer], 2)
+               << "  ";
+    }
+
+    const juce::String lines[] = {
+        "paint " + juce::String(summary.averagePaintMs, 2) + " ms avg, " + juce::String(summary.maxPaintMs, 2) +
+            " ms max, " + juce::String(summary.paints) + "/s",
+        layers.trimEnd(),
+        "cache hits: waveform " + formatRate(summary.hitRate[static_cast<size_t>(Cache::WaveformTiles)]) +
+            ", base pitch " + formatRate(summary.hitRate[static_cast<size_t>(Cache::BasePitch)]),
+        "timer " + juce::String(summary.averageTimerIntervalMs, 1) + " ms, jitter " +
+            juce::String(summary.averageJitterMs, 1) + " avg " + juce::String(summary.maxJitterMs, 1) + " max",
+        audioLine,
+    };
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    auto textArea = bounds.reduced(8, 4);
+    for (const auto& line : lines)
+        g.drawText(line, textArea.removeFromTop(16), juce::Justification::centredLeft, false);
+}
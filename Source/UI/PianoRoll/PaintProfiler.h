@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include <array>
+
+/**
+ * Frame-time profiling for the piano roll.
+ *
+ * Records paint time per layer, cache hit rates and the jitter of the UI
+ * timer, and once per second folds them into a summary that is drawn as an
+ * overlay and written to the log. Disabled, every hook is a single branch;
+ * enabled, a hook costs a high resolution tick read, so it can stay on in
+ * release builds.
+ */
+class PaintProfiler {
+public:
+    enum class Layer {
+        Spectrogram,
+        Waveform,
+        Grid,
+        Notes,
+        Curves,
+        Timeline,
+        Keys,
+        Count
+    };
+
+    enum class Cache {
+        WaveformTiles,
+        BasePitch,
+        Count
+    };
+
+    static constexpr int numLayers = static_cast<int>(Layer::Count);
+    static constexpr int numCaches = static_cast<int>(Cache::Count);
+
+    /** Figures for the last completed one-second window. */
+    struct Summary {
+        int paints = 0;  // paint() calls, i.e. repaints per second
+        double averagePaintMs = 0.0;
+        double maxPaintMs = 0.0;
+        std::array<double, numLayers> averageLayerMs{};
+        std::array<float, numCaches> hitRate{};  // 0..1, or -1 without lookups
+        int timerTicks = 0;
+        double averageTimerIntervalMs = 0.0;
+        double averageJitterMs = 0.0;
+        double maxJitterMs = 0.0;
+    };
+
+    /** Times the enclosing scope as one layer of the current paint. */
+    class ScopedLayer {
+    public:
+        ScopedLayer(PaintProfiler& owner, Layer layerToTime)
+            : profiler(owner.enabled ? &owner : nullptr), layer(layerToTime),
+              start(profiler ? juce::Time::getHighResolutionTicks() : 0) {}
+
+        ~ScopedLayer() {
+            if (profiler)
+                profiler->addLayerTime(layer, juce::Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        PaintProfiler* profiler;
+        Layer layer;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedLayer)
+    };
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return enabled; }
+
+    void beginPaint();
+    void endPaint();
+
+    void recordCacheLookups(Cache cache, int hits, int misses);
+
+    /**
+     * Call from the periodic UI timer. Returns true when a measurement
+     * window has just completed (the overlay has new figures).
+     */
+    bool recordTimerTick(double expectedIntervalMs);
+
+    const Summary& getSummary() const { return summary; }
+
+    /** Extra overlay line with the audio callback figures (empty hides it). */
+    void setAudioLine(const juce::String& text) { audioLine = text; }
+
+    /** Draw the last summary in the top right corner of area. */
+    void drawOverlay(juce::Graphics& g, const juce::Rectangle<int>& area) const;
+    static juce::Rectangle<int> getOverlayBounds(const juce::Rectangle<int>& area);
+
+    static const char* getLayerName(Layer layer);
+
+private:
+    void addLayerTime(Layer layer, juce::int64 ticks);
+    bool advanceWindow(juce::int64 now);
+    void resetWindow(juce::int64 now);
+    juce::String formatSummary() const;
+
+    static double ticksToMs(juce::int64 ticks);
+
+    bool enabled = false;
+    Summary summary;
+    juce::String audioLine;
+
+    // Current window
+    juce::int64 windowStart = 0;
+    juce::int64 paintStart = 0;
+    int paints = 0;
+    juce::int64 paintTicks = 0;
+    juce::int64 maxPaintTicks = 0;
+    std::array<juce::int64, numLayers> layerTicks{};
+    std::array<int, numCaches> cacheHits{};
+    std::array<int, numCaches> cacheMisses{};
+    juce::int64 lastTimerTick = 0;
+    int timerTicks = 0;
+    double timerIntervalMs = 0.0;
+    double jitterMs = 0.0;
+    double maxJitterMs = 0.0;
+};
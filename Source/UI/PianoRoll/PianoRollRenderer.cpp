@@ -1,12 +1,28 @@
 #include "PianoRollRenderer.h"
 
-PianoRollRenderer::PianoRollRenderer() = default;
+PianoRollRenderer::PianoRollRenderer() {
+    waveformTiles.onTileReady = [this]() {
+        if (onRepaintNeeded)
+            onRepaintNeeded();
+    };
+    spectrogramTiles.onTileReady = [this]() {
+        if (onRepaintNeeded)
+            onRepaintNeeded();
+    };
+}
 
 void PianoRollRenderer::invalidateWaveformCache() {
-    cachedScrollX = -1.0;
-    cachedPixelsPerSecond = -1.0f;
-    cachedWidth = 0;
-    cachedHeight = 0;
+    waveformTiles.clear();
+    notePaths.clear();
+}
+
+void PianoRollRenderer::invalidateWaveformRange(int startSample, int numSamples) {
+    waveformTiles.invalidateSamples(startSample, numSamples);
+    notePaths.invalidateSamples(startSample, numSamples);
+}
+
+void PianoRollRenderer::invalidateSpectrogramRange(int startFrame, int endFrame) {
+    spectrogramTiles.invalidateFrames(startFrame, endFrame);
 }
 
 void PianoRollRenderer::invalidateBasePitchCache() {
@@ -15,99 +31,20 @@ void PianoRollRenderer::invalidateBasePitchCache() {
     cachedBasePitch.clear();
 }
 
-float PianoRollRenderer::catmullRom(float t, float p0, float p1, float p2, float p3) {
-    float t2 = t * t;
-    float t3 = t2 * t;
-    return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
-                   (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
-                   (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
-}
-
 void PianoRollRenderer::drawBackgroundWaveform(juce::Graphics& g, const juce::Rectangle<int>& area) {
     if (!project || !coordMapper)
         return;
 
-    const auto& audioData = project->getAudioData();
-    if (audioData.waveform.getNumSamples() == 0)
-        return;
-
-    double scrollX = coordMapper->getScrollX();
-    float pixelsPerSecond = coordMapper->getPixelsPerSecond();
-
-    // Check cache validity
-    bool cacheValid = waveformCache.isValid() &&
-                      std::abs(cachedScrollX - scrollX) < 1.0 &&
-                      std::abs(cachedPixelsPerSecond - pixelsPerSecond) < 0.01f &&
-                      cachedWidth == area.getWidth() &&
-                      cachedHeight == area.getHeight();
+    waveformTiles.draw(g, area, coordMapper->getScrollX(), coordMapper->getPixelsPerSecond(),
+                       project->getAudioData());
+}
 
-    if (cacheValid) {
-        g.drawImageAt(waveformCache, area.getX(), area.getY());
+void PianoRollRenderer::drawSpectrogram(juce::Graphics& g, const juce::Rectangle<int>& area) {
+    if (!project || !coordMapper)
         return;
-    }
-
-    // Render to cache
-    waveformCache = juce::Image(juce::Image::ARGB, area.getWidth(), area.getHeight(), true);
-    juce::Graphics cacheGraphics(waveformCache);
-
-    const float* samples = audioData.waveform.getReadPointer(0);
-    int numSamples = audioData.waveform.getNumSamples();
-
-    float visibleHeight = static_cast<float>(area.getHeight());
-    float centerY = visibleHeight * 0.5f;
-    float waveformHeight = visibleHeight * 0.8f;
-
-    juce::Path waveformPath;
-    int visibleWidth = area.getWidth();
-
-    waveformPath.startNewSubPath(0.0f, centerY);
-
-    // Top half
-    for (int px = 0; px < visibleWidth; ++px) {
-        double time = (scrollX + px) / pixelsPerSecond;
-        int startSample = static_cast<int>(time * SAMPLE_RATE);
-        int endSample = static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
-
-        startSample = std::max(0, std::min(startSample, numSamples - 1));
-        endSample = std::max(startSample + 1, std::min(endSample, numSamples));
-
-        float maxVal = 0.0f;
-        for (int i = startSample; i < endSample; ++i)
-            maxVal = std::max(maxVal, std::abs(samples[i]));
-
-        float y = centerY - maxVal * waveformHeight * 0.5f;
-        waveformPath.lineTo(static_cast<float>(px), y);
-    }
-
-    // Bottom half (reverse)
-    for (int px = visibleWidth - 1; px >= 0; --px) {
-        double time = (scrollX + px) / pixelsPerSecond;
-        int startSample = static_cast<int>(time * SAMPLE_RATE);
-        int endSample = static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
-
-        startSample = std::max(0, std::min(startSample, numSamples - 1));
-        endSample = std::max(startSample + 1, std::min(endSample, numSamples));
-
-        float maxVal = 0.0f;
-        for (int i = startSample; i < endSample; ++i)
-            maxVal = std::max(maxVal, std::abs(samples[i]));
-
-        float y = centerY + maxVal * waveformHeight * 0.5f;
-        waveformPath.lineTo(static_cast<float>(px), y);
-    }
-
-    waveformPath.closeSubPath();
-
-    cacheGraphics.setColour(juce::Colour(COLOR_WAVEFORM));
-    cacheGraphics.fillPath(waveformPath);
-
-    // Update cache metadata
-    cachedScrollX = scrollX;
-    cachedPixelsPerSecond = pixelsPerSecond;
-    cachedWidth = area.getWidth();
-    cachedHeight = area.getHeight();
 
-    g.drawImageAt(waveformCache, area.getX(), area.getY());
+    spectrogramTiles.draw(g, area, coordMapper->getScrollX(), coordMapper->getPixelsPerSecond(),
+                          project->getAudioData());
 }
 
 void PianoRollRenderer::drawGrid(juce::Graphics& g, int width, int height) {
@@ -219,85 +156,48 @@ void PianoRollRenderer::drawNotes(juce::Graphics& g, double visibleStartTime, do
         return;
 
     const auto& audioData = project->getAudioData();
-    const float* samples = audioData.waveform.getNumSamples() > 0
-                               ? audioData.waveform.getReadPointer(0)
-                               : nullptr;
     int totalSamples = audioData.waveform.getNumSamples();
 
-    for (auto& note : project->getNotes()) {
-        if (note.isRest())
-            continue;
+    // Only notes overlapping the visible range, through the note index
+    const int visibleStartFrame = secondsToFrames(static_cast<float>(visibleStartTime));
+    const int visibleEndFrame = secondsToFrames(static_cast<float>(visibleEndTime)) + 1;
 
-        double noteStartTime = framesToSeconds(note.getStartFrame());
-        double noteEndTime = framesToSeconds(note.getEndFrame());
-        if (noteEndTime < visibleStartTime || noteStartTime > visibleEndTime)
+    for (const Note* note : project->getNotesInRange(visibleStartFrame, visibleEndFrame)) {
+        if (note->isRest())
             continue;
 
-        float x = static_cast<float>(noteStartTime * coordMapper->getPixelsPerSecond());
-        float w = framesToSeconds(note.getDurationFrames()) * coordMapper->getPixelsPerSecond();
+        float x = static_cast<float>(framesToSeconds(note->getStartFrame()) * coordMapper->getPixelsPerSecond());
+        float w = framesToSeconds(note->getDurationFrames()) * coordMapper->getPixelsPerSecond();
         float h = coordMapper->getPixelsPerSemitone();
 
-        float baseGridCenterY = coordMapper->midiToY(note.getMidiNote()) + h * 0.5f;
-        float pitchOffsetPixels = -note.getPitchOffset() * coordMapper->getPixelsPerSemitone();
+        float baseGridCenterY = coordMapper->midiToY(note->getMidiNote()) + h * 0.5f;
+        float pitchOffsetPixels = -note->getPitchOffset() * coordMapper->getPixelsPerSemitone();
         float y = baseGridCenterY + pitchOffsetPixels - h * 0.5f;
 
-        juce::Colour noteColor = note.isSelected()
+        juce::Colour noteColor = note->isSelected()
                                      ? juce::Colour(COLOR_NOTE_SELECTED)
                                      : juce::Colour(COLOR_NOTE_NORMAL);
 
-        if (samples && totalSamples > 0 && w > 2.0f) {
-            drawNoteWaveform(g, note, x, y, w, h, samples, totalSamples, audioData.sampleRate);
+        if (totalSamples > 0 && w > 2.0f) {
+            drawNoteWaveform(g, *note, x, y, w, h);
         } else {
             g.setColour(noteColor.withAlpha(0.85f));
             g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
         }
     }
+
+    notePaths.trim();
 }
 
-void PianoRollRenderer::drawNoteWaveform(juce::Graphics& g, const Note& note, float x, float y, float w, float h,
-                                         const float* samples, int totalSamples, int sampleRate) {
+void PianoRollRenderer::drawNoteWaveform(juce::Graphics& g, const Note& note, float x, float y, float w, float h) {
     juce::Colour noteColor = note.isSelected()
                                  ? juce::Colour(COLOR_NOTE_SELECTED)
                                  : juce::Colour(COLOR_NOTE_NORMAL);
 
-    int startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) * sampleRate);
-    int endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) * sampleRate);
-    startSample = std::max(0, std::min(startSample, totalSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, totalSamples));
-
-    int numNoteSamples = endSample - startSample;
-    int samplesPerPixel = std::max(1, static_cast<int>(numNoteSamples / w));
-
-    float centerY = y + h * 0.5f;
-    float waveHeight = h * 3.0f;
-
-    std::vector<float> waveValues;
-    float step = std::max(0.5f, w / 1024.0f);
-
-    for (float px = 0; px <= w; px += step) {
-        int sampleIdx = startSample + static_cast<int>((px / w) * numNoteSamples);
-        int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
-
-        float maxVal = 0.0f;
-        for (int i = sampleIdx; i < sampleEnd; ++i)
-            maxVal = std::max(maxVal, std::abs(samples[i]));
-
-        waveValues.push_back(maxVal);
-    }
-
-    // Smooth waveform
-    if (waveValues.size() > 2) {
-        std::vector<float> smoothed(waveValues.size());
-        smoothed[0] = waveValues[0];
-        for (size_t i = 1; i + 1 < waveValues.size(); ++i) {
-            smoothed[i] = (waveValues[i - 1] * 0.25f + waveValues[i] * 0.5f + waveValues[i + 1] * 0.25f);
-        }
-        smoothed[waveValues.size() - 1] = waveValues[waveValues.size() - 1];
-        waveValues = std::move(smoothed);
-    }
-
-    size_t numPoints = waveValues.size();
-    if (numPoints < 2) {
+    // Built once per note version and zoom (see NotePathCache)
+    const auto& shape = notePaths.getNoteWaveform(*project, note, coordMapper->getPixelsPerSecond(),
+                                                  coordMapper->getPixelsPerSemitone());
+    if (shape.fill.isEmpty()) {
         g.setColour(noteColor.withAlpha(0.85f));
         g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
         return;
@@ -305,57 +205,11 @@ void PianoRollRenderer::drawNoteWaveform(juce::Graphics& g, const Note& note, fl
 
     // Draw filled waveform
     g.setColour(noteColor.withAlpha(0.85f));
-    juce::Path waveformPath;
-
-    waveformPath.startNewSubPath(x, centerY - waveValues[0] * waveHeight * 0.5f);
-
-    const int curveSegments = 4;
-    for (size_t i = 0; i + 1 < numPoints; ++i) {
-        float px1 = (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-        float px2 = (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) * w;
-
-        size_t idx0 = (i > 0) ? i - 1 : i;
-        size_t idx1 = i;
-        size_t idx2 = i + 1;
-        size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
-
-        for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t = static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, waveValues[idx0], waveValues[idx1], waveValues[idx2], waveValues[idx3]);
-            float yPos = centerY - val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-        }
-    }
-
-    // Bottom curve
-    waveformPath.lineTo(x + w, centerY + waveValues[numPoints - 1] * waveHeight * 0.5f);
-
-    for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
-        float px1 = (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) * w;
-        float px2 = (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-
-        size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
-        size_t idx1 = i + 1;
-        size_t idx2 = i;
-        size_t idx3 = (i > 0) ? i - 1 : i;
-
-        for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t = static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, waveValues[idx0], waveValues[idx1], waveValues[idx2], waveValues[idx3]);
-            float yPos = centerY + val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-        }
-    }
-
-    waveformPath.closeSubPath();
-    g.fillPath(waveformPath);
+    g.fillPath(shape.fill);
 
     // Draw outline
     g.setColour(noteColor.brighter(0.2f));
-    g.strokePath(waveformPath, juce::PathStrokeType(1.2f, juce::PathStrokeType::curved,
-                                                     juce::PathStrokeType::rounded));
+    g.fillPath(shape.outline);
 }
 
 void PianoRollRenderer::drawPitchCurves(juce::Graphics& g, float globalPitchOffset) {
@@ -366,47 +220,22 @@ void PianoRollRenderer::drawPitchCurves(juce::Graphics& g, float globalPitchOffs
     if (audioData.f0.empty())
         return;
 
+    // Clip bounds are in world coordinates here
+    const auto clip = g.getClipBounds();
+    const float pixelsPerSecond = coordMapper->getPixelsPerSecond();
+    const int visibleStartFrame = secondsToFrames(clip.getX() / pixelsPerSecond);
+    const int visibleEndFrame = secondsToFrames(clip.getRight() / pixelsPerSecond) + 1;
+
     g.setColour(juce::Colour(COLOR_PITCH_CURVE));
 
-    for (const auto& note : project->getNotes()) {
-        if (note.isRest())
+    for (const Note* note : project->getNotesInRange(visibleStartFrame, visibleEndFrame)) {
+        if (note->isRest())
             continue;
 
-        juce::Path path;
-        bool pathStarted = false;
-
-        int startFrame = note.getStartFrame();
-        int endFrame = std::min(note.getEndFrame(), static_cast<int>(audioData.f0.size()));
-
-        for (int i = startFrame; i < endFrame; ++i) {
-            float baseMidi = (i < static_cast<int>(audioData.basePitch.size()))
-                ? audioData.basePitch[static_cast<size_t>(i)] + note.getPitchOffset()
-                : ((i < static_cast<int>(audioData.f0.size()) && audioData.f0[static_cast<size_t>(i)] > 0.0f)
-                    ? freqToMidi(audioData.f0[static_cast<size_t>(i)]) + note.getPitchOffset()
-                    : 0.0f);
-
-            float deltaMidi = (i < static_cast<int>(audioData.deltaPitch.size()))
-                ? audioData.deltaPitch[static_cast<size_t>(i)]
-                : 0.0f;
-
-            float finalMidi = baseMidi + deltaMidi + globalPitchOffset;
-
-            if (finalMidi > 0.0f) {
-                float x = framesToSeconds(i) * coordMapper->getPixelsPerSecond();
-                float y = coordMapper->midiToY(finalMidi) + coordMapper->getPixelsPerSemitone() * 0.5f;
-
-                if (!pathStarted) {
-                    path.startNewSubPath(x, y);
-                    pathStarted = true;
-                } else {
-                    path.lineTo(x, y);
-                }
-            }
-        }
-
-        if (pathStarted) {
-            g.strokePath(path, juce::PathStrokeType(2.0f));
-        }
+        const auto& stroke = notePaths.getPitchCurve(*project, *note, globalPitchOffset, pixelsPerSecond,
+                                                     coordMapper->getPixelsPerSemitone());
+        if (!stroke.isEmpty())
+            g.fillPath(stroke);
     }
 }
 
@@ -5,6 +5,10 @@
 #include "../../Utils/Constants.h"
 #include "../../Utils/BasePitchCurve.h"
 #include "CoordinateMapper.h"
+#include "NotePathCache.h"
+#include "SpectrogramTileCache.h"
+#include "WaveformTileCache.h"
+#include <functional>
 #include <vector>
 
 /**
@@ -17,10 +21,14 @@ public:
     ~PianoRollRenderer() = default;
 
     void setCoordinateMapper(CoordinateMapper* mapper) { coordMapper = mapper; }
-    void setProject(Project* proj) { project = proj; }
+    void setProject(Project* proj) { project = proj; invalidateWaveformCache(); spectrogramTiles.clear(); }
+
+    // Called on the message thread when background work needs a repaint
+    std::function<void()> onRepaintNeeded;
 
     // Main drawing methods
     void drawBackgroundWaveform(juce::Graphics& g, const juce::Rectangle<int>& area);
+    void drawSpectrogram(juce::Graphics& g, const juce::Rectangle<int>& area);
     void drawGrid(juce::Graphics& g, int width, int height);
     void drawTimeline(juce::Graphics& g, int width);
     void drawNotes(juce::Graphics& g, double visibleStartTime, double visibleEndTime);
@@ -30,6 +38,10 @@ public:
 
     // Cache management
     void invalidateWaveformCache();
+    void invalidateWaveformRange(int startSample, int numSamples);
+    void invalidateSpectrogramRange(int startFrame, int endFrame);
+    NotePathCache& getNotePathCache() { return notePaths; }
+    WaveformTileCache& getWaveformTileCache() { return waveformTiles; }
     void invalidateBasePitchCache();
     void updateBasePitchCacheIfNeeded();
 
@@ -37,22 +49,18 @@ public:
     static constexpr bool ENABLE_BASE_PITCH_DEBUG = true;
 
 private:
-    // Helper for Catmull-Rom spline interpolation
-    static float catmullRom(float t, float p0, float p1, float p2, float p3);
-
     // Draw note waveform with smooth curves
-    void drawNoteWaveform(juce::Graphics& g, const Note& note, float x, float y, float w, float h,
-                         const float* samples, int totalSamples, int sampleRate);
+    void drawNoteWaveform(juce::Graphics& g, const Note& note, float x, float y, float w, float h);
 
     CoordinateMapper* coordMapper = nullptr;
     Project* project = nullptr;
 
-    // Waveform cache
-    juce::Image waveformCache;
-    double cachedScrollX = -1.0;
-    float cachedPixelsPerSecond = -1.0f;
-    int cachedWidth = 0;
-    int cachedHeight = 0;
+    // Background waveform and spectrogram tiles
+    WaveformTileCache waveformTiles;
+    SpectrogramTileCache spectrogramTiles;
+
+    // Per-note pitch curve and waveform paths
+    NotePathCache notePaths;
 
     // Base pitch cache
     std::vector<float> cachedBasePitch;
@@ -6,7 +6,10 @@ Note* PitchEditor::findNoteAt(float x, float y) {
     if (!project || !coordMapper)
         return nullptr;
 
-    for (auto& note : project->getNotes()) {
+    // Only notes around the frame under the cursor can contain it
+    const int frame = secondsToFrames(x / coordMapper->getPixelsPerSecond());
+    for (auto* candidate : project->getNotesInRange(frame - 1, frame + 2)) {
+        auto& note = *candidate;
         if (note.isRest())
             continue;
 
@@ -27,22 +30,13 @@ void PitchEditor::startNoteDrag(Note* note, float y) {
     if (!note || !project)
         return;
 
-    // Capture delta slice from global dense deltaPitch
+    // Delta pitch stays in the dense project curve; only midiNote moves
     auto& audioData = project->getAudioData();
     int startFrame = note->getStartFrame();
     int endFrame = note->getEndFrame();
-    int numFrames = endFrame - startFrame;
-
-    std::vector<float> delta(numFrames, 0.0f);
-    for (int i = 0; i < numFrames; ++i) {
-        int globalFrame = startFrame + i;
-        if (globalFrame >= 0 && globalFrame < static_cast<int>(audioData.deltaPitch.size()))
-            delta[i] = audioData.deltaPitch[static_cast<size_t>(globalFrame)];
-    }
-    note->setDeltaPitch(std::move(delta));
 
     isDragging = true;
-    draggedNote = note;
+    draggedNote = project->getHandle(*note);
     dragStartY = y;
     originalPitchOffset = note->getPitchOffset();
     originalMidiNote = note->getMidiNote();
@@ -64,40 +58,45 @@ void PitchEditor::startNoteDrag(Note* note, float y) {
 }
 
 void PitchEditor::updateNoteDrag(float y) {
-    if (!isDragging || !draggedNote || !coordMapper)
+    auto* note = getDraggedNote();
+    if (!isDragging || !note || !coordMapper)
         return;
 
     float deltaY = dragStartY - y;
     float deltaSemitones = deltaY / coordMapper->getPixelsPerSemitone();
 
-    draggedNote->setPitchOffset(deltaSemitones);
-    draggedNote->markDirty();
+    note->setPitchOffset(deltaSemitones);
+    note->markDirty();
 }
 
 void PitchEditor::endNoteDrag() {
-    if (!isDragging || !draggedNote || !project)
+    auto* dragged = getDraggedNote();
+    if (!isDragging || !dragged || !project) {
+        isDragging = false;
+        draggedNote = {};
         return;
+    }
 
-    float newOffset = draggedNote->getPitchOffset();
+    float newOffset = dragged->getPitchOffset();
     constexpr float CHANGE_THRESHOLD = 0.001f;
     bool hasChange = std::abs(newOffset) >= CHANGE_THRESHOLD;
 
     if (hasChange) {
-        int startFrame = draggedNote->getStartFrame();
-        int endFrame = draggedNote->getEndFrame();
+        int startFrame = dragged->getStartFrame();
+        int endFrame = dragged->getEndFrame();
         auto& audioData = project->getAudioData();
         int f0Size = static_cast<int>(audioData.f0.size());
 
         // Bake pitchOffset into midiNote
-        draggedNote->setMidiNote(originalMidiNote + newOffset);
-        draggedNote->setPitchOffset(0.0f);
+        dragged->setMidiNote(originalMidiNote + newOffset);
+        dragged->setPitchOffset(0.0f);
 
         // Find adjacent notes to expand dirty range
         const auto& notes = project->getNotes();
         int expandedStart = startFrame;
         int expandedEnd = endFrame;
         for (const auto& note : notes) {
-            if (&note == draggedNote) continue;
+            if (&note == dragged) continue;
             if (note.getEndFrame() > startFrame - 30 && note.getEndFrame() <= startFrame) {
                 expandedStart = std::min(expandedStart, note.getStartFrame());
             }
@@ -106,12 +105,11 @@ void PitchEditor::endNoteDrag() {
             }
         }
 
-        // Rebuild pitch curves
-        PitchCurveProcessor::rebuildBaseFromNotes(*project);
-        PitchCurveProcessor::composeF0InPlace(*project, false);
+        // Rebuild pitch curves around the dragged note
+        PitchCurveProcessor::rebuildBaseFromNotes(*project, startFrame, endFrame);
 
         if (onBasePitchCacheInvalidated)
-            onBasePitchCacheInvalidated();
+            onBasePitchCacheInvalidated(startFrame, endFrame);
 
         // Mark dirty range
         int smoothStart = std::max(0, expandedStart - 60);
@@ -136,14 +134,13 @@ void PitchEditor::endNoteDrag() {
             int capturedExpandedEnd = expandedEnd;
             int capturedF0Size = f0Size;
             auto action = std::make_unique<NotePitchDragAction>(
-                draggedNote, &audioData.f0, originalMidiNote,
+                project, draggedNote, &audioData.f0, originalMidiNote,
                 originalMidiNote + newOffset, std::move(f0Edits),
-                [this, capturedExpandedStart, capturedExpandedEnd, capturedF0Size](Note* n) {
+                [this, startFrame, endFrame, capturedExpandedStart, capturedExpandedEnd, capturedF0Size](Note* n) {
                     if (project) {
-                        PitchCurveProcessor::rebuildBaseFromNotes(*project);
-                        PitchCurveProcessor::composeF0InPlace(*project, false);
+                        PitchCurveProcessor::rebuildBaseFromNotes(*project, startFrame, endFrame);
                         if (onBasePitchCacheInvalidated)
-                            onBasePitchCacheInvalidated();
+                            onBasePitchCacheInvalidated(startFrame, endFrame);
                         int smoothStart = std::max(0, capturedExpandedStart - 60);
                         int smoothEnd = std::min(capturedF0Size, capturedExpandedEnd + 60);
                         project->setF0DirtyRange(smoothStart, smoothEnd);
@@ -158,11 +155,11 @@ void PitchEditor::endNoteDrag() {
         if (onPitchEditFinished)
             onPitchEditFinished();
     } else {
-        draggedNote->setPitchOffset(0.0f);
+        dragged->setPitchOffset(0.0f);
     }
 
     isDragging = false;
-    draggedNote = nullptr;
+    draggedNote = {};
 }
 
 void PitchEditor::startDrawing(float x, float y) {
@@ -210,18 +207,8 @@ void PitchEditor::endDrawing() {
         maxFrame = std::max(maxFrame, e.idx);
     }
 
-    // Clear deltaPitch for notes in edited range
-    if (project && minFrame <= maxFrame) {
-        auto& notes = project->getNotes();
-        for (auto& note : notes) {
-            if (note.getEndFrame() > minFrame && note.getStartFrame() < maxFrame) {
-                if (note.hasDeltaPitch()) {
-                    note.setDeltaPitch(std::vector<float>());
-                }
-            }
-        }
+    if (project && minFrame <= maxFrame)
         project->setF0DirtyRange(minFrame, maxFrame);
-    }
 
     // Create undo action
     if (undoManager && project) {
@@ -290,15 +277,6 @@ void PitchEditor::applyPitchPoint(int frameIndex, int midiCents) {
         if (it == drawingEditIndexByFrame.end()) {
             drawingEditIndexByFrame.emplace(idx, drawingEdits.size());
             drawingEdits.push_back(F0FrameEdit{idx, oldF0, newFreq, oldDelta, newDelta, oldVoiced, true});
-
-            // Clear deltaPitch for notes containing this frame
-            auto& notes = project->getNotes();
-            for (auto& note : notes) {
-                if (note.getStartFrame() <= idx && note.getEndFrame() > idx && note.hasDeltaPitch()) {
-                    note.setDeltaPitch(std::vector<float>());
-                    break;
-                }
-            }
         } else {
             auto& e = drawingEdits[it->second];
             e.newF0 = newFreq;
@@ -364,7 +342,8 @@ void PitchEditor::snapNoteToSemitone(Note* note) {
 
     if (std::abs(snappedOffset - currentOffset) > 0.001f) {
         if (undoManager) {
-            auto action = std::make_unique<PitchOffsetAction>(note, currentOffset, snappedOffset);
+            auto action = std::make_unique<PitchOffsetAction>(project, project->getHandle(*note),
+                                                               currentOffset, snappedOffset);
             undoManager->addAction(std::move(action));
         }
 
@@ -382,7 +361,7 @@ void PitchEditor::startMultiNoteDrag(const std::vector<Note*>& notes, float y) {
     if (notes.empty() || !project)
         return;
 
-    draggedNotes = notes;
+    draggedNotes.clear();
     originalMidiNotes.clear();
     originalF0ValuesMulti.clear();
     dragStartY = y;
@@ -390,21 +369,12 @@ void PitchEditor::startMultiNoteDrag(const std::vector<Note*>& notes, float y) {
     auto& audioData = project->getAudioData();
     int f0Size = static_cast<int>(audioData.f0.size());
 
-    for (auto* note : draggedNotes) {
+    for (auto* note : notes) {
+        draggedNotes.push_back(project->getHandle(*note));
         originalMidiNotes.push_back(note->getMidiNote());
 
-        // Capture delta slice for each note
         int startFrame = note->getStartFrame();
         int endFrame = note->getEndFrame();
-        int numFrames = endFrame - startFrame;
-
-        std::vector<float> delta(numFrames, 0.0f);
-        for (int i = 0; i < numFrames; ++i) {
-            int globalFrame = startFrame + i;
-            if (globalFrame >= 0 && globalFrame < static_cast<int>(audioData.deltaPitch.size()))
-                delta[i] = audioData.deltaPitch[static_cast<size_t>(globalFrame)];
-        }
-        note->setDeltaPitch(std::move(delta));
 
         // Save original F0 values
         std::vector<float> f0Values;
@@ -417,13 +387,13 @@ void PitchEditor::startMultiNoteDrag(const std::vector<Note*>& notes, float y) {
 }
 
 void PitchEditor::updateMultiNoteDrag(float y) {
-    if (!isMultiDragging || draggedNotes.empty() || !coordMapper)
+    if (!isMultiDragging || draggedNotes.empty() || !coordMapper || !project)
         return;
 
     float deltaY = dragStartY - y;
     float deltaSemitones = deltaY / coordMapper->getPixelsPerSemitone();
 
-    for (auto* note : draggedNotes) {
+    for (auto* note : getDraggedNotes()) {
         note->setPitchOffset(deltaSemitones);
         note->markDirty();
     }
@@ -438,7 +408,15 @@ void PitchEditor::endMultiNoteDrag() {
         return;
     }
 
-    float newOffset = draggedNotes[0]->getPitchOffset();
+    // Resolve once; a note removed mid-drag becomes nullptr so the entries
+    // stay aligned by index with originalMidiNotes
+    std::vector<Note*> notes;
+    notes.reserve(draggedNotes.size());
+    for (const auto& handle : draggedNotes)
+        notes.push_back(project->getNote(handle));
+
+    const auto firstLive = std::find_if(notes.begin(), notes.end(), [](Note* n) { return n != nullptr; });
+    float newOffset = firstLive != notes.end() ? (*firstLive)->getPitchOffset() : 0.0f;
     constexpr float CHANGE_THRESHOLD = 0.001f;
     bool hasChange = std::abs(newOffset) >= CHANGE_THRESHOLD;
 
@@ -450,14 +428,17 @@ void PitchEditor::endMultiNoteDrag() {
         int expandedEnd = std::numeric_limits<int>::min();
 
         // Bake pitchOffset into midiNote for all notes
-        for (size_t i = 0; i < draggedNotes.size(); ++i) {
-            auto* note = draggedNotes[i];
+        for (size_t i = 0; i < notes.size(); ++i) {
+            auto* note = notes[i];
+            if (!note) continue;
             note->setMidiNote(originalMidiNotes[i] + newOffset);
             note->setPitchOffset(0.0f);
 
             expandedStart = std::min(expandedStart, note->getStartFrame());
             expandedEnd = std::max(expandedEnd, note->getEndFrame());
         }
+        const int changedStart = expandedStart;
+        const int changedEnd = expandedEnd;
 
         // Find adjacent notes to expand dirty range
         const auto& allNotes = project->getNotes();
@@ -468,12 +449,11 @@ void PitchEditor::endMultiNoteDrag() {
                 expandedEnd = std::max(expandedEnd, note.getEndFrame());
         }
 
-        // Rebuild pitch curves
-        PitchCurveProcessor::rebuildBaseFromNotes(*project);
-        PitchCurveProcessor::composeF0InPlace(*project, false);
+        // Rebuild pitch curves across the dragged notes
+        PitchCurveProcessor::rebuildBaseFromNotes(*project, changedStart, changedEnd);
 
         if (onBasePitchCacheInvalidated)
-            onBasePitchCacheInvalidated();
+            onBasePitchCacheInvalidated(changedStart, changedEnd);
 
         // Mark dirty range
         int smoothStart = std::max(0, expandedStart - 60);
@@ -483,8 +463,9 @@ void PitchEditor::endMultiNoteDrag() {
         // Create undo action for multi-note drag
         if (undoManager) {
             std::vector<F0FrameEdit> f0Edits;
-            for (size_t i = 0; i < draggedNotes.size(); ++i) {
-                auto* note = draggedNotes[i];
+            for (size_t i = 0; i < notes.size(); ++i) {
+                auto* note = notes[i];
+                if (!note) continue;
                 int startFrame = note->getStartFrame();
                 int endFrame = note->getEndFrame();
                 for (int j = startFrame; j < endFrame && j < f0Size; ++j) {
@@ -502,19 +483,18 @@ void PitchEditor::endMultiNoteDrag() {
             int capturedExpandedStart = expandedStart;
             int capturedExpandedEnd = expandedEnd;
             int capturedF0Size = f0Size;
-            std::vector<Note*> capturedNotes = draggedNotes;
+            std::vector<NoteHandle> capturedNotes = draggedNotes;
             std::vector<float> capturedOriginalMidi = originalMidiNotes;
             float capturedNewOffset = newOffset;
 
             auto action = std::make_unique<MultiNotePitchDragAction>(
-                capturedNotes, &audioData.f0, capturedOriginalMidi, capturedNewOffset,
+                project, capturedNotes, &audioData.f0, capturedOriginalMidi, capturedNewOffset,
                 std::move(f0Edits),
-                [this, capturedExpandedStart, capturedExpandedEnd, capturedF0Size](const std::vector<Note*>&) {
+                [this, changedStart, changedEnd, capturedExpandedStart, capturedExpandedEnd, capturedF0Size](const std::vector<Note*>&) {
                     if (project) {
-                        PitchCurveProcessor::rebuildBaseFromNotes(*project);
-                        PitchCurveProcessor::composeF0InPlace(*project, false);
+                        PitchCurveProcessor::rebuildBaseFromNotes(*project, changedStart, changedEnd);
                         if (onBasePitchCacheInvalidated)
-                            onBasePitchCacheInvalidated();
+                            onBasePitchCacheInvalidated(changedStart, changedEnd);
                         int smoothStart = std::max(0, capturedExpandedStart - 60);
                         int smoothEnd = std::min(capturedF0Size, capturedExpandedEnd + 60);
                         project->setF0DirtyRange(smoothStart, smoothEnd);
@@ -529,8 +509,8 @@ void PitchEditor::endMultiNoteDrag() {
             onPitchEditFinished();
     } else {
         // No meaningful change: reset pitchOffset
-        for (auto* note : draggedNotes)
-            note->setPitchOffset(0.0f);
+        for (auto* note : notes)
+            if (note) note->setPitchOffset(0.0f);
     }
 
     isMultiDragging = false;
@@ -538,3 +518,14 @@ void PitchEditor::endMultiNoteDrag() {
     originalMidiNotes.clear();
     originalF0ValuesMulti.clear();
 }
+
+std::vector<Note*> PitchEditor::getDraggedNotes() const {
+    std::vector<Note*> notes;
+    if (!project)
+        return notes;
+    for (const auto& handle : draggedNotes) {
+        if (auto* note = project->getNote(handle))
+            notes.push_back(note);
+    }
+    return notes;
+}
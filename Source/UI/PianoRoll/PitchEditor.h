@@ -29,14 +29,14 @@ public:
     void updateNoteDrag(float y);
     void endNoteDrag();
     bool isDraggingNote() const { return isDragging; }
-    Note* getDraggedNote() const { return draggedNote; }
+    Note* getDraggedNote() const { return project ? project->getNote(draggedNote) : nullptr; }
 
     // Multi-note dragging
     void startMultiNoteDrag(const std::vector<Note*>& notes, float y);
     void updateMultiNoteDrag(float y);
     void endMultiNoteDrag();
     bool isDraggingMultiNotes() const { return isMultiDragging; }
-    const std::vector<Note*>& getDraggedNotes() const { return draggedNotes; }
+    std::vector<Note*> getDraggedNotes() const;
 
     // Pitch drawing
     void startDrawing(float x, float y);
@@ -51,7 +51,7 @@ public:
     std::function<void(Note*)> onNoteSelected;
     std::function<void()> onPitchEdited;
     std::function<void()> onPitchEditFinished;
-    std::function<void()> onBasePitchCacheInvalidated;
+    std::function<void(int startFrame, int endFrame)> onBasePitchCacheInvalidated;  // Notes in range changed
 
 private:
     void applyPitchPoint(int frameIndex, int midiCents);
@@ -63,7 +63,7 @@ private:
 
     // Drag state
     bool isDragging = false;
-    Note* draggedNote = nullptr;
+    NoteHandle draggedNote;
     float dragStartY = 0.0f;
     float originalPitchOffset = 0.0f;
     float originalMidiNote = 60.0f;
@@ -73,7 +73,7 @@ private:
 
     // Multi-note drag state
     bool isMultiDragging = false;
-    std::vector<Note*> draggedNotes;
+    std::vector<NoteHandle> draggedNotes;
     std::vector<float> originalMidiNotes;
     std::vector<std::vector<float>> originalF0ValuesMulti;
 
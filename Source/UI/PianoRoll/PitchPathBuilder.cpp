@@ -0,0 +1,72 @@
+#include "PitchPathBuilder.h"
+#include "../../Utils/Constants.h"
+#include <cmath>
+#include <utility>
+
+PitchPathBuilder::PitchPathBuilder(juce::Path& p, float pps, float ppsemi)
+    : path(p), pixelsPerSecond(pps), pixelsPerSemitone(ppsemi) {
+}
+
+void PitchPathBuilder::add(int frame, float midi) {
+    if (midi <= 0.0f) {
+        flushColumn();
+        started = false;
+        return;
+    }
+
+    const int frameColumn = static_cast<int>(std::floor(framesToSeconds(frame) * pixelsPerSecond));
+    if (count > 0 && frameColumn != column)
+        flushColumn();
+
+    const Point point{frame, midi};
+    if (count == 0) {
+        column = frameColumn;
+        first = lowest = highest = point;
+    } else {
+        if (midi < lowest.midi)
+            lowest = point;
+        if (midi > highest.midi)
+            highest = point;
+    }
+    last = point;
+    ++count;
+}
+
+void PitchPathBuilder::finish() {
+    flushColumn();
+}
+
+void PitchPathBuilder::flushColumn() {
+    if (count == 0)
+        return;
+
+    // First point, the extremes in frame order, then the last point
+    const Point* extremes[2] = {&lowest, &highest};
+    if (highest.frame < lowest.frame)
+        std::swap(extremes[0], extremes[1]);
+
+    emit(first);
+    int emitted = first.frame;
+    for (const Point* point : extremes) {
+        if (point->frame > emitted) {
+            emit(*point);
+            emitted = point->frame;
+        }
+    }
+    if (last.frame > emitted)
+        emit(last);
+
+    count = 0;
+}
+
+void PitchPathBuilder::emit(const Point& point) {
+    const float x = framesToSeconds(point.frame) * pixelsPerSecond;
+    const float y = (MAX_MIDI_NOTE - point.midi) * pixelsPerSemitone + pixelsPerSemitone * 0.5f;
+
+    if (!started) {
+        path.startNewSubPath(x, y);
+        started = true;
+    } else {
+        path.lineTo(x, y);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+
+/**
+ * Builds a pitch curve path with at most four vertices per pixel column.
+ *
+ * Frames are fed in order with their pitch in MIDI (<= 0 breaks the line
+ * at an unvoiced frame). While the frames of one column arrive, only the
+ * first, lowest, highest and last point are kept; they are emitted in frame
+ * order when the next column starts. Zoomed in, each frame has a column of
+ * its own and the path is exact; zoomed out, the path stays bounded by the
+ * width it covers while keeping every peak visible.
+ */
+class PitchPathBuilder {
+public:
+    PitchPathBuilder(juce::Path& path, float pixelsPerSecond, float pixelsPerSemitone);
+
+    void add(int frame, float midi);
+
+    /** Emit the pending column (call after the last frame). */
+    void finish();
+
+private:
+    struct Point {
+        int frame = 0;
+        float midi = 0.0f;
+    };
+
+    void flushColumn();
+    void emit(const Point& point);
+
+    juce::Path& path;
+    float pixelsPerSecond;
+    float pixelsPerSemitone;
+
+    bool started = false;  // Current subpath has a vertex
+    int column = 0;
+    int count = 0;
+    Point first, lowest, highest, last;
+};
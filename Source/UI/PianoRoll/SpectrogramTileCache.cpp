@@ -0,0 +1,380 @@
+#include "SpectrogramTileCache.h"
+#include "../../Utils/Constants.h"
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr double FRAMES_PER_SECOND = static_cast<double>(SAMPLE_RATE) / HOP_SIZE;
+
+    // Log-mel span shown between transparent and full colour (natural log, ~78 dB)
+    constexpr float DISPLAY_RANGE = 9.0f;
+
+    // Palette indexed by normalised level: silence stays transparent so the
+    // background shows through, loud bands go from the accent colour to warm
+    const std::array<juce::PixelARGB, 256>& getPalette() {
+        static const std::array<juce::PixelARGB, 256> palette = []() {
+            juce::ColourGradient gradient(juce::Colours::transparentBlack, 0.0f, 0.0f,
+                                          juce::Colour(0xFFFFE08A), 1.0f, 0.0f, false);
+            gradient.addColour(0.35, juce::Colour(COLOR_PRIMARY).withAlpha(0.45f));
+            gradient.addColour(0.7, juce::Colour(0xFFFF6B9B).withAlpha(0.8f));
+
+            std::array<juce::PixelARGB, 256> colours;
+            for (size_t i = 0; i < colours.size(); ++i)
+                colours[i] = gradient.getColourAtPosition(static_cast<double>(i) / 255.0).getPixelARGB();
+            return colours;
+        }();
+        return palette;
+    }
+}
+
+SpectrogramTileCache::SpectrogramTileCache(size_t budgetBytes)
+    : budget(budgetBytes) {
+    worker = std::thread([this]() { workerLoop(); });
+}
+
+SpectrogramTileCache::~SpectrogramTileCache() {
+    alive->store(false);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+    queueCondition.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+double SpectrogramTileCache::getLevelPixelsPerSecond(int level) {
+    return MIN_PIXELS_PER_SECOND * static_cast<double>(1 << level);
+}
+
+int SpectrogramTileCache::getLevelFor(float pixelsPerSecond) {
+    for (int level = 0; level < numLevels; ++level) {
+        if (getLevelPixelsPerSecond(level) >= pixelsPerSecond - 0.001)
+            return level;
+    }
+    return numLevels - 1;
+}
+
+void SpectrogramTileCache::getTileFrames(const TileKey& key, int& startFrame, int& endFrame) {
+    // One frame of margin on each side for interpolation at the tile edges
+    const double levelPps = getLevelPixelsPerSecond(key.level);
+    startFrame = static_cast<int>(std::floor(key.index * tileWidth / levelPps * FRAMES_PER_SECOND)) - 1;
+    endFrame = static_cast<int>(std::ceil((key.index + 1) * tileWidth / levelPps * FRAMES_PER_SECOND)) + 2;
+}
+
+int SpectrogramTileCache::getTileX(int areaX, double scrollX, int index, double scale) {
+    // Rounded per edge, so neighbouring tiles share their edge without seams
+    return areaX + juce::roundToInt(index * tileWidth * scale) - static_cast<int>(scrollX);
+}
+
+void SpectrogramTileCache::draw(juce::Graphics& g, const juce::Rectangle<int>& area, double scrollX,
+                                float pixelsPerSecond, const AudioData& audioData) {
+    const auto& mel = audioData.melSpectrogram;
+    if (mel.empty() || area.isEmpty() || pixelsPerSecond <= 0.0f)
+        return;
+
+    adoptFinishedTiles();
+
+    if (mel.getNumFrames() != melFrames || mel.getNumMels() != melBands) {
+        clear();
+        melFrames = mel.getNumFrames();
+        melBands = mel.getNumMels();
+        updateDisplayRange(mel);
+    }
+
+    const int level = getLevelFor(pixelsPerSecond);
+    const double levelPps = getLevelPixelsPerSecond(level);
+    const double scale = pixelsPerSecond / levelPps;
+    const double levelScroll = static_cast<int>(scrollX) / scale;
+    const double audioWidth = melFrames / FRAMES_PER_SECOND * levelPps;
+    const int firstIndex = std::max(0, static_cast<int>(levelScroll / tileWidth));
+    const int lastIndex = std::min(static_cast<int>((levelScroll + area.getWidth() / scale) / tileWidth),
+                                   static_cast<int>(audioWidth / tileWidth));
+
+    // Tiles scrolled past before their turn came are not worth rendering any more
+    dropQueuedJobsExcept(level, firstIndex, lastIndex);
+
+    for (int index = firstIndex; index <= lastIndex; ++index) {
+        const TileKey key{level, index};
+        const int x0 = getTileX(area.getX(), scrollX, index, scale);
+        const int x1 = getTileX(area.getX(), scrollX, index + 1, scale);
+        const juce::Rectangle<int> tileArea(x0, area.getY(), x1 - x0, area.getHeight());
+
+        auto it = tiles.find(key);
+        if (it != tiles.end()) {
+            lru.splice(lru.end(), lru, it->second.lruPosition);
+            g.drawImage(it->second.image, tileArea.toFloat());
+            if (it->second.stale)
+                requestTile(key, mel);
+        } else {
+            requestTile(key, mel);
+            drawFallback(g, tileArea, index * tileWidth / levelPps, (index + 1) * tileWidth / levelPps, level,
+                         area, scrollX, pixelsPerSecond);
+        }
+    }
+}
+
+void SpectrogramTileCache::updateDisplayRange(const MelBuffer& mel) {
+    // Ceiling from a sparse sample of frames: enough to find the loud parts
+    // without decoding an hour of float16 rows
+    const int stride = std::max(1, mel.getNumFrames() / 4096);
+    std::vector<float> scratch(static_cast<size_t>(mel.getNumMels()));
+    float ceiling = -std::numeric_limits<float>::max();
+
+    for (int frame = 0; frame < mel.getNumFrames(); frame += stride) {
+        const float* row = mel.readFrame(frame, scratch.data());
+        for (int band = 0; band < mel.getNumMels(); ++band)
+            ceiling = std::max(ceiling, row[band]);
+    }
+
+    displayFloor = ceiling - DISPLAY_RANGE;
+    displayRange = DISPLAY_RANGE;
+}
+
+void SpectrogramTileCache::requestTile(const TileKey& key, const MelBuffer& mel) {
+    if (pending.count(key) > 0)
+        return;
+
+    int startFrame = 0;
+    int endFrame = 0;
+    getTileFrames(key, startFrame, endFrame);
+    startFrame = std::max(0, startFrame);
+    endFrame = std::min(endFrame, mel.getNumFrames());
+    if (endFrame <= startFrame)
+        return;
+
+    Job job;
+    job.key = key;
+    job.ticket = nextTicket++;
+    job.firstFrame = startFrame;
+    job.floor = displayFloor;
+    job.range = displayRange;
+    mel.decodeRange(startFrame, endFrame, job.mel);
+
+    Pending entry;
+    entry.ticket = job.ticket;
+    entry.startFrame = startFrame;
+    entry.endFrame = endFrame;
+    pending[key] = entry;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(job));
+    }
+    queueCondition.notify_one();
+}
+
+void SpectrogramTileCache::dropQueuedJobsExcept(int level, int firstIndex, int lastIndex) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (it->key.level == level && it->key.index >= firstIndex && it->key.index <= lastIndex) {
+            ++it;
+            continue;
+        }
+        pending.erase(it->key);
+        it = queue.erase(it);
+    }
+}
+
+void SpectrogramTileCache::drawFallback(juce::Graphics& g, const juce::Rectangle<int>& tileArea,
+                                        double tileStartTime, double tileEndTime, int level,
+                                        const juce::Rectangle<int>& area, double scrollX, float pixelsPerSecond) {
+    juce::Graphics::ScopedSaveState saveState(g);
+    g.reduceClipRegion(tileArea);
+
+    // Nearest levels first, finer before coarser
+    for (int distance = 1; distance < numLevels; ++distance) {
+        bool drewAny = false;
+
+        for (int fallback : {level + distance, level - distance}) {
+            if (fallback < 0 || fallback >= numLevels)
+                continue;
+
+            const double fallbackPps = getLevelPixelsPerSecond(fallback);
+            const double scale = pixelsPerSecond / fallbackPps;
+            const int first = static_cast<int>(tileStartTime * fallbackPps) / tileWidth;
+            const int last = static_cast<int>(tileEndTime * fallbackPps) / tileWidth;
+
+            // Coarse tiles over a fine view are few; the reverse is capped
+            for (int index = first; index <= last && index - first < 64; ++index) {
+                auto it = tiles.find({fallback, index});
+                if (it == tiles.end())
+                    continue;
+
+                const int x0 = getTileX(area.getX(), scrollX, index, scale);
+                const int x1 = getTileX(area.getX(), scrollX, index + 1, scale);
+                g.drawImage(it->second.image,
+                            juce::Rectangle<int>(x0, tileArea.getY(), x1 - x0, tileArea.getHeight()).toFloat());
+                drewAny = true;
+            }
+        }
+
+        if (drewAny)
+            return;
+    }
+}
+
+void SpectrogramTileCache::adoptFinishedTiles() {
+    std::vector<Finished> done;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        done.swap(finished);
+    }
+
+    for (auto& result : done) {
+        // Superseded by an invalidation or a clear() while it was rendering
+        auto p = pending.find(result.key);
+        if (p == pending.end() || p->second.ticket != result.ticket || !result.image.isValid())
+            continue;
+
+        auto existing = tiles.find(result.key);
+        if (existing != tiles.end())
+            removeTile(existing);
+
+        Tile tile;
+        tile.image = std::move(result.image);
+        tile.startFrame = p->second.startFrame;
+        tile.endFrame = p->second.endFrame;
+        pending.erase(p);
+
+        totalBytes += static_cast<size_t>(tile.image.getWidth()) * static_cast<size_t>(tile.image.getHeight()) * 4;
+        lru.push_back(result.key);
+        tile.lruPosition = std::prev(lru.end());
+        tiles.emplace(result.key, std::move(tile));
+    }
+
+    evictToBudget();
+}
+
+void SpectrogramTileCache::invalidateFrames(int startFrame, int endFrame) {
+    for (auto& entry : tiles) {
+        if (entry.second.startFrame < endFrame && entry.second.endFrame > startFrame)
+            entry.second.stale = true;
+    }
+
+    // Renders already in flight read the old frames
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.startFrame < endFrame && it->second.endFrame > startFrame)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+void SpectrogramTileCache::clear() {
+    tiles.clear();
+    lru.clear();
+    pending.clear();
+    totalBytes = 0;
+    melFrames = 0;
+    melBands = 0;
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queue.clear();
+    finished.clear();
+}
+
+void SpectrogramTileCache::removeTile(std::map<TileKey, Tile>::iterator it) {
+    const auto& image = it->second.image;
+    totalBytes -= static_cast<size_t>(image.getWidth()) * static_cast<size_t>(image.getHeight()) * 4;
+    lru.erase(it->second.lruPosition);
+    tiles.erase(it);
+}
+
+void SpectrogramTileCache::evictToBudget() {
+    while (totalBytes > budget && !lru.empty())
+        removeTile(tiles.find(lru.front()));
+}
+
+void SpectrogramTileCache::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopRequested || !queue.empty(); });
+            if (stopRequested)
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        auto image = renderTile(job);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            finished.push_back({job.key, job.ticket, std::move(image)});
+        }
+
+        juce::MessageManager::callAsync([this, flag = alive]() {
+            if (!flag->load())
+                return;
+            adoptFinishedTiles();
+            if (onTileReady)
+                onTileReady();
+        });
+    }
+}
+
+juce::Image SpectrogramTileCache::renderTile(const Job& job) {
+    const int bands = job.mel.getNumMels();
+    const int frames = job.mel.getNumFrames();
+    if (bands == 0 || frames == 0)
+        return {};
+
+    const double framesPerPixel = FRAMES_PER_SECOND / getLevelPixelsPerSecond(job.key.level);
+
+    // Band-major, so each band is one contiguous run of columns
+    std::vector<float> values(static_cast<size_t>(bands) * tileWidth);
+    auto at = [&values](int band, int column) -> float& {
+        return values[static_cast<size_t>(band) * tileWidth + static_cast<size_t>(column)];
+    };
+
+    for (int column = 0; column < tileWidth; ++column) {
+        const double frameStart = (job.key.index * tileWidth + column) * framesPerPixel - job.firstFrame;
+
+        if (framesPerPixel <= 1.0) {
+            // Zoomed in: interpolate between the frames around the column centre
+            const double position = juce::jlimit(0.0, frames - 1.0, frameStart + framesPerPixel * 0.5);
+            const int f0 = static_cast<int>(position);
+            const int f1 = std::min(f0 + 1, frames - 1);
+            const float t = static_cast<float>(position - f0);
+            const float* a = job.mel.getFrame(f0);
+            const float* b = job.mel.getFrame(f1);
+            for (int band = 0; band < bands; ++band)
+                at(band, column) = a[band] + (b[band] - a[band]) * t;
+        } else {
+            // Zoomed out: loudest frame in the column, so short events stay visible
+            const int first = juce::jlimit(0, frames - 1, static_cast<int>(frameStart));
+            const int last = juce::jlimit(first + 1, frames, static_cast<int>(std::ceil(frameStart + framesPerPixel)));
+            const float* row = job.mel.getFrame(first);
+            for (int band = 0; band < bands; ++band)
+                at(band, column) = row[band];
+            for (int frame = first + 1; frame < last; ++frame) {
+                row = job.mel.getFrame(frame);
+                for (int band = 0; band < bands; ++band)
+                    at(band, column) = std::max(at(band, column), row[band]);
+            }
+        }
+    }
+
+    // Log-mel to palette index for the whole tile in three vector passes
+    const int numValues = static_cast<int>(values.size());
+    juce::FloatVectorOperations::add(values.data(), -job.floor, numValues);
+    juce::FloatVectorOperations::multiply(values.data(), 255.0f / job.range, numValues);
+    juce::FloatVectorOperations::clip(values.data(), values.data(), 0.0f, 255.0f, numValues);
+
+    juce::Image image(juce::Image::ARGB, tileWidth, bands, false, juce::SoftwareImageType());
+    juce::Image::BitmapData bitmap(image, juce::Image::BitmapData::writeOnly);
+    const auto& palette = getPalette();
+
+    for (int band = 0; band < bands; ++band) {
+        // Lowest band at the bottom
+        auto* line = reinterpret_cast<juce::PixelARGB*>(bitmap.getLinePointer(bands - 1 - band));
+        const float* levels = &at(band, 0);
+        for (int column = 0; column < tileWidth; ++column)
+            line[column] = palette[static_cast<size_t>(levels[column])];
+    }
+
+    return image;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../../Models/Project.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Mel spectrogram layer of the piano roll as a pyramid of image tiles.
+ *
+ * Level L is rendered at MIN_PIXELS_PER_SECOND * 2^L; a view zoom draws the
+ * tiles of the nearest level at or above it, scaled down by less than half,
+ * so zooming within a level and scrolling only blit existing tiles. Tiles
+ * hold one row per mel band and are stretched over the visible height.
+ *
+ * Missing tiles are rendered on a worker thread from a decoded copy of
+ * their mel frames taken on the message thread; until one arrives, tiles of
+ * other levels are scaled into its place. Tiles live in an LRU bounded by a
+ * memory budget and survive the layer being hidden.
+ */
+class SpectrogramTileCache {
+public:
+    static constexpr int tileWidth = 256;
+    static constexpr int numLevels = 6;  // 20 to 640 pixels per second
+    static constexpr size_t defaultBudgetBytes = 16 * 1024 * 1024;
+
+    explicit SpectrogramTileCache(size_t budgetBytes = defaultBudgetBytes);
+    ~SpectrogramTileCache();
+
+    /** Called on the message thread when a queued tile has been rendered. */
+    std::function<void()> onTileReady;
+
+    /** Draw the spectrogram into area, with area's left edge at world x scrollX. */
+    void draw(juce::Graphics& g, const juce::Rectangle<int>& area, double scrollX, float pixelsPerSecond,
+              const AudioData& audioData);
+
+    /** Mel frames [startFrame, endFrame) changed. */
+    void invalidateFrames(int startFrame, int endFrame);
+
+    void clear();
+
+    size_t getMemoryBytes() const { return totalBytes; }
+
+private:
+    struct TileKey {
+        int level = 0;
+        int index = 0;  // Level x / tileWidth
+
+        bool operator<(const TileKey& other) const {
+            return level != other.level ? level < other.level : index < other.index;
+        }
+    };
+
+    struct Tile {
+        juce::Image image;
+        int startFrame = 0;
+        int endFrame = 0;
+        bool stale = false;
+        std::list<TileKey>::iterator lruPosition;
+    };
+
+    struct Pending {
+        juce::uint64 ticket = 0;
+        int startFrame = 0;
+        int endFrame = 0;
+    };
+
+    struct Job {
+        TileKey key;
+        juce::uint64 ticket = 0;
+        int firstFrame = 0;  // Project frame of mel row 0
+        MelBuffer mel;       // Float32 copy of the tile's frames
+        float floor = 0.0f;  // Log-mel value drawn transparent
+        float range = 1.0f;  // Log-mel span up to full colour
+    };
+
+    struct Finished {
+        TileKey key;
+        juce::uint64 ticket = 0;
+        juce::Image image;
+    };
+
+    static double getLevelPixelsPerSecond(int level);
+    static int getLevelFor(float pixelsPerSecond);
+    static void getTileFrames(const TileKey& key, int& startFrame, int& endFrame);
+    static int getTileX(int areaX, double scrollX, int index, double scale);
+
+    void updateDisplayRange(const MelBuffer& mel);
+    void requestTile(const TileKey& key, const MelBuffer& mel);
+    void dropQueuedJobsExcept(int level, int firstIndex, int lastIndex);
+    void drawFallback(juce::Graphics& g, const juce::Rectangle<int>& tileArea, double tileStartTime,
+                      double tileEndTime, int level, const juce::Rectangle<int>& area, double scrollX,
+                      float pixelsPerSecond);
+    void adoptFinishedTiles();
+    void removeTile(std::map<TileKey, Tile>::iterator it);
+    void evictToBudget();
+
+    void workerLoop();
+    static juce::Image renderTile(const Job& job);
+
+    // Message thread state
+    std::map<TileKey, Tile> tiles;
+    std::list<TileKey> lru;  // Front = least recently used
+    std::map<TileKey, Pending> pending;
+    size_t budget;
+    size_t totalBytes = 0;
+    int melFrames = 0;
+    int melBands = 0;
+    float displayFloor = 0.0f;
+    float displayRange = 1.0f;
+    juce::uint64 nextTicket = 1;
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+
+    // Worker thread
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<Job> queue;
+    std::vector<Finished> finished;
+    bool stopRequested = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramTileCache)
+};
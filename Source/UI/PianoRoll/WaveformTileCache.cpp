@@ -0,0 +1,284 @@
+#include "WaveformTileCache.h"
+#include "../../Utils/Constants.h"
+#include <cmath>
+
+WaveformTileCache::WaveformTileCache(size_t budgetBytes)
+    : budget(budgetBytes) {
+    worker = std::thread([this]() { workerLoop(); });
+}
+
+WaveformTileCache::~WaveformTileCache() {
+    alive->store(false);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+    queueCondition.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+void WaveformTileCache::getTileSamples(int index, double pixelsPerSecond, int& startSample, int& endSample) {
+    // One column past the tile's right edge, so neighbouring tiles join up
+    startSample = static_cast<int>(std::floor(index * tileWidth / pixelsPerSecond * SAMPLE_RATE));
+    endSample = static_cast<int>(std::ceil(((index + 1) * tileWidth + 1) / pixelsPerSecond * SAMPLE_RATE));
+}
+
+void WaveformTileCache::draw(juce::Graphics& g, const juce::Rectangle<int>& area, double scrollX,
+                             float pixelsPerSecond, const AudioData& audioData) {
+    const int numSamples = audioData.waveform.getNumSamples();
+    if (numSamples == 0 || area.isEmpty() || pixelsPerSecond <= 0.0f)
+        return;
+
+    adoptFinishedTiles();
+
+    if (area.getHeight() != tileHeight || numSamples != waveformSamples) {
+        clear();
+        tileHeight = area.getHeight();
+        waveformSamples = numSamples;
+    }
+
+    const int zoom = toZoomKey(pixelsPerSecond);
+    if (zoom != currentZoom) {
+        fallbackZoom = currentZoom;
+        currentZoom = zoom;
+    }
+
+    const int scrollPixels = static_cast<int>(scrollX);
+    const int audioWidth = static_cast<int>(std::ceil(static_cast<double>(numSamples) / SAMPLE_RATE * pixelsPerSecond));
+    const int firstIndex = std::max(0, scrollPixels / tileWidth);
+    const int lastIndex = std::min((scrollPixels + area.getWidth()) / tileWidth, audioWidth / tileWidth);
+
+    // Tiles scrolled past before their turn came are not worth rendering any more
+    dropQueuedJobsExcept(zoom, firstIndex, lastIndex);
+
+    for (int index = firstIndex; index <= lastIndex; ++index) {
+        const TileKey key{zoom, index};
+        const juce::Rectangle<int> tileArea(area.getX() + index * tileWidth - scrollPixels, area.getY(), tileWidth,
+                                            tileHeight);
+
+        auto it = tiles.find(key);
+        if (it != tiles.end()) {
+            ++lookupHits;
+            lru.splice(lru.end(), lru, it->second.lruPosition);
+            g.drawImageAt(it->second.image, tileArea.getX(), tileArea.getY());
+            if (it->second.stale)
+                requestTile(key, pixelsPerSecond, audioData);
+        } else {
+            ++lookupMisses;
+            requestTile(key, pixelsPerSecond, audioData);
+            drawFallback(g, tileArea, index * tileWidth / static_cast<double>(pixelsPerSecond),
+                         (index + 1) * tileWidth / static_cast<double>(pixelsPerSecond), pixelsPerSecond,
+                         area.getX(), scrollX);
+        }
+    }
+}
+
+void WaveformTileCache::requestTile(const TileKey& key, float pixelsPerSecond, const AudioData& audioData) {
+    if (pending.count(key) > 0)
+        return;
+
+    Job job;
+    job.key = key;
+    job.ticket = nextTicket++;
+    job.height = tileHeight;
+    job.peaks.resize(static_cast<size_t>(tileWidth + 1));
+
+    for (int column = 0; column <= tileWidth; ++column) {
+        const double time = static_cast<double>(key.index * tileWidth + column) / pixelsPerSecond;
+        const int startSample = static_cast<int>(time * SAMPLE_RATE);
+        const int endSample = std::max(startSample + 1, static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE));
+        job.peaks[static_cast<size_t>(column)] = audioData.getWaveformPeak(startSample, endSample).getMagnitude();
+    }
+
+    Pending entry;
+    entry.ticket = job.ticket;
+    getTileSamples(key.index, pixelsPerSecond, entry.startSample, entry.endSample);
+    pending[key] = entry;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(job));
+    }
+    queueCondition.notify_one();
+}
+
+void WaveformTileCache::dropQueuedJobsExcept(int zoom, int firstIndex, int lastIndex) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (it->key.zoom == zoom && it->key.index >= firstIndex && it->key.index <= lastIndex) {
+            ++it;
+            continue;
+        }
+        pending.erase(it->key);
+        it = queue.erase(it);
+    }
+}
+
+void WaveformTileCache::drawFallback(juce::Graphics& g, const juce::Rectangle<int>& tileArea, double tileStartTime,
+                                     double tileEndTime, float pixelsPerSecond, int areaX, double scrollX) {
+    if (fallbackZoom <= 0 || fallbackZoom == currentZoom)
+        return;
+
+    const double fallbackPps = fallbackZoom / 1000.0;
+    const double scale = pixelsPerSecond / fallbackPps;
+    const int first = static_cast<int>(tileStartTime * fallbackPps) / tileWidth;
+    const int last = static_cast<int>(tileEndTime * fallbackPps) / tileWidth;
+
+    juce::Graphics::ScopedSaveState saveState(g);
+    g.reduceClipRegion(tileArea);
+
+    // Zooming far out can cover many old tiles; stop at a screenful
+    for (int index = first; index <= last && index - first < 64; ++index) {
+        auto it = tiles.find({fallbackZoom, index});
+        if (it == tiles.end())
+            continue;
+
+        const double x = areaX + index * tileWidth * scale - static_cast<int>(scrollX);
+        g.drawImage(it->second.image,
+                    juce::Rectangle<float>(static_cast<float>(x), static_cast<float>(tileArea.getY()),
+                                           static_cast<float>(tileWidth * scale),
+                                           static_cast<float>(tileArea.getHeight())),
+                    juce::RectanglePlacement::stretchToFit);
+    }
+}
+
+void WaveformTileCache::adoptFinishedTiles() {
+    std::vector<Finished> done;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        done.swap(finished);
+    }
+
+    for (auto& result : done) {
+        // Superseded by an invalidation or a clear() while it was rendering
+        auto p = pending.find(result.key);
+        if (p == pending.end() || p->second.ticket != result.ticket || !result.image.isValid())
+            continue;
+
+        auto existing = tiles.find(result.key);
+        if (existing != tiles.end())
+            removeTile(existing);
+
+        Tile tile;
+        tile.image = std::move(result.image);
+        tile.startSample = p->second.startSample;
+        tile.endSample = p->second.endSample;
+        pending.erase(p);
+
+        totalBytes += static_cast<size_t>(tile.image.getWidth()) * static_cast<size_t>(tile.image.getHeight()) * 4;
+        lru.push_back(result.key);
+        tile.lruPosition = std::prev(lru.end());
+        tiles.emplace(result.key, std::move(tile));
+    }
+
+    evictToBudget();
+}
+
+void WaveformTileCache::invalidateSamples(int startSample, int numSamples) {
+    const int endSample = startSample + numSamples;
+
+    for (auto& entry : tiles) {
+        if (entry.second.startSample < endSample && entry.second.endSample > startSample)
+            entry.second.stale = true;
+    }
+
+    // Renders already in flight read the old samples
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.startSample < endSample && it->second.endSample > startSample)
+            it = pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+void WaveformTileCache::clear() {
+    tiles.clear();
+    lru.clear();
+    pending.clear();
+    totalBytes = 0;
+    currentZoom = 0;
+    fallbackZoom = 0;
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    queue.clear();
+    finished.clear();
+}
+
+void WaveformTileCache::takeLookupCounts(int& hits, int& misses) {
+    hits = lookupHits;
+    misses = lookupMisses;
+    lookupHits = lookupMisses = 0;
+}
+
+void WaveformTileCache::setBudget(size_t bytes) {
+    budget = bytes;
+    evictToBudget();
+}
+
+void WaveformTileCache::removeTile(std::map<TileKey, Tile>::iterator it) {
+    const auto& image = it->second.image;
+    totalBytes -= static_cast<size_t>(image.getWidth()) * static_cast<size_t>(image.getHeight()) * 4;
+    lru.erase(it->second.lruPosition);
+    tiles.erase(it);
+}
+
+void WaveformTileCache::evictToBudget() {
+    while (totalBytes > budget && !lru.empty())
+        removeTile(tiles.find(lru.front()));
+}
+
+void WaveformTileCache::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopRequested || !queue.empty(); });
+            if (stopRequested)
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        auto image = renderTile(job);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            finished.push_back({job.key, job.ticket, std::move(image)});
+        }
+
+        juce::MessageManager::callAsync([this, flag = alive]() {
+            if (!flag->load())
+                return;
+            adoptFinishedTiles();
+            if (onTileReady)
+                onTileReady();
+        });
+    }
+}
+
+juce::Image WaveformTileCache::renderTile(const Job& job) {
+    juce::Image image(juce::Image::ARGB, tileWidth, job.height, true, juce::SoftwareImageType());
+    juce::Graphics g(image);
+
+    const float centerY = job.height * 0.5f;
+    const float waveformHeight = job.height * 0.8f;
+    const int numColumns = static_cast<int>(job.peaks.size());
+
+    juce::Path waveformPath;
+    waveformPath.startNewSubPath(0.0f, centerY);
+
+    // Top half
+    for (int px = 0; px < numColumns; ++px)
+        waveformPath.lineTo(static_cast<float>(px), centerY - job.peaks[static_cast<size_t>(px)] * waveformHeight * 0.5f);
+
+    // Bottom half (reverse)
+    for (int px = numColumns - 1; px >= 0; --px)
+        waveformPath.lineTo(static_cast<float>(px), centerY + job.peaks[static_cast<size_t>(px)] * waveformHeight * 0.5f);
+
+    waveformPath.closeSubPath();
+
+    g.setColour(juce::Colour(COLOR_WAVEFORM));
+    g.fillPath(waveformPath);
+    return image;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "../../JuceHeader.h"
+#include "../../Models/Project.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Background waveform of the piano roll as fixed-width image tiles.
+ *
+ * Tiles are keyed by zoom level and tile index in world x, so scrolling
+ * (and playback follow) only blits tiles that already exist. Missing tiles
+ * are rendered on a worker thread: the per-column peaks are read from the
+ * waveform's peak pyramid on the message thread when the tile is requested,
+ * so the worker never touches project data and only rasterises the path.
+ * Until a tile arrives, tiles cached at the previous zoom are scaled into
+ * its place.
+ *
+ * Tiles live in an LRU bounded by a memory budget. invalidateSamples()
+ * marks tiles that cover resynthesised samples stale; a stale tile is still
+ * drawn until its replacement is ready.
+ */
+class WaveformTileCache {
+public:
+    static constexpr int tileWidth = 256;
+    static constexpr size_t defaultBudgetBytes = 32 * 1024 * 1024;
+
+    explicit WaveformTileCache(size_t budgetBytes = defaultBudgetBytes);
+    ~WaveformTileCache();
+
+    /** Called on the message thread when a queued tile has been rendered. */
+    std::function<void()> onTileReady;
+
+    /** Draw the waveform into area, with area's left edge at world x scrollX. */
+    void draw(juce::Graphics& g, const juce::Rectangle<int>& area, double scrollX, float pixelsPerSecond,
+              const AudioData& audioData);
+
+    /** Samples [startSample, startSample + numSamples) changed. */
+    void invalidateSamples(int startSample, int numSamples);
+
+    void clear();
+
+    void setBudget(size_t bytes);
+    size_t getMemoryBytes() const { return totalBytes; }
+
+    /** Tiles draw() found cached and found missing since the last call. */
+    void takeLookupCounts(int& hits, int& misses);
+
+private:
+    struct TileKey {
+        int zoom = 0;   // Pixels per second in thousandths
+        int index = 0;  // World x / tileWidth
+
+        bool operator<(const TileKey& other) const {
+            return zoom != other.zoom ? zoom < other.zoom : index < other.index;
+        }
+    };
+
+    struct Tile {
+        juce::Image image;
+        int startSample = 0;
+        int endSample = 0;
+        bool stale = false;
+        std::list<TileKey>::iterator lruPosition;
+    };
+
+    struct Pending {
+        juce::uint64 ticket = 0;
+        int startSample = 0;
+        int endSample = 0;
+    };
+
+    struct Job {
+        TileKey key;
+        juce::uint64 ticket = 0;
+        int height = 0;
+        std::vector<float> peaks;  // tileWidth + 1 column magnitudes
+    };
+
+    struct Finished {
+        TileKey key;
+        juce::uint64 ticket = 0;
+        juce::Image image;
+    };
+
+    static int toZoomKey(float pixelsPerSecond) { return juce::roundToInt(pixelsPerSecond * 1000.0f); }
+    static void getTileSamples(int index, double pixelsPerSecond, int& startSample, int& endSample);
+
+    void requestTile(const TileKey& key, float pixelsPerSecond, const AudioData& audioData);
+    void dropQueuedJobsExcept(int zoom, int firstIndex, int lastIndex);
+    void drawFallback(juce::Graphics& g, const juce::Rectangle<int>& tileArea, double tileStartTime,
+                      double tileEndTime, float pixelsPerSecond, int areaX, double scrollX);
+    void adoptFinishedTiles();
+    void removeTile(std::map<TileKey, Tile>::iterator it);
+    void evictToBudget();
+
+    void workerLoop();
+    static juce::Image renderTile(const Job& job);
+
+    // Message thread state
+    std::map<TileKey, Tile> tiles;
+    std::list<TileKey> lru;  // Front = least recently used
+    std::map<TileKey, Pending> pending;
+    size_t budget;
+    size_t totalBytes = 0;
+    int tileHeight = 0;
+    int waveformSamples = 0;
+    int currentZoom = 0;
+    int fallbackZoom = 0;
+    int lookupHits = 0;
+    int lookupMisses = 0;
+    juce::uint64 nextTicket = 1;
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+
+    // Worker thread
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<Job> queue;
+    std::vector<Finished> finished;
+    bool stopRequested = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformTileCache)
+};
@@ -1,7 +1,11 @@
 #include "PianoRollComponent.h"
+#include "../Audio/AudioCallbackMonitor.h"
+#include "../Utils/AppLogger.h"
 #include "../Utils/BasePitchCurve.h"
 #include "../Utils/Constants.h"
 #include "../Utils/PitchCurveProcessor.h"
+#include "../Utils/Tracer.h"
+#include "PianoRoll/PitchPathBuilder.h"
 #include <cmath>
 #include <limits>
 
@@ -16,6 +20,7 @@ PianoRollComponent::PianoRollComponent() {
 
   // Wire up components
   renderer->setCoordinateMapper(coordMapper.get());
+  renderer->onRepaintNeeded = [this]() { repaint(); };
   scrollZoomController->setCoordinateMapper(coordMapper.get());
   pitchEditor->setCoordinateMapper(coordMapper.get());
   noteSplitter->setCoordinateMapper(coordMapper.get());
@@ -40,8 +45,9 @@ PianoRollComponent::PianoRollComponent() {
   pitchEditor->onPitchEditFinished = [this]() {
     if (onPitchEditFinished) onPitchEditFinished();
   };
-  pitchEditor->onBasePitchCacheInvalidated = [this]() {
-    invalidateBasePitchCache();
+  pitchEditor->onBasePitchCacheInvalidated = [this](int startFrame,
+                                                     int endFrame) {
+    invalidateBasePitchCache(startFrame, endFrame);
   };
 
   // Setup noteSplitter callbacks
@@ -84,6 +90,10 @@ PianoRollComponent::~PianoRollComponent() {
 }
 
 void PianoRollComponent::paint(juce::Graphics &g) {
+  TRACE_SCOPE("piano roll paint");
+  using Layer = PaintProfiler::Layer;
+  profiler.beginPaint();
+
   // Apply rounded corner clipping
   const float cornerRadius = 8.0f;
   juce::Path clipPath;
@@ -93,37 +103,71 @@ void PianoRollComponent::paint(juce::Graphics &g) {
   // Background
   g.fillAll(juce::Colour(COLOR_BACKGROUND));
 
-  constexpr int scrollBarSize = 8;
-
   // Create clipping region for main area (below timeline)
-  auto mainArea = getLocalBounds()
-                      .withTrimmedLeft(pianoKeysWidth)
-                      .withTrimmedTop(timelineHeight)
-                      .withTrimmedBottom(scrollBarSize)
-                      .withTrimmedRight(scrollBarSize);
-
-  // Draw background waveform (only horizontal scroll, fills visible height)
+  auto mainArea = getMainArea();
+  const int originX = pianoKeysWidth - static_cast<int>(scrollX);
+  const int originY = timelineHeight - static_cast<int>(scrollY);
+  const double duration =
+      project ? project->getAudioData().getDuration() : 60.0;
+
+  // Draw spectrogram and background waveform (only horizontal scroll, fill
+  // visible height) and the grid over them
   {
     juce::Graphics::ScopedSaveState saveState(g);
     g.reduceClipRegion(mainArea);
-    drawBackgroundWaveform(g, mainArea);
+    if (showSpectrogram) {
+      PaintProfiler::ScopedLayer timed(profiler, Layer::Spectrogram);
+      renderer->drawSpectrogram(g, mainArea);
+    }
+    {
+      PaintProfiler::ScopedLayer timed(profiler, Layer::Waveform);
+      drawBackgroundWaveform(g, mainArea);
+
+      int hits = 0, misses = 0;
+      renderer->getWaveformTileCache().takeLookupCounts(hits, misses);
+      profiler.recordCacheLookups(PaintProfiler::Cache::WaveformTiles, hits,
+                                  misses);
+    }
+    {
+      PaintProfiler::ScopedLayer timed(profiler, Layer::Grid);
+      drawCachedLayer(g, gridLayer, mainArea,
+                      {static_cast<double>(originX),
+                       static_cast<double>(originY), pixelsPerSecond,
+                       pixelsPerSemitone, duration},
+                      [this, originX, originY](juce::Graphics &lg) {
+                        lg.setOrigin(originX, originY);
+                        drawGrid(lg);
+                      });
+    }
   }
 
-  // Draw scrolled content (grid, notes, pitch curves)
+  // Draw scrolled content (notes, pitch curves)
   {
     juce::Graphics::ScopedSaveState saveState(g);
     g.reduceClipRegion(mainArea);
-    g.setOrigin(pianoKeysWidth - static_cast<int>(scrollX),
-                timelineHeight - static_cast<int>(scrollY));
+    g.setOrigin(originX, originY);
 
-    drawGrid(g);
-    drawNotes(g);
-    drawPitchCurves(g);
+    {
+      PaintProfiler::ScopedLayer timed(profiler, Layer::Notes);
+      drawNotes(g);
+    }
+    {
+      PaintProfiler::ScopedLayer timed(profiler, Layer::Curves);
+      drawPitchCurves(g);
+    }
     drawSelectionRect(g);
+
+    // Drop cached note paths that scrolled out of view long ago
+    renderer->getNotePathCache().trim();
   }
 
   // Draw timeline (above grid, scrolls horizontally)
-  drawTimeline(g);
+  {
+    PaintProfiler::ScopedLayer timed(profiler, Layer::Timeline);
+    drawCachedLayer(g, timelineLayer, {0, 0, getWidth(), timelineHeight},
+                    {scrollX, pixelsPerSecond, duration, 0.0, 0.0},
+                    [this](juce::Graphics &lg) { drawTimeline(lg); });
+  }
 
   // Draw unified cursor line (spans from timeline through grid)
   {
@@ -137,113 +181,175 @@ void PianoRollComponent::paint(juce::Graphics &g) {
     g.fillRect(x - 0.5f, cursorTop, 1.0f, cursorBottom);
   }
 
-  // Draw piano keys
-  drawPianoKeys(g);
+  // Draw piano keys (keys near the top may overlap the timeline corner)
+  {
+    PaintProfiler::ScopedLayer timed(profiler, Layer::Keys);
+    drawCachedLayer(g, keysLayer, {0, 0, pianoKeysWidth, getHeight()},
+                    {scrollY, pixelsPerSemitone, 0.0, 0.0, 0.0},
+                    [this](juce::Graphics &lg) { drawPianoKeys(lg); });
+  }
+
+  profiler.endPaint();
+
+  // Figures from the last completed second; not part of the paint timed
+  profiler.drawOverlay(g, mainArea);
 }
 
-void PianoRollComponent::resized() {
-  auto bounds = getLocalBounds();
+juce::Rectangle<int> PianoRollComponent::getMainArea() const {
   constexpr int scrollBarSize = 8;
+  return getLocalBounds()
+      .withTrimmedLeft(pianoKeysWidth)
+      .withTrimmedTop(timelineHeight)
+      .withTrimmedBottom(scrollBarSize)
+      .withTrimmedRight(scrollBarSize);
+}
 
-  horizontalScrollBar.setBounds(
-      pianoKeysWidth, bounds.getHeight() - scrollBarSize,
-      bounds.getWidth() - pianoKeysWidth - scrollBarSize, scrollBarSize);
+void PianoRollComponent::drawCachedLayer(
+    juce::Graphics &g, CachedLayer &layer, const juce::Rectangle<int> &area,
+    const LayerKey &key,
+    const std::function<void(juce::Graphics &)> &drawLayer) {
+  if (area.isEmpty())
+    return;
 
-  verticalScrollBar.setBounds(
-      bounds.getWidth() - scrollBarSize, timelineHeight, scrollBarSize,
-      bounds.getHeight() - scrollBarSize - timelineHeight);
+  // Rendered at the display's pixel density so the blit stays sharp
+  const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const int imageWidth = juce::roundToInt(area.getWidth() * scale);
+  const int imageHeight = juce::roundToInt(area.getHeight() * scale);
+
+  bool sizeChanged = !layer.image.isValid() ||
+                     layer.image.getWidth() != imageWidth ||
+                     layer.image.getHeight() != imageHeight;
+  if (sizeChanged || layer.key != key) {
+    if (sizeChanged)
+      layer.image =
+          juce::Image(juce::Image::ARGB, imageWidth, imageHeight, true);
+    else
+      layer.image.clear(layer.image.getBounds());
 
-  updateScrollBars();
+    layer.key = key;
+    juce::Graphics lg(layer.image);
+    lg.addTransform(juce::AffineTransform::scale(scale));
+    lg.setOrigin(-area.getX(), -area.getY());
+    drawLayer(lg);
+  }
+
+  g.drawImage(layer.image, area.toFloat());
 }
 
-void PianoRollComponent::drawBackgroundWaveform(
-    juce::Graphics &g, const juce::Rectangle<int> &visibleArea) {
-  if (!project)
+void PianoRollComponent::markWorldAreaDirty(
+    const juce::Rectangle<float> &area) {
+  // World to component coordinates, as paint() sets up the origin; the
+  // margin covers antialiased edges
+  auto screenArea =
+      area.translated(
+              static_cast<float>(pianoKeysWidth - static_cast<int>(scrollX)),
+              static_cast<float>(timelineHeight - static_cast<int>(scrollY)))
+          .expanded(2.0f)
+          .getSmallestIntegerContainer()
+          .getIntersection(getMainArea());
+  if (screenArea.isEmpty())
     return;
 
-  const auto &audioData = project->getAudioData();
-  if (audioData.waveform.getNumSamples() == 0)
-    return;
+  dirtyArea =
+      dirtyArea.isEmpty() ? screenArea : dirtyArea.getUnion(screenArea);
+}
 
-  // Check if we can use cached waveform
-  bool cacheValid = waveformCache.isValid() &&
-                    std::abs(cachedScrollX - scrollX) < 1.0 &&
-                    std::abs(cachedPixelsPerSecond - pixelsPerSecond) < 0.01f &&
-                    cachedWidth == visibleArea.getWidth() &&
-                    cachedHeight == visibleArea.getHeight();
+void PianoRollComponent::markFramesDirty(int startFrame, int endFrame) {
+  // Full visible height: the curves of these frames can be anywhere
+  float x1 = framesToSeconds(startFrame) * pixelsPerSecond;
+  float x2 = framesToSeconds(endFrame) * pixelsPerSecond;
+  markWorldAreaDirty({x1, static_cast<float>(scrollY), x2 - x1,
+                      static_cast<float>(getHeight())});
+}
 
-  if (cacheValid) {
-    g.drawImageAt(waveformCache, visibleArea.getX(), visibleArea.getY());
+void PianoRollComponent::markNoteDirty(const Note &note) {
+  if (!project || note.isRest())
     return;
-  }
 
-  // Render waveform to cache
-  waveformCache = juce::Image(juce::Image::ARGB, visibleArea.getWidth(),
-                              visibleArea.getHeight(), true);
-  juce::Graphics cacheGraphics(waveformCache);
-
-  const float *samples = audioData.waveform.getReadPointer(0);
-  int numSamples = audioData.waveform.getNumSamples();
-
-  // Draw waveform filling the visible area height
-  float visibleHeight = static_cast<float>(visibleArea.getHeight());
-  float centerY = visibleHeight * 0.5f;
-  float waveformHeight = visibleHeight * 0.8f;
+  float x = framesToSeconds(note.getStartFrame()) * pixelsPerSecond;
+  float w = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
+  float y = midiToY(note.getMidiNote()) -
+            note.getPitchOffset() * pixelsPerSemitone;
+  juce::Rectangle<float> bounds(x, y, std::max(w, 4.0f), pixelsPerSemitone);
+
+  // The cached shapes drawNotes() and drawPitchCurves() draw; after an edit
+  // they are rebuilt here instead of in the next paint
+  auto &notePaths = renderer->getNotePathCache();
+  if (project->getAudioData().waveform.getNumSamples() > 0 && w > 2.0f)
+    bounds = bounds.getUnion(notePaths
+                                 .getNoteWaveform(*project, note,
+                                                  pixelsPerSecond,
+                                                  pixelsPerSemitone)
+                                 .outline.getBounds());
+  if (showDeltaPitch)
+    bounds = bounds.getUnion(
+        notePaths
+            .getPitchCurve(*project, note, project->getGlobalPitchOffset(),
+                           pixelsPerSecond, pixelsPerSemitone)
+            .getBounds());
+
+  markWorldAreaDirty(bounds);
+}
 
-  juce::Path waveformPath;
-  int visibleWidth = visibleArea.getWidth();
+void PianoRollComponent::repaintDirtyArea() {
+  if (!dirtyArea.isEmpty())
+    repaint(dirtyArea);
+  dirtyArea = {};
+}
 
-  waveformPath.startNewSubPath(0.0f, centerY);
+void PianoRollComponent::resized() {
+  auto bounds = getLocalBounds();
+  constexpr int scrollBarSize = 8;
 
-  // Draw only the visible portion
-  for (int px = 0; px < visibleWidth; ++px) {
-    double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
+  horizontalScrollBar.setBounds(
+      pianoKeysWidth, bounds.getHeight() - scrollBarSize,
+      bounds.getWidth() - pianoKeysWidth - scrollBarSize, scrollBarSize);
 
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
+  verticalScrollBar.setBounds(
+      bounds.getWidth() - scrollBarSize, timelineHeight, scrollBarSize,
+      bounds.getHeight() - scrollBarSize - timelineHeight);
 
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+  updateScrollBars();
+}
 
-    float y = centerY - maxVal * waveformHeight * 0.5f;
-    waveformPath.lineTo(static_cast<float>(px), y);
-  }
+void PianoRollComponent::drawBackgroundWaveform(
+    juce::Graphics &g, const juce::Rectangle<int> &visibleArea) {
+  // Tiles keyed by zoom and world position: scrolling only blits
+  renderer->drawBackgroundWaveform(g, visibleArea);
+}
 
-  // Bottom half (reverse)
-  for (int px = visibleWidth - 1; px >= 0; --px) {
-    double time = (scrollX + px) / pixelsPerSecond;
-    int startSample = static_cast<int>(time * SAMPLE_RATE);
-    int endSample =
-        static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
+void PianoRollComponent::invalidateWaveformRange(int startSample,
+                                                 int numSamples) {
+  renderer->invalidateWaveformRange(startSample, numSamples);
+  repaint();
+}
 
-    startSample = std::max(0, std::min(startSample, numSamples - 1));
-    endSample = std::max(startSample + 1, std::min(endSample, numSamples));
+void PianoRollComponent::setShowPerformanceOverlay(bool show) {
+  profiler.setEnabled(show);
+  repaint();
+}
 
-    float maxVal = 0.0f;
-    for (int i = startSample; i < endSample; ++i)
-      maxVal = std::max(maxVal, std::abs(samples[i]));
+void PianoRollComponent::recordTimerTick(double expectedIntervalMs) {
+  // New figures once per second: refresh just the overlay
+  if (!profiler.recordTimerTick(expectedIntervalMs))
+    return;
 
-    float y = centerY + maxVal * waveformHeight * 0.5f;
-    waveformPath.lineTo(static_cast<float>(px), y);
+  if (callbackMonitor) {
+    const auto snapshot = callbackMonitor->getSnapshot();
+    const auto audioLine = AudioCallbackMonitor::formatSnapshot(snapshot);
+    profiler.setAudioLine(audioLine);
+    LOG("Audio callback: " + audioLine + "; " +
+        AudioCallbackMonitor::formatHistogram(snapshot));
   }
 
-  waveformPath.closeSubPath();
-
-  cacheGraphics.setColour(juce::Colour(COLOR_WAVEFORM));
-  cacheGraphics.fillPath(waveformPath);
-
-  // Update cache metadata
-  cachedScrollX = scrollX;
-  cachedPixelsPerSecond = pixelsPerSecond;
-  cachedWidth = visibleArea.getWidth();
-  cachedHeight = visibleArea.getHeight();
+  repaint(PaintProfiler::getOverlayBounds(getMainArea()));
+}
 
-  // Draw cached image
-  g.drawImageAt(waveformCache, visibleArea.getX(), visibleArea.getY());
+void PianoRollComponent::invalidateSpectrogramRange(int startFrame,
+                                                    int endFrame) {
+  renderer->invalidateSpectrogramRange(startFrame, endFrame);
+  if (showSpectrogram)
+    repaint();
 }
 
 void PianoRollComponent::drawGrid(juce::Graphics &g) {
@@ -355,245 +461,51 @@ void PianoRollComponent::drawNotes(juce::Graphics &g) {
     return;
 
   const auto &audioData = project->getAudioData();
-  const float *samples = audioData.waveform.getNumSamples() > 0
-                             ? audioData.waveform.getReadPointer(0)
-                             : nullptr;
   int totalSamples = audioData.waveform.getNumSamples();
-
-  // Calculate visible time range for culling
-  double visibleStartTime = scrollX / pixelsPerSecond;
-  double visibleEndTime = (scrollX + getWidth()) / pixelsPerSecond;
-
-  for (auto &note : project->getNotes()) {
+  auto &notePaths = renderer->getNotePathCache();
+
+  // Calculate visible time range for culling; during drags only the dirty
+  // region is being repainted
+  auto clip = g.getClipBounds();
+  double visibleStartTime = clip.getX() / pixelsPerSecond;
+  double visibleEndTime = clip.getRight() / pixelsPerSecond;
+
+  // Viewport culling through the note index: only notes on screen are visited
+  for (const Note *note : project->getNotesInRange(
+           secondsToFrames(static_cast<float>(visibleStartTime)),
+           secondsToFrames(static_cast<float>(visibleEndTime)) + 1)) {
     // Skip rest notes (they have no pitch)
-    if (note.isRest())
-      continue;
-
-    // Viewport culling: skip notes outside visible area
-    double noteStartTime = framesToSeconds(note.getStartFrame());
-    double noteEndTime = framesToSeconds(note.getEndFrame());
-    if (noteEndTime < visibleStartTime || noteStartTime > visibleEndTime)
+    if (note->isRest())
       continue;
 
-    float x = static_cast<float>(noteStartTime * pixelsPerSecond);
-    float w = framesToSeconds(note.getDurationFrames()) * pixelsPerSecond;
+    float x = static_cast<float>(framesToSeconds(note->getStartFrame()) *
+                                 pixelsPerSecond);
+    float w = framesToSeconds(note->getDurationFrames()) * pixelsPerSecond;
     float h = pixelsPerSemitone;
 
     // Position at grid cell center for MIDI note, then offset by pitch
     // adjustment
     float baseGridCenterY =
-        midiToY(note.getMidiNote()) + pixelsPerSemitone * 0.5f;
-    float pitchOffsetPixels = -note.getPitchOffset() * pixelsPerSemitone;
+        midiToY(note->getMidiNote()) + pixelsPerSemitone * 0.5f;
+    float pitchOffsetPixels = -note->getPitchOffset() * pixelsPerSemitone;
     float y = baseGridCenterY + pitchOffsetPixels - h * 0.5f;
 
     // Note color based on pitch
-    juce::Colour noteColor = note.isSelected()
+    juce::Colour noteColor = note->isSelected()
                                  ? juce::Colour(COLOR_NOTE_SELECTED)
                                  : juce::Colour(COLOR_NOTE_NORMAL);
 
-    if (samples && totalSamples > 0 && w > 2.0f) {
-      // Draw waveform slice inside note
-      int startSample = static_cast<int>(framesToSeconds(note.getStartFrame()) *
-                                         audioData.sampleRate);
-      int endSample = static_cast<int>(framesToSeconds(note.getEndFrame()) *
-                                       audioData.sampleRate);
-      startSample = std::max(0, std::min(startSample, totalSamples - 1));
-      endSample = std::max(startSample + 1, std::min(endSample, totalSamples));
-
-      int numNoteSamples = endSample - startSample;
-      int samplesPerPixel = std::max(1, static_cast<int>(numNoteSamples / w));
+    // Waveform slice inside the note, built once per note version and zoom
+    const NotePathCache::NoteWaveform *shape = nullptr;
+    if (totalSamples > 0 && w > 2.0f)
+      shape = &notePaths.getNoteWaveform(*project, *note, pixelsPerSecond,
+                                         pixelsPerSemitone);
 
-      float centerY = y + h * 0.5f;
-      float waveHeight = h * 3.0f;
-
-      // Build waveform data with increased resolution for smoother curves
-      std::vector<float> waveValues;
-      // Increase point density for smoother curves (up to 800 points)
-      float step = std::max(0.5f, w / 1024.0f);
-
-      for (float px = 0; px <= w; px += step) {
-        int sampleIdx =
-            startSample + static_cast<int>((px / w) * numNoteSamples);
-        int sampleEnd = std::min(sampleIdx + samplesPerPixel, endSample);
-
-        float maxVal = 0.0f;
-        for (int i = sampleIdx; i < sampleEnd; ++i)
-          maxVal = std::max(maxVal, std::abs(samples[i]));
-
-        waveValues.push_back(maxVal);
-      }
-
-      // Apply smoothing filter to reduce aliasing artifacts
-      if (waveValues.size() > 2) {
-        std::vector<float> smoothed(waveValues.size());
-        smoothed[0] = waveValues[0];
-        for (size_t i = 1; i + 1 < waveValues.size(); ++i) {
-          // Simple 3-point moving average for gentle smoothing
-          smoothed[i] = (waveValues[i - 1] * 0.25f + waveValues[i] * 0.5f +
-                         waveValues[i + 1] * 0.25f);
-        }
-        smoothed[waveValues.size() - 1] = waveValues[waveValues.size() - 1];
-        waveValues = std::move(smoothed);
-      }
-
-      size_t numPoints = waveValues.size();
-      if (numPoints < 2) {
-        // Fallback for very short notes
-        g.setColour(noteColor.withAlpha(0.85f));
-        g.fillRoundedRectangle(x, y, std::max(w, 4.0f), h, 2.0f);
-      } else {
-        // Helper function for Catmull-Rom spline interpolation
-        auto catmullRom = [](float t, float p0, float p1, float p2,
-                             float p3) -> float {
-          // Catmull-Rom spline: smooth interpolation between p1 and p2
-          float t2 = t * t;
-          float t3 = t2 * t;
-          return 0.5f * ((2.0f * p1) + (-p0 + p2) * t +
-                         (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
-                         (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
-        };
-
-        // Draw filled waveform using smooth curves
-        g.setColour(noteColor.withAlpha(0.85f));
-        juce::Path waveformPath;
-
-        // Build top curve with Catmull-Rom spline
-        waveformPath.startNewSubPath(x, centerY -
-                                            waveValues[0] * waveHeight * 0.5f);
-
-        // Use cubic curves for smooth interpolation
-        const int curveSegments = 4; // Interpolate 4 points between each pair
-        for (size_t i = 0; i + 1 < numPoints; ++i) {
-          float px1 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-          float px2 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-
-          // Get control points for spline
-          size_t idx0 = (i > 0) ? i - 1 : i;
-          size_t idx1 = i;
-          size_t idx2 = i + 1;
-          size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          // Draw smooth curve segment
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY - val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-          }
-        }
-
-        // Build bottom curve (mirror of top)
-        waveformPath.lineTo(x + w, centerY + waveValues[numPoints - 1] *
-                                                 waveHeight * 0.5f);
-
-        for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
-          float px1 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-          float px2 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-
-          size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
-          size_t idx1 = i + 1;
-          size_t idx2 = i;
-          size_t idx3 = (i > 0) ? i - 1 : i;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY + val * waveHeight * 0.5f;
-            waveformPath.lineTo(x + px, yPos);
-          }
-        }
-
-        waveformPath.closeSubPath();
-        g.fillPath(waveformPath);
-
-        // Draw smooth outline with anti-aliasing
-        juce::Path outline;
-        outline.startNewSubPath(x, centerY - waveValues[0] * waveHeight * 0.5f);
-
-        // Top curve
-        for (size_t i = 0; i + 1 < numPoints; ++i) {
-          float px1 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-          float px2 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-
-          size_t idx0 = (i > 0) ? i - 1 : i;
-          size_t idx1 = i;
-          size_t idx2 = i + 1;
-          size_t idx3 = (i + 2 < numPoints) ? i + 2 : i + 1;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY - val * waveHeight * 0.5f;
-            outline.lineTo(x + px, yPos);
-          }
-        }
-
-        // Bottom curve
-        for (int i = static_cast<int>(numPoints) - 2; i >= 0; --i) {
-          float px1 =
-              (static_cast<float>(i + 1) / static_cast<float>(numPoints - 1)) *
-              w;
-          float px2 =
-              (static_cast<float>(i) / static_cast<float>(numPoints - 1)) * w;
-
-          size_t idx0 = (i + 2 < numPoints) ? i + 2 : i + 1;
-          size_t idx1 = i + 1;
-          size_t idx2 = i;
-          size_t idx3 = (i > 0) ? i - 1 : i;
-
-          float val0 = waveValues[idx0];
-          float val1 = waveValues[idx1];
-          float val2 = waveValues[idx2];
-          float val3 = waveValues[idx3];
-
-          for (int seg = 1; seg <= curveSegments; ++seg) {
-            float t =
-                static_cast<float>(seg) / static_cast<float>(curveSegments);
-            float px = px1 + (px2 - px1) * t;
-            float val = catmullRom(t, val0, val1, val2, val3);
-            float yPos = centerY + val * waveHeight * 0.5f;
-            outline.lineTo(x + px, yPos);
-          }
-        }
-
-        outline.closeSubPath();
-        g.setColour(noteColor.brighter(0.2f));
-        // Use slightly thicker stroke with anti-aliasing for smoother
-        // appearance
-        g.strokePath(outline,
-                     juce::PathStrokeType(1.2f, juce::PathStrokeType::curved,
-                                          juce::PathStrokeType::rounded));
-      }
+    if (shape && !shape->fill.isEmpty()) {
+      g.setColour(noteColor.withAlpha(0.85f));
+      g.fillPath(shape->fill);
+      g.setColour(noteColor.brighter(0.2f));
+      g.fillPath(shape->outline);
     } else {
       // Fallback: simple rectangle for very short notes
       g.setColour(noteColor.withAlpha(0.85f));
@@ -602,15 +514,16 @@ void PianoRollComponent::drawNotes(juce::Graphics &g) {
   }
 
   // Draw split guide line when in split mode and hovering over a note
-  if (editMode == EditMode::Split && splitGuideNote && splitGuideX >= 0) {
-    float noteStartTime = framesToSeconds(splitGuideNote->getStartFrame());
-    float noteEndTime = framesToSeconds(splitGuideNote->getEndFrame());
+  const Note *guideNote = project ? project->getNote(splitGuideNote) : nullptr;
+  if (editMode == EditMode::Split && guideNote && splitGuideX >= 0) {
+    float noteStartTime = framesToSeconds(guideNote->getStartFrame());
+    float noteEndTime = framesToSeconds(guideNote->getEndFrame());
     float noteStartX = static_cast<float>(noteStartTime * pixelsPerSecond);
     float noteEndX = static_cast<float>(noteEndTime * pixelsPerSecond);
 
     // Only draw if guide is within note bounds (with margin)
     if (splitGuideX > noteStartX + 5 && splitGuideX < noteEndX - 5) {
-      float noteY = midiToY(splitGuideNote->getAdjustedMidiNote());
+      float noteY = midiToY(guideNote->getAdjustedMidiNote());
       float noteH = pixelsPerSemitone;
 
       // Draw dashed vertical line
@@ -639,49 +552,23 @@ void PianoRollComponent::drawPitchCurves(juce::Graphics &g) {
   if (showDeltaPitch) {
     g.setColour(juce::Colour(COLOR_PITCH_CURVE));
 
-    for (const auto &note : project->getNotes()) {
-      if (note.isRest())
-        continue;
+    auto clip = g.getClipBounds();
+    double visibleStartTime = clip.getX() / pixelsPerSecond;
+    double visibleEndTime = clip.getRight() / pixelsPerSecond;
+    auto &notePaths = renderer->getNotePathCache();
 
-      juce::Path path;
-      bool pathStarted = false;
-
-      int startFrame = note.getStartFrame();
-      int endFrame =
-          std::min(note.getEndFrame(), static_cast<int>(audioData.f0.size()));
-
-      for (int i = startFrame; i < endFrame; ++i) {
-        // Base pitch: during drag, add pitchOffset to simulate the new base pitch
-        // This gives real-time preview of how the curve will look after drag completes
-        float baseMidi =
-            (i < static_cast<int>(audioData.basePitch.size()))
-                ? audioData.basePitch[static_cast<size_t>(i)] + note.getPitchOffset()
-                : ((i < static_cast<int>(audioData.f0.size()) &&
-                    audioData.f0[static_cast<size_t>(i)] > 0.0f)
-                       ? freqToMidi(audioData.f0[static_cast<size_t>(i)]) + note.getPitchOffset()
-                       : 0.0f);
-        float deltaMidi = (i < static_cast<int>(audioData.deltaPitch.size()))
-                              ? audioData.deltaPitch[static_cast<size_t>(i)]
-                              : 0.0f;
-        // Final = base (with drag offset) + delta + global offset only
-        float finalMidi = baseMidi + deltaMidi + globalOffset;
-
-        if (finalMidi > 0.0f) {
-          float x = framesToSeconds(i) * pixelsPerSecond;
-          float y = midiToY(finalMidi) + pixelsPerSemitone * 0.5f;
-
-          if (!pathStarted) {
-            path.startNewSubPath(x, y);
-            pathStarted = true;
-          } else {
-            path.lineTo(x, y);
-          }
-        }
-      }
+    for (const Note *note : project->getNotesInRange(
+             secondsToFrames(static_cast<float>(visibleStartTime)),
+             secondsToFrames(static_cast<float>(visibleEndTime)) + 1)) {
+      if (note->isRest())
+        continue;
 
-      if (pathStarted) {
-        g.strokePath(path, juce::PathStrokeType(2.0f));
-      }
+      // Stroked curve, rebuilt only when the note, its curve slice or the
+      // zoom changed
+      const auto &stroke = notePaths.getPitchCurve(
+          *project, *note, globalOffset, pixelsPerSecond, pixelsPerSemitone);
+      if (!stroke.isEmpty())
+        g.fillPath(stroke);
     }
   }
 
@@ -702,41 +589,19 @@ void PianoRollComponent::drawPitchCurves(juce::Graphics &g) {
           static_cast<int>(visibleEndTime * audioData.sampleRate / HOP_SIZE) +
               1);
 
-      // Draw base pitch curve with dashed line
+      // Draw base pitch curve with dashed line, at most a few vertices per
+      // pixel column however far out the view is zoomed
       g.setColour(
           juce::Colour(0xFF00FF00).withAlpha(0.6f)); // Green with transparency
       juce::Path basePath;
-      bool basePathStarted = false;
-
-      for (int i = visStartFrame; i < visEndFrame; ++i) {
-        if (i >= 0 && i < static_cast<int>(cachedBasePitch.size())) {
-          float baseMidi = cachedBasePitch[static_cast<size_t>(i)];
-          if (baseMidi > 0.0f) {
-            float x = framesToSeconds(i) * pixelsPerSecond;
-            float y = midiToY(baseMidi) +
-                      pixelsPerSemitone * 0.5f; // Center in grid cell
-
-            if (!basePathStarted) {
-              basePath.startNewSubPath(x, y);
-              basePathStarted = true;
-            } else {
-              basePath.lineTo(x, y);
-            }
-          } else if (basePathStarted) {
-            // Break path at unvoiced regions - draw current segment before
-            // breaking
-            juce::Path dashedPath;
-            juce::PathStrokeType stroke(1.5f);
-            const float dashLengths[] = {4.0f, 4.0f}; // 4px dash, 4px gap
-            stroke.createDashedStroke(dashedPath, basePath, dashLengths, 2);
-            g.strokePath(dashedPath, juce::PathStrokeType(1.5f));
-            basePath.clear();
-            basePathStarted = false;
-          }
-        }
-      }
+      PitchPathBuilder builder(basePath, pixelsPerSecond, pixelsPerSemitone);
 
-      if (basePathStarted) {
+      // Unvoiced frames break the path
+      for (int i = visStartFrame; i < visEndFrame; ++i)
+        builder.add(i, cachedBasePitch[static_cast<size_t>(i)]);
+      builder.finish();
+
+      if (!basePath.isEmpty()) {
         // Use dashed stroke for base pitch curve
         juce::Path dashedPath;
         juce::PathStrokeType stroke(1.5f);
@@ -823,6 +688,9 @@ void PianoRollComponent::mouseDown(const juce::MouseEvent &e) {
   if (!project)
     return;
 
+  // Left over from a drag whose last move was throttled; mouseUp repainted
+  dirtyArea = {};
+
   float adjustedX = e.x - pianoKeysWidth + static_cast<float>(scrollX);
   float adjustedY = e.y - timelineHeight + static_cast<float>(scrollY);
 
@@ -889,24 +757,14 @@ void PianoRollComponent::mouseDown(const juce::MouseEvent &e) {
       if (onNoteSelected)
         onNoteSelected(note);
 
-      // Capture delta slice from global dense deltaPitch for this note
+      // Delta pitch stays in the dense project curve; only midiNote moves
       auto &audioData = project->getAudioData();
       int startFrame = note->getStartFrame();
       int endFrame = note->getEndFrame();
-      int numFrames = endFrame - startFrame;
-
-      std::vector<float> delta(numFrames, 0.0f);
-      for (int i = 0; i < numFrames; ++i) {
-        int globalFrame = startFrame + i;
-        if (globalFrame >= 0 &&
-            globalFrame < static_cast<int>(audioData.deltaPitch.size()))
-          delta[i] = audioData.deltaPitch[static_cast<size_t>(globalFrame)];
-      }
-      note->setDeltaPitch(std::move(delta));
 
       // Start single note dragging
       isDragging = true;
-      draggedNote = note;
+      draggedNote = project->getHandle(*note);
       dragStartY = adjustedY;
       originalPitchOffset = note->getPitchOffset();
       originalMidiNote = note->getMidiNote();
@@ -935,7 +793,8 @@ void PianoRollComponent::mouseDown(const juce::MouseEvent &e) {
 }
 
 void PianoRollComponent::mouseDrag(const juce::MouseEvent &e) {
-  // Throttle repaints during drag to ~60fps max
+  // Throttle repaints during drag to ~60fps max; only the regions the drag
+  // changed since the last repaint are redrawn
   juce::int64 now = juce::Time::getMillisecondCounter();
   bool shouldRepaint = (now - lastDragRepaintTime) >= minDragRepaintInterval;
 
@@ -943,13 +802,28 @@ void PianoRollComponent::mouseDrag(const juce::MouseEvent &e) {
   float adjustedY = e.y - timelineHeight + static_cast<float>(scrollY);
 
   if (editMode == EditMode::Draw && isDrawing) {
+    const int previousFrame = lastDrawFrame;
     applyPitchDrawing(adjustedX, adjustedY);
 
+    if (project && lastDrawFrame >= 0) {
+      // Frames from the previous point to this one were rewritten. The curve
+      // joins across unvoiced frames, so widen to the notes they belong to.
+      int startFrame = std::min(previousFrame >= 0 ? previousFrame
+                                                   : lastDrawFrame,
+                                lastDrawFrame);
+      int endFrame = std::max(previousFrame, lastDrawFrame) + 1;
+      for (const Note *note : project->getNotesInRange(startFrame, endFrame)) {
+        startFrame = std::min(startFrame, note->getStartFrame());
+        endFrame = std::max(endFrame, note->getEndFrame());
+      }
+      markFramesDirty(startFrame - 1, endFrame + 1);
+    }
+
     if (onPitchEdited)
       onPitchEdited();
 
     if (shouldRepaint) {
-      repaint();
+      repaintDirtyArea();
       lastDragRepaintTime = now;
     }
     return;
@@ -957,9 +831,11 @@ void PianoRollComponent::mouseDrag(const juce::MouseEvent &e) {
 
   // Handle box selection
   if (boxSelector->isSelecting()) {
+    markWorldAreaDirty(boxSelector->getSelectionRect());
     boxSelector->updateSelection(adjustedX, adjustedY);
+    markWorldAreaDirty(boxSelector->getSelectionRect());
     if (shouldRepaint) {
-      repaint();
+      repaintDirtyArea();
       lastDragRepaintTime = now;
     }
     return;
@@ -967,24 +843,32 @@ void PianoRollComponent::mouseDrag(const juce::MouseEvent &e) {
 
   // Handle multi-note drag
   if (pitchEditor->isDraggingMultiNotes()) {
+    auto draggedNotes = pitchEditor->getDraggedNotes();
+    for (const Note *note : draggedNotes)
+      markNoteDirty(*note);
     pitchEditor->updateMultiNoteDrag(adjustedY);
+    for (const Note *note : draggedNotes)
+      markNoteDirty(*note);
     if (shouldRepaint) {
-      repaint();
+      repaintDirtyArea();
       lastDragRepaintTime = now;
     }
     return;
   }
 
   // Handle single note drag
-  if (isDragging && draggedNote) {
+  Note *dragged = isDragging && project ? project->getNote(draggedNote) : nullptr;
+  if (dragged) {
     float deltaY = dragStartY - adjustedY;
     float deltaSemitones = deltaY / pixelsPerSemitone;
 
-    draggedNote->setPitchOffset(deltaSemitones);
-    draggedNote->markDirty();
+    markNoteDirty(*dragged);
+    dragged->setPitchOffset(deltaSemitones);
+    dragged->markDirty();
+    markNoteDirty(*dragged);
 
     if (shouldRepaint) {
-      repaint();
+      repaintDirtyArea();
       lastDragRepaintTime = now;
     }
   }
@@ -1019,23 +903,24 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
   }
 
   // Handle single note drag end
-  if (isDragging && draggedNote) {
-    float newOffset = draggedNote->getPitchOffset();
+  Note *dragged = isDragging && project ? project->getNote(draggedNote) : nullptr;
+  if (dragged) {
+    float newOffset = dragged->getPitchOffset();
 
     // Check if there was any meaningful change (threshold: 0.001 semitones)
     constexpr float CHANGE_THRESHOLD = 0.001f;
     bool hasChange = std::abs(newOffset) >= CHANGE_THRESHOLD;
 
     if (hasChange && project) {
-      int startFrame = draggedNote->getStartFrame();
-      int endFrame = draggedNote->getEndFrame();
+      int startFrame = dragged->getStartFrame();
+      int endFrame = dragged->getEndFrame();
       auto &audioData = project->getAudioData();
       int f0Size = static_cast<int>(audioData.f0.size());
 
       // Update note's midiNote with final offset (bake pitchOffset into
       // midiNote)
-      draggedNote->setMidiNote(originalMidiNote + newOffset);
-      draggedNote->setPitchOffset(
+      dragged->setMidiNote(originalMidiNote + newOffset);
+      dragged->setPitchOffset(
           0.0f); // Reset offset since it's baked into midiNote
 
       // Find adjacent notes to expand dirty range (basePitch smoothing affects neighbors)
@@ -1043,7 +928,7 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
       int expandedStart = startFrame;
       int expandedEnd = endFrame;
       for (const auto& note : notes) {
-        if (&note == draggedNote) continue;
+        if (&note == dragged) continue;
         // If note is adjacent (within smoothing window ~20 frames), include it
         if (note.getEndFrame() > startFrame - 30 && note.getEndFrame() <= startFrame) {
           expandedStart = std::min(expandedStart, note.getStartFrame());
@@ -1053,12 +938,11 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
         }
       }
 
-      // Rebuild base pitch curve and F0 with final note position
-      PitchCurveProcessor::rebuildBaseFromNotes(*project);
-      PitchCurveProcessor::composeF0InPlace(*project, /*applyUvMask=*/false);
+      // Rebuild base pitch curve and F0 around the dragged note only
+      PitchCurveProcessor::rebuildBaseFromNotes(*project, startFrame, endFrame);
 
-      // Invalidate base pitch cache so it gets regenerated on next paint
-      invalidateBasePitchCache();
+      // Patch the cached base pitch around the note on next paint
+      invalidateBasePitchCache(startFrame, endFrame);
 
       // Mark dirty range for synthesis (use expanded range)
       int smoothStart = std::max(0, expandedStart - 60);
@@ -1083,15 +967,15 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
         int capturedExpandedEnd = expandedEnd;
         int capturedF0Size = f0Size;
         auto action = std::make_unique<NotePitchDragAction>(
-            draggedNote, &audioData.f0, originalMidiNote,
+            project, draggedNote, &audioData.f0, originalMidiNote,
             originalMidiNote + newOffset, std::move(f0Edits),
-            [this, capturedExpandedStart, capturedExpandedEnd, capturedF0Size](Note *n) {
+            [this, startFrame, endFrame, capturedExpandedStart,
+             capturedExpandedEnd, capturedF0Size](Note *n) {
               if (project) {
-                PitchCurveProcessor::rebuildBaseFromNotes(*project);
-                PitchCurveProcessor::composeF0InPlace(*project,
-                                                      /*applyUvMask=*/false);
-                // Invalidate base pitch cache
-                invalidateBasePitchCache();
+                PitchCurveProcessor::rebuildBaseFromNotes(*project, startFrame,
+                                                          endFrame);
+                // Patch base pitch cache around the note
+                invalidateBasePitchCache(startFrame, endFrame);
                 // Set dirty range for synthesis (use expanded range)
                 int smoothStart = std::max(0, capturedExpandedStart - 60);
                 int smoothEnd = std::min(capturedF0Size, capturedExpandedEnd + 60);
@@ -1114,13 +998,13 @@ void PianoRollComponent::mouseUp(const juce::MouseEvent &e) {
         onPitchEditFinished();
     } else {
       // No meaningful change: just reset pitchOffset and repaint
-      draggedNote->setPitchOffset(0.0f);
+      dragged->setPitchOffset(0.0f);
       repaint();
     }
   }
 
   isDragging = false;
-  draggedNote = nullptr;
+  draggedNote = {};
 }
 
 void PianoRollComponent::mouseMove(const juce::MouseEvent &e) {
@@ -1132,16 +1016,16 @@ void PianoRollComponent::mouseMove(const juce::MouseEvent &e) {
     Note *note = noteSplitter->findNoteAt(adjustedX, adjustedY);
     if (note) {
       splitGuideX = adjustedX;
-      splitGuideNote = note;
+      splitGuideNote = project->getHandle(*note);
     } else {
       splitGuideX = -1.0f;
-      splitGuideNote = nullptr;
+      splitGuideNote = {};
     }
     repaint();
   } else if (splitGuideX >= 0) {
     // Clear guide when leaving split mode
     splitGuideX = -1.0f;
-    splitGuideNote = nullptr;
+    splitGuideNote = {};
     repaint();
   }
 }
@@ -1164,9 +1048,9 @@ void PianoRollComponent::mouseDoubleClick(const juce::MouseEvent &e) {
     if (std::abs(snappedOffset - currentOffset) > 0.001f) {
       // Create undo action
       if (undoManager && note) {
-        // Store note index for safer undo (in case notes change)
-        auto action = std::make_unique<PitchOffsetAction>(note, currentOffset,
-                                                          snappedOffset);
+        // Reference the note by handle so undo survives notes changing
+        auto action = std::make_unique<PitchOffsetAction>(
+            project, project->getHandle(*note), currentOffset, snappedOffset);
         undoManager->addAction(std::move(action));
       }
 
@@ -1481,7 +1365,7 @@ void PianoRollComponent::setEditMode(EditMode mode) {
   // Clear split guide when leaving split mode
   if (mode != EditMode::Split) {
     splitGuideX = -1.0f;
-    splitGuideNote = nullptr;
+    splitGuideNote = {};
   }
 
   // Change cursor based on mode
@@ -1513,7 +1397,10 @@ Note *PianoRollComponent::findNoteAt(float x, float y) {
   if (!project)
     return nullptr;
 
-  for (auto &note : project->getNotes()) {
+  // Only notes around the frame under the cursor can contain it
+  const int frame = secondsToFrames(x / pixelsPerSecond);
+  for (auto *candidate : project->getNotesInRange(frame - 1, frame + 2)) {
+    auto &note = *candidate;
     // Skip rest notes
     if (note.isRest())
       continue;
@@ -1547,11 +1434,28 @@ void PianoRollComponent::updateScrollBars() {
   }
 }
 
+void PianoRollComponent::invalidateBasePitchCache(int startFrame, int endFrame) {
+  if (cacheInvalidated || cachedBasePitch.empty()) {
+    invalidateBasePitchCache();
+    return;
+  }
+
+  if (cacheDirtyEnd > cacheDirtyStart) {
+    cacheDirtyStart = std::min(cacheDirtyStart, startFrame);
+    cacheDirtyEnd = std::max(cacheDirtyEnd, endFrame);
+  } else {
+    cacheDirtyStart = startFrame;
+    cacheDirtyEnd = endFrame;
+  }
+}
+
 void PianoRollComponent::updateBasePitchCacheIfNeeded() {
+  TRACE_SCOPE("base pitch cache");
   if (!project) {
     cachedBasePitch.clear();
     cachedNoteCount = 0;
     cachedTotalFrames = 0;
+    cacheDirtyStart = cacheDirtyEnd = 0;
     return;
   }
 
@@ -1567,44 +1471,63 @@ void PianoRollComponent::updateBasePitchCacheIfNeeded() {
     }
   }
 
-  // Invalidate cache if notes changed or total frames changed or explicitly
-  // invalidated For performance, we only check note count and total frames A
-  // more precise check would compare note positions/pitches, but that's
-  // expensive
-  if (cacheInvalidated || cachedNoteCount != currentNoteCount ||
-      cachedTotalFrames != totalFrames || cachedBasePitch.empty()) {
-    // Only regenerate if we have notes and frames
-    if (currentNoteCount > 0 && totalFrames > 0) {
-      // Collect all notes
-      std::vector<BasePitchCurve::NoteSegment> noteSegments;
-      noteSegments.reserve(currentNoteCount);
-      for (const auto &note : notes) {
-        if (!note.isRest()) {
-          noteSegments.push_back(
-              {note.getStartFrame(), note.getEndFrame(), note.getMidiNote()});
-        }
+  auto collectSegments = [&]() {
+    std::vector<BasePitchCurve::NoteSegment> noteSegments;
+    noteSegments.reserve(currentNoteCount);
+    for (const auto &note : notes) {
+      if (!note.isRest()) {
+        noteSegments.push_back(
+            {note.getStartFrame(), note.getEndFrame(), note.getMidiNote()});
       }
+    }
+    return noteSegments;
+  };
 
-      if (!noteSegments.empty()) {
-        // Generate smoothed base pitch curve (expensive operation, cached)
-        // This is only called when notes change, not on every repaint
-        cachedBasePitch =
-            BasePitchCurve::generateForNotes(noteSegments, totalFrames);
-        cachedNoteCount = currentNoteCount;
-        cachedTotalFrames = totalFrames;
-        cacheInvalidated = false; // Mark cache as valid
-      } else {
-        cachedBasePitch.clear();
-        cachedNoteCount = 0;
-        cachedTotalFrames = 0;
-        cacheInvalidated = false; // Mark as processed (even if empty)
-      }
+  // Same note layout with a known edited range: patch the affected frames
+  // only, so a note edit costs the same regardless of song length
+  if (!cacheInvalidated && cachedNoteCount == currentNoteCount &&
+      cachedTotalFrames == totalFrames && !cachedBasePitch.empty()) {
+    // A patch counts as a hit: only a full regeneration is a miss
+    profiler.recordCacheLookups(PaintProfiler::Cache::BasePitch, 1, 0);
+    if (cacheDirtyEnd > cacheDirtyStart) {
+      BasePitchCurve::regenerateRange(collectSegments(), cacheDirtyStart,
+                                      cacheDirtyEnd, cachedBasePitch);
+      cacheDirtyStart = cacheDirtyEnd = 0;
+    }
+    return;
+  }
+
+  // Otherwise notes changed, total frames changed or the cache was explicitly
+  // invalidated. For performance, we only check note count and total frames;
+  // a more precise check would compare note positions/pitches, but that's
+  // expensive
+  cacheDirtyStart = cacheDirtyEnd = 0;
+  profiler.recordCacheLookups(PaintProfiler::Cache::BasePitch, 0, 1);
+
+  // Only regenerate if we have notes and frames
+  if (currentNoteCount > 0 && totalFrames > 0) {
+    // Collect all notes
+    auto noteSegments = collectSegments();
+
+    if (!noteSegments.empty()) {
+      // Generate smoothed base pitch curve (expensive operation, cached)
+      // This is only called when notes change, not on every repaint
+      cachedBasePitch =
+          BasePitchCurve::generateForNotes(noteSegments, totalFrames);
+      cachedNoteCount = currentNoteCount;
+      cachedTotalFrames = totalFrames;
+      cacheInvalidated = false; // Mark cache as valid
     } else {
       cachedBasePitch.clear();
       cachedNoteCount = 0;
       cachedTotalFrames = 0;
       cacheInvalidated = false; // Mark as processed (even if empty)
     }
+  } else {
+    cachedBasePitch.clear();
+    cachedNoteCount = 0;
+    cachedTotalFrames = 0;
+    cacheInvalidated = false; // Mark as processed (even if empty)
   }
 }
 
@@ -1618,15 +1541,8 @@ void PianoRollComponent::reapplyBasePitchForNote(Note *note) {
   int f0Size = static_cast<int>(audioData.f0.size());
 
   // Reapply base + delta from dense curves
-  for (int i = startFrame; i < endFrame && i < f0Size; ++i) {
-    float base = (i < static_cast<int>(audioData.basePitch.size()))
-                     ? audioData.basePitch[static_cast<size_t>(i)]
-                     : 0.0f;
-    float delta = (i < static_cast<int>(audioData.deltaPitch.size()))
-                      ? audioData.deltaPitch[static_cast<size_t>(i)]
-                      : 0.0f;
-    audioData.f0[i] = midiToFreq(base + delta);
-  }
+  PitchCurveProcessor::composeF0InPlace(*project, startFrame, endFrame,
+                                        /*applyUvMask=*/false);
 
   // Always set F0 dirty range for synthesis (needed for undo/redo to trigger
   // resynthesis)
@@ -1667,22 +1583,6 @@ void PianoRollComponent::commitPitchDrawing() {
     maxFrame = std::max(maxFrame, e.idx);
   }
 
-  // Clear deltaPitch for notes in the edited range so they use the drawn F0
-  // values
-  if (project && minFrame <= maxFrame) {
-    auto &notes = project->getNotes();
-    for (auto &note : notes) {
-      // Check if note overlaps with edited range
-      if (note.getEndFrame() > minFrame && note.getStartFrame() < maxFrame) {
-        // Clear deltaPitch so the note will use audioData.f0 instead of
-        // computed values
-        if (note.hasDeltaPitch()) {
-          note.setDeltaPitch(std::vector<float>());
-        }
-      }
-    }
-  }
-
   // Set F0 dirty range in project for incremental synthesis
   if (project && minFrame <= maxFrame) {
     project->setF0DirtyRange(minFrame, maxFrame);
@@ -1757,16 +1657,6 @@ void PianoRollComponent::applyPitchPoint(int frameIndex, int midiCents) {
         drawingEditIndexByFrame.emplace(idx, drawingEdits.size());
         drawingEdits.push_back(
             F0FrameEdit{idx, oldF0, newFreq, oldDelta, newDelta, oldVoiced, true});
-        // Clear deltaPitch for any note containing this frame so changes are
-        // visible immediately
-        auto &notes = project->getNotes();
-        for (auto &note : notes) {
-          if (note.getStartFrame() <= idx && note.getEndFrame() > idx &&
-              note.hasDeltaPitch()) {
-            note.setDeltaPitch(std::vector<float>());
-            break;
-          }
-        }
       } else {
         auto &e = drawingEdits[it->second];
         e.newF0 = newFreq;
@@ -1808,17 +1698,6 @@ void PianoRollComponent::applyPitchPoint(int frameIndex, int midiCents) {
     if (it == drawingEditIndexByFrame.end()) {
       drawingEditIndexByFrame.emplace(idx, drawingEdits.size());
       drawingEdits.push_back(F0FrameEdit{idx, oldF0, newFreq, oldDelta, newDelta, oldVoiced, true});
-
-      // Clear deltaPitch for any note containing this frame so changes are
-      // visible immediately
-      auto &notes = project->getNotes();
-      for (auto &note : notes) {
-        if (note.getStartFrame() <= idx && note.getEndFrame() > idx &&
-            note.hasDeltaPitch()) {
-          note.setDeltaPitch(std::vector<float>());
-          break;
-        }
-      }
     } else {
       auto &e = drawingEdits[it->second];
       e.newF0 = newFreq;
@@ -11,11 +11,15 @@
 #include "PianoRoll/PitchEditor.h"
 #include "PianoRoll/BoxSelector.h"
 #include "PianoRoll/NoteSplitter.h"
+#include "PianoRoll/PaintProfiler.h"
 
+#include <array>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 
+class AudioCallbackMonitor;
 class PitchUndoManager;
 
 /**
@@ -81,8 +85,18 @@ public:
     // View settings
     void setShowDeltaPitch(bool show) { showDeltaPitch = show; repaint(); }
     void setShowBasePitch(bool show) { showBasePitch = show; repaint(); }
+    void setShowSpectrogram(bool show) { showSpectrogram = show; repaint(); }
     bool getShowDeltaPitch() const { return showDeltaPitch; }
     bool getShowBasePitch() const { return showBasePitch; }
+    bool getShowSpectrogram() const { return showSpectrogram; }
+
+    // Paint profiling overlay (also logs a summary once per second)
+    void setShowPerformanceOverlay(bool show);
+    bool getShowPerformanceOverlay() const { return profiler.isEnabled(); }
+    // Call from the periodic UI timer to measure its jitter
+    void recordTimerTick(double expectedIntervalMs);
+    // Audio callback figures shown with the overlay (may be null)
+    void setAudioCallbackMonitor(const AudioCallbackMonitor* monitor) { callbackMonitor = monitor; }
     
     // Callbacks
     std::function<void(Note*)> onNoteSelected;
@@ -104,6 +118,25 @@ private:
     void drawDrawingCursor(juce::Graphics& g);  // Draw mode indicator
     void drawSelectionRect(juce::Graphics& g);  // Box selection rectangle
 
+    // Static layers (grid, timeline, keys) are drawn into an image once and
+    // blitted until the view state they were drawn for changes
+    using LayerKey = std::array<double, 5>;
+    struct CachedLayer
+    {
+        juce::Image image;
+        LayerKey key {};
+    };
+    void drawCachedLayer(juce::Graphics& g, CachedLayer& layer, const juce::Rectangle<int>& area,
+                         const LayerKey& key, const std::function<void(juce::Graphics&)>& drawLayer);
+    juce::Rectangle<int> getMainArea() const;
+
+    // Drag repaint regions: mark what an edit touches (before and after the
+    // change), then repaint just that on the throttled tick
+    void markWorldAreaDirty(const juce::Rectangle<float>& area);
+    void markFramesDirty(int startFrame, int endFrame);
+    void markNoteDirty(const Note& note);
+    void repaintDirtyArea();
+
     float midiToY(float midiNote) const;
     float yToMidi(float y) const;
     float timeToX(double time) const;
@@ -149,10 +182,11 @@ private:
     // View settings
     bool showDeltaPitch = true;
     bool showBasePitch = false;
+    bool showSpectrogram = false;
     
     // Dragging state
     bool isDragging = false;
-    Note* draggedNote = nullptr;
+    NoteHandle draggedNote;
     float dragStartY = 0.0f;
     float originalPitchOffset = 0.0f;
     float originalMidiNote = 60.0f;  // Original MIDI note before drag
@@ -171,28 +205,29 @@ private:
 
     // Split mode guide line
     float splitGuideX = -1.0f;  // World X coordinate for split guide line (-1 = hidden)
-    Note* splitGuideNote = nullptr;  // Note being hovered for split
+    NoteHandle splitGuideNote;  // Note being hovered for split
 
     // Scrollbars
     juce::ScrollBar horizontalScrollBar { false };
     juce::ScrollBar verticalScrollBar { true };
 
-    // Waveform cache for performance
-    juce::Image waveformCache;
-    double cachedScrollX = -1.0;
-    float cachedPixelsPerSecond = -1.0f;
-    int cachedWidth = 0;
-    int cachedHeight = 0;
-
     // Base pitch curve cache for performance
     // Only recalculates when notes change, not on every repaint
     std::vector<float> cachedBasePitch;
     size_t cachedNoteCount = 0;
     int cachedTotalFrames = 0;
     bool cacheInvalidated = true;  // Start invalidated, force first calculation
+    int cacheDirtyStart = 0;       // Frames to patch when only some notes changed
+    int cacheDirtyEnd = 0;
 
 public:
-    void invalidateBasePitchCache() { cacheInvalidated = true; cachedNoteCount = 0; cachedBasePitch.clear(); }
+    void invalidateBasePitchCache() { cacheInvalidated = true; cachedNoteCount = 0; cachedBasePitch.clear(); cacheDirtyStart = cacheDirtyEnd = 0; }
+    // Notes covering [startFrame, endFrame) changed pitch; patch just that part
+    void invalidateBasePitchCache(int startFrame, int endFrame);
+    // Samples [startSample, startSample + numSamples) were resynthesized
+    void invalidateWaveformRange(int startSample, int numSamples);
+    // Mel frames [startFrame, endFrame) were re-analyzed
+    void invalidateSpectrogramRange(int startFrame, int endFrame);
 
 private:
     // Optional: disable base pitch rendering for performance testing
@@ -201,6 +236,14 @@ private:
     // Mouse drag throttling
     juce::int64 lastDragRepaintTime = 0;
     static constexpr juce::int64 minDragRepaintInterval = 16;  // ~60fps max
+    juce::Rectangle<int> dirtyArea;  // Accumulated between throttled repaints
+
+    PaintProfiler profiler;
+    const AudioCallbackMonitor* callbackMonitor = nullptr;
+
+    CachedLayer gridLayer;
+    CachedLayer timelineLayer;
+    CachedLayer keysLayer;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoRollComponent)
 };
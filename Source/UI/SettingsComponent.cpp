@@ -71,6 +71,17 @@ SettingsComponent::SettingsComponent(juce::AudioDeviceManager* audioDeviceManage
     pitchDetectorComboBox.addListener(this);
     addAndMakeVisible(pitchDetectorComboBox);
 
+    // Mel spectrogram storage (half precision for long sessions)
+    melStorageLabel.setText(TR("settings.mel_storage"), juce::dontSendNotification);
+    melStorageLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(melStorageLabel);
+
+    melStorageComboBox.addItem(TR("settings.mel_storage_full"), 1);
+    melStorageComboBox.addItem(TR("settings.mel_storage_half"), 2);
+    melStorageComboBox.setSelectedId(1, juce::dontSendNotification);
+    melStorageComboBox.addListener(this);
+    addAndMakeVisible(melStorageComboBox);
+
     // Info label
     infoLabel.setColour(juce::Label::textColourId, juce::Colour(0xFF888888));
     infoLabel.setFont(juce::Font(12.0f));
@@ -130,9 +141,9 @@ SettingsComponent::SettingsComponent(juce::AudioDeviceManager* audioDeviceManage
 
     // Set size based on mode
     if (pluginMode)
-        setSize(400, 260);
+        setSize(400, 300);
     else
-        setSize(400, 560);
+        setSize(400, 600);
 }
 
 SettingsComponent::~SettingsComponent()
@@ -178,6 +189,12 @@ void SettingsComponent::resized()
     pitchDetectorComboBox.setBounds(pitchDetectorRow.reduced(0, 2));
     bounds.removeFromTop(10);
 
+    // Mel storage row
+    auto melStorageRow = bounds.removeFromTop(30);
+    melStorageLabel.setBounds(melStorageRow.removeFromLeft(120));
+    melStorageComboBox.setBounds(melStorageRow.reduced(0, 2));
+    bounds.removeFromTop(10);
+
     bounds.removeFromTop(5);
 
     // Info label
@@ -310,6 +327,13 @@ void SettingsComponent::comboBoxChanged(juce::ComboBox* comboBox)
         if (onPitchDetectorChanged)
             onPitchDetectorChanged(pitchDetectorType);
     }
+    else if (comboBox == &melStorageComboBox)
+    {
+        melStorage = melStorageComboBox.getSelectedId() == 2 ? MelStorage::Float16 : MelStorage::Float32;
+        saveSettings();
+        if (onSettingsChanged)
+            onSettingsChanged();
+    }
     else if (comboBox == &audioDeviceTypeComboBox)
     {
         auto& types = deviceManager->getAvailableDeviceTypes();
@@ -644,6 +668,8 @@ void SettingsComponent::loadSettings()
             juce::String pitchDetectorStr = xml->getStringAttribute("pitchDetector", "RMVPE");
             pitchDetectorType = stringToPitchDetectorType(pitchDetectorStr);
 
+            melStorage = stringToMelStorage(xml->getStringAttribute("melStorage", "float32").toStdString());
+
             // Load language
             juce::String langCode = xml->getStringAttribute("language", "auto");
             if (langCode == "auto")
@@ -701,6 +727,8 @@ void SettingsComponent::loadSettings()
         pitchDetectorComboBox.setSelectedId(1, juce::dontSendNotification);
     else if (pitchDetectorType == PitchDetectorType::FCPE)
         pitchDetectorComboBox.setSelectedId(2, juce::dontSendNotification);
+
+    melStorageComboBox.setSelectedId(melStorage == MelStorage::Float16 ? 2 : 1, juce::dontSendNotification);
 }
 
 void SettingsComponent::saveSettings()
@@ -719,6 +747,7 @@ void SettingsComponent::saveSettings()
     xml.setAttribute("device", currentDevice);
     xml.setAttribute("gpuDeviceId", gpuDeviceId);
     xml.setAttribute("pitchDetector", pitchDetectorTypeToString(pitchDetectorType));
+    xml.setAttribute("melStorage", melStorageToString(melStorage));
 
     // Save language code
     int langId = languageComboBox.getSelectedId();
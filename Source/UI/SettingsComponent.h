@@ -3,6 +3,7 @@
 #include "../JuceHeader.h"
 #include "../Utils/Constants.h"
 #include "../Audio/PitchDetectorType.h"
+#include "../Models/FrameBuffers.h"
 #include "StyledComponents.h"
 #include <functional>
 
@@ -29,6 +30,7 @@ public:
     juce::String getSelectedDevice() const { return currentDevice; }
     int getGPUDeviceId() const { return gpuDeviceId; }
     PitchDetectorType getPitchDetectorType() const { return pitchDetectorType; }
+    MelStorage getMelStorage() const { return melStorage; }
 
     // Plugin mode (disables audio device settings)
     bool isPluginMode() const { return pluginMode; }
@@ -70,6 +72,9 @@ private:
     juce::Label pitchDetectorLabel;
     StyledComboBox pitchDetectorComboBox;
 
+    juce::Label melStorageLabel;
+    StyledComboBox melStorageComboBox;
+
     juce::Label infoLabel;
 
     // Audio device settings (standalone mode only)
@@ -88,6 +93,7 @@ private:
     juce::String currentDevice = "CPU";
     int gpuDeviceId = 0;
     PitchDetectorType pitchDetectorType = PitchDetectorType::RMVPE;
+    MelStorage melStorage = MelStorage::Float32;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsComponent)
 };
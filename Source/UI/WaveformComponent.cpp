@@ -1,5 +1,6 @@
 #include "WaveformComponent.h"
 #include "../Utils/Constants.h"
+#include "../Utils/Tracer.h"
 
 WaveformComponent::WaveformComponent()
 {
@@ -14,6 +15,7 @@ WaveformComponent::~WaveformComponent()
 
 void WaveformComponent::paint(juce::Graphics& g)
 {
+    TRACE_SCOPE("waveform paint");
     // Background
     g.fillAll(juce::Colour(0xFF16161E));
     
@@ -42,7 +44,6 @@ void WaveformComponent::drawWaveform(juce::Graphics& g)
     float centerY = static_cast<float>(bounds.getCentreY());
     float amplitude = bounds.getHeight() * 0.4f;
     
-    const float* samples = audioData.waveform.getReadPointer(0);
     int numSamples = audioData.waveform.getNumSamples();
     
     // Calculate visible range
@@ -54,9 +55,6 @@ void WaveformComponent::drawWaveform(juce::Graphics& g)
     
     if (startSample >= endSample) return;
     
-    // Samples per pixel
-    juce::ignoreUnused(startSample, endSample);
-    
     g.setColour(juce::Colour(COLOR_WAVEFORM));
     
     for (int x = 0; x < bounds.getWidth(); ++x)
@@ -65,19 +63,12 @@ void WaveformComponent::drawWaveform(juce::Graphics& g)
         int sampleStart = static_cast<int>(time * SAMPLE_RATE);
         int sampleEnd = static_cast<int>((time + 1.0 / pixelsPerSecond) * SAMPLE_RATE);
         
-        sampleStart = juce::jmax(0, sampleStart);
-        sampleEnd = juce::jmin(numSamples - 1, sampleEnd);
-        
         if (sampleStart >= numSamples || sampleEnd < 0) continue;
         
-        // Find min/max in this range
-        float minVal = 0.0f, maxVal = 0.0f;
-        for (int i = sampleStart; i <= sampleEnd; ++i)
-        {
-            float s = samples[i];
-            if (s < minVal) minVal = s;
-            if (s > maxVal) maxVal = s;
-        }
+        // Find min/max in this range (peak pyramid, end inclusive)
+        auto peak = audioData.getWaveformPeak(sampleStart, sampleEnd + 1);
+        float minVal = juce::jmin(0.0f, peak.min);
+        float maxVal = juce::jmax(0.0f, peak.max);
         
         float yMin = centerY - maxVal * amplitude;
         float yMax = centerY - minVal * amplitude;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * std::allocator replacement returning Alignment-byte aligned storage, so
+ * frame rows start on a cache line and SIMD loops can use aligned loads.
+ *
+ * Over-allocates from malloc and keeps the original pointer just before the
+ * aligned block (no dependency on C++17 aligned operator new, which older
+ * macOS deployment targets lack).
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator
+{
+    static_assert(Alignment >= sizeof(void*) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two and hold a pointer");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t count)
+    {
+        void* raw = std::malloc(count * sizeof(T) + Alignment);
+        if (raw == nullptr)
+            throw std::bad_alloc();
+
+        const auto aligned = (reinterpret_cast<std::uintptr_t>(raw) + Alignment) & ~(Alignment - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept
+    {
+        if (ptr != nullptr)
+            std::free(reinterpret_cast<void**>(ptr)[-1]);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "AsyncLogger.h"
 
 /**
- * Simple file logger for debugging.
+ * App log, written asynchronously by AsyncLogger.
  * Logs to %APPDATA%/HachiTune/debug.log
  */
 class AppLogger
@@ -11,24 +12,18 @@ class AppLogger
 public:
     static void log(const juce::String& message)
     {
-        auto logFile = getLogFile();
-        auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-        logFile.appendText("[" + timestamp + "] " + message + "\n");
-        DBG(message);
+        AsyncLogger::getInstance().write(AsyncLogger::Channel::App, AsyncLogger::Level::Info, message);
     }
 
     static void clear()
     {
-        auto logFile = getLogFile();
-        logFile.deleteFile();
+        // The writer reopens the file on its next write
+        getLogFile().deleteFile();
     }
 
     static juce::File getLogFile()
     {
-        auto dir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-                       .getChildFile("HachiTune");
-        dir.createDirectory();
-        return dir.getChildFile("debug.log");
+        return AsyncLogger::getLogFile(AsyncLogger::Channel::App);
     }
 };
 
@@ -0,0 +1,255 @@
+#include "AsyncLogger.h"
+#include "PlatformPaths.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace
+{
+    constexpr std::uint64_t queueMask = AsyncLogger::queueCapacity - 1;
+    static_assert((AsyncLogger::queueCapacity & queueMask) == 0, "queueCapacity must be a power of two");
+
+    // Idle writer wake-up interval
+    constexpr auto writerInterval = std::chrono::milliseconds(20);
+
+    const char* getLevelName(AsyncLogger::Level level)
+    {
+        switch (level)
+        {
+            case AsyncLogger::Level::Debug:   return "DEBUG";
+            case AsyncLogger::Level::Info:    return "INFO ";
+            case AsyncLogger::Level::Warning: return "WARN ";
+            case AsyncLogger::Level::Error:   return "ERROR";
+            default:                          return "";
+        }
+    }
+
+    // Cut at most maxBytes without splitting a UTF-8 sequence
+    size_t truncateUtf8(const char* text, size_t numBytes, size_t maxBytes)
+    {
+        if (numBytes <= maxBytes)
+            return numBytes;
+
+        size_t length = maxBytes;
+        while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80)
+            --length;
+        return length;
+    }
+
+    void appendTimestamp(std::string& out, std::int64_t timeMicros)
+    {
+        const auto time = static_cast<std::time_t>(timeMicros / 1000000);
+        std::tm tm_buf;
+#ifdef _WIN32
+        localtime_s(&tm_buf, &time);
+#else
+        localtime_r(&time, &tm_buf);
+#endif
+        char buffer[32];
+        const auto length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        out.append(buffer, length);
+
+        std::snprintf(buffer, sizeof(buffer), ".%03d", static_cast<int>((timeMicros / 1000) % 1000));
+        out += buffer;
+    }
+}
+
+/** One log file, owned by the writer thread. */
+struct AsyncLogger::Sink
+{
+    juce::File file;
+    std::ofstream stream;
+    std::int64_t size = 0;
+    std::string pending;
+
+    void open()
+    {
+        file.getParentDirectory().createDirectory();
+#if JUCE_WINDOWS
+        stream.open(file.getFullPathName().toWideCharPointer(), std::ios::app | std::ios::binary);
+#else
+        stream.open(file.getFullPathName().toStdString(), std::ios::app | std::ios::binary);
+#endif
+        size = file.getSize();
+    }
+
+    void rotate()
+    {
+        stream.close();
+        for (int i = numBackupFiles - 1; i >= 1; --i)
+        {
+            auto older = file.getSiblingFile(file.getFileName() + "." + juce::String(i));
+            if (older.existsAsFile())
+                older.moveFileTo(file.getSiblingFile(file.getFileName() + "." + juce::String(i + 1)));
+        }
+        file.moveFileTo(file.getSiblingFile(file.getFileName() + ".1"));
+        open();
+    }
+
+    void flushPending()
+    {
+        if (pending.empty())
+            return;
+
+        // Reopen if the file was deleted or never opened
+        if (!stream.is_open() || !file.existsAsFile())
+        {
+            stream.close();
+            open();
+        }
+
+        stream.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+        stream.flush();
+        size += static_cast<std::int64_t>(pending.size());
+        pending.clear();
+
+        if (size > maxFileBytes)
+            rotate();
+    }
+};
+
+AsyncLogger& AsyncLogger::getInstance()
+{
+    static AsyncLogger instance;
+    return instance;
+}
+
+juce::File AsyncLogger::getLogFile(Channel channel)
+{
+    switch (channel)
+    {
+        case Channel::Vocoder:  return PlatformPaths::getLogsDirectory().getChildFile("vocoder_log.txt");
+        case Channel::Analysis: return PlatformPaths::getLogsDirectory().getChildFile("analysis_log.txt");
+        case Channel::App:
+        default:                return PlatformPaths::getConfigDirectory().getChildFile("debug.log");
+    }
+}
+
+AsyncLogger::AsyncLogger()
+    : slots(new Slot[queueCapacity]),
+#if JUCE_DEBUG
+      minimumLevel(static_cast<int>(Level::Debug)),
+#else
+      minimumLevel(static_cast<int>(Level::Info)),
+#endif
+      sinks(new Sink[static_cast<size_t>(Channel::Count)])
+{
+    for (std::uint64_t i = 0; i < static_cast<std::uint64_t>(queueCapacity); ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    for (int i = 0; i < static_cast<int>(Channel::Count); ++i)
+        sinks[i].file = getLogFile(static_cast<Channel>(i));
+
+    writer = std::thread([this] { writerLoop(); });
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stopRequested = true;
+    wakeCondition.notify_one();
+    if (writer.joinable())
+        writer.join();
+}
+
+void AsyncLogger::write(Channel channel, Level level, const char* text, size_t numBytes)
+{
+    if (!isEnabled(level))
+        return;
+
+    // Bounded MPMC queue (Vyukov) used with a single consumer: a slot is free
+    // for position p when its sequence equals p, and readable at p + 1.
+    auto position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;)
+    {
+        slot = &slots[position & queueMask];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::int64_t>(sequence - position);
+        if (difference == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // Full: the writer is behind, never wait for it
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->channel = channel;
+    slot->level = level;
+    slot->timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+    slot->numBytes = static_cast<std::uint32_t>(truncateUtf8(text, numBytes, maxMessageBytes));
+    std::memcpy(slot->text, text, slot->numBytes);
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Errors go out at once; bursts wake the writer before the queue fills
+    if (level == Level::Error || (position & (queueCapacity / 2 - 1)) == 0)
+        wakeCondition.notify_one();
+}
+
+bool AsyncLogger::drain()
+{
+    bool wroteAny = false;
+    for (int count = 0; count < queueCapacity; ++count)
+    {
+        auto& slot = slots[dequeuePosition & queueMask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+            break;
+
+        auto& sink = sinks[static_cast<size_t>(slot.channel)];
+        appendTimestamp(sink.pending, slot.timeMicros);
+        sink.pending += " [";
+        sink.pending += getLevelName(slot.level);
+        sink.pending += "] ";
+        sink.pending.append(slot.text, slot.numBytes);
+        sink.pending += '\n';
+
+#if JUCE_DEBUG
+        juce::Logger::outputDebugString(juce::String::fromUTF8(slot.text, static_cast<int>(slot.numBytes)));
+#endif
+
+        slot.sequence.store(dequeuePosition + queueCapacity, std::memory_order_release);
+        ++dequeuePosition;
+        wroteAny = true;
+    }
+
+    if (const auto numDropped = dropped.exchange(0, std::memory_order_relaxed))
+    {
+        auto& sink = sinks[static_cast<size_t>(Channel::App)];
+        appendTimestamp(sink.pending, std::chrono::duration_cast<std::chrono::microseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch()).count());
+        sink.pending += " [WARN ] " + std::to_string(numDropped) + " log messages dropped (queue full)\n";
+        wroteAny = true;
+    }
+
+    if (wroteAny)
+        for (int i = 0; i < static_cast<int>(Channel::Count); ++i)
+            sinks[i].flushPending();
+
+    return wroteAny;
+}
+
+void AsyncLogger::writerLoop()
+{
+    while (!stopRequested.load())
+    {
+        if (!drain())
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, writerInterval);
+        }
+    }
+
+    // Everything queued before shutdown still reaches the files
+    drain();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Process-wide logger that never blocks the caller on disk.
+ *
+ * Messages are copied into a bounded lock-free multi-producer queue together
+ * with a timestamp; a background thread formats them, appends them to one
+ * file per channel and rotates a file once it grows past maxFileBytes. A
+ * call costs a clock read and a copy of the text. When the queue is full the
+ * message is dropped and counted instead of waiting, and the writer notes
+ * the number of drops in the app log.
+ *
+ * Writes below the minimum level are filtered before any formatting when
+ * going through the LOG_AT macro.
+ */
+class AsyncLogger
+{
+public:
+    enum class Level
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    enum class Channel
+    {
+        App,       // debug.log
+        Vocoder,   // vocoder_log.txt
+        Analysis,  // analysis_log.txt (pitch and note detectors)
+        Count
+    };
+
+    static constexpr int queueCapacity = 2048;       // Power of two
+    static constexpr int maxMessageBytes = 480;      // Longer messages are truncated
+    static constexpr std::int64_t maxFileBytes = 4 * 1024 * 1024;
+    static constexpr int numBackupFiles = 3;         // name.1 .. name.3
+
+    static AsyncLogger& getInstance();
+
+    bool isEnabled(Level level) const
+    {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    void setMinimumLevel(Level level) { minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+    /** Queue a message; returns immediately. Thread safe. */
+    void write(Channel channel, Level level, const char* text, size_t numBytes);
+    void write(Channel channel, Level level, const std::string& text) { write(channel, level, text.data(), text.size()); }
+    void write(Channel channel, Level level, const juce::String& text)
+    {
+        write(channel, level, text.toRawUTF8(), text.getNumBytesAsUTF8());
+    }
+
+    static juce::File getLogFile(Channel channel);
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{0};
+        Channel channel = Channel::App;
+        Level level = Level::Info;
+        std::int64_t timeMicros = 0;  // Since the epoch
+        std::uint32_t numBytes = 0;
+        char text[maxMessageBytes];
+    };
+
+    struct Sink;
+
+    AsyncLogger();
+    ~AsyncLogger();
+
+    bool drain();
+    void writerLoop();
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::uint64_t> enqueuePosition{0};
+    std::uint64_t dequeuePosition = 0;  // Writer thread only
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<int> minimumLevel;
+
+    std::unique_ptr<Sink[]> sinks;  // Writer thread only
+
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> stopRequested{false};
+
+    JUCE_DECLARE_NON_COPYABLE(AsyncLogger)
+};
+
+/**
+ * Log to a channel at a level, e.g. LOG_AT(Warning, Analysis, "Failed: " << e.what()).
+ * The message expression is only evaluated if the level passes the filter.
+ */
+#define LOG_AT(levelName, channelName, textToWrite)                                              \
+    do                                                                                           \
+    {                                                                                            \
+        auto& asyncLogger_ = AsyncLogger::getInstance();                                         \
+        if (asyncLogger_.isEnabled(AsyncLogger::Level::levelName))                               \
+        {                                                                                        \
+            juce::String asyncLogText_;                                                          \
+            asyncLogText_ << textToWrite;                                                        \
+            asyncLogger_.write(AsyncLogger::Channel::channelName, AsyncLogger::Level::levelName, \
+                               asyncLogText_);                                                   \
+        }                                                                                        \
+    } while (false)
@@ -1,5 +1,8 @@
 #include "BasePitchCurve.h"
+#include "Tracer.h"
 #include <algorithm>
+#include <iterator>
+#include <limits>
 
 // Local constants (to avoid JUCE dependency from Constants.h)
 namespace {
@@ -16,6 +19,17 @@ namespace {
         if (freq <= 0.0f) return 0.0f;
         return 12.0f * std::log2(freq / FREQ_A4) + MIDI_A4;
     }
+
+    bool isSortedByStart(const std::vector<BasePitchCurve::NoteSegment>& notes) {
+        return std::is_sorted(notes.begin(), notes.end(),
+                              [](const auto& a, const auto& b) { return a.startFrame < b.startFrame; });
+    }
+
+    std::vector<BasePitchCurve::NoteSegment> sortedByStart(std::vector<BasePitchCurve::NoteSegment> notes) {
+        std::stable_sort(notes.begin(), notes.end(),
+                         [](const auto& a, const auto& b) { return a.startFrame < b.startFrame; });
+        return notes;
+    }
 }
 
 std::vector<double> BasePitchCurve::createCosineKernel()
@@ -45,87 +59,172 @@ std::vector<float> BasePitchCurve::generateForNote(int startFrame, int endFrame,
 
 std::vector<float> BasePitchCurve::generateForNotes(const std::vector<NoteSegment>& notes, int totalFrames)
 {
+    TRACE_SCOPE("base pitch");
     if (notes.empty() || totalFrames <= 0)
         return {};
 
-    // Convert frames to milliseconds (at ~86 fps, each frame is ~11.6ms)
-    // We'll work at 1ms resolution for smoothing, then resample
-    double msPerFrame = 1000.0 * HOP_SIZE / SAMPLE_RATE;  // ~11.6ms
-
-    // Calculate total duration in seconds, add padding for convolution kernel
-    double lastNoteEndSec = notes.back().endFrame * msPerFrame / 1000.0;
-    int totalMs = static_cast<int>(std::round(1000.0 * (lastNoteEndSec + SMOOTH_WINDOW))) + 1;
-
-    // Create initial step function values at 1ms resolution
-    // This matches ds-editor-lite's BasePitchCurve::Convolve algorithm
-    std::vector<double> initValues(totalMs, 0.0);
-    
-    // Convert note segments from frames to seconds for step function
-    struct NoteInSeconds {
-        double start;
-        double end;
-        float midiNote;
-    };
-    std::vector<NoteInSeconds> noteArray;
-    for (const auto& note : notes)
+    if (!isSortedByStart(notes))
+        return generateForNotes(sortedByStart(notes), totalFrames);
+
+    std::vector<float> result(static_cast<size_t>(totalFrames));
+    renderFrames(notes, 0, totalFrames, result.data());
+    return result;
+}
+
+std::pair<int, int> BasePitchCurve::getAffectedRange(const std::vector<NoteSegment>& notes,
+                                                     int changedStartFrame, int changedEndFrame,
+                                                     int totalFrames)
+{
+    if (totalFrames <= 0)
+        return {0, 0};
+
+    auto byStart = [](const NoteSegment& note, int frame) { return note.startFrame < frame; };
+
+    // Notes before 'first' start before the edit; 'next' is the first note after it
+    const auto first = std::lower_bound(notes.begin(), notes.end(), changedStartFrame, byStart);
+    const auto next = std::lower_bound(first, notes.end(), changedEndFrame, byStart);
+
+    // The step function switches notes at the midpoint of each gap, so the
+    // edit can reach halfway into the gaps on either side (or to the ends of
+    // the curve when there is no neighbour).
+    int startFrame = 0;
+    if (first != notes.begin())
     {
-        double startSec = note.startFrame * msPerFrame / 1000.0;
-        double endSec = note.endFrame * msPerFrame / 1000.0;
-        noteArray.push_back({startSec, endSec, note.midiNote});
+        const int prevEnd = std::prev(first)->endFrame;
+        startFrame = std::min(changedStartFrame, (prevEnd + changedStartFrame) / 2);
     }
-    
-    if (noteArray.empty())
-        return {};
-    
-    // Create step function: each millisecond gets the semitone value of its note
-    // At note boundaries, switch at the midpoint (matching ds-editor-lite)
-    int noteIndex = 0;
-    for (int i = 0; i < totalMs; ++i)
+
+    int endFrame = totalFrames;
+    if (next != notes.end())
+    {
+        int changedEnd = changedEndFrame;
+        for (auto it = first; it != next; ++it)
+            changedEnd = std::max(changedEnd, it->endFrame);
+        endFrame = std::max(changedEndFrame, (changedEnd + next->startFrame + 1) / 2 + 1);
+    }
+
+    const double msPerFrame = 1000.0 * HOP_SIZE / SAMPLE_RATE;
+    const int reachFrames = static_cast<int>(std::ceil((KERNEL_SIZE / 2 + 2) / msPerFrame)) + 1;
+
+    startFrame = std::clamp(startFrame - reachFrames, 0, totalFrames);
+    endFrame = std::clamp(endFrame + reachFrames, startFrame, totalFrames);
+    return {startFrame, endFrame};
+}
+
+std::pair<int, int> BasePitchCurve::regenerateRange(const std::vector<NoteSegment>& notes,
+                                                    int changedStartFrame, int changedEndFrame,
+                                                    std::vector<float>& basePitch)
+{
+    TRACE_SCOPE("base pitch range");
+    if (notes.empty() || basePitch.empty())
+        return {0, 0};
+
+    if (!isSortedByStart(notes))
+        return regenerateRange(sortedByStart(notes), changedStartFrame, changedEndFrame, basePitch);
+
+    const auto range = getAffectedRange(notes, changedStartFrame, changedEndFrame,
+                                        static_cast<int>(basePitch.size()));
+    if (range.second > range.first)
+        renderFrames(notes, range.first, range.second, basePitch.data() + range.first);
+    return range;
+}
+
+const std::vector<double>& BasePitchCurve::getKernelPrefixSums()
+{
+    static const std::vector<double> prefix = []
+    {
+        const auto kernel = createCosineKernel();
+        std::vector<double> sums(kernel.size() + 1, 0.0);
+        for (size_t i = 0; i < kernel.size(); ++i)
+            sums[i + 1] = sums[i] + kernel[i];
+        return sums;
+    }();
+    return prefix;
+}
+
+void BasePitchCurve::renderFrames(const std::vector<NoteSegment>& notes,
+                                  int startFrame, int endFrame, float* out)
+{
+    if (notes.empty() || endFrame <= startFrame)
+        return;
+
+    // Work at 1ms resolution (each frame is ~11.6ms), then resample to frames
+    const double msPerFrame = 1000.0 * HOP_SIZE / SAMPLE_RATE;
+    constexpr int halfKernel = KERNEL_SIZE / 2;
+    const auto& prefix = getKernelPrefixSums();
+
+    // Only notes that can appear under the kernel for this frame range matter.
+    // Starting one note early guarantees the first local note is already
+    // active at the left edge of the window.
+    const int windowStartMs = static_cast<int>(startFrame * msPerFrame) - halfKernel;
+    const int windowEndMs = static_cast<int>((endFrame - 1) * msPerFrame) + 1 + halfKernel;
+    const int loFrame = static_cast<int>(std::floor(windowStartMs / msPerFrame)) - 1;
+    const int hiFrame = static_cast<int>(std::ceil(windowEndMs / msPerFrame)) + 1;
+
+    auto startsBefore = [](int frame, const NoteSegment& note) { return frame < note.startFrame; };
+    const int numNotes = static_cast<int>(notes.size());
+    const int firstNote = std::max(0, static_cast<int>(std::upper_bound(notes.begin(), notes.end(), loFrame, startsBefore)
+                                                       - notes.begin()) - 2);
+    const int lastNote = std::min(numNotes, static_cast<int>(std::upper_bound(notes.begin(), notes.end(), hiFrame, startsBefore)
+                                                             - notes.begin()) + 1);
+
+    // Step function: segment k holds notes[firstNote + k] from switchMs[k] on.
+    // A note takes over 1ms after time passes the midpoint between the
+    // previous note's end and its start (matches ds-editor-lite). Before the
+    // first note the curve holds the first note's value, and after the last
+    // note it holds the last one, which is what the clamped convolution of
+    // the original algorithm produces at both ends.
+    std::vector<int> switchMs;
+    std::vector<double> values;
+    switchMs.reserve(static_cast<size_t>(lastNote - firstNote));
+    values.reserve(static_cast<size_t>(lastNote - firstNote));
+    for (int k = firstNote; k < lastNote; ++k)
     {
-        const double time = 0.001 * i;  // Time in seconds
-        
-        // Assign current note's semitone value
-        initValues[i] = noteArray[noteIndex].midiNote;
-        
-        // Check if we should advance to next note at midpoint
-        // Switch at: 0.5 * (current_note_end + next_note_start)
-        if (noteIndex < static_cast<int>(noteArray.size()) - 1 &&
-            time > 0.5 * (noteArray[noteIndex].end + noteArray[noteIndex + 1].start))
+        int switchAt = std::numeric_limits<int>::min();
+        if (k > firstNote)
         {
-            noteIndex++;
+            // Same comparison as the per-millisecond scan: the next note starts
+            // one step after the first time (in seconds) past the midpoint
+            const double midpoint = 0.5 * (notes[k - 1].endFrame * msPerFrame / 1000.0
+                                           + notes[k].startFrame * msPerFrame / 1000.0);
+            int passed = static_cast<int>(std::floor(1000.0 * midpoint)) - 1;
+            while (!(0.001 * passed > midpoint))
+                ++passed;
+            switchAt = std::max(switchMs.back(), passed + 1);
         }
+        switchMs.push_back(switchAt);
+        values.push_back(notes[k].midiNote);
     }
 
-    // Apply cosine kernel convolution
-    auto kernel = createCosineKernel();
-    std::vector<double> smoothedMs(totalMs, 0.0);
+    const int numSegments = static_cast<int>(switchMs.size());
 
-    for (int i = 0; i < totalMs; ++i)
+    // Convolution at one millisecond: each constant segment under the kernel
+    // contributes value * (sum of the kernel taps it covers).
+    auto smoothedAt = [&](int ms)
     {
-        for (int j = 0; j < KERNEL_SIZE; ++j)
+        const int lo = ms - halfKernel;
+        const int hi = ms + halfKernel;
+        int k = static_cast<int>(std::upper_bound(switchMs.begin(), switchMs.end(), lo) - switchMs.begin()) - 1;
+
+        double sum = 0.0;
+        for (; k < numSegments && switchMs[k] <= hi; ++k)
         {
-            int srcIdx = std::clamp(i - KERNEL_SIZE / 2 + j, 0, totalMs - 1);
-            smoothedMs[i] += initValues[srcIdx] * kernel[j];
+            const int segStart = std::max(switchMs[k], lo);
+            const int segEnd = (k + 1 < numSegments) ? std::min(switchMs[k + 1] - 1, hi) : hi;
+            if (segEnd >= segStart)
+                sum += values[k] * (prefix[segEnd - lo + 1] - prefix[segStart - lo]);
         }
-    }
+        return sum;
+    };
 
-    // Resample back to frame resolution
-    std::vector<float> result(totalFrames);
-    for (int frame = 0; frame < totalFrames; ++frame)
+    for (int frame = startFrame; frame < endFrame; ++frame)
     {
-        double ms = frame * msPerFrame;
-        int msIdx = static_cast<int>(ms);
-        double frac = ms - msIdx;
-
-        if (msIdx + 1 < totalMs)
-            result[frame] = static_cast<float>(smoothedMs[msIdx] * (1.0 - frac) + smoothedMs[msIdx + 1] * frac);
-        else if (msIdx < totalMs)
-            result[frame] = static_cast<float>(smoothedMs[msIdx]);
-        else
-            result[frame] = static_cast<float>(smoothedMs.back());
+        const double ms = frame * msPerFrame;
+        const int msIdx = static_cast<int>(ms);
+        const double frac = ms - msIdx;
+        out[frame - startFrame] = static_cast<float>(smoothedAt(msIdx) * (1.0 - frac)
+                                                     + smoothedAt(msIdx + 1) * frac);
     }
-
-    return result;
 }
 
 std::vector<float> BasePitchCurve::calculateDeltaPitch(const std::vector<float>& f0Values,
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cmath>
+#include <utility>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -16,8 +17,14 @@
  * The algorithm:
  * 1. Creates a step function where each note has a constant semitone value
  * 2. At note boundaries, switches at the midpoint between notes
- * 3. Applies cosine-windowed convolution (119-point kernel, ±59ms, 0.12s window)
+ * 3. Applies cosine-windowed convolution (241-point kernel, ±120ms, 0.24s window)
  * 4. Results in a smooth base pitch curve that preserves note transitions
+ *
+ * The step function is piecewise constant, so the convolution is evaluated
+ * per output frame from prefix sums of the kernel (one term per note under
+ * the kernel) instead of 241 taps per millisecond. A value only depends on
+ * notes within ±120ms, which lets regenerateRange() patch an existing curve
+ * after an edit at a cost independent of the song length.
  */
 class BasePitchCurve
 {
@@ -35,6 +42,22 @@ public:
     // Generate smoothed base pitch for multiple notes
     static std::vector<float> generateForNotes(const std::vector<NoteSegment>& notes, int totalFrames);
 
+    // Frames whose base pitch can change when the notes covering
+    // [changedStartFrame, changedEndFrame) are edited: the span up to the
+    // midpoints with the neighbouring notes, widened by the kernel reach.
+    // For moved notes pass a range covering both the old and new extents.
+    static std::pair<int, int> getAffectedRange(const std::vector<NoteSegment>& notes,
+                                                int changedStartFrame, int changedEndFrame,
+                                                int totalFrames);
+
+    // Recompute basePitch in place for the frames affected by an edit of
+    // [changedStartFrame, changedEndFrame); everything else is left untouched.
+    // basePitch must already hold a curve generated for the same note layout
+    // outside that range. Returns the frame range that was rewritten.
+    static std::pair<int, int> regenerateRange(const std::vector<NoteSegment>& notes,
+                                               int changedStartFrame, int changedEndFrame,
+                                               std::vector<float>& basePitch);
+
     // Calculate delta pitch (actual F0 in MIDI - base pitch)
     static std::vector<float> calculateDeltaPitch(const std::vector<float>& f0Values,
                                                    const std::vector<float>& basePitch,
@@ -51,4 +74,12 @@ private:
     static constexpr double SMOOTH_WINDOW = 0.24;  // 240ms total window for smoother transitions
 
     static std::vector<double> createCosineKernel();
+
+    // Cumulative sums of the normalized kernel (KERNEL_SIZE + 1 entries)
+    static const std::vector<double>& getKernelPrefixSums();
+
+    // Evaluate the smoothed curve for frames [startFrame, endFrame) into out.
+    // notes must be sorted by startFrame.
+    static void renderFrames(const std::vector<NoteSegment>& notes,
+                             int startFrame, int endFrame, float* out);
 };
@@ -56,7 +56,7 @@ std::vector<float> F0Smoother::medianFilter(const std::vector<float>& f0, int wi
 }
 
 std::vector<float> F0Smoother::smoothTransitions(const std::vector<float>& f0,
-                                                  const std::vector<bool>& voicedMask,
+                                                  const VoicedMask& voicedMask,
                                                   int windowSize)
 {
     if (f0.empty() || f0.size() != voicedMask.size())
@@ -107,7 +107,7 @@ std::vector<float> F0Smoother::smoothTransitions(const std::vector<float>& f0,
 }
 
 std::vector<float> F0Smoother::interpolateUnvoiced(const std::vector<float>& f0,
-                                                     const std::vector<bool>& voicedMask,
+                                                     const VoicedMask& voicedMask,
                                                      int maxGapFrames)
 {
     if (f0.empty() || f0.size() != voicedMask.size())
@@ -211,7 +211,7 @@ std::vector<float> F0Smoother::removeOutliers(const std::vector<float>& f0,
 }
 
 std::vector<float> F0Smoother::smoothF0(const std::vector<float>& f0,
-                                         const std::vector<bool>& voicedMask)
+                                         const VoicedMask& voicedMask)
 {
     if (f0.empty())
         return f0;
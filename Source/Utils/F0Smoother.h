@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Models/FrameBuffers.h"
 #include <vector>
 
 /**
@@ -26,7 +27,7 @@ public:
      * @return Smoothed F0 values
      */
     static std::vector<float> smoothTransitions(const std::vector<float>& f0,
-                                                 const std::vector<bool>& voicedMask,
+                                                 const VoicedMask& voicedMask,
                                                  int windowSize = 3);
     
     /**
@@ -38,7 +39,7 @@ public:
      * @return Interpolated F0 values
      */
     static std::vector<float> interpolateUnvoiced(const std::vector<float>& f0,
-                                                    const std::vector<bool>& voicedMask,
+                                                    const VoicedMask& voicedMask,
                                                     int maxGapFrames = 5);
     
     /**
@@ -57,7 +58,7 @@ public:
      * @return Fully smoothed F0 values
      */
     static std::vector<float> smoothF0(const std::vector<float>& f0,
-                                        const std::vector<bool>& voicedMask);
+                                        const VoicedMask& voicedMask);
     
 private:
     /**
@@ -0,0 +1,299 @@
+#include "FrameEditRuns.h"
+#include "AppLogger.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    uint32_t floatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float bitsToFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Length code per XOR word: 0 = unchanged, 1..3 = 2..4 low bytes follow
+    int byteCount(int code)
+    {
+        return code == 0 ? 0 : code + 1;
+    }
+
+    void encodeChannel(const F0FrameEdit* edits, int count, float F0FrameEdit::*field, std::vector<uint8_t>& out)
+    {
+        const size_t codesAt = out.size();
+        out.resize(codesAt + static_cast<size_t>((count + 3) / 4), 0);
+
+        uint32_t previous = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const uint32_t bits = floatBits(edits[i].*field);
+            const uint32_t word = bits ^ previous;
+            previous = bits;
+
+            const int code = word == 0 ? 0 : word <= 0xffffu ? 1 : word <= 0xffffffu ? 2 : 3;
+            out[codesAt + static_cast<size_t>(i / 4)] |= static_cast<uint8_t>(code << (2 * (i % 4)));
+            for (int b = 0; b < byteCount(code); ++b)
+                out.push_back(static_cast<uint8_t>(word >> (8 * b)));
+        }
+    }
+
+    const uint8_t* decodeChannel(const uint8_t* in, int count, F0FrameEdit* edits, float F0FrameEdit::*field)
+    {
+        const uint8_t* codes = in;
+        const uint8_t* data = in + (count + 3) / 4;
+
+        uint32_t previous = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const int code = (codes[i / 4] >> (2 * (i % 4))) & 3;
+            uint32_t word = 0;
+            for (int b = 0; b < byteCount(code); ++b)
+                word |= static_cast<uint32_t>(*data++) << (8 * b);
+
+            previous ^= word;
+            edits[i].*field = bitsToFloat(previous);
+        }
+        return data;
+    }
+}
+
+FrameEditRuns::FrameEditRuns(std::vector<F0FrameEdit> edits)
+{
+    encode(std::move(edits));
+}
+
+FrameEditRuns::~FrameEditRuns()
+{
+    releaseSpillFile();
+}
+
+FrameEditRuns::FrameEditRuns(FrameEditRuns&& other) noexcept
+    : runs(std::move(other.runs)),
+      bytes(std::move(other.bytes)),
+      numFrames(other.numFrames),
+      spillFile(std::move(other.spillFile)),
+      spilledBytes(other.spilledBytes)
+{
+    other.numFrames = 0;
+    other.spillFile = juce::File();
+}
+
+FrameEditRuns& FrameEditRuns::operator=(FrameEditRuns&& other) noexcept
+{
+    if (this != &other)
+    {
+        releaseSpillFile();
+        runs = std::move(other.runs);
+        bytes = std::move(other.bytes);
+        numFrames = other.numFrames;
+        spillFile = std::move(other.spillFile);
+        spilledBytes = other.spilledBytes;
+        other.numFrames = 0;
+        other.spillFile = juce::File();
+    }
+    return *this;
+}
+
+void FrameEditRuns::encode(std::vector<F0FrameEdit> edits)
+{
+    runs.clear();
+    bytes.clear();
+
+    // A frame collected twice keeps its first old and last new values
+    std::stable_sort(edits.begin(), edits.end(),
+                     [](const F0FrameEdit& a, const F0FrameEdit& b) { return a.idx < b.idx; });
+    size_t unique = 0;
+    for (size_t i = 0; i < edits.size(); ++i)
+    {
+        if (edits[i].idx < 0)
+            continue;
+        if (unique > 0 && edits[unique - 1].idx == edits[i].idx)
+        {
+            auto& kept = edits[unique - 1];
+            kept.newF0 = edits[i].newF0;
+            kept.newDelta = edits[i].newDelta;
+            kept.newVoiced = edits[i].newVoiced;
+            continue;
+        }
+        edits[unique++] = edits[i];
+    }
+    edits.resize(unique);
+    numFrames = static_cast<int>(unique);
+
+    size_t first = 0;
+    while (first < edits.size())
+    {
+        size_t last = first + 1;
+        while (last < edits.size() && edits[last].idx == edits[last - 1].idx + 1)
+            ++last;
+
+        const int count = static_cast<int>(last - first);
+        const F0FrameEdit* run = edits.data() + first;
+        runs.push_back({run->idx, count});
+
+        encodeChannel(run, count, &F0FrameEdit::oldF0, bytes);
+        encodeChannel(run, count, &F0FrameEdit::newF0, bytes);
+        encodeChannel(run, count, &F0FrameEdit::oldDelta, bytes);
+        encodeChannel(run, count, &F0FrameEdit::newDelta, bytes);
+
+        const size_t flagsAt = bytes.size();
+        bytes.resize(flagsAt + static_cast<size_t>((count + 3) / 4), 0);
+        for (int i = 0; i < count; ++i)
+        {
+            const int flags = (run[i].oldVoiced ? 1 : 0) | (run[i].newVoiced ? 2 : 0);
+            bytes[flagsAt + static_cast<size_t>(i / 4)] |= static_cast<uint8_t>(flags << (2 * (i % 4)));
+        }
+
+        first = last;
+    }
+
+    bytes.shrink_to_fit();
+    runs.shrink_to_fit();
+}
+
+std::vector<F0FrameEdit> FrameEditRuns::decode() const
+{
+    std::vector<F0FrameEdit> edits(static_cast<size_t>(numFrames));
+    const uint8_t* in = bytes.data();
+    size_t position = 0;
+
+    for (const auto& run : runs)
+    {
+        F0FrameEdit* out = edits.data() + position;
+        for (int i = 0; i < run.count; ++i)
+            out[i].idx = run.start + i;
+
+        in = decodeChannel(in, run.count, out, &F0FrameEdit::oldF0);
+        in = decodeChannel(in, run.count, out, &F0FrameEdit::newF0);
+        in = decodeChannel(in, run.count, out, &F0FrameEdit::oldDelta);
+        in = decodeChannel(in, run.count, out, &F0FrameEdit::newDelta);
+
+        for (int i = 0; i < run.count; ++i)
+        {
+            const int flags = (in[i / 4] >> (2 * (i % 4))) & 3;
+            out[i].oldVoiced = (flags & 1) != 0;
+            out[i].newVoiced = (flags & 2) != 0;
+        }
+        in += (run.count + 3) / 4;
+        position += static_cast<size_t>(run.count);
+    }
+    return edits;
+}
+
+bool FrameEditRuns::apply(bool useNewValues, std::vector<float>* f0, std::vector<float>* delta, VoicedMask* voiced,
+                          int& minFrame, int& maxFrame)
+{
+    minFrame = std::numeric_limits<int>::max();
+    maxFrame = std::numeric_limits<int>::min();
+    if (!load())
+        return false;
+
+    for (const auto& e : decode())
+    {
+        const auto idx = static_cast<size_t>(e.idx);
+        if (f0 && idx < f0->size())
+        {
+            (*f0)[idx] = useNewValues ? e.newF0 : e.oldF0;
+            minFrame = std::min(minFrame, e.idx);
+            maxFrame = std::max(maxFrame, e.idx);
+        }
+        if (delta && idx < delta->size())
+            (*delta)[idx] = useNewValues ? e.newDelta : e.oldDelta;
+        if (voiced && idx < voiced->size())
+            (*voiced)[idx] = (useNewValues ? e.newVoiced : e.oldVoiced) ? 1 : 0;
+    }
+    return minFrame <= maxFrame;
+}
+
+bool FrameEditRuns::append(FrameEditRuns& later)
+{
+    if (!load() || !later.load())
+        return false;
+
+    const auto earlier = decode();
+    const auto next = later.decode();
+
+    std::vector<F0FrameEdit> merged;
+    merged.reserve(earlier.size() + next.size());
+    size_t i = 0, j = 0;
+    while (i < earlier.size() || j < next.size())
+    {
+        if (j == next.size() || (i < earlier.size() && earlier[i].idx < next[j].idx))
+        {
+            merged.push_back(earlier[i++]);
+        }
+        else if (i == earlier.size() || next[j].idx < earlier[i].idx)
+        {
+            merged.push_back(next[j++]);
+        }
+        else
+        {
+            auto combined = earlier[i++];
+            const auto& newer = next[j++];
+            combined.newF0 = newer.newF0;
+            combined.newDelta = newer.newDelta;
+            combined.newVoiced = newer.newVoiced;
+            merged.push_back(combined);
+        }
+    }
+
+    encode(std::move(merged));
+    return true;
+}
+
+size_t FrameEditRuns::getMemoryBytes() const
+{
+    return runs.capacity() * sizeof(Run) + bytes.capacity();
+}
+
+bool FrameEditRuns::spill(const juce::File& file)
+{
+    if (isSpilled() || bytes.empty())
+        return false;
+
+    if (!file.replaceWithData(bytes.data(), bytes.size()))
+    {
+        LOG("FrameEditRuns: cannot spill to " + file.getFullPathName());
+        return false;
+    }
+
+    spillFile = file;
+    spilledBytes = bytes.size();
+    bytes.clear();
+    bytes.shrink_to_fit();
+    return true;
+}
+
+bool FrameEditRuns::load()
+{
+    if (!isSpilled())
+        return true;
+
+    juce::MemoryBlock data;
+    if (!spillFile.loadFileAsData(data) || data.getSize() != spilledBytes)
+    {
+        LOG("FrameEditRuns: spilled edit lost: " + spillFile.getFullPathName());
+        return false;
+    }
+
+    const auto* begin = static_cast<const uint8_t*>(data.getData());
+    bytes.assign(begin, begin + data.getSize());
+    releaseSpillFile();
+    return true;
+}
+
+void FrameEditRuns::releaseSpillFile()
+{
+    if (isSpilled())
+        spillFile.deleteFile();
+    spillFile = juce::File();
+    spilledBytes = 0;
+}
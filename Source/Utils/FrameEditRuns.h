@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../JuceHeader.h"
+#include "../Models/FrameBuffers.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * One frame of a pitch edit, as collected while drawing or dragging.
+ */
+struct F0FrameEdit
+{
+    int idx = -1;
+    float oldF0 = 0.0f;
+    float newF0 = 0.0f;
+    float oldDelta = 0.0f;
+    float newDelta = 0.0f;
+    bool oldVoiced = false;
+    bool newVoiced = false;
+};
+
+/**
+ * Compact storage for the frames touched by a pitch edit (undo history).
+ *
+ * Edits are sorted into runs of consecutive frames. Within a run each value
+ * channel (old/new f0, old/new delta) is stored as the XOR with the previous
+ * frame's bits, trimmed to its significant low bytes with a 2-bit length
+ * code per frame; the voiced flags are packed two bits per frame. Flat
+ * stretches cost a quarter byte per channel and smooth ones about three
+ * bytes, against 24 bytes per F0FrameEdit.
+ *
+ * The encoded bytes can be spilled to a file and are reloaded on the next
+ * apply().
+ */
+class FrameEditRuns
+{
+public:
+    FrameEditRuns() = default;
+    explicit FrameEditRuns(std::vector<F0FrameEdit> edits);
+    ~FrameEditRuns();
+
+    FrameEditRuns(const FrameEditRuns&) = delete;
+    FrameEditRuns& operator=(const FrameEditRuns&) = delete;
+    FrameEditRuns(FrameEditRuns&& other) noexcept;
+    FrameEditRuns& operator=(FrameEditRuns&& other) noexcept;
+
+    /**
+     * Write the old (undo) or new (redo) values into the given arrays;
+     * null arrays are skipped and frames past an array's end are ignored.
+     * minFrame/maxFrame receive the touched f0 range. Returns false if no
+     * f0 frame was touched (or spilled data could not be reloaded).
+     */
+    bool apply(bool useNewValues, std::vector<float>* f0, std::vector<float>* delta, VoicedMask* voiced,
+               int& minFrame, int& maxFrame);
+
+    /**
+     * Fold in an edit that followed this one: frames touched by both keep
+     * this edit's old values and take later's new values.
+     */
+    bool append(FrameEditRuns& later);
+
+    bool empty() const { return numFrames == 0; }
+    int getNumFrames() const { return numFrames; }
+
+    /** Heap bytes currently held (excluding spilled data). */
+    size_t getMemoryBytes() const;
+
+    bool spill(const juce::File& file);
+    bool isSpilled() const { return spillFile != juce::File(); }
+
+private:
+    struct Run
+    {
+        int start = 0;
+        int count = 0;
+    };
+
+    void encode(std::vector<F0FrameEdit> edits);
+    std::vector<F0FrameEdit> decode() const;
+    bool load();
+    void releaseSpillFile();
+
+    std::vector<Run> runs;
+    std::vector<uint8_t> bytes;
+    int numFrames = 0;
+
+    juce::File spillFile;
+    size_t spilledBytes = 0;
+};
@@ -1,4 +1,5 @@
 #include "MelSpectrogram.h"
+#include "Tracer.h"
 #include <cmath>
 #include <algorithm>
 
@@ -101,8 +102,9 @@ void MelSpectrogram::createMelFilterbank()
     }
 }
 
-std::vector<std::vector<float>> MelSpectrogram::compute(const float* audio, int numSamples)
+MelBuffer MelSpectrogram::compute(const float* audio, int numSamples)
 {
+    TRACE_SCOPE("mel spectrogram");
     // Add center padding for better frame alignment (matches librosa default)
     // This ensures the first frame is centered at hopSize/2
     int padLeft = nFft / 2;
@@ -116,7 +118,7 @@ std::vector<std::vector<float>> MelSpectrogram::compute(const float* audio, int
         numFrames = 1;
     }
     
-    std::vector<std::vector<float>> mel(numFrames);
+    MelBuffer mel(numFrames, numMels);
     int numBins = nFft / 2 + 1;
     
     std::vector<float> frame(nFft * 2, 0.0f);  // Complex FFT buffer
@@ -164,7 +166,7 @@ std::vector<std::vector<float>> MelSpectrogram::compute(const float* audio, int
         }
         
         // Apply mel filterbank
-        mel[i].resize(numMels);
+        float* melFrame = mel.getFrame(i);
         for (int m = 0; m < numMels; ++m)
         {
             float sum = 0.0f;
@@ -175,7 +177,7 @@ std::vector<std::vector<float>> MelSpectrogram::compute(const float* audio, int
             
             // Log scale (natural log for vocoder compatibility)
             // Use slightly larger epsilon to match common vocoder implementations
-            mel[i][m] = std::log(std::max(sum, 1e-10f));
+            melFrame[m] = std::log(std::max(sum, 1e-10f));
         }
     }
     
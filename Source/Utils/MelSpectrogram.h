@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../JuceHeader.h"
+#include "../Models/FrameBuffers.h"
 #include <vector>
 
 /**
@@ -19,7 +20,7 @@ public:
      * @param numSamples Number of samples
      * @return Mel spectrogram [T, numMels] in log scale
      */
-    std::vector<std::vector<float>> compute(const float* audio, int numSamples);
+    MelBuffer compute(const float* audio, int numSamples);
     
 private:
     void createMelFilterbank();
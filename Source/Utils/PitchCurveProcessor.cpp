@@ -1,16 +1,94 @@
 #include "PitchCurveProcessor.h"
 #include "BasePitchCurve.h"
 #include "../Utils/Constants.h"
+#include "Tracer.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PITCH_CURVE_USE_SSE 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PITCH_CURVE_USE_NEON 1
+#endif
 
 namespace
 {
-    inline float safeMidiToFreq(float midi)
+    constexpr double twoPi = 6.283185307179586476925;
+
+    // 2^x = 2^n * p(f) with n = round(x), f = x - n in [-0.5, 0.5]; p is the
+    // degree-6 Taylor series of 2^f. midiToFreqBlock stays within 5e-7 of
+    // the exact frequency (under a thousandth of a cent). Scalar and SIMD
+    // paths use the same steps so results do not depend on block alignment.
+    constexpr float EXP2_LIMIT = 126.0f;
+    constexpr float EXP2_C1 = 0.6931471806f;
+    constexpr float EXP2_C2 = 0.2402265070f;
+    constexpr float EXP2_C3 = 0.0555041087f;
+    constexpr float EXP2_C4 = 0.0096181291f;
+    constexpr float EXP2_C5 = 0.0013333558f;
+    constexpr float EXP2_C6 = 0.0001540353f;
+
+    inline float exp2Scalar(float x)
     {
-        return midiToFreq(midi);
+        x = std::clamp(x, -EXP2_LIMIT, EXP2_LIMIT);
+        const float n = std::nearbyint(x);
+        const float f = x - n;
+
+        float p = EXP2_C6;
+        p = p * f + EXP2_C5;
+        p = p * f + EXP2_C4;
+        p = p * f + EXP2_C3;
+        p = p * f + EXP2_C2;
+        p = p * f + EXP2_C1;
+        p = p * f + 1.0f;
+
+        const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
     }
 
+#if PITCH_CURVE_USE_SSE
+    inline __m128 exp2Sse(__m128 x)
+    {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-EXP2_LIMIT)), _mm_set1_ps(EXP2_LIMIT));
+        const __m128i ni = _mm_cvtps_epi32(x);  // round to nearest even
+        const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(ni));
+
+        __m128 p = _mm_set1_ps(EXP2_C6);
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C5));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C4));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C3));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C2));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(EXP2_C1));
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+
+        const __m128i bits = _mm_slli_epi32(_mm_add_epi32(ni, _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(p, _mm_castsi128_ps(bits));
+    }
+#elif PITCH_CURVE_USE_NEON
+    inline float32x4_t exp2Neon(float32x4_t x)
+    {
+        x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-EXP2_LIMIT)), vdupq_n_f32(EXP2_LIMIT));
+        const int32x4_t ni = vcvtnq_s32_f32(x);  // round to nearest even
+        const float32x4_t f = vsubq_f32(x, vcvtq_f32_s32(ni));
+
+        float32x4_t p = vdupq_n_f32(EXP2_C6);
+        p = vmlaq_f32(vdupq_n_f32(EXP2_C5), p, f);
+        p = vmlaq_f32(vdupq_n_f32(EXP2_C4), p, f);
+        p = vmlaq_f32(vdupq_n_f32(EXP2_C3), p, f);
+        p = vmlaq_f32(vdupq_n_f32(EXP2_C2), p, f);
+        p = vmlaq_f32(vdupq_n_f32(EXP2_C1), p, f);
+        p = vmlaq_f32(vdupq_n_f32(1.0f), p, f);
+
+        const int32x4_t bits = vshlq_n_s32(vaddq_s32(ni, vdupq_n_s32(127)), 23);
+        return vmulq_f32(p, vreinterpretq_f32_s32(bits));
+    }
+#endif
+
     inline float safeFreqToMidi(float freq)
     {
         if (freq <= 0.0f)
@@ -52,12 +130,68 @@ namespace
                   [](const auto& a, const auto& b) { return a.startFrame < b.startFrame; });
         return segments;
     }
+
+    // Clamp [startFrame, endFrame) to the composed curves (basePitch length)
+    std::pair<int, int> clampToCurves(const AudioData& audioData, int startFrame, int endFrame)
+    {
+        const int numFrames = static_cast<int>(audioData.basePitch.size());
+        const int lo = std::clamp(startFrame, 0, numFrames);
+        const int hi = std::clamp(endFrame, lo, numFrames);
+        return {lo, hi};
+    }
+
+    // out[i - lo] = base + delta + offset for frames [lo, hi) (already clamped)
+    void composeMidi(const AudioData& audioData, int lo, int hi, float offset, float* out)
+    {
+        const float* base = audioData.basePitch.data();
+        const float* delta = audioData.deltaPitch.data();
+        const int withDelta = std::clamp(static_cast<int>(audioData.deltaPitch.size()), lo, hi);
+
+        for (int i = lo; i < withDelta; ++i)
+            out[i - lo] = base[i] + delta[i] + offset;
+        for (int i = withDelta; i < hi; ++i)
+            out[i - lo] = base[i] + offset;
+    }
+
+    // Zero unvoiced frames of out (frame lo at out[0]); frames past the mask count as voiced
+    void maskUnvoiced(const AudioData& audioData, int lo, int hi, float* out)
+    {
+        const int masked = std::min(hi, static_cast<int>(audioData.voicedMask.size()));
+        for (int i = lo; i < masked; ++i)
+        {
+            if (!audioData.voicedMask[static_cast<size_t>(i)])
+                out[i - lo] = 0.0f;
+        }
+    }
+
+    // Add a note's vibrato (semitones) to out for frames [from, to), frame from at out[0]
+    void addVibrato(const Note& note, int from, int to, float* out)
+    {
+        const int noteStart = std::max(0, note.getStartFrame());
+        const double depth = note.getVibratoDepthSemitones();
+        const double step = twoPi * note.getVibratoRateHz() * HOP_SIZE / SAMPLE_RATE;
+        const double phase0 = twoPi * note.getVibratoRateHz() * framesToSeconds(from - noteStart)
+                            + note.getVibratoPhaseRadians();
+
+        // Rotate (cos, sin) by one frame per step instead of calling sin per frame
+        const double cosStep = std::cos(step);
+        const double sinStep = std::sin(step);
+        double c = std::cos(phase0);
+        double sn = std::sin(phase0);
+        for (int i = 0; i < to - from; ++i)
+        {
+            out[i] += static_cast<float>(depth * sn);
+            const double nextSin = sn * cosStep + c * sinStep;
+            c = c * cosStep - sn * sinStep;
+            sn = nextSin;
+        }
+    }
 } // namespace
 
 namespace PitchCurveProcessor
 {
     std::vector<float> interpolateWithUvMask(const std::vector<float>& pitchHz,
-                                             const std::vector<bool>& uvMask)
+                                             const VoicedMask& uvMask)
     {
         if (pitchHz.empty())
             return {};
@@ -129,6 +263,7 @@ namespace PitchCurveProcessor
     void rebuildCurvesFromSource(Project& project,
                                  const std::vector<float>& sourcePitchHz)
     {
+        TRACE_SCOPE("rebuild curves");
         auto& audioData = project.getAudioData();
         const int totalFrames = static_cast<int>(sourcePitchHz.size());
         ensureSizes(audioData, totalFrames);
@@ -156,42 +291,57 @@ namespace PitchCurveProcessor
             audioData.deltaPitch[static_cast<size_t>(i)] = midi - base;
         }
 
-        // Cache base F0 (Hz) for backwards compatibility
-        audioData.baseF0.resize(static_cast<size_t>(totalFrames));
-        for (int i = 0; i < totalFrames; ++i)
-            audioData.baseF0[static_cast<size_t>(i)] = safeMidiToFreq(audioData.basePitch[static_cast<size_t>(i)]);
-
         composeF0InPlace(project, /*applyUvMask=*/false);
     }
 
     void rebuildBaseFromNotes(Project& project)
     {
+        TRACE_SCOPE("rebuild base pitch");
         auto& audioData = project.getAudioData();
         const int totalFrames = audioData.getNumFrames();
         ensureSizes(audioData, totalFrames);
 
-        auto segments = collectNoteSegments(project.getNotes());
-        if (!segments.empty())
-        {
-            audioData.basePitch = BasePitchCurve::generateForNotes(segments, totalFrames);
-        }
-
         if (audioData.basePitch.size() != static_cast<size_t>(totalFrames))
         {
             audioData.basePitch.assign(static_cast<size_t>(totalFrames), 0.0f);
         }
 
+        // Regenerate over the whole song, in place
+        auto segments = collectNoteSegments(project.getNotes());
+        if (!segments.empty())
+            BasePitchCurve::regenerateRange(segments, 0, totalFrames, audioData.basePitch);
+
         // Preserve existing delta but clamp size
         audioData.deltaPitch.resize(static_cast<size_t>(totalFrames), 0.0f);
 
-        // Update cached baseF0
-        audioData.baseF0.resize(static_cast<size_t>(totalFrames));
-        for (int i = 0; i < totalFrames; ++i)
-            audioData.baseF0[static_cast<size_t>(i)] = safeMidiToFreq(audioData.basePitch[static_cast<size_t>(i)]);
-
         composeF0InPlace(project, /*applyUvMask=*/false);
     }
 
+    std::pair<int, int> rebuildBaseFromNotes(Project& project, int startFrame, int endFrame)
+    {
+        TRACE_SCOPE("rebuild base pitch range");
+        auto& audioData = project.getAudioData();
+        const int totalFrames = audioData.getNumFrames();
+        const auto frameCount = static_cast<size_t>(totalFrames);
+
+        if (totalFrames <= 0 || audioData.basePitch.size() != frameCount
+            || audioData.deltaPitch.size() != frameCount || audioData.f0.size() != frameCount)
+        {
+            rebuildBaseFromNotes(project);
+            return {0, std::max(0, totalFrames)};
+        }
+
+        const auto segments = collectNoteSegments(project.getNotes());
+        if (segments.empty())
+            return {0, 0};
+
+        const auto range = BasePitchCurve::regenerateRange(segments, startFrame, endFrame,
+                                                           audioData.basePitch);
+
+        composeF0InPlace(project, range.first, range.second, /*applyUvMask=*/false);
+        return range;
+    }
+
     std::vector<float> composeF0(const Project& project,
                                  bool applyUvMask,
                                  float globalPitchOffset)
@@ -199,31 +349,129 @@ namespace PitchCurveProcessor
         const auto& audioData = project.getAudioData();
         const int totalFrames = static_cast<int>(audioData.basePitch.size());
         std::vector<float> result(static_cast<size_t>(totalFrames), 0.0f);
+        composeF0Range(project, 0, totalFrames, applyUvMask, globalPitchOffset, result.data());
+        return result;
+    }
 
-        for (int i = 0; i < totalFrames; ++i)
+    void composeF0InPlace(Project& project,
+                          bool applyUvMask,
+                          float globalPitchOffset)
+    {
+        auto& audioData = project.getAudioData();
+        const int totalFrames = static_cast<int>(audioData.basePitch.size());
+        audioData.f0.resize(static_cast<size_t>(totalFrames));
+        composeF0Range(project, 0, totalFrames, applyUvMask, globalPitchOffset, audioData.f0.data());
+    }
+
+    void composeF0Range(const Project& project, int startFrame, int endFrame,
+                        bool applyUvMask, float globalPitchOffset, float* out)
+    {
+        if (endFrame <= startFrame)
+            return;
+
+        const auto& audioData = project.getAudioData();
+        const auto [lo, hi] = clampToCurves(audioData, startFrame, endFrame);
+        std::fill(out, out + (endFrame - startFrame), 0.0f);
+        if (lo >= hi)
+            return;
+
+        float* dest = out + (lo - startFrame);
+        composeMidi(audioData, lo, hi, globalPitchOffset, dest);
+        midiToFreqBlock(dest, dest, hi - lo);
+        if (applyUvMask)
+            maskUnvoiced(audioData, lo, hi, dest);
+    }
+
+    void composeF0InPlace(Project& project, int startFrame, int endFrame,
+                          bool applyUvMask, float globalPitchOffset)
+    {
+        auto& audioData = project.getAudioData();
+        const auto [lo, hi] = clampToCurves(audioData, startFrame, endFrame);
+        const int count = std::min(hi, static_cast<int>(audioData.f0.size())) - lo;
+        if (count <= 0)
+            return;
+
+        composeF0Range(project, lo, lo + count, applyUvMask, globalPitchOffset, audioData.f0.data() + lo);
+    }
+
+    void updateDeltaFromSource(Project& project, int startFrame, int endFrame,
+                               const float* sourcePitchHz)
+    {
+        auto& audioData = project.getAudioData();
+        const auto [lo, hi] = clampToCurves(audioData, startFrame, endFrame);
+        const int withDelta = std::min(hi, static_cast<int>(audioData.deltaPitch.size()));
+
+        for (int i = lo; i < withDelta; ++i)
+        {
+            const float midi = safeFreqToMidi(sourcePitchHz[i - startFrame]);
+            audioData.deltaPitch[static_cast<size_t>(i)] = midi - audioData.basePitch[static_cast<size_t>(i)];
+        }
+
+        composeF0InPlace(project, lo, hi, /*applyUvMask=*/false);
+    }
+
+    void composeAdjustedF0(const Project& project, int startFrame, int endFrame, float* out)
+    {
+        if (endFrame <= startFrame)
+            return;
+
+        const auto& audioData = project.getAudioData();
+        const auto [lo, hi] = clampToCurves(audioData, startFrame, endFrame);
+        std::fill(out, out + (endFrame - startFrame), 0.0f);
+        if (lo >= hi)
+            return;
+
+        float* dest = out + (lo - startFrame);
+        composeMidi(audioData, lo, hi, project.getGlobalPitchOffset(), dest);
+
+        // Vibrato is a pitch offset, so it is added in the MIDI domain before
+        // the single conversion to Hz (same as multiplying by 2^(vib/12))
+        for (const auto* candidate : project.getNotesInRange(lo, hi))
         {
-            bool isVoiced = (i < static_cast<int>(audioData.voicedMask.size())) ? audioData.voicedMask[i] : true;
-            if (applyUvMask && !isVoiced)
+            const auto& note = *candidate;
+            const bool hasVibrato = note.isVibratoEnabled() &&
+                                    note.getVibratoDepthSemitones() > 0.0001f &&
+                                    note.getVibratoRateHz() > 0.0001f;
+            if (!hasVibrato)
                 continue;
 
-            const float base = audioData.basePitch[static_cast<size_t>(i)];
-            const float delta = (i < static_cast<int>(audioData.deltaPitch.size()))
-                                    ? audioData.deltaPitch[static_cast<size_t>(i)]
-                                    : 0.0f;
-            const float midi = base + delta + globalPitchOffset;
-            result[static_cast<size_t>(i)] = safeMidiToFreq(midi);
+            const int from = std::max({note.getStartFrame(), lo, 0});
+            const int to = std::min(note.getEndFrame(), hi);
+            if (from < to)
+                addVibrato(note, from, to, dest + (from - lo));
         }
 
-        return result;
+        midiToFreqBlock(dest, dest, hi - lo);
+        maskUnvoiced(audioData, lo, hi, dest);
     }
 
-    void composeF0InPlace(Project& project,
-                          bool applyUvMask,
-                          float globalPitchOffset)
+    void midiToFreqBlock(const float* midi, float* freq, int count)
     {
-        auto composed = composeF0(project, applyUvMask, globalPitchOffset);
-        auto& audioData = project.getAudioData();
-        audioData.f0 = std::move(composed);
+        constexpr float semitoneScale = 1.0f / 12.0f;
+        int i = 0;
+
+#if PITCH_CURVE_USE_SSE
+        const __m128 a4 = _mm_set1_ps(static_cast<float>(MIDI_A4));
+        const __m128 scale = _mm_set1_ps(semitoneScale);
+        const __m128 freqA4 = _mm_set1_ps(FREQ_A4);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(midi + i), a4), scale);
+            _mm_storeu_ps(freq + i, _mm_mul_ps(freqA4, exp2Sse(x)));
+        }
+#elif PITCH_CURVE_USE_NEON
+        const float32x4_t a4 = vdupq_n_f32(static_cast<float>(MIDI_A4));
+        const float32x4_t scale = vdupq_n_f32(semitoneScale);
+        const float32x4_t freqA4 = vdupq_n_f32(FREQ_A4);
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t x = vmulq_f32(vsubq_f32(vld1q_f32(midi + i), a4), scale);
+            vst1q_f32(freq + i, vmulq_f32(freqA4, exp2Neon(x)));
+        }
+#endif
+
+        for (; i < count; ++i)
+            freq[i] = FREQ_A4 * exp2Scalar((midi[i] - MIDI_A4) * semitoneScale);
     }
 } // namespace PitchCurveProcessor
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Models/Project.h"
+#include <utility>
 #include <vector>
 
 namespace PitchCurveProcessor
@@ -10,7 +11,7 @@ namespace PitchCurveProcessor
      * Returns a dense pitch (Hz) array with the same length as the input.
      */
     std::vector<float> interpolateWithUvMask(const std::vector<float>& pitchHz,
-                                             const std::vector<bool>& uvMask);
+                                             const VoicedMask& uvMask);
 
     /**
      * Rebuild base pitch (midi) from current notes and keep existing delta.
@@ -19,6 +20,15 @@ namespace PitchCurveProcessor
      */
     void rebuildBaseFromNotes(Project& project);
 
+    /**
+     * Incremental rebuildBaseFromNotes after the notes covering
+     * [startFrame, endFrame) changed (for moved notes, cover the old and new
+     * extents). Only frames within reach of the base pitch smoothing are
+     * rewritten in basePitch and f0; returns that frame range.
+     * Falls back to a full rebuild when the curves are not yet aligned.
+     */
+    std::pair<int, int> rebuildBaseFromNotes(Project& project, int startFrame, int endFrame);
+
     /**
      * Rebuild base and delta from a source pitch (Hz). This is used after
      * detection/segmentation or when we need to recompute delta from edited
@@ -42,6 +52,45 @@ namespace PitchCurveProcessor
     void composeF0InPlace(Project& project,
                           bool applyUvMask,
                           float globalPitchOffset = 0.0f);
+
+    // Range-scoped variants ---------------------------------------------------
+    // These touch only frames [startFrame, endFrame) (clamped to the curves),
+    // write into existing storage and never allocate, so interactive edits
+    // cost the same regardless of song length.
+
+    /**
+     * Compose base + delta + offset for [startFrame, endFrame) into out,
+     * which must hold endFrame - startFrame values (frames past the curves
+     * are written as 0).
+     */
+    void composeF0Range(const Project& project, int startFrame, int endFrame,
+                        bool applyUvMask, float globalPitchOffset, float* out);
+
+    /**
+     * Recompose audioData.f0 for a frame range.
+     */
+    void composeF0InPlace(Project& project, int startFrame, int endFrame,
+                          bool applyUvMask, float globalPitchOffset = 0.0f);
+
+    /**
+     * Re-derive delta = midi(source) - base for [startFrame, endFrame) from
+     * sourcePitchHz (endFrame - startFrame values, 0 = unvoiced) and recompose
+     * f0 there. Base pitch must already be up to date for the range.
+     */
+    void updateDeltaFromSource(Project& project, int startFrame, int endFrame,
+                               const float* sourcePitchHz);
+
+    /**
+     * Synthesis-ready pitch for [startFrame, endFrame): composed f0 with the
+     * uv mask, global offset and per-note vibrato applied. out must hold
+     * endFrame - startFrame values.
+     */
+    void composeAdjustedF0(const Project& project, int startFrame, int endFrame, float* out);
+
+    /**
+     * Vectorized midiToFreq over a block (in and out may alias).
+     */
+    void midiToFreqBlock(const float* midi, float* freq, int count);
 } // namespace PitchCurveProcessor
 
 
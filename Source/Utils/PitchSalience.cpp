@@ -0,0 +1,152 @@
+#include "PitchSalience.h"
+#include <algorithm>
+#include <cmath>
+
+void PitchSalience::reset(double frameTimeSeconds, std::vector<float> cents, float decodeThreshold)
+{
+    clear();
+    frameTime = frameTimeSeconds;
+    binCents = std::move(cents);
+    binCents.resize(NUM_BINS, 0.0f);
+    threshold = decodeThreshold;
+}
+
+void PitchSalience::appendFrames(const float* salience, int numFrames)
+{
+    if (salience == nullptr || numFrames <= 0)
+        return;
+
+    const size_t oldFrames = peaks.size();
+    peaks.resize(oldFrames + static_cast<size_t>(numFrames));
+    bins.resize(peaks.size() * NUM_BINS);
+
+    for (int t = 0; t < numFrames; ++t)
+    {
+        const float* frame = salience + static_cast<size_t>(t) * NUM_BINS;
+        uint8_t* out = bins.data() + (oldFrames + static_cast<size_t>(t)) * NUM_BINS;
+
+        float peak = frame[0];
+        for (int i = 1; i < NUM_BINS; ++i)
+            peak = std::max(peak, frame[i]);
+
+        peaks[oldFrames + static_cast<size_t>(t)] = peak;
+
+        if (peak <= 0.0f)
+        {
+            std::fill(out, out + NUM_BINS, static_cast<uint8_t>(0));
+            continue;
+        }
+
+        const float scale = 255.0f / peak;
+        for (int i = 0; i < NUM_BINS; ++i)
+        {
+            const float q = std::max(0.0f, frame[i]) * scale + 0.5f;
+            out[i] = static_cast<uint8_t>(std::min(q, 255.0f));
+        }
+    }
+}
+
+void PitchSalience::replaceFrames(int dstStart, const PitchSalience& source, int srcStart, int numFrames)
+{
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const int dst = dstStart + i;
+        const int src = srcStart + i;
+        if (dst < 0 || src < 0 || dst >= getNumFrames() || src >= source.getNumFrames())
+            continue;
+
+        peaks[static_cast<size_t>(dst)] = source.peaks[static_cast<size_t>(src)];
+        std::copy_n(source.bins.data() + static_cast<size_t>(src) * NUM_BINS, NUM_BINS,
+                    bins.data() + static_cast<size_t>(dst) * NUM_BINS);
+    }
+}
+
+PitchSalience PitchSalience::extractFrames(int start, int numFrames) const
+{
+    PitchSalience result;
+    result.frameTime = frameTime;
+    result.threshold = threshold;
+    result.binCents = binCents;
+
+    const int first = std::clamp(start, 0, getNumFrames());
+    const int last = std::clamp(start + std::max(0, numFrames), first, getNumFrames());
+    result.peaks.assign(peaks.begin() + first, peaks.begin() + last);
+    result.bins.assign(bins.begin() + static_cast<std::ptrdiff_t>(first) * NUM_BINS,
+                       bins.begin() + static_cast<std::ptrdiff_t>(last) * NUM_BINS);
+    return result;
+}
+
+void PitchSalience::clear()
+{
+    peaks.clear();
+    bins.clear();
+}
+
+std::vector<float> PitchSalience::decode(float decodeThreshold, Decoder decoder) const
+{
+    const int numFrames = getNumFrames();
+    std::vector<float> f0(static_cast<size_t>(numFrames), 0.0f);
+
+    if (binCents.size() != NUM_BINS)
+        return f0;
+
+    for (int t = 0; t < numFrames; ++t)
+    {
+        // Voiced at the threshold itself, as RMVPE decodes
+        if (peaks[static_cast<size_t>(t)] < decodeThreshold)
+            continue;
+
+        const uint8_t* frame = bins.data() + static_cast<size_t>(t) * NUM_BINS;
+        const int center = static_cast<int>(std::max_element(frame, frame + NUM_BINS) - frame);
+
+        float cents = binCents[static_cast<size_t>(center)];
+
+        if (decoder == Decoder::LocalArgmax)
+        {
+            const int start = std::max(0, center - 4);
+            const int end = std::min(NUM_BINS, center + 5);
+
+            float weightedSum = 0.0f;
+            float weightSum = 0.0f;
+            for (int i = start; i < end; ++i)
+            {
+                const float w = static_cast<float>(frame[i]);
+                weightedSum += w * binCents[static_cast<size_t>(i)];
+                weightSum += w;
+            }
+
+            if (weightSum <= 0.0f)
+                continue;
+            cents = weightedSum / weightSum;
+        }
+
+        f0[static_cast<size_t>(t)] = 10.0f * std::pow(2.0f, cents / 1200.0f);
+    }
+
+    return f0;
+}
+
+size_t PitchSalience::getMemoryUsage() const
+{
+    return bins.capacity() * sizeof(uint8_t)
+         + peaks.capacity() * sizeof(float)
+         + binCents.capacity() * sizeof(float);
+}
+
+bool PitchSalience::restore(double frameTimeSeconds, float decodeThreshold,
+                            std::vector<float> cents, std::vector<float> framePeaks,
+                            std::vector<uint8_t> quantizedBins)
+{
+    if (cents.size() != NUM_BINS || quantizedBins.size() != framePeaks.size() * NUM_BINS)
+    {
+        clear();
+        return false;
+    }
+
+    frameTime = frameTimeSeconds;
+    threshold = decodeThreshold;
+    binCents = std::move(cents);
+    peaks = std::move(framePeaks);
+    bins = std::move(quantizedBins);
+    return true;
+}
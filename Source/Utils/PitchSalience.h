@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Compact store of the raw per-frame salience produced by the neural pitch
+ * detectors (RMVPE hidden / FCPE latent, 360 bins per frame).
+ *
+ * Each frame keeps its exact peak value plus the bins quantized to 8 bits
+ * relative to that peak. Voicing decisions compare against the exact peak,
+ * and the local weighted-average decoder only depends on bin ratios, so
+ * re-decoding with a new threshold or decoder matches the detector output
+ * closely without running inference again (360 bytes per 10 ms frame).
+ */
+class PitchSalience
+{
+public:
+    static constexpr int NUM_BINS = 360;
+
+    enum class Decoder
+    {
+        LocalArgmax = 0,  // Weighted average of +-4 bins around the peak (detector default)
+        Argmax            // Peak bin only
+    };
+
+    /**
+     * Clear stored frames and set up the bin-to-cents mapping.
+     * @param frameTimeSeconds Time between salience frames (detector hop)
+     * @param binCents Cents value of each bin (NUM_BINS entries)
+     * @param threshold Threshold the detector used for its own decode
+     */
+    void reset(double frameTimeSeconds, std::vector<float> binCents, float threshold);
+
+    /**
+     * Quantize and append frames from a row-major [numFrames x NUM_BINS] array.
+     */
+    void appendFrames(const float* salience, int numFrames);
+
+    /**
+     * Overwrite frames [dstStart, dstStart + numFrames) with frames from
+     * another salience store (used by range re-analysis). Frames outside
+     * either store are skipped.
+     */
+    void replaceFrames(int dstStart, const PitchSalience& source, int srcStart, int numFrames);
+
+    /** Copy of frames [start, start + numFrames), clamped, with the same mapping. */
+    PitchSalience extractFrames(int start, int numFrames) const;
+
+    void clear();
+    bool isEmpty() const { return peaks.empty(); }
+    int getNumFrames() const { return static_cast<int>(peaks.size()); }
+    double getFrameTime() const { return frameTime; }
+
+    /** Threshold of the most recent decode (or the detector default). */
+    float getThreshold() const { return threshold; }
+    void setThreshold(float newThreshold) { threshold = newThreshold; }
+
+    /** Exact peak salience of a frame (its voicing confidence). */
+    float getPeak(int frame) const { return peaks[static_cast<size_t>(frame)]; }
+
+    /**
+     * Decode F0 (Hz, 0 = unvoiced) at the detector frame rate.
+     */
+    std::vector<float> decode(float decodeThreshold, Decoder decoder = Decoder::LocalArgmax) const;
+
+    /** Approximate heap usage in bytes. */
+    size_t getMemoryUsage() const;
+
+    // Raw access for persistence
+    const std::vector<float>& getBinCents() const { return binCents; }
+    const std::vector<float>& getPeaks() const { return peaks; }
+    const std::vector<uint8_t>& getQuantizedBins() const { return bins; }
+
+    /**
+     * Restore previously persisted data. Returns false (and clears) if the
+     * array sizes are inconsistent.
+     */
+    bool restore(double frameTimeSeconds, float decodeThreshold,
+                 std::vector<float> cents, std::vector<float> framePeaks,
+                 std::vector<uint8_t> quantizedBins);
+
+private:
+    double frameTime = 0.01;
+    float threshold = 0.0f;
+    std::vector<float> binCents;  // [NUM_BINS]
+    std::vector<float> peaks;     // [T] exact per-frame maximum
+    std::vector<uint8_t> bins;    // [T * NUM_BINS] quantized relative to the frame peak
+};
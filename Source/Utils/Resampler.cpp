@@ -0,0 +1,441 @@
+#include "Resampler.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLER_USE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_USE_NEON 1
+#endif
+
+namespace
+{
+    struct FilterDesign
+    {
+        int zeroCrossings;    // Sinc lobes on each side at the cutoff
+        double rolloff;       // Cutoff relative to the lower Nyquist
+        double kaiserBeta;
+    };
+
+    constexpr FilterDesign HIGH_QUALITY = {12, 0.95, 8.0};  // ~80 dB stopband
+    constexpr FilterDesign FAST = {2, 0.95, 4.5};           // ~30 dB stopband, a sixth of the taps
+
+    constexpr int64_t MAX_EXACT_PHASES = 1024;
+    constexpr int APPROX_PHASES = 256;        // Used (with interpolation) when L is too large
+
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double halfX = 0.5 * x;
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    // Dot product of two float arrays; n is a multiple of 4
+    inline float dot(const float* a, const float* b, int n)
+    {
+#if RESAMPLER_USE_SSE
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        if (i < n)
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+        acc0 = _mm_add_ps(acc0, acc1);
+        acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+        acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+        return _mm_cvtss_f32(acc0);
+#elif RESAMPLER_USE_NEON
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        if (i < n)
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+
+        acc0 = vaddq_f32(acc0, acc1);
+        float32x2_t sum2 = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+        return vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+#else
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        for (int i = 0; i < n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        return (s0 + s1) + (s2 + s3);
+#endif
+    }
+
+    // Four dot products x[k] . r[k] at once; the horizontal sums share one transpose
+    inline void dot4(const float* const* x, const float* const* r, int n, float* out)
+    {
+#if RESAMPLER_USE_SSE
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps();
+        __m128 acc3 = _mm_setzero_ps();
+        for (int i = 0; i < n; i += 4)
+        {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x[0] + i), _mm_loadu_ps(r[0] + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x[1] + i), _mm_loadu_ps(r[1] + i)));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(x[2] + i), _mm_loadu_ps(r[2] + i)));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(x[3] + i), _mm_loadu_ps(r[3] + i)));
+        }
+        _MM_TRANSPOSE4_PS(acc0, acc1, acc2, acc3);
+        _mm_storeu_ps(out, _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+#else
+        for (int k = 0; k < 4; ++k)
+            out[k] = dot(x[k], r[k], n);
+#endif
+    }
+}
+
+struct Resampler::Kernel
+{
+    bool exact = true;        // Rational L/M stepping (otherwise interpolated phases)
+    int64_t up = 1;           // L
+    int64_t down = 1;         // M
+    double step = 1.0;        // Source samples per output sample
+    int numPhases = 1;        // Rows in the table (exact: L, approx: APPROX_PHASES + 1)
+    int halfWidth = 1;        // Taps on each side of the output position
+    int numTaps = 4;          // Row length, padded to a multiple of 4
+    std::vector<float> taps;  // [numPhases x numTaps]; exact rows are in output order
+    std::vector<int> offsets;  // Exact: input offset of output q within a period
+
+    const float* row(int index) const { return taps.data() + static_cast<size_t>(index) * numTaps; }
+
+    Kernel(int sourceRate, int targetRate, const FilterDesign& design)
+    {
+        const int64_t g = std::gcd(static_cast<int64_t>(sourceRate), static_cast<int64_t>(targetRate));
+        up = targetRate / g;
+        down = sourceRate / g;
+        step = static_cast<double>(sourceRate) / targetRate;
+        exact = up <= MAX_EXACT_PHASES;
+
+        const int phases = exact ? static_cast<int>(up) : APPROX_PHASES;
+        numPhases = exact ? phases : phases + 1;
+
+        // Cutoff in cycles per source sample (relative to source Nyquist)
+        const double cutoff = std::min(1.0, static_cast<double>(targetRate) / sourceRate) * design.rolloff;
+        halfWidth = static_cast<int>(std::ceil(design.zeroCrossings / cutoff));
+        numTaps = (2 * halfWidth + 3) & ~3;
+
+        taps.assign(static_cast<size_t>(numPhases) * numTaps, 0.0f);
+        const double i0Beta = besselI0(design.kaiserBeta);
+
+        if (exact)
+        {
+            offsets.resize(static_cast<size_t>(up));
+            for (int64_t q = 0; q < up; ++q)
+                offsets[static_cast<size_t>(q)] = static_cast<int>((q * down) / up);
+        }
+
+        for (int p = 0; p < numPhases; ++p)
+        {
+            // Exact row p serves output p of each period, at phase (p * M) mod L
+            const double frac = exact ? static_cast<double>((p * down) % up) / phases
+                                      : static_cast<double>(p) / phases;
+            float* r = taps.data() + static_cast<size_t>(p) * numTaps;
+            double sum = 0.0;
+
+            for (int j = 0; j < 2 * halfWidth; ++j)
+            {
+                const double t = (j - (halfWidth - 1)) - frac;
+                const double x = t / halfWidth;
+                if (std::abs(x) >= 1.0)
+                    continue;
+
+                const double arg = 3.14159265358979323846 * cutoff * t;
+                const double sinc = std::abs(arg) < 1e-12 ? 1.0 : std::sin(arg) / arg;
+                const double window = besselI0(design.kaiserBeta * std::sqrt(1.0 - x * x)) / i0Beta;
+                const double h = cutoff * sinc * window;
+                r[j] = static_cast<float>(h);
+                sum += h;
+            }
+
+            // Unity DC gain for every phase
+            if (sum != 0.0)
+                for (int j = 0; j < numTaps; ++j)
+                    r[j] = static_cast<float>(r[j] / sum);
+        }
+    }
+};
+
+Resampler::Resampler(int srcRate, int dstRate, Quality filterQuality)
+    : sourceRate(std::max(1, srcRate)), targetRate(std::max(1, dstRate)), quality(filterQuality)
+{
+    if (!isPassthrough())
+        kernel = getKernel(sourceRate, targetRate, quality);
+}
+
+Resampler::~Resampler() = default;
+
+std::shared_ptr<const Resampler::Kernel> Resampler::getKernel(int srcRate, int dstRate, Quality filterQuality)
+{
+    static std::mutex cacheLock;
+    static std::map<std::tuple<int, int, Quality>, std::shared_ptr<const Kernel>> cache;
+
+    const int g = std::gcd(srcRate, dstRate);
+    const auto key = std::make_tuple(srcRate / g, dstRate / g, filterQuality);
+
+    std::lock_guard<std::mutex> lock(cacheLock);
+    auto& entry = cache[key];
+    if (!entry)
+        entry = std::make_shared<const Kernel>(srcRate, dstRate,
+                                               filterQuality == Quality::Fast ? FAST : HIGH_QUALITY);
+    return entry;
+}
+
+int Resampler::getOutputLength(int numInput) const
+{
+    if (numInput <= 0)
+        return 0;
+    return static_cast<int>(static_cast<int64_t>(numInput) * targetRate / sourceRate);
+}
+
+void Resampler::render(int64_t first, int64_t last, const float* base, int64_t baseIndex,
+                       int64_t end, float* output) const
+{
+    const Kernel& k = *kernel;
+    const int lead = k.halfWidth - 1;
+
+    auto inside = [&](int64_t start) { return start >= baseIndex && start + k.numTaps <= end; };
+
+    // Edge of the available input: zero outside [baseIndex, end)
+    auto edgeDot = [&](int64_t start, const float* r)
+    {
+        float sum = 0.0f;
+        for (int j = 0; j < k.numTaps; ++j)
+        {
+            const int64_t idx = start + j;
+            if (idx >= baseIndex && idx < end)
+                sum += base[idx - baseIndex] * r[j];
+        }
+        return sum;
+    };
+
+    if (!k.exact)
+    {
+        for (int64_t n = first; n < last; ++n)
+        {
+            const double pos = static_cast<double>(n) * k.step;
+            const auto ip = static_cast<int64_t>(pos);
+            const double fp = (pos - static_cast<double>(ip)) * APPROX_PHASES;
+            const int phase = std::min(APPROX_PHASES - 1, static_cast<int>(fp));
+            const auto blend = static_cast<float>(fp - phase);
+
+            const int64_t start = ip - lead;
+            const float* r0 = k.row(phase);
+            const float* r1 = k.row(phase + 1);
+            float v0, v1;
+            if (inside(start))
+            {
+                const float* x = base + (start - baseIndex);
+                v0 = dot(x, r0, k.numTaps);
+                v1 = dot(x, r1, k.numTaps);
+            }
+            else
+            {
+                v0 = edgeDot(start, r0);
+                v1 = edgeDot(start, r1);
+            }
+            output[n - first] = v0 + blend * (v1 - v0);
+        }
+        return;
+    }
+
+    // Output n = period * L + q reads input from period * M + offsets[q]
+    // with row q, so stepping needs no division or data-dependent branch
+    int64_t q = first % k.up;
+    int64_t periodStart = (first / k.up) * k.down;
+    auto advance = [&]()
+    {
+        if (++q == k.up)
+        {
+            q = 0;
+            periodStart += k.down;
+        }
+    };
+
+    // Outputs whose whole window lies inside the input form one run, since
+    // windows only move forward: n in [safeFirst, safeLast)
+    auto firstOutputAt = [&](int64_t ip)
+    {
+        // Smallest n with floor(n * M / L) >= ip
+        return ip <= 0 ? 0 : (ip * k.up + k.down - 1) / k.down;
+    };
+    const int64_t safeFirst = std::clamp(firstOutputAt(baseIndex + lead), first, last);
+    const int64_t safeLast = std::clamp(firstOutputAt(end - k.numTaps + lead + 1), safeFirst, last);
+
+    auto renderEdge = [&](int64_t from, int64_t to)
+    {
+        for (int64_t n = from; n < to; ++n)
+        {
+            const int64_t start = periodStart + k.offsets[static_cast<size_t>(q)] - lead;
+            const float* r = k.row(static_cast<int>(q));
+            output[n - first] = inside(start) ? dot(base + (start - baseIndex), r, k.numTaps) : edgeDot(start, r);
+            advance();
+        }
+    };
+
+    renderEdge(first, safeFirst);
+
+    // Inside the run, walk the offsets and rows with pointers
+    const float* periodInput = base + (periodStart - lead - baseIndex);
+    const int* offset = k.offsets.data() + q;
+    const float* r = k.row(static_cast<int>(q));
+    const float* xs[4];
+    const float* rs[4];
+    int64_t n = safeFirst;
+    for (; n + 4 <= safeLast; n += 4)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            xs[j] = periodInput + *offset++;
+            rs[j] = r;
+            r += k.numTaps;
+            if (++q == k.up)
+            {
+                q = 0;
+                periodStart += k.down;
+                periodInput += k.down;
+                offset = k.offsets.data();
+                r = k.taps.data();
+            }
+        }
+        dot4(xs, rs, k.numTaps, output + (n - first));
+    }
+
+    renderEdge(n, last);
+}
+
+void Resampler::process(const float* input, int numInput, float* output, int numOutput) const
+{
+    if (numOutput <= 0)
+        return;
+
+    if (isPassthrough())
+    {
+        const int n = std::min(numInput, numOutput);
+        std::copy(input, input + n, output);
+        std::fill(output + n, output + numOutput, 0.0f);
+        return;
+    }
+
+    render(0, numOutput, input, 0, numInput, output);
+}
+
+std::vector<float> Resampler::resample(const float* input, int numInput, int srcRate, int dstRate,
+                                       Quality filterQuality)
+{
+    TRACE_SCOPE("resample");
+    if (input == nullptr || numInput <= 0)
+        return {};
+
+    Resampler resampler(srcRate, dstRate, filterQuality);
+    std::vector<float> output(static_cast<size_t>(resampler.getOutputLength(numInput)));
+    resampler.process(input, numInput, output.data(), static_cast<int>(output.size()));
+    return output;
+}
+
+void Resampler::reset()
+{
+    history.clear();
+    historyStart = 0;
+    totalInput = 0;
+    nextOutput = 0;
+}
+
+int Resampler::processBlock(const float* input, int numInput, std::vector<float>& output)
+{
+    if (input == nullptr || numInput <= 0)
+        return 0;
+
+    if (isPassthrough())
+    {
+        output.insert(output.end(), input, input + numInput);
+        totalInput += numInput;
+        nextOutput += numInput;
+        return numInput;
+    }
+
+    history.insert(history.end(), input, input + numInput);
+    totalInput += numInput;
+
+    // An output is final once its last non-zero tap (ip + halfWidth) has arrived
+    const Kernel& k = *kernel;
+    const int64_t limit = totalInput - k.halfWidth;  // ip must be < limit
+    int64_t last = nextOutput;
+    if (limit > 0)
+    {
+        last = k.exact ? (limit * k.up + k.down - 1) / k.down
+                       : static_cast<int64_t>(std::ceil(static_cast<double>(limit) / k.step));
+        last = std::max(last, nextOutput);
+    }
+
+    const auto produced = static_cast<int>(last - nextOutput);
+    if (produced > 0)
+    {
+        const size_t oldSize = output.size();
+        output.resize(oldSize + static_cast<size_t>(produced));
+        render(nextOutput, last, history.data(), historyStart, totalInput, output.data() + oldSize);
+        nextOutput = last;
+    }
+
+    // Drop input no later output can reach
+    const int64_t nextIp = k.exact ? (nextOutput * k.down) / k.up
+                                   : static_cast<int64_t>(std::floor(static_cast<double>(nextOutput) * k.step));
+    const int64_t keepFrom = std::min(totalInput, std::max(historyStart, nextIp - (k.halfWidth - 1)));
+    if (keepFrom > historyStart)
+    {
+        history.erase(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(keepFrom - historyStart));
+        historyStart = keepFrom;
+    }
+
+    return produced;
+}
+
+int Resampler::flush(std::vector<float>& output)
+{
+    const int64_t total = static_cast<int64_t>(totalInput) * targetRate / sourceRate;
+    const auto remaining = static_cast<int>(std::max<int64_t>(0, total - nextOutput));
+
+    if (remaining > 0)
+    {
+        const size_t oldSize = output.size();
+        output.resize(oldSize + static_cast<size_t>(remaining));
+        if (isPassthrough())
+            std::fill(output.begin() + static_cast<std::ptrdiff_t>(oldSize), output.end(), 0.0f);
+        else
+            render(nextOutput, total, history.data(), historyStart, totalInput, output.data() + oldSize);
+    }
+
+    reset();
+    return remaining;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Band-limited polyphase resampler shared by file import, the neural
+ * detectors (44.1k -> 16k / any -> 44.1k) and host-rate playback.
+ *
+ * The rate ratio is reduced to L/M. Each of the L phases of a Kaiser
+ * windowed-sinc prototype (cutoff at the lower of the two Nyquist rates)
+ * is stored as a contiguous tap row, in the order the outputs of one
+ * period use them, so every output sample is a single SIMD dot product
+ * and four outputs share one horizontal sum. Tables are built once per
+ * ratio and quality and shared through a process-wide cache. Ratios whose
+ * L would be too large (unusual rates) use a fixed phase table with linear
+ * interpolation between phases.
+ *
+ * Quality::High (~80 dB stopband) is for audio that is played back or
+ * analyzed as the project waveform; Quality::Fast (~30 dB, a sixth of the
+ * taps) is for detector inputs, where it costs less than the linear
+ * interpolation it replaced.
+ *
+ * The streaming API (processBlock / flush) produces the same output as
+ * process() chunk by chunk with bounded memory.
+ */
+class Resampler
+{
+public:
+    enum class Quality
+    {
+        Fast,
+        High
+    };
+
+    Resampler(int sourceRate, int targetRate, Quality quality = Quality::High);
+    ~Resampler();
+
+    int getSourceRate() const { return sourceRate; }
+    int getTargetRate() const { return targetRate; }
+    Quality getQuality() const { return quality; }
+    bool isPassthrough() const { return sourceRate == targetRate; }
+
+    /** Number of output samples produced for numInput input samples. */
+    int getOutputLength(int numInput) const;
+
+    /**
+     * Resample a whole buffer into out[0, numOutput). Input outside
+     * [0, numInput) is treated as silence.
+     */
+    void process(const float* input, int numInput, float* output, int numOutput) const;
+
+    /** Convenience one-shot resample. */
+    static std::vector<float> resample(const float* input, int numInput,
+                                       int sourceRate, int targetRate,
+                                       Quality quality = Quality::High);
+
+    // Streaming -------------------------------------------------------------
+
+    /** Forget buffered input and restart the output clock at zero. */
+    void reset();
+
+    /**
+     * Feed a chunk of input and append every output sample that is fully
+     * determined so far. Returns the number of samples appended.
+     */
+    int processBlock(const float* input, int numInput, std::vector<float>& output);
+
+    /**
+     * Finish the stream (remaining input is followed by silence) and
+     * append the tail so the total equals getOutputLength(total input).
+     */
+    int flush(std::vector<float>& output);
+
+private:
+    struct Kernel;
+
+    static std::shared_ptr<const Kernel> getKernel(int sourceRate, int targetRate, Quality quality);
+
+    // Compute output samples [first, last) from input available at absolute
+    // indices [base, end); base points at absolute index baseIndex.
+    void render(int64_t first, int64_t last, const float* base, int64_t baseIndex,
+                int64_t end, float* output) const;
+
+    int sourceRate;
+    int targetRate;
+    Quality quality;
+    std::shared_ptr<const Kernel> kernel;
+
+    // Streaming state
+    std::vector<float> history;   // Input from absolute index historyStart
+    int64_t historyStart = 0;
+    int64_t totalInput = 0;
+    int64_t nextOutput = 0;
+};
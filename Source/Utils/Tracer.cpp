@@ -0,0 +1,291 @@
+#include "Tracer.h"
+#include "../JuceHeader.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct ThreadBuffer
+    {
+        std::vector<Tracer::Event> events = std::vector<Tracer::Event>(Tracer::bufferCapacity);
+        std::atomic<std::uint64_t> written{0};  // Total spans ever recorded
+        int threadId = 0;
+        std::string threadName;
+    };
+
+    constexpr size_t maxRealtimeThreads = 64;  // Buffer list capacity the audio path may use
+
+    struct Registry
+    {
+        Registry() { buffers.reserve(maxRealtimeThreads); }
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;  // Exported: live and retired threads
+        std::deque<std::shared_ptr<ThreadBuffer>> retired;   // Finished threads, oldest first
+        std::vector<std::shared_ptr<ThreadBuffer>> unused;   // Recycled from retired threads
+        std::vector<std::shared_ptr<ThreadBuffer>> spares;   // For audio threads
+        int nextThreadId = 1;
+        std::atomic<std::int64_t> clearedAt{-1};  // Spans starting before this are dropped
+    };
+
+    Registry& getRegistry()
+    {
+        // Never destroyed: detached threads may exit after static destruction
+        static auto* registry = new Registry();
+        return *registry;
+    }
+
+    std::string getCurrentThreadName(int threadId)
+    {
+        if (auto* mm = juce::MessageManager::getInstanceWithoutCreating())
+            if (mm->isThisTheMessageThread())
+                return "Message thread";
+
+        if (auto* thread = juce::Thread::getCurrentThread())
+            if (thread->getThreadName().isNotEmpty())
+                return thread->getThreadName().toStdString();
+
+        return "Thread " + std::to_string(threadId);
+    }
+
+    // Owned by the registry, which lives until exit
+    thread_local ThreadBuffer* currentBuffer = nullptr;
+
+    // Move a finished thread's buffer to the retired list; past
+    // maxRetiredBuffers the oldest one leaves the export and is recycled
+    void retireBuffer(ThreadBuffer* buffer)
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = std::find_if(registry.buffers.begin(), registry.buffers.end(),
+                               [buffer](const auto& entry) { return entry.get() == buffer; });
+        if (it == registry.buffers.end())
+            return;
+
+        registry.retired.push_back(*it);
+        if (registry.retired.size() <= static_cast<size_t>(Tracer::maxRetiredBuffers))
+            return;
+
+        auto oldest = std::move(registry.retired.front());
+        registry.retired.pop_front();
+        registry.buffers.erase(std::find(registry.buffers.begin(), registry.buffers.end(), oldest));
+
+        // An export still reading it keeps its own reference; let that one free it
+        if (oldest.use_count() == 1 && registry.unused.size() < static_cast<size_t>(Tracer::maxRetiredBuffers))
+            registry.unused.push_back(std::move(oldest));
+    }
+
+    // Destroyed when its thread exits. Audio threads never create one, since
+    // registering the destructor may allocate; their buffers come from the
+    // spares and are not recycled.
+    struct ThreadExitHook
+    {
+        ~ThreadExitHook()
+        {
+            if (currentBuffer != nullptr)
+                retireBuffer(currentBuffer);
+            currentBuffer = nullptr;
+        }
+    };
+
+    thread_local ThreadExitHook threadExitHook;
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        if (currentBuffer == nullptr)
+        {
+            static_cast<void>(&threadExitHook);  // Constructs the hook for this thread
+
+            auto& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::shared_ptr<ThreadBuffer> buffer;
+            if (!registry.unused.empty())
+            {
+                buffer = std::move(registry.unused.back());
+                registry.unused.pop_back();
+                buffer->written.store(0, std::memory_order_relaxed);
+            }
+            else
+            {
+                buffer = std::make_shared<ThreadBuffer>();
+            }
+
+            buffer->threadId = registry.nextThreadId++;
+            buffer->threadName = getCurrentThreadName(buffer->threadId);
+            registry.buffers.push_back(buffer);
+            currentBuffer = buffer.get();
+        }
+        return *currentBuffer;
+    }
+
+    ThreadBuffer* getRealtimeThreadBuffer()
+    {
+        if (currentBuffer != nullptr)
+            return currentBuffer;
+
+        auto& registry = getRegistry();
+        std::unique_lock<std::mutex> lock(registry.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || registry.spares.empty() ||
+            registry.buffers.size() >= registry.buffers.capacity())
+            return nullptr;
+
+        auto& buffer = registry.spares.back();
+        buffer->threadId = registry.nextThreadId++;
+        buffer->threadName = "Audio thread";  // Short enough not to allocate
+        currentBuffer = buffer.get();
+        registry.buffers.push_back(std::move(buffer));
+        registry.spares.pop_back();
+        return currentBuffer;
+    }
+
+    void append(ThreadBuffer& buffer, const char* name, std::int64_t startMicros, std::int64_t durationMicros)
+    {
+        const auto index = buffer.written.load(std::memory_order_relaxed);
+        auto& event = buffer.events[static_cast<size_t>(index % Tracer::bufferCapacity)];
+        event.name = name;
+        event.startMicros = startMicros;
+        event.durationMicros = durationMicros;
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    // Copies the spans of one buffer that are not being overwritten while we read
+    std::vector<Tracer::Event> snapshot(const ThreadBuffer& buffer)
+    {
+        const std::uint64_t capacity = Tracer::bufferCapacity;
+        const std::uint64_t end = buffer.written.load(std::memory_order_acquire);
+        const std::uint64_t begin = end > capacity ? end - capacity : 0;
+
+        std::vector<Tracer::Event> copy;
+        copy.reserve(static_cast<size_t>(end - begin));
+        for (std::uint64_t i = begin; i < end; ++i)
+            copy.push_back(buffer.events[static_cast<size_t>(i % capacity)]);
+
+        // The writer may have lapped the oldest slots during the copy; the
+        // slot it is filling now belongs to index written - capacity.
+        const std::uint64_t after = buffer.written.load(std::memory_order_acquire);
+        const std::uint64_t firstValid = after >= capacity ? after - capacity + 1 : 0;
+        if (firstValid > begin)
+            copy.erase(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(std::min(firstValid, end) - begin));
+
+        return copy;
+    }
+
+    void appendEscaped(std::string& out, const std::string& text)
+    {
+        out += '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += ' ';
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+}
+
+std::int64_t Tracer::nowMicros()
+{
+    using Clock = std::chrono::steady_clock;
+    static const auto origin = Clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin).count();
+}
+
+void Tracer::record(const char* name, std::int64_t startMicros, std::int64_t durationMicros)
+{
+    append(getThreadBuffer(), name, startMicros, durationMicros);
+}
+
+void Tracer::recordRealtime(const char* name, std::int64_t startMicros, std::int64_t durationMicros)
+{
+    if (!isEnabled())
+        return;
+
+    if (auto* buffer = getRealtimeThreadBuffer())
+        append(*buffer, name, startMicros, durationMicros);
+}
+
+void Tracer::recordInstantRealtime(const char* name)
+{
+    recordRealtime(name, nowMicros(), -1);
+}
+
+void Tracer::reserveRealtimeBuffers(int count)
+{
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    while (static_cast<int>(registry.spares.size()) < count)
+        registry.spares.push_back(std::make_shared<ThreadBuffer>());
+}
+
+void Tracer::clear()
+{
+    // Buffers belong to their threads, so clearing moves a cut-off instead
+    getRegistry().clearedAt.store(nowMicros(), std::memory_order_relaxed);
+}
+
+std::string Tracer::toChromeTraceJson()
+{
+    auto& registry = getRegistry();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+    const auto clearedAt = registry.clearedAt.load(std::memory_order_relaxed);
+
+    std::string json = "{\"traceEvents\":[";
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first)
+            json += ",\n";
+        first = false;
+    };
+
+    for (const auto& buffer : buffers)
+    {
+        beginEvent();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(buffer->threadId) +
+                ",\"args\":{\"name\":";
+        appendEscaped(json, buffer->threadName);
+        json += "}}";
+
+        for (const auto& event : snapshot(*buffer))
+        {
+            if (event.name == nullptr || event.startMicros < clearedAt)
+                continue;
+
+            beginEvent();
+            json += "{\"name\":";
+            appendEscaped(json, event.name);
+            if (event.durationMicros < 0)
+                json += ",\"ph\":\"i\",\"s\":\"t\"";
+            else
+                json += ",\"ph\":\"X\",\"dur\":" + std::to_string(event.durationMicros);
+            json += ",\"ts\":" + std::to_string(event.startMicros) +
+                    ",\"pid\":1,\"tid\":" + std::to_string(buffer->threadId) + "}";
+        }
+    }
+
+    json += "],\n\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+}
+
+bool Tracer::exportChromeTrace(const std::string& path)
+{
+    juce::File file(juce::String::fromUTF8(path.c_str()));
+    return file.replaceWithText(juce::String::fromUTF8(toChromeTraceJson().c_str()));
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Application-wide span tracing with Chrome trace export.
+ *
+ * Recording is off until setEnabled(true) (--trace, or View > Record
+ * Performance Trace); while off, a span costs one relaxed load.
+ *
+ * Each thread records into its own fixed-size ring buffer, so recording a
+ * span is two clock reads and a store with no locks or allocation; once a
+ * buffer is full the oldest spans are overwritten. When a thread exits its
+ * buffer stays exportable until maxRetiredBuffers newer threads have
+ * finished; after that the memory is handed to the next new thread, so
+ * short-lived workers do not grow the trace without bound.
+ *
+ * The export is a Chrome trace JSON file ("X" complete events plus thread
+ * names) that loads in chrome://tracing and ui.perfetto.dev.
+ *
+ * Span names must be string literals (only the pointer is stored).
+ * Instant events (e.g. an audio overrun) are stored with a negative duration.
+ * Header is standard C++ only so the DSP utilities can use it.
+ */
+class Tracer
+{
+public:
+    static constexpr int bufferCapacity = 16384;  // Spans kept per thread
+    static constexpr int maxRetiredBuffers = 8;   // Finished threads kept for export
+
+    struct Event
+    {
+        const char* name = nullptr;
+        std::int64_t startMicros = 0;
+        std::int64_t durationMicros = 0;
+    };
+
+    /** Records the time from construction to end() or destruction. */
+    class Span
+    {
+    public:
+        explicit Span(const char* spanName)
+            : name(spanName), start(isEnabled() ? nowMicros() : -1) {}
+
+        ~Span() { end(); }
+
+        /** Close the span early, e.g. at the end of a stage within a function. */
+        void end()
+        {
+            if (start >= 0)
+            {
+                record(name, start, nowMicros() - start);
+                start = -1;
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name;
+        std::int64_t start;
+    };
+
+    static void setEnabled(bool shouldBeEnabled) { enabled().store(shouldBeEnabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled().load(std::memory_order_relaxed); }
+
+    /** Microseconds on a monotonic clock, relative to the first call. */
+    static std::int64_t nowMicros();
+
+    /** Append a finished span to the calling thread's buffer. */
+    static void record(const char* name, std::int64_t startMicros, std::int64_t durationMicros);
+
+    /**
+     * Audio thread variants of record(): they never allocate or wait. A
+     * thread's first event takes one of the buffers set aside by
+     * reserveRealtimeBuffers(), and is dropped if none is left or the
+     * buffer list is locked by an export at that moment.
+     */
+    static void recordRealtime(const char* name, std::int64_t startMicros, std::int64_t durationMicros);
+    static void recordInstantRealtime(const char* name);
+
+    /** Set aside buffers for up to count audio threads (call from prepareToPlay). */
+    static void reserveRealtimeBuffers(int count);
+
+    /** Drop everything recorded so far (from all threads). */
+    static void clear();
+
+    /** The recorded spans of all threads as Chrome trace JSON. */
+    static std::string toChromeTraceJson();
+
+    /** Write toChromeTraceJson() to a file. Returns false if it can't be written. */
+    static bool exportChromeTrace(const std::string& path);
+
+private:
+    static std::atomic<bool>& enabled()
+    {
+        static std::atomic<bool> flag{false};
+        return flag;
+    }
+};
+
+#define TRACE_JOIN_INNER(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN_INNER(a, b)
+
+/** Trace the enclosing scope as a span called name. */
+#define TRACE_SCOPE(name) Tracer::Span TRACE_JOIN(traceSpan_, __LINE__)(name)
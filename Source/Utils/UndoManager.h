@@ -3,9 +3,11 @@
 #include "../JuceHeader.h"
 #include "../Models/Note.h"
 #include "../Models/Project.h"
+#include "FrameEditRuns.h"
 #include <vector>
 #include <memory>
 #include <functional>
+#include <algorithm>
 #include <limits>
 
 /**
@@ -18,6 +20,40 @@ public:
     virtual void undo() = 0;
     virtual void redo() = 0;
     virtual juce::String getName() const = 0;
+
+    // Fold an action that directly follows this one into the same undo step
+    virtual bool coalesce(UndoableAction& next) { juce::ignoreUnused(next); return false; }
+
+    // Approximate heap bytes held, counted against the history budget
+    virtual size_t getMemoryBytes() const { return 256; }
+
+    // Move bulky data to a file until the next undo/redo needs it
+    virtual bool spill(const juce::File& file) { juce::ignoreUnused(file); return false; }
+    virtual bool isSpilled() const { return false; }
+
+    // Rendered audio around this edit: ids into a RenderSnapshotStore for
+    // the samples before and after each render, so undo/redo can swap them
+    // back in instead of resynthesizing
+    struct RenderSnapshot
+    {
+        int startSample = 0;
+        int numSamples = 0;
+        int beforeId = 0;
+        int afterId = 0;
+    };
+
+    void addRenderSnapshot(const RenderSnapshot& snapshot) { renderSnapshots.push_back(snapshot); }
+    const std::vector<RenderSnapshot>& getRenderSnapshots() const { return renderSnapshots; }
+    void clearRenderSnapshots() { renderSnapshots.clear(); }
+
+    // Unique per manager; stays the same when later actions coalesce into this one
+    juce::uint64 getSerial() const { return serial; }
+
+private:
+    friend class PitchUndoManager;
+
+    std::vector<RenderSnapshot> renderSnapshots;
+    juce::uint64 serial = 0;
 };
 
 /**
@@ -26,152 +62,181 @@ public:
 class PitchOffsetAction : public UndoableAction
 {
 public:
-    PitchOffsetAction(Note* note, float oldOffset, float newOffset)
-        : note(note), oldOffset(oldOffset), newOffset(newOffset) {}
+    PitchOffsetAction(Project* proj, NoteHandle note, float oldOffset, float newOffset)
+        : project(proj), note(note), oldOffset(oldOffset), newOffset(newOffset) {}
     
-    void undo() override { if (note) note->setPitchOffset(oldOffset); }
-    void redo() override { if (note) note->setPitchOffset(newOffset); }
+    void undo() override { apply(oldOffset); }
+    void redo() override { apply(newOffset); }
     juce::String getName() const override { return "Change Pitch Offset"; }
     
 private:
-    Note* note;
+    void apply(float offset)
+    {
+        if (auto* n = project ? project->getNote(note) : nullptr)
+            n->setPitchOffset(offset);
+    }
+
+    Project* project;
+    NoteHandle note;
     float oldOffset;
     float newOffset;
 };
 
 /**
  * Action for changing multiple F0 values (hand-drawing).
+ * Consecutive strokes coalesce into one undo step (see PitchUndoManager).
  */
-struct F0FrameEdit
-{
-    int idx = -1;
-    float oldF0 = 0.0f;
-    float newF0 = 0.0f;
-    float oldDelta = 0.0f;
-    float newDelta = 0.0f;
-    bool oldVoiced = false;
-    bool newVoiced = false;
-};
-
 class F0EditAction : public UndoableAction
 {
 public:
     F0EditAction(std::vector<float>* f0Array,
                  std::vector<float>* deltaPitchArray,
-                 std::vector<bool>* voicedMask,
+                 VoicedMask* voicedMask,
                  std::vector<F0FrameEdit> edits,
                  std::function<void(int, int)> onF0Changed = nullptr)
         : f0Array(f0Array), deltaPitchArray(deltaPitchArray), voicedMask(voicedMask), edits(std::move(edits)), onF0Changed(onF0Changed) {}
 
-    void undo() override
+    void undo() override { apply(false); }
+    void redo() override { apply(true); }
+
+    juce::String getName() const override { return "Edit Pitch Curve"; }
+
+    bool coalesce(UndoableAction& next) override
     {
-        if (!f0Array) return;
-        int minIdx = std::numeric_limits<int>::max();
-        int maxIdx = std::numeric_limits<int>::min();
-        for (const auto& e : edits)
-        {
-            if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size())) {
-                (*f0Array)[e.idx] = e.oldF0;
-                minIdx = std::min(minIdx, e.idx);
-                maxIdx = std::max(maxIdx, e.idx);
-            }
-            if (deltaPitchArray && e.idx >= 0 && e.idx < static_cast<int>(deltaPitchArray->size()))
-                (*deltaPitchArray)[e.idx] = e.oldDelta;
-            if (voicedMask && e.idx >= 0 && e.idx < static_cast<int>(voicedMask->size()))
-                (*voicedMask)[e.idx] = e.oldVoiced;
-        }
-        if (onF0Changed && minIdx <= maxIdx)
-            onF0Changed(minIdx, maxIdx);
+        auto* other = dynamic_cast<F0EditAction*>(&next);
+        if (other == nullptr || other->f0Array != f0Array || other->deltaPitchArray != deltaPitchArray ||
+            other->voicedMask != voicedMask)
+            return false;
+        return edits.append(other->edits);
     }
 
-    void redo() override
+    size_t getMemoryBytes() const override { return sizeof(*this) + edits.getMemoryBytes(); }
+    bool spill(const juce::File& file) override { return edits.spill(file); }
+    bool isSpilled() const override { return edits.isSpilled(); }
+
+private:
+    void apply(bool useNewValues)
     {
         if (!f0Array) return;
-        int minIdx = std::numeric_limits<int>::max();
-        int maxIdx = std::numeric_limits<int>::min();
-        for (const auto& e : edits)
-        {
-            if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size())) {
-                (*f0Array)[e.idx] = e.newF0;
-                minIdx = std::min(minIdx, e.idx);
-                maxIdx = std::max(maxIdx, e.idx);
-            }
-            if (deltaPitchArray && e.idx >= 0 && e.idx < static_cast<int>(deltaPitchArray->size()))
-                (*deltaPitchArray)[e.idx] = e.newDelta;
-            if (voicedMask && e.idx >= 0 && e.idx < static_cast<int>(voicedMask->size()))
-                (*voicedMask)[e.idx] = e.newVoiced;
-        }
-        if (onF0Changed && minIdx <= maxIdx)
+        int minIdx = 0, maxIdx = 0;
+        if (edits.apply(useNewValues, f0Array, deltaPitchArray, voicedMask, minIdx, maxIdx) && onF0Changed)
             onF0Changed(minIdx, maxIdx);
     }
 
-    juce::String getName() const override { return "Edit Pitch Curve"; }
-
-private:
     std::vector<float>* f0Array;
     std::vector<float>* deltaPitchArray;
-    std::vector<bool>* voicedMask;
-    std::vector<F0FrameEdit> edits;
+    VoicedMask* voicedMask;
+    FrameEditRuns edits;
     std::function<void(int, int)> onF0Changed;  // Callback with (minFrame, maxFrame) to trigger resynthesis
 };
 
+/**
+ * Action for moving the voicing threshold: the frames whose voicing the
+ * re-decode flipped, plus the stored salience threshold. One slider
+ * gesture is one action; wheel and keyboard steps coalesce.
+ */
+class VoicingThresholdAction : public UndoableAction
+{
+public:
+    VoicingThresholdAction(Project* proj, std::vector<F0FrameEdit> frameEdits, float thresholdBefore,
+                           float thresholdAfter, std::function<void(int, int)> onChanged = nullptr)
+        : project(proj), edits(std::move(frameEdits)), oldThreshold(thresholdBefore), newThreshold(thresholdAfter),
+          onF0Changed(std::move(onChanged)) {}
+
+    void undo() override { apply(false); }
+    void redo() override { apply(true); }
+
+    juce::String getName() const override { return "Change Voicing Threshold"; }
+
+    bool coalesce(UndoableAction& next) override
+    {
+        auto* other = dynamic_cast<VoicingThresholdAction*>(&next);
+        if (other == nullptr || other->project != project || !edits.append(other->edits))
+            return false;
+        newThreshold = other->newThreshold;
+        return true;
+    }
+
+    size_t getMemoryBytes() const override { return sizeof(*this) + edits.getMemoryBytes(); }
+    bool spill(const juce::File& file) override { return edits.spill(file); }
+    bool isSpilled() const override { return edits.isSpilled(); }
+
+private:
+    void apply(bool useNewValues)
+    {
+        if (!project) return;
+        auto& audioData = project->getAudioData();
+        audioData.pitchSalience.setThreshold(useNewValues ? newThreshold : oldThreshold);
+
+        int minIdx = 0, maxIdx = 0;
+        edits.apply(useNewValues, &audioData.f0, &audioData.deltaPitch, &audioData.voicedMask, minIdx, maxIdx);
+        if (onF0Changed)
+            onF0Changed(minIdx, maxIdx);  // maxIdx < minIdx: only the threshold changed
+    }
+
+    Project* project;
+    FrameEditRuns edits;
+    float oldThreshold;
+    float newThreshold;
+    std::function<void(int, int)> onF0Changed;
+};
+
 /**
  * Action for dragging a note to change pitch (MIDI note + F0 values).
  */
 class NotePitchDragAction : public UndoableAction
 {
 public:
-    NotePitchDragAction(Note* note, std::vector<float>* f0Array,
+    NotePitchDragAction(Project* proj, NoteHandle note, std::vector<float>* f0Array,
                         float oldMidi, float newMidi,
                         std::vector<F0FrameEdit> f0Edits,
                         std::function<void(Note*)> onNoteChanged = nullptr)
-        : note(note), f0Array(f0Array), oldMidi(oldMidi), newMidi(newMidi),
+        : project(proj), note(note), f0Array(f0Array), oldMidi(oldMidi), newMidi(newMidi),
           f0Edits(std::move(f0Edits)), onNoteChanged(onNoteChanged) {}
 
     void undo() override
     {
-        if (note) {
-            note->setMidiNote(oldMidi);
-            note->markDirty();
-        }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.oldF0;
-            }
+        auto* n = project ? project->getNote(note) : nullptr;
+        if (n) {
+            n->setMidiNote(oldMidi);
+            n->markDirty();
         }
+        int minIdx = 0, maxIdx = 0;
+        f0Edits.apply(false, f0Array, nullptr, nullptr, minIdx, maxIdx);
         // Notify that note changed, so base pitch can be recalculated
-        if (onNoteChanged && note) {
-            onNoteChanged(note);
+        if (onNoteChanged && n) {
+            onNoteChanged(n);
         }
     }
 
     void redo() override
     {
-        if (note) {
-            note->setMidiNote(newMidi);
-            note->markDirty();
-        }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.newF0;
-            }
+        auto* n = project ? project->getNote(note) : nullptr;
+        if (n) {
+            n->setMidiNote(newMidi);
+            n->markDirty();
         }
+        int minIdx = 0, maxIdx = 0;
+        f0Edits.apply(true, f0Array, nullptr, nullptr, minIdx, maxIdx);
         // Notify that note changed, so base pitch can be recalculated
-        if (onNoteChanged && note) {
-            onNoteChanged(note);
+        if (onNoteChanged && n) {
+            onNoteChanged(n);
         }
     }
 
     juce::String getName() const override { return "Drag Note Pitch"; }
 
+    size_t getMemoryBytes() const override { return sizeof(*this) + f0Edits.getMemoryBytes(); }
+    bool spill(const juce::File& file) override { return f0Edits.spill(file); }
+    bool isSpilled() const override { return f0Edits.isSpilled(); }
+
 private:
-    Note* note;
+    Project* project;
+    NoteHandle note;
     std::vector<float>* f0Array;
     float oldMidi;
     float newMidi;
-    std::vector<F0FrameEdit> f0Edits;
+    FrameEditRuns f0Edits;
     std::function<void(Note*)> onNoteChanged;  // Callback when note MIDI changes
 };
 
@@ -181,57 +246,64 @@ private:
 class MultiNotePitchDragAction : public UndoableAction
 {
 public:
-    MultiNotePitchDragAction(std::vector<Note*> notes, std::vector<float>* f0Array,
+    MultiNotePitchDragAction(Project* proj, std::vector<NoteHandle> notes, std::vector<float>* f0Array,
                              std::vector<float> oldMidis, float pitchDelta,
                              std::vector<F0FrameEdit> f0Edits,
                              std::function<void(const std::vector<Note*>&)> onNotesChanged = nullptr)
-        : notes(std::move(notes)), f0Array(f0Array), oldMidis(std::move(oldMidis)),
+        : project(proj), notes(std::move(notes)), f0Array(f0Array), oldMidis(std::move(oldMidis)),
           pitchDelta(pitchDelta), f0Edits(std::move(f0Edits)), onNotesChanged(onNotesChanged) {}
 
     void undo() override
     {
-        for (size_t i = 0; i < notes.size() && i < oldMidis.size(); ++i) {
-            if (notes[i]) {
-                notes[i]->setMidiNote(oldMidis[i]);
-                notes[i]->markDirty();
-            }
-        }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.oldF0;
-            }
-        }
+        auto resolved = setMidiNotes(0.0f);
+        int minIdx = 0, maxIdx = 0;
+        f0Edits.apply(false, f0Array, nullptr, nullptr, minIdx, maxIdx);
         if (onNotesChanged)
-            onNotesChanged(notes);
+            onNotesChanged(resolved);
     }
 
     void redo() override
     {
-        for (size_t i = 0; i < notes.size() && i < oldMidis.size(); ++i) {
-            if (notes[i]) {
-                notes[i]->setMidiNote(oldMidis[i] + pitchDelta);
-                notes[i]->markDirty();
-            }
-        }
-        if (f0Array) {
-            for (const auto& e : f0Edits) {
-                if (e.idx >= 0 && e.idx < static_cast<int>(f0Array->size()))
-                    (*f0Array)[e.idx] = e.newF0;
-            }
-        }
+        auto resolved = setMidiNotes(pitchDelta);
+        int minIdx = 0, maxIdx = 0;
+        f0Edits.apply(true, f0Array, nullptr, nullptr, minIdx, maxIdx);
         if (onNotesChanged)
-            onNotesChanged(notes);
+            onNotesChanged(resolved);
     }
 
     juce::String getName() const override { return "Drag Multiple Notes"; }
 
+    size_t getMemoryBytes() const override
+    {
+        return sizeof(*this) + notes.capacity() * sizeof(NoteHandle) + oldMidis.capacity() * sizeof(float) +
+               f0Edits.getMemoryBytes();
+    }
+    bool spill(const juce::File& file) override { return f0Edits.spill(file); }
+    bool isSpilled() const override { return f0Edits.isSpilled(); }
+
 private:
-    std::vector<Note*> notes;
+    // Applies oldMidi + delta to every note that still exists; returns those notes
+    std::vector<Note*> setMidiNotes(float delta)
+    {
+        std::vector<Note*> resolved;
+        if (!project)
+            return resolved;
+        for (size_t i = 0; i < notes.size() && i < oldMidis.size(); ++i) {
+            if (auto* n = project->getNote(notes[i])) {
+                n->setMidiNote(oldMidis[i] + delta);
+                n->markDirty();
+                resolved.push_back(n);
+            }
+        }
+        return resolved;
+    }
+
+    Project* project;
+    std::vector<NoteHandle> notes;
     std::vector<float>* f0Array;
     std::vector<float> oldMidis;
     float pitchDelta;
-    std::vector<F0FrameEdit> f0Edits;
+    FrameEditRuns f0Edits;
     std::function<void(const std::vector<Note*>&)> onNotesChanged;
 };
 
@@ -241,23 +313,21 @@ private:
 class NoteSplitAction : public UndoableAction
 {
 public:
-    NoteSplitAction(Project* proj, const Note& original, const Note& firstPart, const Note& secondPart,
+    NoteSplitAction(Project* proj, NoteHandle firstHandle, NoteHandle secondHandle,
+                    const Note& original, const Note& firstPart, const Note& secondPart,
                     std::function<void()> onChanged = nullptr)
-        : project(proj), originalNote(original), firstNote(firstPart), secondNote(secondPart),
+        : project(proj), firstHandle(firstHandle), secondHandle(secondHandle),
+          originalNote(original), firstNote(firstPart), secondNote(secondPart),
           onChanged(onChanged) {}
 
     void undo() override
     {
         if (!project) return;
         // Remove the second note and restore original
-        project->removeNoteByStartFrame(secondNote.getStartFrame());
-        // Find and restore the first note to original state
-        for (auto& note : project->getNotes()) {
-            if (note.getStartFrame() == firstNote.getStartFrame()) {
-                note = originalNote;
-                break;
-            }
-        }
+        project->removeNote(secondHandle);
+        if (auto* note = project->getNote(firstHandle))
+            *note = originalNote;
+        project->notesChanged();
         if (onChanged) onChanged();
     }
 
@@ -265,13 +335,9 @@ public:
     {
         if (!project) return;
         // Split again: modify first note and add second
-        for (auto& note : project->getNotes()) {
-            if (note.getStartFrame() == originalNote.getStartFrame()) {
-                note = firstNote;
-                break;
-            }
-        }
-        project->addNote(secondNote);
+        if (auto* note = project->getNote(firstHandle))
+            *note = firstNote;
+        secondHandle = project->restoreNote(secondNote, secondHandle);
         if (onChanged) onChanged();
     }
 
@@ -279,6 +345,8 @@ public:
 
 private:
     Project* project;
+    NoteHandle firstHandle;
+    NoteHandle secondHandle;  // Kept across redo unless its slot was taken
     Note originalNote;
     Note firstNote;
     Note secondNote;
@@ -286,25 +354,89 @@ private:
 };
 
 /**
- * Simple undo manager for the pitch editor.
+ * Action for re-analyzing a selected range (mel, notes, pitch curves and
+ * salience inside the range are replaced together).
+ */
+class ReanalyzeRangeAction : public UndoableAction
+{
+public:
+    ReanalyzeRangeAction(Project* proj, Project::RangeSnapshot rangeBefore, Project::RangeSnapshot rangeAfter,
+                         std::function<void(int, int)> onChanged = nullptr)
+        : project(proj), before(std::move(rangeBefore)), after(std::move(rangeAfter)),
+          onRangeChanged(std::move(onChanged)) {}
+
+    void undo() override { apply(before); }
+    void redo() override { apply(after); }
+
+    juce::String getName() const override { return "Re-analyze Selection"; }
+
+    size_t getMemoryBytes() const override { return before.getMemoryBytes() + after.getMemoryBytes(); }
+
+private:
+    void apply(const Project::RangeSnapshot& snapshot)
+    {
+        if (!project) return;
+        project->restoreRange(snapshot);
+        if (onRangeChanged)
+            onRangeChanged(std::min(snapshot.startFrame, snapshot.curveStart),
+                           std::max(snapshot.endFrame, snapshot.getCurveEnd()));
+    }
+
+    Project* project;
+    Project::RangeSnapshot before;
+    Project::RangeSnapshot after;
+    std::function<void(int, int)> onRangeChanged;
+};
+
+/**
+ * Undo manager for the pitch editor.
+ *
+ * History is bounded by entry count and by a memory budget. Draw strokes
+ * added within the coalescing window of each other merge into one undo
+ * step. When the history exceeds its budget, the oldest entries are first
+ * spilled to a temporary directory (reloaded on undo), then dropped; the
+ * most recent entry always stays in memory.
  */
 class PitchUndoManager
 {
 public:
-    PitchUndoManager(size_t maxHistory = 100) : maxHistory(maxHistory) {}
+    static constexpr size_t defaultMemoryBudget = 64 * 1024 * 1024;
+    static constexpr juce::uint32 defaultCoalesceWindowMs = 1000;
+
+    PitchUndoManager(size_t maxHistory = 100, size_t memoryBudget = defaultMemoryBudget)
+        : maxHistory(maxHistory), memoryBudget(memoryBudget) {}
+
+    ~PitchUndoManager()
+    {
+        undoStack.clear();
+        redoStack.clear();
+        if (spillDirectory != juce::File())
+            spillDirectory.deleteRecursively();
+    }
     
     void addAction(std::unique_ptr<UndoableAction> action)
     {
         // Clear redo stack when new action is added
-        redoStack.clear();
-        
-        undoStack.push_back(std::move(action));
+        dropAll(redoStack);
+
+        const auto now = juce::Time::getMillisecondCounter();
+        const bool merged = canCoalesce && !undoStack.empty() && now - lastActionTime < coalesceWindowMs &&
+                            undoStack.back()->coalesce(*action);
+        if (!merged)
+        {
+            action->serial = ++nextSerial;
+            undoStack.push_back(std::move(action));
+        }
+        ++editCount;
+        canCoalesce = true;
+        lastActionTime = now;
         
         // Limit history size
         while (undoStack.size() > maxHistory)
         {
-            undoStack.erase(undoStack.begin());
+            dropOldest();
         }
+        enforceBudget();
         
         if (onHistoryChanged)
             onHistoryChanged();
@@ -322,6 +454,8 @@ public:
         
         action->undo();
         redoStack.push_back(std::move(action));
+        canCoalesce = false;
+        enforceBudget();
         
         if (onHistoryChanged)
             onHistoryChanged();
@@ -336,6 +470,8 @@ public:
         
         action->redo();
         undoStack.push_back(std::move(action));
+        canCoalesce = false;
+        enforceBudget();
         
         if (onHistoryChanged)
             onHistoryChanged();
@@ -343,13 +479,50 @@ public:
     
     void clear()
     {
-        undoStack.clear();
-        redoStack.clear();
+        dropAll(undoStack);
+        dropAll(redoStack);
+        canCoalesce = false;
         
         if (onHistoryChanged)
             onHistoryChanged();
     }
     
+    // Action the next undo() reverts, or nullptr
+    UndoableAction* getLastAction() const
+    {
+        return undoStack.empty() ? nullptr : undoStack.back().get();
+    }
+
+    // Action the next redo() re-applies, or nullptr
+    UndoableAction* getNextRedoAction() const
+    {
+        return redoStack.empty() ? nullptr : redoStack.back().get();
+    }
+
+    UndoableAction* findAction(juce::uint64 serial) const
+    {
+        for (const auto* stack : {&undoStack, &redoStack})
+        {
+            for (const auto& action : *stack)
+            {
+                if (action->serial == serial)
+                    return action.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void forEachAction(const std::function<void(UndoableAction&)>& fn)
+    {
+        for (auto& action : undoStack)
+            fn(*action);
+        for (auto& action : redoStack)
+            fn(*action);
+    }
+
+    // Bumped by every addAction, including ones that coalesced
+    juce::uint64 getEditCount() const { return editCount; }
+
     juce::String getUndoName() const
     {
         return undoStack.empty() ? "" : undoStack.back()->getName();
@@ -359,11 +532,100 @@ public:
     {
         return redoStack.empty() ? "" : redoStack.back()->getName();
     }
+
+    void setMemoryBudget(size_t bytes)
+    {
+        memoryBudget = bytes;
+        enforceBudget();
+    }
+    size_t getMemoryBudget() const { return memoryBudget; }
+
+    // 0 disables coalescing
+    void setCoalesceWindowMs(juce::uint32 ms) { coalesceWindowMs = ms; }
+
+    // Bytes held in memory by the history (spilled entries excluded)
+    size_t getMemoryBytes() const
+    {
+        size_t total = 0;
+        for (const auto& action : undoStack)
+            total += action->getMemoryBytes();
+        for (const auto& action : redoStack)
+            total += action->getMemoryBytes();
+        return total;
+    }
     
     std::function<void()> onHistoryChanged;
+
+    // Called for each action the history discards (redo branch, size limit,
+    // memory budget, clear()) just before it is destroyed, so resources it
+    // refers to (e.g. RenderSnapshot ids) can be released
+    std::function<void(UndoableAction&)> onActionDropped;
     
 private:
+    void enforceBudget()
+    {
+        size_t total = getMemoryBytes();
+        if (total <= memoryBudget || undoStack.size() < 2)
+            return;
+
+        // Spill oldest first, keeping the latest entry in memory
+        for (size_t i = 0; i + 1 < undoStack.size() && total > memoryBudget; ++i)
+        {
+            auto& action = *undoStack[i];
+            if (action.isSpilled())
+                continue;
+
+            const size_t before = action.getMemoryBytes();
+            if (action.spill(getSpillFile()))
+                total -= before - std::min(before, action.getMemoryBytes());
+        }
+
+        while (total > memoryBudget && undoStack.size() > 1)
+        {
+            total -= std::min(total, undoStack.front()->getMemoryBytes());
+            dropOldest();
+        }
+    }
+
+    void dropOldest()
+    {
+        if (onActionDropped)
+            onActionDropped(*undoStack.front());
+        undoStack.erase(undoStack.begin());
+    }
+
+    void dropAll(std::vector<std::unique_ptr<UndoableAction>>& stack)
+    {
+        if (onActionDropped)
+        {
+            for (auto& action : stack)
+                onActionDropped(*action);
+        }
+        stack.clear();
+    }
+
+    juce::File getSpillFile()
+    {
+        if (spillDirectory == juce::File())
+        {
+            spillDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("HachiTune-undo", "", false);
+            spillDirectory.createDirectory();
+        }
+        return spillDirectory.getChildFile(juce::String(nextSpillId++) + ".edits");
+    }
+
     std::vector<std::unique_ptr<UndoableAction>> undoStack;
     std::vector<std::unique_ptr<UndoableAction>> redoStack;
     size_t maxHistory;
+    size_t memoryBudget;
+
+    juce::uint32 coalesceWindowMs = defaultCoalesceWindowMs;
+    juce::uint32 lastActionTime = 0;
+    bool canCoalesce = false;
+    juce::uint64 nextSerial = 0;
+    juce::uint64 editCount = 0;
+
+    juce::File spillDirectory;
+    int nextSpillId = 0;
 };